@@ -0,0 +1,145 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#ifndef TOMTOM_APPLICATION_CONVERSION_SERVICE_H
+#define TOMTOM_APPLICATION_CONVERSION_SERVICE_H
+
+#include "AutoStreamMapConverter/MapConverter.hpp"
+
+#include <string>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+
+/**
+ * Service that accepts bounding box conversion jobs on a local Unix socket, using a single map
+ * converter of which AutoStream has been initialized once. Jobs are handled one at a time, each
+ * connection carries a single request line:
+ *
+ *   convert <southWestLat> <southWestLon> <northEastLat> <northEastLon> [<outputFile>]
+ *   shutdown
+ *
+ * If an output file is given, it must be a relative path within the output directory of the
+ * service. The map is written to that file and the response is "OK <path of the written file>".
+ * Otherwise the map is written to the scratch file and streamed back as "OK <size>" followed by
+ * size bytes of OSM data. Failures are reported as "ERROR <reason>". Every response line ends with
+ * a newline.
+ *
+ * The socket is only accessible by the user running the service.
+ */
+class CConversionService
+{
+public:
+  /**
+   * Delete default constructor.
+   */
+  CConversionService() = delete;
+
+  /**
+   * Constructor.
+   *
+   * @param[in] aMapConverter Map converter used for all jobs, AutoStream must have been
+   * initialized. Must outlive the service.
+   * @param[in] aSocketPath Path of the Unix socket on which jobs are accepted.
+   * @param[in] aOutputDirectory Directory within which jobs may name output files, empty if jobs
+   * must not name output files.
+   * @param[in] aScratchFileName File used for maps that are streamed back.
+   */
+  CConversionService(AutoStreamMapConverter::CAutoStreamMapConverter& aMapConverter,
+                     const std::string&                               aSocketPath,
+                     const std::string&                               aOutputDirectory,
+                     const std::string&                               aScratchFileName);
+
+  /**
+   * Destructor, closes and removes the socket and closes the stop pipe.
+   */
+  ~CConversionService();
+
+  CConversionService(const CConversionService&) = delete;
+  CConversionService& operator=(const CConversionService&) = delete;
+
+  /**
+   * Accept and handle jobs until a shutdown request is received or the process is interrupted.
+   *
+   * @retval True If the service stopped on request.
+   * @retval False If the socket could not be opened or accepting connections failed.
+   */
+  bool run();
+
+private:
+  /**
+   * Create the socket, bind it to the socket path and start listening. A stale socket file left by
+   * a previous service is removed. The socket file is created accessible by the owner only.
+   *
+   * @retval True If the socket is listening.
+   * @retval False If creating, binding or listening failed.
+   */
+  bool openSocket();
+
+  /**
+   * Create the pipe to which the signal handler writes, such that waiting for connections is
+   * interrupted by a stop signal irrespective of when and on which thread it arrives.
+   *
+   * @retval True If the pipe has been created.
+   * @retval False If creating the pipe failed.
+   */
+  bool openStopPipe();
+
+  /**
+   * Wait until a connection can be accepted or a stop has been requested.
+   *
+   * @retval True If a connection can be accepted.
+   * @retval False If a stop has been requested or waiting failed.
+   */
+  bool waitForConnection();
+
+  /**
+   * Get the file to which a job must write its map.
+   *
+   * @param[in] aRequestedFileName Output file named by the job.
+   * @param[out] aOutputFileName Path of the output file within the output directory.
+   * @retval True If the output file lies within the output directory.
+   * @retval False If output files are not allowed or the requested file is absolute, refers to a
+   * parent directory, is a symbolic link or lies in a directory outside the output directory.
+   */
+  bool getOutputFileName(const std::string& aRequestedFileName, std::string& aOutputFileName) const;
+
+  /**
+   * Read the request of a connection, perform it and send the response.
+   *
+   * @param[in] aConnection File descriptor of the accepted connection.
+   * @retval True If the service must continue accepting jobs.
+   * @retval False If a shutdown was requested.
+   */
+  bool handleConnection(const int aConnection);
+
+  /**
+   * Convert the map for a bounding box and send the response.
+   *
+   * @param[in] aConnection File descriptor of the connection.
+   * @param[in] aBoundingBox Bounding box that must be converted.
+   * @param[in] aOutputFileName File to which the map must be written, empty to stream it back.
+   */
+  void convert(const int                       aConnection,
+               const AutoStream::TBoundingBox& aBoundingBox,
+               const std::string&              aOutputFileName);
+
+  AutoStreamMapConverter::CAutoStreamMapConverter& mMapConverter;
+
+  std::string mSocketPath;
+  std::string mOutputDirectory;
+  std::string mScratchFileName;
+  int         mSocket;
+  int         mStopPipe[2];
+};
+}
+}
+#endif
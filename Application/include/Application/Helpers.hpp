@@ -13,22 +13,63 @@
 #define TOMTOM_APPLICATION_HELPERS_H
 
 #include "AutoStreamMapConverter/AutoStreamInterface.hpp"
+#include "AutoStreamMapConverter/MapConverter.hpp"
+#include "AutoStreamMapConverter/SyntheticMapSource.hpp"
 
 #include "TomTom/AutoStream/MapBaseTypes.h"
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 namespace TomTom {
 namespace AutoStreamForAutoware {
 
+/**
+ * Modes in which the application can run.
+ */
+enum class TApplicationMode
+{
+  // Convert the configured bounding box once
+  Convert,
+  // Accept bounding box conversion jobs on a Unix socket
+  Serve,
+  // Fill the persistent tile cache along a route without converting
+  WarmUp,
+  // Convert the bounding boxes of a batch manifest, converting shared arcs once
+  Batch
+};
+
 /**
  * Structure that is used to store configuration parameters.
  */
 struct CConfigurationParameters
 {
-  AutoStreamMapConverter::CAutoStreamParameters mParams;
-  AutoStream::TBoundingBox                      mBoundingBox;
-  std::string                                   mOutputFileName;
+  TApplicationMode                                         mMode;
+  AutoStreamMapConverter::CAutoStreamParameters            mParams;
+  AutoStream::TBoundingBox                                 mBoundingBox;
+  std::string                                              mOutputFileName;
+  AutoStreamMapConverter::TMapFileFormat                   mOutputFormat;
+  std::string                                              mIncrementalCacheFileName;
+  std::string                                              mRecordFileName;
+  std::string                                              mReplayFileName;
+  bool                                                     mConversionReport;
+  bool                                                     mRoutingGraph;
+  std::string                                              mTraceFileName;
+  std::string                                              mDeltaBaseFileName;
+  size_t                                                   mNumberOfWorkerThreads;
+  size_t                                                   mPrefetchDepth;
+  size_t                                                   mTileGridRows;
+  size_t                                                   mTileGridColumns;
+  std::string                                              mServiceSocket;
+  std::string                                              mServiceOutputDirectory;
+  std::vector<AutoStream::TCoordinate>                     mRoute;
+  double                                                   mRouteBufferWidth;
+  std::vector<AutoStreamMapConverter::CAutoStreamBatchJob> mBatchJobs;
+
+  // Synthetic map served instead of AutoStream, unused if it has no arcs
+  AutoStreamMapConverter::CSyntheticMapParameters mSyntheticMap;
 };
 
 /**
@@ -41,6 +82,39 @@ struct CConfigurationParameters
  */
 bool getParametersFromConfigurationFile(const std::string&        aFilePath,
                                         CConfigurationParameters& aConfig);
+
+/**
+ * Read a route from a file. Every line contains the latitude and longitude in degrees of one
+ * route point, separated by white space or a comma. Empty lines and lines starting with '#' are
+ * skipped.
+ *
+ * @param[in] aFilePath Route file path.
+ * @param[out] aRoute Points of the route.
+ * @retval True If the route was read.
+ * @retval False If the file could not be opened or contains an invalid line.
+ */
+bool readRouteFile(const std::string& aFilePath, std::vector<AutoStream::TCoordinate>& aRoute);
+
+/**
+ * Read a batch manifest from a file. Every line contains one job: the south west latitude and
+ * longitude, the north east latitude and longitude in degrees, and the output file, separated by
+ * white space. Empty lines and lines starting with '#' are skipped.
+ *
+ * @param[in] aFilePath Batch manifest file path.
+ * @param[out] aJobs Jobs of the batch.
+ * @retval True If the manifest was read.
+ * @retval False If the file could not be opened or contains an invalid line.
+ */
+bool readBatchManifest(const std::string&                                        aFilePath,
+                       std::vector<AutoStreamMapConverter::CAutoStreamBatchJob>& aJobs);
+
+/**
+ * Get the size of a file.
+ *
+ * @param[in] aFilePath File path.
+ * @retval uint64_t Size of the file in bytes, zero if the file does not exist.
+ */
+uint64_t getFileSize(const std::string& aFilePath);
 }
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,143 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+// Replacement of the global allocation functions, passing the size of every heap block to the
+// memory usage counters of the map converter. Only compiled when the allocation hook is enabled,
+// since it adds two atomic operations to every allocation.
+
+#include "AutoStreamMapConverter/MemoryUsage.hpp"
+
+#include <malloc.h>
+
+#include <cstdlib>
+#include <new>
+
+using namespace TomTom::AutoStreamForAutoware::AutoStreamMapConverter;
+
+/**
+ * Allocate a counted heap block.
+ *
+ * @param[in] aSize Requested size in bytes.
+ * @retval void* Allocated block, nullptr if allocating failed.
+ */
+void* allocateCounted(const std::size_t aSize) noexcept
+{
+  void* memory = std::malloc(aSize > 0 ? aSize : 1);
+  if (memory != nullptr)
+  {
+    // The usable size is counted, such that a block is released with the size it was counted with
+    countAllocation(malloc_usable_size(memory));
+  }
+
+  return memory;
+}
+
+/**
+ * Release a counted heap block.
+ *
+ * @param[in] aMemory Block that must be released, may be nullptr.
+ */
+void releaseCounted(void* aMemory) noexcept
+{
+  if (aMemory != nullptr)
+  {
+    countDeallocation(malloc_usable_size(aMemory));
+    std::free(aMemory);
+  }
+}
+
+/**
+ * Allocate a counted heap block, calling the new handler until allocating succeeds.
+ *
+ * @param[in] aSize Requested size in bytes.
+ * @retval void* Allocated block.
+ * @throw std::bad_alloc If allocating failed and no new handler is installed.
+ */
+void* allocateCountedOrThrow(const std::size_t aSize)
+{
+  void* memory = allocateCounted(aSize);
+  while (memory == nullptr)
+  {
+    const std::new_handler handler = std::get_new_handler();
+    if (handler == nullptr)
+    {
+      throw std::bad_alloc();
+    }
+
+    handler();
+    memory = allocateCounted(aSize);
+  }
+
+  return memory;
+}
+
+/**
+ * Object of which the construction marks allocations as counted when the executable starts.
+ */
+struct CAllocationHookInstaller
+{
+  CAllocationHookInstaller() noexcept
+  {
+    enableAllocationCounting();
+  }
+};
+
+const CAllocationHookInstaller gAllocationHookInstaller;
+
+void* operator new(std::size_t aSize)
+{
+  return allocateCountedOrThrow(aSize);
+}
+
+void* operator new[](std::size_t aSize)
+{
+  return allocateCountedOrThrow(aSize);
+}
+
+void* operator new(std::size_t aSize, const std::nothrow_t& /*aTag*/) noexcept
+{
+  return allocateCounted(aSize);
+}
+
+void* operator new[](std::size_t aSize, const std::nothrow_t& /*aTag*/) noexcept
+{
+  return allocateCounted(aSize);
+}
+
+void operator delete(void* aMemory) noexcept
+{
+  releaseCounted(aMemory);
+}
+
+void operator delete[](void* aMemory) noexcept
+{
+  releaseCounted(aMemory);
+}
+
+void operator delete(void* aMemory, std::size_t /*aSize*/) noexcept
+{
+  releaseCounted(aMemory);
+}
+
+void operator delete[](void* aMemory, std::size_t /*aSize*/) noexcept
+{
+  releaseCounted(aMemory);
+}
+
+void operator delete(void* aMemory, const std::nothrow_t& /*aTag*/) noexcept
+{
+  releaseCounted(aMemory);
+}
+
+void operator delete[](void* aMemory, const std::nothrow_t& /*aTag*/) noexcept
+{
+  releaseCounted(aMemory);
+}
@@ -0,0 +1,497 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#include "Application/ConversionService.hpp"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+
+namespace Constants {
+// Number of connections that may wait while a job is being converted
+constexpr int kListenBacklog = 16;
+
+// Longest request line that is accepted
+constexpr size_t kMaxRequestLength = 4096;
+
+// Time within which a client must send its request line after connecting
+constexpr std::chrono::milliseconds kRequestTimeout(10000);
+
+// Size of the chunks in which maps are streamed back
+constexpr size_t kStreamChunkSize = 1 << 16;
+
+// Permissions masked when creating the socket file, such that only its owner can connect
+constexpr mode_t kSocketUmask = S_IRWXG | S_IRWXO | S_IXUSR;
+}
+
+// Set by the signal handler, such that the service stops after the current job
+volatile std::sig_atomic_t gStopRequested = 0;
+
+// Write end of the pipe on which the signal handler wakes up the service, -1 if there is none
+volatile std::sig_atomic_t gStopPipeWriteEnd = -1;
+
+/**
+ * Signal handler for SIGINT and SIGTERM.
+ *
+ * @param[in] aSignal Signal number.
+ */
+extern "C" void requestStop(int aSignal)
+{
+  (void)aSignal;
+  gStopRequested = 1;
+
+  const int savedErrno = errno;
+  const int writeEnd   = gStopPipeWriteEnd;
+  if (writeEnd >= 0)
+  {
+    // The pipe is non-blocking, a full pipe already wakes up the service
+    const char    wakeUp  = 1;
+    const ssize_t written = ::write(writeEnd, &wakeUp, 1);
+    (void)written;
+  }
+  errno = savedErrno;
+}
+
+/**
+ * Send all bytes of a buffer on a connection.
+ *
+ * @param[in] aConnection File descriptor of the connection.
+ * @param[in] aData Data that must be sent.
+ * @param[in] aSize Number of bytes that must be sent.
+ * @retval True If all bytes were sent.
+ * @retval False If the peer closed the connection or sending failed.
+ */
+bool sendAll(const int aConnection, const char* aData, size_t aSize)
+{
+  while (aSize > 0)
+  {
+    const ssize_t sent = ::send(aConnection, aData, aSize, MSG_NOSIGNAL);
+    if (sent < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    if (sent <= 0)
+    {
+      return false;
+    }
+
+    aData += sent;
+    aSize -= static_cast<size_t>(sent);
+  }
+
+  return true;
+}
+
+/**
+ * Send a response line on a connection.
+ *
+ * @param[in] aConnection File descriptor of the connection.
+ * @param[in] aLine Line that must be sent, without newline.
+ * @retval True If the line was sent.
+ * @retval False If sending failed.
+ */
+bool sendLine(const int aConnection, const std::string& aLine)
+{
+  const std::string line = aLine + '\n';
+  return sendAll(aConnection, line.data(), line.size());
+}
+
+/**
+ * Read a request line from a connection. A client that does not send its line in time is dropped,
+ * such that it cannot hold up later jobs, and reading stops as soon as a stop is requested.
+ *
+ * @param[in] aConnection File descriptor of the connection.
+ * @param[in] aStopPipe Read end of the pipe on which the signal handler wakes up the service.
+ * @param[out] aLine Line that has been read, without newline.
+ * @retval True If a complete line was read.
+ * @retval False If the peer closed the connection early or was too slow, the line is too long, a
+ * stop has been requested or reading failed.
+ */
+bool readLine(const int aConnection, const int aStopPipe, std::string& aLine)
+{
+  aLine.clear();
+
+  const auto deadline = std::chrono::steady_clock::now() + Constants::kRequestTimeout;
+  pollfd     waitFor[2];
+  waitFor[0].fd     = aConnection;
+  waitFor[0].events = POLLIN;
+  waitFor[1].fd     = aStopPipe;
+  waitFor[1].events = POLLIN;
+
+  char character = 0;
+  while (aLine.size() < Constants::kMaxRequestLength)
+  {
+    const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+      deadline - std::chrono::steady_clock::now());
+    if (gStopRequested != 0 || remaining.count() <= 0)
+    {
+      return false;
+    }
+
+    waitFor[0].revents = 0;
+    waitFor[1].revents = 0;
+    const int ready    = ::poll(waitFor, 2, static_cast<int>(remaining.count()));
+    if (ready < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    if (ready < 0 || waitFor[1].revents != 0)
+    {
+      return false;
+    }
+    if (ready == 0)
+    {
+      continue;
+    }
+
+    const ssize_t received = ::recv(aConnection, &character, 1, 0);
+    if (received < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    if (received <= 0)
+    {
+      // Accept a last line without newline
+      return !aLine.empty();
+    }
+    if (character == '\n')
+    {
+      return true;
+    }
+
+    aLine += character;
+  }
+
+  return false;
+}
+
+CConversionService::CConversionService(
+  AutoStreamMapConverter::CAutoStreamMapConverter& aMapConverter,
+  const std::string&                               aSocketPath,
+  const std::string&                               aOutputDirectory,
+  const std::string&                               aScratchFileName)
+  : mMapConverter(aMapConverter)
+  , mSocketPath(aSocketPath)
+  , mOutputDirectory(aOutputDirectory)
+  , mScratchFileName(aScratchFileName)
+  , mSocket(-1)
+  , mStopPipe { -1, -1 }
+{
+}
+
+CConversionService::~CConversionService()
+{
+  if (mSocket >= 0)
+  {
+    ::close(mSocket);
+    ::unlink(mSocketPath.c_str());
+  }
+
+  if (mStopPipe[0] >= 0)
+  {
+    gStopPipeWriteEnd = -1;
+    ::close(mStopPipe[0]);
+    ::close(mStopPipe[1]);
+  }
+}
+
+bool CConversionService::run()
+{
+  // Output files named by jobs are checked against the resolved directory
+  if (!mOutputDirectory.empty())
+  {
+    char* outputDirectory = ::realpath(mOutputDirectory.c_str(), nullptr);
+    if (outputDirectory == nullptr)
+    {
+      std::cerr << "Output directory " << mOutputDirectory << " does not exist." << std::endl;
+      return false;
+    }
+    mOutputDirectory = outputDirectory;
+    std::free(outputDirectory);
+  }
+
+  if (!openStopPipe() || !openSocket())
+  {
+    return false;
+  }
+
+  // The stop pipe wakes up waiting for connections, such that interrupted calls can be restarted
+  struct sigaction stopAction;
+  std::memset(&stopAction, 0, sizeof(stopAction));
+  stopAction.sa_handler = requestStop;
+  stopAction.sa_flags   = SA_RESTART;
+  sigemptyset(&stopAction.sa_mask);
+  sigaction(SIGINT, &stopAction, nullptr);
+  sigaction(SIGTERM, &stopAction, nullptr);
+
+  std::cout << "Accepting conversion jobs on " << mSocketPath << std::endl;
+
+  while (gStopRequested == 0)
+  {
+    if (!waitForConnection())
+    {
+      return false;
+    }
+    if (gStopRequested != 0)
+    {
+      break;
+    }
+
+    const int connection = ::accept(mSocket, nullptr, nullptr);
+    if (connection < 0)
+    {
+      // The listening socket is non-blocking, a client may have given up since it was polled
+      if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK || errno == ECONNABORTED)
+      {
+        continue;
+      }
+      std::cerr << "Accepting connection failed: " << std::strerror(errno) << std::endl;
+      return false;
+    }
+
+    const bool keepRunning = handleConnection(connection);
+    ::close(connection);
+    if (!keepRunning)
+    {
+      break;
+    }
+  }
+
+  std::cout << "Conversion service stopped." << std::endl;
+  return true;
+}
+
+bool CConversionService::openSocket()
+{
+  sockaddr_un address;
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (mSocketPath.empty() || mSocketPath.size() >= sizeof(address.sun_path))
+  {
+    std::cerr << "Socket path " << mSocketPath << " is empty or too long." << std::endl;
+    return false;
+  }
+  std::strncpy(address.sun_path, mSocketPath.c_str(), sizeof(address.sun_path) - 1);
+
+  mSocket = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (mSocket < 0)
+  {
+    std::cerr << "Creating socket failed: " << std::strerror(errno) << std::endl;
+    return false;
+  }
+
+  // The socket file takes its permissions from the umask, which is restored right after binding
+  ::unlink(mSocketPath.c_str());
+  const mode_t previousUmask = ::umask(Constants::kSocketUmask);
+  const bool   bound =
+    ::bind(mSocket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+  ::umask(previousUmask);
+  if (!bound || ::listen(mSocket, Constants::kListenBacklog) != 0)
+  {
+    std::cerr << "Listening on " << mSocketPath << " failed: " << std::strerror(errno)
+              << std::endl;
+    ::close(mSocket);
+    mSocket = -1;
+    return false;
+  }
+
+  return true;
+}
+
+bool CConversionService::openStopPipe()
+{
+  if (::pipe2(mStopPipe, O_NONBLOCK | O_CLOEXEC) != 0)
+  {
+    std::cerr << "Creating stop pipe failed: " << std::strerror(errno) << std::endl;
+    mStopPipe[0] = -1;
+    mStopPipe[1] = -1;
+    return false;
+  }
+
+  gStopPipeWriteEnd = mStopPipe[1];
+  return true;
+}
+
+bool CConversionService::waitForConnection()
+{
+  // A signal arriving at any time after the stop pipe was opened leaves a byte in the pipe, such
+  // that polling returns even if the signal arrived before polling started
+  pollfd waitFor[2];
+  waitFor[0].fd     = mSocket;
+  waitFor[0].events = POLLIN;
+  waitFor[1].fd     = mStopPipe[0];
+  waitFor[1].events = POLLIN;
+
+  while (true)
+  {
+    waitFor[0].revents = 0;
+    waitFor[1].revents = 0;
+    if (::poll(waitFor, 2, -1) >= 0)
+    {
+      return true;
+    }
+    if (errno != EINTR)
+    {
+      std::cerr << "Waiting for connections failed: " << std::strerror(errno) << std::endl;
+      return false;
+    }
+  }
+}
+
+bool CConversionService::getOutputFileName(const std::string& aRequestedFileName,
+                                           std::string&       aOutputFileName) const
+{
+  if (mOutputDirectory.empty() || aRequestedFileName.front() == '/')
+  {
+    return false;
+  }
+
+  std::istringstream components(aRequestedFileName);
+  std::string        component;
+  while (std::getline(components, component, '/'))
+  {
+    if (component == "..")
+    {
+      return false;
+    }
+  }
+
+  aOutputFileName = mOutputDirectory + '/' + aRequestedFileName;
+
+  // Symbolic links must not lead out of the output directory, neither the file itself nor any of
+  // the directories it is in
+  struct stat status;
+  if (::lstat(aOutputFileName.c_str(), &status) == 0 && S_ISLNK(status.st_mode))
+  {
+    return false;
+  }
+
+  char* directory = ::realpath(
+    aOutputFileName.substr(0, aOutputFileName.find_last_of('/')).c_str(), nullptr);
+  if (directory == nullptr)
+  {
+    return false;
+  }
+  const std::string resolvedDirectory(directory);
+  std::free(directory);
+
+  return resolvedDirectory == mOutputDirectory
+         || resolvedDirectory.compare(0, mOutputDirectory.size() + 1, mOutputDirectory + '/') == 0;
+}
+
+bool CConversionService::handleConnection(const int aConnection)
+{
+  std::string request;
+  if (!readLine(aConnection, mStopPipe[0], request))
+  {
+    sendLine(aConnection, "ERROR incomplete request");
+    return true;
+  }
+
+  std::istringstream requestStream(request);
+  std::string        command;
+  requestStream >> command;
+
+  if (command == "shutdown")
+  {
+    sendLine(aConnection, "OK");
+    return false;
+  }
+
+  if (command != "convert")
+  {
+    sendLine(aConnection, "ERROR unknown command " + command);
+    return true;
+  }
+
+  double      swLat = 0., swLon = 0., neLat = 0., neLon = 0.;
+  std::string outputFileName;
+  if (!(requestStream >> swLat >> swLon >> neLat >> neLon))
+  {
+    sendLine(aConnection, "ERROR expected four bounding box coordinates");
+    return true;
+  }
+  std::string requestedFileName;
+  if ((requestStream >> requestedFileName)
+      && !getOutputFileName(requestedFileName, outputFileName))
+  {
+    sendLine(aConnection, "ERROR output file not allowed " + requestedFileName);
+    return true;
+  }
+
+  const AutoStream::TBoundingBox boundingBox(
+    AutoStream::TCoordinate::createFromDegrees(swLat, swLon),
+    AutoStream::TCoordinate::createFromDegrees(neLat, neLon));
+  convert(aConnection, boundingBox, outputFileName);
+
+  return true;
+}
+
+void CConversionService::convert(const int                       aConnection,
+                                 const AutoStream::TBoundingBox& aBoundingBox,
+                                 const std::string&              aOutputFileName)
+{
+  const bool streamBack = aOutputFileName.empty();
+  mMapConverter.setOutputFileName(streamBack ? mScratchFileName : aOutputFileName);
+  if (!mMapConverter.storeMap(aBoundingBox))
+  {
+    sendLine(aConnection, "ERROR converting map failed");
+    return;
+  }
+
+  if (!streamBack)
+  {
+    sendLine(aConnection, "OK " + aOutputFileName);
+    return;
+  }
+
+  std::ifstream map(mScratchFileName, std::ios::binary | std::ios::ate);
+  if (!map.is_open())
+  {
+    sendLine(aConnection, "ERROR reading converted map failed");
+    return;
+  }
+
+  const std::streamoff size = map.tellg();
+  map.seekg(0);
+  if (!sendLine(aConnection, "OK " + std::to_string(size)))
+  {
+    return;
+  }
+
+  std::vector<char> chunk(Constants::kStreamChunkSize);
+  while (map.read(chunk.data(), static_cast<std::streamsize>(chunk.size())) || map.gcount() > 0)
+  {
+    if (!sendAll(aConnection, chunk.data(), static_cast<size_t>(map.gcount())))
+    {
+      std::cerr << "Streaming map failed, peer closed the connection." << std::endl;
+      return;
+    }
+  }
+}
+}
+}
@@ -14,6 +14,7 @@
 #include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <map>
 #include <sstream>
 
 namespace TomTom {
@@ -23,17 +24,17 @@ const char kCommentSymbol   = '#';
 const char kDelimiterSymbol = ':';
 
 /**
- * Function for reading a named parameter as a string from a given file. The file is assumed
+ * Function for looking up a named parameter as a string in a given file. The file is assumed
  * to follow a yaml-like format where a parameter name is followed by ':' and a value.
  *
  * @param[in] aFilename File from which the parameter must be read.
  * @param[in] aName Name of the parameter.
- * @param[out] aValue Value of the parameter.
+ * @param[out] aValue Value of the parameter, unchanged if the parameter is not defined.
  *
- * @retval true If getting parameter succeeded.
- * @retval false If getting parameter failed.
+ * @retval true If the parameter was found.
+ * @retval false If the parameter was not found.
  */
-bool getNamedParameter(const std::string& aFilename, const std::string& aName, std::string& aValue)
+bool findNamedParameter(const std::string& aFilename, const std::string& aName, std::string& aValue)
 {
   std::ifstream file(aFilename);
   if (file.is_open())
@@ -65,11 +66,112 @@ bool getNamedParameter(const std::string& aFilename, const std::string& aName, s
     std::cerr << "Couldn't open config file for reading.\n";
   }
 
+  return false;
+}
+
+/**
+ * Function for reading a mandatory named parameter as a string from a given file.
+ *
+ * @param[in] aFilename File from which the parameter must be read.
+ * @param[in] aName Name of the parameter.
+ * @param[out] aValue Value of the parameter.
+ *
+ * @retval true If getting parameter succeeded.
+ * @retval false If getting parameter failed.
+ */
+bool getNamedParameter(const std::string& aFilename, const std::string& aName, std::string& aValue)
+{
+  if (findNamedParameter(aFilename, aName, aValue))
+  {
+    return true;
+  }
+
   std::cerr << "Parameter " << aName << " not defined!" << std::endl;
 
   return false;
 }
 
+/**
+ * Function for reading an optional named parameter as a string from a given file. The given value
+ * is kept as default if the parameter is not defined.
+ *
+ * @param[in] aFilename File from which the parameter must be read.
+ * @param[in] aName Name of the parameter.
+ * @param[in, out] aValue Default value on input, value of the parameter on output.
+ */
+void getOptionalNamedParameter(const std::string& aFilename,
+                               const std::string& aName,
+                               std::string&       aValue)
+{
+  findNamedParameter(aFilename, aName, aValue);
+}
+
+/**
+ * Parse a comma separated list of synthetic lane border markings.
+ *
+ * @param[in] aNames Names of the markings, e.g. "long_dashed,double".
+ * @param[out] aMarkings Parsed markings.
+ *
+ * @retval true If all names are known.
+ * @retval false If a name is unknown.
+ */
+bool parseSyntheticBorderMarkings(
+  const std::string&                                            aNames,
+  std::vector<AutoStreamMapConverter::TSyntheticBorderMarking>& aMarkings)
+{
+  using AutoStreamMapConverter::TSyntheticBorderMarking;
+  static const std::map<std::string, TSyntheticBorderMarking> kMarkings = {
+    { "long_dashed", TSyntheticBorderMarking::LongDashedLine },
+    { "short_dashed", TSyntheticBorderMarking::ShortDashedLine },
+    { "solid", TSyntheticBorderMarking::SolidLine },
+    { "double", TSyntheticBorderMarking::DoubleLine },
+    { "none", TSyntheticBorderMarking::NoMarking },
+    { "curb", TSyntheticBorderMarking::Curb },
+    { "guardrail", TSyntheticBorderMarking::Guardrail },
+    { "fence", TSyntheticBorderMarking::Fence }
+  };
+
+  aMarkings.clear();
+  std::istringstream names(aNames);
+  std::string        name;
+  while (std::getline(names, name, ','))
+  {
+    const auto marking = kMarkings.find(name);
+    if (marking == kMarkings.end())
+    {
+      std::cerr << "Unknown synthetic lane border marking " << name << std::endl;
+      return false;
+    }
+    aMarkings.push_back(marking->second);
+  }
+
+  return true;
+}
+
+/**
+ * Parse a single synthetic lane border marking.
+ *
+ * @param[in] aName Name of the marking, e.g. "curb".
+ * @param[out] aMarking Parsed marking.
+ *
+ * @retval true If the name is known.
+ * @retval false If the name is unknown or more than one marking is given.
+ */
+bool parseSyntheticBorderMarking(const std::string&                               aName,
+                                 AutoStreamMapConverter::TSyntheticBorderMarking& aMarking)
+{
+  std::vector<AutoStreamMapConverter::TSyntheticBorderMarking> markings;
+  if (!parseSyntheticBorderMarkings(aName, markings) || markings.size() != 1)
+  {
+    std::cerr << "Expected a single synthetic lane border marking instead of " << aName
+              << std::endl;
+    return false;
+  }
+
+  aMarking = markings.front();
+  return true;
+}
+
 /**
  * Get the content of a file and store it into a single string.
  *
@@ -120,18 +222,135 @@ bool getParametersFromConfigurationFile(const std::string&        aFilePath,
   std::string numConnections;
   allParams = getNamedParameter(aFilePath, "numberOfConnections", numConnections) && allParams;
 
-  std::string swLatString, swLonString, neLatString, neLonString;
-  allParams = getNamedParameter(aFilePath, "southWestLat", swLatString) && allParams;
-  allParams = getNamedParameter(aFilePath, "southWestLon", swLonString) && allParams;
-  allParams = getNamedParameter(aFilePath, "northEastLat", neLatString) && allParams;
-  allParams = getNamedParameter(aFilePath, "northEastLon", neLonString) && allParams;
+  std::string mode = "convert";
+  getOptionalNamedParameter(aFilePath, "mode", mode);
+  if (mode == "convert")
+  {
+    aConfig.mMode = TApplicationMode::Convert;
+  }
+  else if (mode == "serve")
+  {
+    aConfig.mMode = TApplicationMode::Serve;
+  }
+  else if (mode == "warmup")
+  {
+    aConfig.mMode = TApplicationMode::WarmUp;
+  }
+  else if (mode == "batch")
+  {
+    aConfig.mMode = TApplicationMode::Batch;
+  }
+  else
+  {
+    std::cerr << "Unknown mode " << mode << " in configuration file" << std::endl;
+    return false;
+  }
+
+  // A route replaces the bounding box when converting, it is mandatory when warming up
+  std::string routeFile, routeBufferWidth = "50";
+  getOptionalNamedParameter(aFilePath, "routeFile", routeFile);
+  getOptionalNamedParameter(aFilePath, "routeBufferWidth", routeBufferWidth);
+  if (aConfig.mMode == TApplicationMode::WarmUp && routeFile.empty())
+  {
+    allParams = getNamedParameter(aFilePath, "routeFile", routeFile) && allParams;
+  }
+
+  // A synthetic map replaces AutoStream, its whole area is converted by default
+  std::string syntheticArcs = "0", syntheticLanes = "3", syntheticTrafficSignsPerKm = "4";
+  getOptionalNamedParameter(aFilePath, "syntheticArcs", syntheticArcs);
+  getOptionalNamedParameter(aFilePath, "syntheticLanes", syntheticLanes);
+  getOptionalNamedParameter(aFilePath, "syntheticTrafficSignsPerKm", syntheticTrafficSignsPerKm);
+  std::string syntheticRightBorder = "curb", syntheticLeftBorder = "guardrail";
+  std::string syntheticInnerBorders          = "long_dashed,short_dashed,double";
+  std::string syntheticConnectionGapInterval = "0", syntheticTwoWayRoadInterval = "0";
+  getOptionalNamedParameter(aFilePath, "syntheticRightBorder", syntheticRightBorder);
+  getOptionalNamedParameter(aFilePath, "syntheticLeftBorder", syntheticLeftBorder);
+  getOptionalNamedParameter(aFilePath, "syntheticInnerBorders", syntheticInnerBorders);
+  getOptionalNamedParameter(
+    aFilePath, "syntheticConnectionGapInterval", syntheticConnectionGapInterval);
+  getOptionalNamedParameter(aFilePath, "syntheticTwoWayRoadInterval", syntheticTwoWayRoadInterval);
+  const bool synthetic = std::stoul(syntheticArcs) > 0;
+
+  // The bounding box is given per job in serve mode
+  std::string swLatString = "0", swLonString = "0", neLatString = "0", neLonString = "0";
+  if (aConfig.mMode == TApplicationMode::Convert && routeFile.empty() && !synthetic)
+  {
+    allParams = getNamedParameter(aFilePath, "southWestLat", swLatString) && allParams;
+    allParams = getNamedParameter(aFilePath, "southWestLon", swLonString) && allParams;
+    allParams = getNamedParameter(aFilePath, "northEastLat", neLatString) && allParams;
+    allParams = getNamedParameter(aFilePath, "northEastLon", neLonString) && allParams;
+  }
+
+  // Bounding boxes and output files are given by the manifest in batch mode
+  std::string batchManifest;
+  if (aConfig.mMode == TApplicationMode::Batch)
+  {
+    allParams = getNamedParameter(aFilePath, "batchManifest", batchManifest) && allParams;
+  }
+
+  std::string serviceSocket, serviceOutputDirectory;
+  if (aConfig.mMode == TApplicationMode::Serve)
+  {
+    allParams = getNamedParameter(aFilePath, "serviceSocket", serviceSocket) && allParams;
+    getOptionalNamedParameter(aFilePath, "serviceOutputDirectory", serviceOutputDirectory);
+  }
 
   std::string trustedRootCertificateFile;
   allParams = getNamedParameter(aFilePath, "trustedRootCertificateFile", trustedRootCertificateFile)
               && allParams;
 
+  // Nothing is written when warming up the tile cache
   std::string outputFile;
-  allParams = getNamedParameter(aFilePath, "outputFile", outputFile) && allParams;
+  if (aConfig.mMode != TApplicationMode::WarmUp && aConfig.mMode != TApplicationMode::Batch)
+  {
+    allParams = getNamedParameter(aFilePath, "outputFile", outputFile) && allParams;
+  }
+
+  // Optional parameters
+  std::string numWorkerThreads = "1";
+  getOptionalNamedParameter(aFilePath, "numberOfWorkerThreads", numWorkerThreads);
+
+  std::string prefetchDepth = "0";
+  getOptionalNamedParameter(aFilePath, "prefetchDepth", prefetchDepth);
+
+  std::string tileGridRows = "1", tileGridColumns = "1";
+  getOptionalNamedParameter(aFilePath, "tileGridRows", tileGridRows);
+  getOptionalNamedParameter(aFilePath, "tileGridColumns", tileGridColumns);
+
+  std::string incrementalCacheFile;
+  getOptionalNamedParameter(aFilePath, "incrementalCacheFile", incrementalCacheFile);
+
+  std::string recordFile, replayFile;
+  getOptionalNamedParameter(aFilePath, "recordFile", recordFile);
+  getOptionalNamedParameter(aFilePath, "replayFile", replayFile);
+
+  std::string conversionReport = "false";
+  getOptionalNamedParameter(aFilePath, "conversionReport", conversionReport);
+
+  std::string routingGraph = "false";
+  getOptionalNamedParameter(aFilePath, "routingGraph", routingGraph);
+
+  std::string traceFile;
+  getOptionalNamedParameter(aFilePath, "traceFile", traceFile);
+
+  std::string deltaBaseFile;
+  getOptionalNamedParameter(aFilePath, "deltaBaseFile", deltaBaseFile);
+
+  std::string outputFormat = "osm";
+  getOptionalNamedParameter(aFilePath, "outputFormat", outputFormat);
+  if (outputFormat == "osm")
+  {
+    aConfig.mOutputFormat = AutoStreamMapConverter::TMapFileFormat::Osm;
+  }
+  else if (outputFormat == "binary")
+  {
+    aConfig.mOutputFormat = AutoStreamMapConverter::TMapFileFormat::Binary;
+  }
+  else
+  {
+    std::cerr << "Unknown output format " << outputFormat << " in configuration file" << std::endl;
+    return false;
+  }
 
   // Check if all parameters were found
   if (!allParams)
@@ -156,9 +375,73 @@ bool getParametersFromConfigurationFile(const std::string&        aFilePath,
   // Name of output file
   aConfig.mOutputFileName = outputFile;
 
+  // Socket on which conversion jobs are accepted in serve mode, and the directory within which jobs
+  // may name output files
+  aConfig.mServiceSocket          = serviceSocket;
+  aConfig.mServiceOutputDirectory = serviceOutputDirectory;
+
+  // Route along which the tile cache is warmed up or the map is converted
+  aConfig.mRouteBufferWidth = std::stod(routeBufferWidth);
+  if (!routeFile.empty() && (!readRouteFile(routeFile, aConfig.mRoute) || aConfig.mRoute.empty()))
+  {
+    std::cerr << "Failed to read route file or route is empty" << std::endl;
+    return false;
+  }
+
+  // Jobs converted in batch mode
+  if (!batchManifest.empty()
+      && (!readBatchManifest(batchManifest, aConfig.mBatchJobs) || aConfig.mBatchJobs.empty()))
+  {
+    std::cerr << "Failed to read batch manifest or manifest is empty" << std::endl;
+    return false;
+  }
+
+  // Name of the arc cache file used for incremental conversion, empty if disabled
+  aConfig.mIncrementalCacheFileName = incrementalCacheFile;
+
+  // Names of the files to which map data is recorded or from which it is replayed, empty if unused
+  aConfig.mRecordFileName = recordFile;
+  aConfig.mReplayFileName = replayFile;
+
+  // Write timings and counters of each conversion next to the output file
+  aConfig.mConversionReport = conversionReport == "true";
+
+  // Write the routing graph of each converted map next to the output file
+  aConfig.mRoutingGraph = routingGraph == "true";
+
+  // Name of the file to which conversion spans are traced, empty if disabled
+  aConfig.mTraceFileName = traceFile;
+
+  // Name of the previous map against which a change set is written, empty if disabled
+  aConfig.mDeltaBaseFileName = deltaBaseFile;
+
+  // Set synthetic map
+  aConfig.mSyntheticMap.mNumberOfArcs             = std::stoul(syntheticArcs);
+  aConfig.mSyntheticMap.mNumberOfLanes            = std::stoul(syntheticLanes);
+  aConfig.mSyntheticMap.mTrafficSignsPerKilometer = std::stod(syntheticTrafficSignsPerKm);
+  aConfig.mSyntheticMap.mConnectionGapInterval    = std::stoul(syntheticConnectionGapInterval);
+  aConfig.mSyntheticMap.mTwoWayRoadInterval       = std::stoul(syntheticTwoWayRoadInterval);
+  if (!parseSyntheticBorderMarking(syntheticRightBorder, aConfig.mSyntheticMap.mRightBorder)
+      || !parseSyntheticBorderMarking(syntheticLeftBorder, aConfig.mSyntheticMap.mLeftBorder)
+      || !parseSyntheticBorderMarkings(syntheticInnerBorders, aConfig.mSyntheticMap.mInnerBorders))
+  {
+    std::cerr << "Invalid synthetic lane borders in configuration file" << std::endl;
+    return false;
+  }
+
   // Set number of connections
   aConfig.mParams.mNumConnections = std::stoul(numConnections);
 
+  // Set number of threads used for converting arcs
+  aConfig.mNumberOfWorkerThreads = std::stoul(numWorkerThreads);
+
+  // Set number of arcs fetched ahead of conversion
+  aConfig.mPrefetchDepth = std::stoul(prefetchDepth);
+
+  // Set grid in which the bounding box is split into tiles
+  aConfig.mTileGridRows    = std::stoul(tileGridRows);
+  aConfig.mTileGridColumns = std::stoul(tileGridColumns);
+
   // Set certificate by reading it from file
   std::string certificate;
   if (!getFileContent(trustedRootCertificateFile, certificate))
@@ -171,5 +454,96 @@ bool getParametersFromConfigurationFile(const std::string&        aFilePath,
 
   return true;
 }
+
+bool readRouteFile(const std::string& aFilePath, std::vector<AutoStream::TCoordinate>& aRoute)
+{
+  std::ifstream file(aFilePath);
+  if (!file.is_open())
+  {
+    std::cerr << "Could not open file " << aFilePath << std::endl;
+    return false;
+  }
+
+  aRoute.clear();
+  std::string line;
+  size_t      lineNumber = 0;
+  while (getline(file, line))
+  {
+    ++lineNumber;
+    std::replace(line.begin(), line.end(), ',', ' ');
+
+    std::istringstream lineStream(line);
+    std::string        firstWord;
+    if (!(lineStream >> firstWord) || firstWord[0] == kCommentSymbol)
+    {
+      continue;
+    }
+
+    double lat = 0., lon = 0.;
+    lineStream.str(line);
+    lineStream.clear();
+    if (!(lineStream >> lat >> lon))
+    {
+      std::cerr << "Invalid route point on line " << lineNumber << " of " << aFilePath
+                << std::endl;
+      return false;
+    }
+
+    aRoute.push_back(AutoStream::TCoordinate::createFromDegrees(lat, lon));
+  }
+
+  return true;
+}
+
+bool readBatchManifest(const std::string&                                        aFilePath,
+                       std::vector<AutoStreamMapConverter::CAutoStreamBatchJob>& aJobs)
+{
+  std::ifstream file(aFilePath);
+  if (!file.is_open())
+  {
+    std::cerr << "Could not open file " << aFilePath << std::endl;
+    return false;
+  }
+
+  aJobs.clear();
+  std::string line;
+  size_t      lineNumber = 0;
+  while (getline(file, line))
+  {
+    ++lineNumber;
+
+    std::istringstream lineStream(line);
+    std::string        firstWord;
+    if (!(lineStream >> firstWord) || firstWord[0] == kCommentSymbol)
+    {
+      continue;
+    }
+
+    double      swLat = 0., swLon = 0., neLat = 0., neLon = 0.;
+    std::string outputFile;
+    lineStream.str(line);
+    lineStream.clear();
+    if (!(lineStream >> swLat >> swLon >> neLat >> neLon >> outputFile))
+    {
+      std::cerr << "Invalid batch job on line " << lineNumber << " of " << aFilePath << std::endl;
+      return false;
+    }
+
+    AutoStreamMapConverter::CAutoStreamBatchJob job;
+    job.mBoundingBox =
+      AutoStream::TBoundingBox(AutoStream::TCoordinate::createFromDegrees(swLat, swLon),
+                               AutoStream::TCoordinate::createFromDegrees(neLat, neLon));
+    job.mOutputFileName = outputFile;
+    aJobs.push_back(job);
+  }
+
+  return true;
+}
+
+uint64_t getFileSize(const std::string& aFilePath)
+{
+  std::ifstream file(aFilePath, std::ios::binary | std::ios::ate);
+  return file.is_open() ? static_cast<uint64_t>(file.tellg()) : 0;
+}
 }
 }
\ No newline at end of file
@@ -0,0 +1,123 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#include "AutoStreamMapConverter/MapDelta.hpp"
+
+#include <iostream>
+#include <string>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+
+/**
+ * Write the change set between two converted maps.
+ *
+ * @param[in] aPreviousFileName Name of the previous map.
+ * @param[in] aCurrentFileName Name of the current map.
+ * @param[in] aDeltaFileName Name of the file to which the change set must be written.
+ * @retval True If the change set was written.
+ * @retval False If reading a map or writing the change set failed.
+ */
+bool storeMapDelta(const std::string& aPreviousFileName,
+                   const std::string& aCurrentFileName,
+                   const std::string& aDeltaFileName)
+{
+  AutoStreamMapConverter::COsmDocument previousMap, currentMap;
+  if (!previousMap.load(aPreviousFileName) || !currentMap.load(aCurrentFileName))
+  {
+    std::cerr << "Reading maps " << aPreviousFileName << " and " << aCurrentFileName << " failed."
+              << std::endl;
+    return false;
+  }
+
+  AutoStreamMapConverter::CMapDelta delta;
+  delta.compute(previousMap, currentMap);
+  if (!delta.store(aDeltaFileName))
+  {
+    std::cerr << "Storing change set " << aDeltaFileName << " failed." << std::endl;
+    return false;
+  }
+
+  std::cout << "Stored change set with ";
+  delta.printStatistics(std::cout);
+  std::cout << "." << std::endl;
+
+  return true;
+}
+
+/**
+ * Apply a change set to a converted map.
+ *
+ * @param[in] aMapFileName Name of the map to which the change set is applied.
+ * @param[in] aDeltaFileName Name of the change set.
+ * @param[in] aOutputFileName Name of the file to which the resulting map must be written, may be
+ * the map itself.
+ * @retval True If the resulting map was written.
+ * @retval False If reading, applying or writing failed.
+ */
+bool applyMapDelta(const std::string& aMapFileName,
+                   const std::string& aDeltaFileName,
+                   const std::string& aOutputFileName)
+{
+  AutoStreamMapConverter::COsmDocument map;
+  if (!map.load(aMapFileName))
+  {
+    std::cerr << "Reading map " << aMapFileName << " failed." << std::endl;
+    return false;
+  }
+
+  AutoStreamMapConverter::CMapDelta delta;
+  if (!delta.load(aDeltaFileName))
+  {
+    std::cerr << "Reading change set " << aDeltaFileName << " failed." << std::endl;
+    return false;
+  }
+
+  if (!delta.apply(map, aOutputFileName))
+  {
+    std::cerr << "Applying change set " << aDeltaFileName << " to " << aMapFileName << " failed."
+              << std::endl;
+    return false;
+  }
+
+  std::cout << "Applied change set with "
+            << delta.getNumberOfElements(AutoStreamMapConverter::TOsmChangeAction::Create)
+            << " created, "
+            << delta.getNumberOfElements(AutoStreamMapConverter::TOsmChangeAction::Modify)
+            << " modified and "
+            << delta.getNumberOfElements(AutoStreamMapConverter::TOsmChangeAction::Delete)
+            << " deleted elements." << std::endl;
+
+  return true;
+}
+}
+}
+
+int main(int argc, char* argv[])
+{
+  using namespace TomTom::AutoStreamForAutoware;
+
+  const std::string command = argc == 5 ? argv[1] : "";
+  if (command == "diff")
+  {
+    return storeMapDelta(argv[2], argv[3], argv[4]) ? 0 : 1;
+  }
+
+  if (command == "apply")
+  {
+    return applyMapDelta(argv[2], argv[3], argv[4]) ? 0 : 1;
+  }
+
+  std::cerr << "Usage: " << argv[0] << " diff <previous-map.osm> <current-map.osm> <changes.osc>\n"
+            << "       " << argv[0] << " apply <map.osm> <changes.osc> <output-map.osm>"
+            << std::endl;
+  return 1;
+}
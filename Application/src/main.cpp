@@ -9,11 +9,66 @@
  * immediately return or destroy it.
  */
 
+#include "Application/ConversionService.hpp"
 #include "Application/Helpers.hpp"
 
 #include "AutoStreamMapConverter/MapConverter.hpp"
+#include "AutoStreamMapConverter/RouteCorridor.hpp"
+#include "AutoStreamMapConverter/SyntheticMapSource.hpp"
 
 #include <iostream>
+#include <memory>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+
+/**
+ * Get the size of the persistent tile cache, including the SQLite write-ahead log.
+ *
+ * @param[in] aConfig Configuration containing the tile cache path.
+ * @retval uint64_t Size of the tile cache in bytes.
+ */
+uint64_t getTileCacheSize(const CConfigurationParameters& aConfig)
+{
+  const std::string& tileCachePath = aConfig.mParams.mPersistentTileCachePath;
+  return getFileSize(tileCachePath) + getFileSize(tileCachePath + "-wal");
+}
+
+/**
+ * Retrieve all map data in the corridor around the configured route into the persistent tile
+ * cache and report what has been retrieved.
+ *
+ * @param[in] aMapConverter Map converter of which AutoStream has been initialized.
+ * @param[in] aConfig Configuration containing the route and buffer width.
+ * @retval True If warming up succeeded.
+ * @retval False If retrieving map data failed.
+ */
+bool warmUpTileCache(AutoStreamMapConverter::CAutoStreamMapConverter& aMapConverter,
+                     const CConfigurationParameters&                  aConfig)
+{
+  const AutoStreamMapConverter::CRouteCorridor corridor(aConfig.mRoute, aConfig.mRouteBufferWidth);
+  const uint64_t tileCacheSizeBefore = getTileCacheSize(aConfig);
+
+  AutoStreamMapConverter::CTileCacheWarmUpStatistics statistics;
+  if (!aMapConverter.warmUpTileCache(corridor.getBoundingBoxes(), statistics))
+  {
+    return false;
+  }
+
+  // Tiles are not exposed by AutoStream, the growth of the tile cache shows what was fetched
+  const uint64_t tileCacheSizeAfter = getTileCacheSize(aConfig);
+  std::cout << "Warmed up tile cache along route of " << aConfig.mRoute.size() << " points: "
+            << statistics.mNumberOfAreas << " areas, " << statistics.mNumberOfArcs << " arcs, "
+            << statistics.mNumberOfTrafficSigns << " traffic signs, "
+            << (tileCacheSizeAfter > tileCacheSizeBefore ? tileCacheSizeAfter - tileCacheSizeBefore
+                                                         : 0)
+            << " bytes added to the tile cache (" << tileCacheSizeAfter << " bytes in total)."
+            << std::endl;
+
+  return true;
+}
+}
+}
 
 int main(int argc, char* argv[])
 {
@@ -34,14 +89,91 @@ int main(int argc, char* argv[])
   }
 
   AutoStreamMapConverter::CAutoStreamMapConverter mapConverter;
-  if (!mapConverter.initializeAutoStream(config.mParams))
+  const bool synthetic = config.mSyntheticMap.mNumberOfArcs > 0;
+  if (synthetic)
+  {
+    mapConverter.setMapSourceFactory([&config]() {
+      return std::make_unique<AutoStreamMapConverter::CAutoStreamSyntheticMapSource>(
+        config.mSyntheticMap);
+    });
+  }
+
+  // Replayed and synthetic conversions are served without connecting to AutoStream
+  const bool initialized = !config.mReplayFileName.empty() || synthetic
+                           || mapConverter.initializeAutoStream(config.mParams);
+  if (!initialized)
   {
     std::cerr << "Failed to initialize AutoStream." << std::endl;
   }
 
   // Create map
   mapConverter.setOutputFileName(config.mOutputFileName);
-  if (!mapConverter.storeMap(config.mBoundingBox))
+  mapConverter.setOutputFormat(config.mOutputFormat);
+  mapConverter.setNumberOfWorkers(config.mNumberOfWorkerThreads);
+  mapConverter.setPrefetchDepth(config.mPrefetchDepth);
+  mapConverter.setTileGrid(config.mTileGridRows, config.mTileGridColumns);
+  mapConverter.setArcCacheFileName(config.mIncrementalCacheFileName);
+  mapConverter.setRecordingFileName(config.mRecordFileName);
+  mapConverter.setReplayFileName(config.mReplayFileName);
+  mapConverter.setReportEnabled(config.mConversionReport);
+  mapConverter.setRoutingGraphEnabled(config.mRoutingGraph);
+  mapConverter.setTraceFileName(config.mTraceFileName);
+  mapConverter.setDeltaBaseFileName(config.mDeltaBaseFileName);
+
+  if (config.mMode == TApplicationMode::Serve)
+  {
+    // AutoStream stays initialized between jobs, a service without it is of no use
+    if (!initialized)
+    {
+      return 1;
+    }
+
+    CConversionService service(mapConverter,
+                               config.mServiceSocket,
+                               config.mServiceOutputDirectory,
+                               config.mOutputFileName);
+    return service.run() ? 0 : 1;
+  }
+
+  if (config.mMode == TApplicationMode::WarmUp)
+  {
+    if (!initialized || !warmUpTileCache(mapConverter, config))
+    {
+      std::cerr << "Warming up tile cache along route failed." << std::endl;
+      return 1;
+    }
+
+    return 0;
+  }
+
+  if (config.mMode == TApplicationMode::Batch)
+  {
+    if (!mapConverter.storeMaps(config.mBatchJobs))
+    {
+      std::cerr << "Converting maps of batch manifest failed." << std::endl;
+      return 1;
+    }
+
+    return 0;
+  }
+
+  if (!config.mRoute.empty())
+  {
+    if (!mapConverter.storeMap(config.mRoute, config.mRouteBufferWidth))
+    {
+      std::cerr << "Converting map along given route failed." << std::endl;
+      return 1;
+    }
+
+    return 0;
+  }
+
+  // Without a route, the whole synthetic map is converted
+  const TomTom::AutoStream::TBoundingBox boundingBox =
+    synthetic
+      ? AutoStreamMapConverter::CAutoStreamSyntheticMapSource(config.mSyntheticMap).getBoundingBox()
+      : config.mBoundingBox;
+  if (!mapConverter.storeMap(boundingBox))
   {
     std::cerr << "Converting map for given bounding box failed." << std::endl;
     return 1;
@@ -0,0 +1,340 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#include "AutoStreamMapConverter/ConversionHelpers.hpp"
+#include "AutoStreamMapConverter/SyntheticMapSource.hpp"
+#include "AutoStreamMapConverter/UtmBatchProjector.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+// Number of heap allocations made by the benchmark process, counted by the replaced operator new
+std::atomic<size_t> gNumberOfAllocations(0);
+
+void* operator new(std::size_t aSize)
+{
+  gNumberOfAllocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* memory = std::malloc(aSize > 0 ? aSize : 1))
+  {
+    return memory;
+  }
+
+  throw std::bad_alloc();
+}
+
+void operator delete(void* aMemory) noexcept
+{
+  std::free(aMemory);
+}
+
+void operator delete(void* aMemory, std::size_t /*aSize*/) noexcept
+{
+  std::free(aMemory);
+}
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+namespace Constants {
+// Synthetic arcs from which the benchmark inputs are taken. Every fifth arc has a parking area and
+// a triangular lane opens and closes every five arcs, such that all border and lane types occur.
+constexpr size_t   kBenchmarkArcs          = 10;
+constexpr size_t   kBenchmarkInterval      = 5;
+constexpr uint32_t kDefaultPointsPerBorder = 11;
+
+// First ID of converted primitives, every iteration starts anew such that the range cannot run out
+constexpr lanelet::Id kBenchmarkFirstId = lanelet::Id(1) << 20;
+
+// Distance and heading used for moving coordinates, as done for traffic sign corners
+constexpr double kMoveDistanceMeter = 0.3;
+constexpr double kMoveHeadingDeg    = 45.0;
+}
+
+/**
+ * Generate the synthetic arcs from which benchmark inputs are taken.
+ *
+ * @param[in] aPointsPerBorder Number of points of each lane border line.
+ * @retval std::vector<CAutoStreamArcData> Data of the arcs.
+ */
+std::vector<CAutoStreamArcData> getBenchmarkArcs(const uint32_t aPointsPerBorder)
+{
+  CSyntheticMapParameters parameters;
+  parameters.mNumberOfArcs           = Constants::kBenchmarkArcs;
+  parameters.mArcsPerRoad            = Constants::kBenchmarkArcs;
+  parameters.mPointsPerBorder        = aPointsPerBorder;
+  parameters.mParkingAreaInterval    = Constants::kBenchmarkInterval;
+  parameters.mTriangularLaneInterval = Constants::kBenchmarkInterval;
+
+  CAutoStreamSyntheticMapSource   mapSource(parameters);
+  std::vector<CAutoStreamArcData> arcs;
+  for (const auto& key : mapSource.getArcKeysInArea(mapSource.getBoundingBox()))
+  {
+    arcs.push_back(mapSource.getArc(key));
+  }
+
+  return arcs;
+}
+
+/**
+ * Collect the lane borders of all benchmark arcs.
+ *
+ * @param[in] aPointsPerBorder Number of points of each lane border line.
+ * @retval std::vector<CAutoStreamLaneBorder> Lane borders.
+ */
+std::vector<CAutoStreamLaneBorder> getBenchmarkLaneBorders(const uint32_t aPointsPerBorder)
+{
+  std::vector<CAutoStreamLaneBorder> laneBorders;
+  for (const CAutoStreamArcData& arc : getBenchmarkArcs(aPointsPerBorder))
+  {
+    laneBorders.insert(laneBorders.end(), arc.mLaneBorders.begin(), arc.mLaneBorders.end());
+  }
+
+  return laneBorders;
+}
+
+/**
+ * Collect the lane types of all benchmark arcs.
+ *
+ * @retval std::vector<AutoStream::HdMap::HdRoad::TLaneType> Lane types.
+ */
+std::vector<AutoStream::HdMap::HdRoad::TLaneType> getBenchmarkLaneTypes()
+{
+  std::vector<AutoStream::HdMap::HdRoad::TLaneType> laneTypes;
+  for (const CAutoStreamArcData& arc : getBenchmarkArcs(Constants::kDefaultPointsPerBorder))
+  {
+    for (const CAutoStreamLaneMetaData& metaData : arc.mLaneMetaData)
+    {
+      laneTypes.push_back(metaData.mType);
+    }
+  }
+
+  return laneTypes;
+}
+
+/**
+ * Create the UTM projector used by conversions of the benchmark arcs.
+ *
+ * @retval lanelet::projection::UtmProjector UTM projector with the origin of the synthetic map.
+ */
+lanelet::projection::UtmProjector createBenchmarkUtmProjector()
+{
+  const CSyntheticMapParameters parameters;
+  return lanelet::projection::UtmProjector(
+    lanelet::Origin({ parameters.mOriginLatDeg, parameters.mOriginLonDeg }));
+}
+
+/**
+ * Report the average number of heap allocations per iteration of a benchmark.
+ *
+ * @param[in] aNumberOfAllocationsBefore Number of allocations before the benchmark loop.
+ * @param[in, out] aState Benchmark state to which the counter must be added.
+ */
+void reportAllocations(const size_t aNumberOfAllocationsBefore, benchmark::State& aState)
+{
+  const double numberOfAllocations =
+    static_cast<double>(gNumberOfAllocations.load() - aNumberOfAllocationsBefore);
+  aState.counters["allocs/op"] =
+    benchmark::Counter(numberOfAllocations, benchmark::Counter::kAvgIterations);
+}
+
+/**
+ * Measure projecting a single lane border point to UTM.
+ *
+ * @param[in, out] aState Benchmark state.
+ */
+void benchmarkToUtm(benchmark::State& aState)
+{
+  const auto laneBorders  = getBenchmarkLaneBorders(Constants::kDefaultPointsPerBorder);
+  const auto utmProjector = createBenchmarkUtmProjector();
+  const std::vector<AutoStream::TCoordinate3D>& points = laneBorders.front().mComponents[0].mLine;
+
+  size_t       pointIdx = 0;
+  const size_t before   = gNumberOfAllocations.load();
+  for (auto _ : aState)
+  {
+    CIdAllocator idAllocator(Constants::kBenchmarkFirstId);
+    benchmark::DoNotOptimize(toUtm(points[pointIdx], utmProjector, idAllocator));
+    pointIdx = (pointIdx + 1) % points.size();
+  }
+  reportAllocations(before, aState);
+}
+
+/**
+ * Measure converting a lane border line, the number of points per line is the benchmark argument.
+ *
+ * @param[in, out] aState Benchmark state.
+ */
+void benchmarkConvertLine(benchmark::State& aState)
+{
+  const auto laneBorders  = getBenchmarkLaneBorders(static_cast<uint32_t>(aState.range(0)));
+  const auto utmProjector = createBenchmarkUtmProjector();
+  const CUtmBatchProjector batchProjector(utmProjector);
+
+  size_t       borderIdx = 0;
+  const size_t before    = gNumberOfAllocations.load();
+  for (auto _ : aState)
+  {
+    CIdAllocator idAllocator(Constants::kBenchmarkFirstId);
+    benchmark::DoNotOptimize(
+      convertLine(laneBorders[borderIdx].mComponents[0].mLine, batchProjector, idAllocator));
+    borderIdx = (borderIdx + 1) % laneBorders.size();
+  }
+  reportAllocations(before, aState);
+  aState.SetItemsProcessed(aState.iterations() * aState.range(0));
+}
+
+/**
+ * Measure converting a lane border including its type and attributes, the number of points per
+ * line is the benchmark argument.
+ *
+ * @param[in, out] aState Benchmark state.
+ */
+void benchmarkConvertLaneBorder(benchmark::State& aState)
+{
+  const auto laneBorders  = getBenchmarkLaneBorders(static_cast<uint32_t>(aState.range(0)));
+  const auto utmProjector = createBenchmarkUtmProjector();
+  const CUtmBatchProjector batchProjector(utmProjector);
+
+  size_t       borderIdx = 0;
+  const size_t before    = gNumberOfAllocations.load();
+  for (auto _ : aState)
+  {
+    CIdAllocator idAllocator(Constants::kBenchmarkFirstId);
+    benchmark::DoNotOptimize(
+      convertLaneBorder(laneBorders[borderIdx], batchProjector, idAllocator));
+    borderIdx = (borderIdx + 1) % laneBorders.size();
+  }
+  reportAllocations(before, aState);
+  aState.SetItemsProcessed(aState.iterations() * aState.range(0));
+}
+
+/**
+ * Measure setting the type and subtype of a converted lane border.
+ *
+ * @param[in, out] aState Benchmark state.
+ */
+void benchmarkSetTypeAndSubtype(benchmark::State& aState)
+{
+  const auto laneBorders  = getBenchmarkLaneBorders(Constants::kDefaultPointsPerBorder);
+  const auto utmProjector = createBenchmarkUtmProjector();
+  const CUtmBatchProjector batchProjector(utmProjector);
+  CIdAllocator             idAllocator(Constants::kBenchmarkFirstId);
+  lanelet::LineString3d    lineString =
+    convertLine(laneBorders.front().mComponents[0].mLine, batchProjector, idAllocator);
+
+  size_t       borderIdx = 0;
+  const size_t before    = gNumberOfAllocations.load();
+  for (auto _ : aState)
+  {
+    setTypeAndSubtype(laneBorders[borderIdx], lineString);
+    benchmark::ClobberMemory();
+    borderIdx = (borderIdx + 1) % laneBorders.size();
+  }
+  reportAllocations(before, aState);
+}
+
+/**
+ * Measure comparing two converted points, as done when stitching lane borders.
+ *
+ * @param[in, out] aState Benchmark state.
+ */
+void benchmarkIsSame(benchmark::State& aState)
+{
+  const auto laneBorders  = getBenchmarkLaneBorders(Constants::kDefaultPointsPerBorder);
+  const auto utmProjector = createBenchmarkUtmProjector();
+  const std::vector<AutoStream::TCoordinate3D>& line = laneBorders.front().mComponents[0].mLine;
+  CIdAllocator           idAllocator(Constants::kBenchmarkFirstId);
+  const lanelet::Point3d first  = toUtm(line.front(), utmProjector, idAllocator);
+  const lanelet::Point3d second = toUtm(line.back(), utmProjector, idAllocator);
+
+  const size_t before = gNumberOfAllocations.load();
+  for (auto _ : aState)
+  {
+    benchmark::DoNotOptimize(isSame(first, second));
+  }
+  reportAllocations(before, aState);
+}
+
+/**
+ * Measure getting the lanelet subtype of a lane.
+ *
+ * @param[in, out] aState Benchmark state.
+ */
+void benchmarkGetLaneSubtype(benchmark::State& aState)
+{
+  const auto laneTypes = getBenchmarkLaneTypes();
+
+  size_t       laneIdx = 0;
+  const size_t before  = gNumberOfAllocations.load();
+  for (auto _ : aState)
+  {
+    benchmark::DoNotOptimize(getLaneSubtype(laneTypes[laneIdx]));
+    laneIdx = (laneIdx + 1) % laneTypes.size();
+  }
+  reportAllocations(before, aState);
+}
+
+/**
+ * Measure getting the vehicle type expected on a lane.
+ *
+ * @param[in, out] aState Benchmark state.
+ */
+void benchmarkGetVehicleType(benchmark::State& aState)
+{
+  const auto laneTypes = getBenchmarkLaneTypes();
+
+  size_t       laneIdx = 0;
+  const size_t before  = gNumberOfAllocations.load();
+  for (auto _ : aState)
+  {
+    benchmark::DoNotOptimize(getVehicleType(laneTypes[laneIdx]));
+    laneIdx = (laneIdx + 1) % laneTypes.size();
+  }
+  reportAllocations(before, aState);
+}
+
+/**
+ * Measure moving a coordinate over a distance, as done for the corners of traffic signs.
+ *
+ * @param[in, out] aState Benchmark state.
+ */
+void benchmarkMoveCoordinateDistance(benchmark::State& aState)
+{
+  const auto laneBorders = getBenchmarkLaneBorders(Constants::kDefaultPointsPerBorder);
+  const AutoStream::TCoordinate position = laneBorders.front().mComponents[0].mLine.front().getXY();
+
+  const size_t before = gNumberOfAllocations.load();
+  for (auto _ : aState)
+  {
+    benchmark::DoNotOptimize(
+      moveCoordinateDistance(position, Constants::kMoveDistanceMeter, Constants::kMoveHeadingDeg));
+  }
+  reportAllocations(before, aState);
+}
+
+BENCHMARK(benchmarkToUtm);
+BENCHMARK(benchmarkConvertLine)->Arg(2)->Arg(11)->Arg(101);
+BENCHMARK(benchmarkConvertLaneBorder)->Arg(2)->Arg(11)->Arg(101);
+BENCHMARK(benchmarkSetTypeAndSubtype);
+BENCHMARK(benchmarkIsSame);
+BENCHMARK(benchmarkGetLaneSubtype);
+BENCHMARK(benchmarkGetVehicleType);
+BENCHMARK(benchmarkMoveCoordinateDistance);
+}
+}
+}
+
+BENCHMARK_MAIN();
@@ -0,0 +1,150 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#ifndef TOMTOM_AUTOSTREAM_MAP_CONVERTER_ARC_CACHE_H
+#define TOMTOM_AUTOSTREAM_MAP_CONVERTER_ARC_CACHE_H
+
+#include "DataTypes.hpp"
+#include "IdAllocator.hpp"
+
+#include "TomTom/AutoStream/AutoStream.h"
+#include "TomTom/AutoStream/HdMap/HdMapArc.h"
+
+#include <lanelet2_core/primitives/GPSPoint.h>
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+/**
+ * Cached conversion result of a single arc, together with the fingerprint of the AutoStream data
+ * it was converted from.
+ */
+struct CAutoStreamArcCacheEntry
+{
+  uint64_t    mFingerprint;
+  std::string mData;
+};
+
+/**
+ * Persistent per-arc conversion results, used for converting only new and changed arcs in
+ * subsequent runs. Results are stored before connections are stitched, such that they can be
+ * stitched again together with newly converted arcs. Primitives are stored without IDs: restored
+ * results get IDs from the range of their arc, exactly like freshly converted arcs.
+ *
+ * The cache is tagged with the map version and hash that was used and with the origin of the UTM
+ * projection. Results from another map version are reused only if the fingerprint of the arc
+ * data did not change; results for another origin are never reused.
+ */
+class CAutoStreamArcCache
+{
+public:
+  /**
+   * Constructor.
+   */
+  CAutoStreamArcCache();
+
+  /**
+   * Remove all entries and set the map version and origin of the cache.
+   *
+   * @param[in] aMapVersionAndHash Map version and hash used for converting arcs.
+   * @param[in] aOrigin Origin of the UTM projection used for converting arcs.
+   */
+  void reset(const AutoStream::CMapVersionAndHash& aMapVersionAndHash,
+             const lanelet::GPSPoint&              aOrigin);
+
+  /**
+   * Load a cache from file. Entries are removed if the file cannot be read.
+   *
+   * @param[in] aFileName Name of the cache file.
+   * @retval True If loading succeeded.
+   * @retval False If the file does not exist or is not a valid cache file.
+   */
+  bool load(const std::string& aFileName);
+
+  /**
+   * Store the cache in a file.
+   *
+   * @param[in] aFileName Name of the cache file.
+   * @retval True If storing succeeded.
+   * @retval False If writing the file failed.
+   */
+  bool store(const std::string& aFileName) const;
+
+  /**
+   * Check if the cache was created for the given map version and hash.
+   *
+   * @param[in] aMapVersionAndHash Map version and hash.
+   * @retval True If the map versions are equal.
+   * @retval False If the map versions differ.
+   */
+  bool hasMapVersion(const AutoStream::CMapVersionAndHash& aMapVersionAndHash) const noexcept;
+
+  /**
+   * Check if the cache was created using a projection with the given origin.
+   *
+   * @param[in] aOrigin Origin of the UTM projection.
+   * @retval True If the origins are equal.
+   * @retval False If the origins differ.
+   */
+  bool hasOrigin(const lanelet::GPSPoint& aOrigin) const noexcept;
+
+  /**
+   * Find the entry of the given arc.
+   *
+   * @param[in] aArcKey Key of the arc.
+   * @retval const CAutoStreamArcCacheEntry* Entry of the arc, null pointer if there is none.
+   */
+  const CAutoStreamArcCacheEntry* find(const AutoStream::HdMap::TArcKey& aArcKey) const;
+
+  /**
+   * Add the conversion result of an arc, replacing an existing entry.
+   *
+   * @param[in] aArcKey Key of the arc.
+   * @param[in] aResult Conversion result, connections must not have been stitched yet.
+   */
+  void add(const AutoStream::HdMap::TArcKey&     aArcKey,
+           const CAutoStreamArcConversionResult& aResult);
+
+  /**
+   * Restore the conversion result stored in an entry. All primitives get new IDs.
+   *
+   * @param[in] aEntry Entry that must be restored.
+   * @param[in, out] aIdAllocator Allocator providing the IDs of the restored primitives.
+   * @param[out] aResult Restored conversion result.
+   * @retval True If restoring succeeded.
+   * @retval False If the entry is corrupt.
+   */
+  static bool restore(const CAutoStreamArcCacheEntry& aEntry,
+                      CIdAllocator&                   aIdAllocator,
+                      CAutoStreamArcConversionResult& aResult);
+
+  /**
+   * Get number of entries.
+   *
+   * @retval size_t Number of entries.
+   */
+  size_t size() const noexcept;
+
+private:
+  AutoStream::CMapVersionAndHash                                 mMapVersionAndHash;
+  double                                                         mOriginLat;
+  double                                                         mOriginLon;
+  std::map<AutoStream::HdMap::TArcKey, CAutoStreamArcCacheEntry> mEntries;
+};
+}
+}
+}
+#endif
@@ -12,19 +12,16 @@
 #ifndef TOMTOM_AUTOSTREAM_MAP_CONVERTER_ARC_CONVERTER_H
 #define TOMTOM_AUTOSTREAM_MAP_CONVERTER_ARC_CONVERTER_H
 
-#include "AutoStreamInterface.hpp"
 #include "DataTypes.hpp"
 #include "LaneConverter.hpp"
-
-#include "TomTom/AutoStream/HdMap/HdMapAccess.h"
-#include "TomTom/AutoStream/HdMap/HdMapArc.h"
-#include "TomTom/AutoStream/HdMap/HdRoadDataTypes.h"
+#include "RouteCorridor.hpp"
 
 #include <lanelet2_core/primitives/Area.h>
 #include <lanelet2_core/primitives/Lanelet.h>
 #include <lanelet2_core/primitives/LineString.h>
 #include <lanelet2_projection/UTM.h>
 
+#include <cstdint>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -52,86 +49,65 @@ public:
   explicit CAutoStreamArcConverter(const lanelet::projection::UtmProjector& aUtmProjector);
 
   /**
-   * Convert a given AutoStream arc to a set of lanelet2 lanes.
+   * Convert the data of an AutoStream arc to a set of lanelet2 lanes.
    *
-   * @param[in] aArc Arc that must be converted.
-   * @param[in] aMapAccess Map access that can be used to retrieve required information.
+   * @param[in] aArcData Data of the arc that must be converted.
+   * @param[in, out] aIdAllocator Allocator providing the IDs of the converted primitives.
    * @param[out] aAreas Vector used to store converted areas.
    * @param[out] aLanelets Vector used to store converted lanelets.
    * @param[out] aConnections AutoStream arc lane meta data containing connectivity information.
-   * @param[in, out] aInvalidConnectionsOut Ids of triangular lanelets that should not be used as
-   * outgoing connection.
    * @retval True If conversion succeeded.
    * @retval False If conversion failed.
    */
-  bool convertArc(const AutoStream::HdMap::TArc&         aArc,
-                  const AutoStream::HdMap::CHdMapAccess* aMapAccess,
-                  std::vector<lanelet::Area>&            aAreas,
-                  std::vector<lanelet::Lanelet>&         aLanelets,
-                  std::vector<CAutoStreamLaneMetaData>&  aConnections,
-                  std::set<lanelet::Id>&                 aInvalidConnectionsOut);
+  bool convertArc(CAutoStreamArcData&                   aArcData,
+                  CIdAllocator&                         aIdAllocator,
+                  std::vector<lanelet::Area>&           aAreas,
+                  std::vector<lanelet::Lanelet>&        aLanelets,
+                  std::vector<CAutoStreamLaneMetaData>& aConnections);
 
-private:
   /**
-   * Validate a map access pointer.
+   * Compute a fingerprint of all AutoStream data that is used for converting an arc: lane meta
+   * data, connections, lane border geometry and attributes, and speed limits. Arcs with equal
+   * fingerprints are converted to equal lanelets and areas.
    *
-   * @param[in] aMapAccess Object that needs to be check on validity.
-   * @retval True If HD map access is valid.
-   * @retval False If HD map access is invalid.
+   * @param[in] aArcData Data of the arc for which the fingerprint must be computed.
+   * @retval uint64_t Fingerprint of the arc data.
    */
-  bool validateMapAccess(const AutoStream::HdMap::CHdMapAccess* aMapAccess) const noexcept;
+  uint64_t getArcFingerprint(const CAutoStreamArcData& aArcData) const;
 
   /**
-   * Get lane information in a more appropriate form for a given arc.
+   * Check if the lane border geometry of an arc comes within the buffer distance of one of the
+   * given pieces of a route corridor.
    *
-   * @param[in] aArc Arc from which lanes must be retrieved.
-   * @param[in] aMapAccess HD map access object that can be used to retrieve required information
-   * about lanes.
-   * @retval CAutoStreamArcData Lane information in a convenient internal datatype.
+   * @param[in] aArcData Data of the arc that must be checked.
+   * @param[in] aCorridor Corridor around a route.
+   * @param[in] aPieceIndices Indices of the corridor pieces that must be checked.
+   * @retval True If a lane border of the arc lies partly within the corridor.
+   * @retval False If the arc lies outside the given pieces of the corridor.
    */
-  CAutoStreamArcData getLanes(const AutoStream::HdMap::TArc&         aArc,
-                              const AutoStream::HdMap::CHdMapAccess* aMapAccess) const;
+  bool isArcInCorridor(const CAutoStreamArcData&  aArcData,
+                       const CRouteCorridor&      aCorridor,
+                       const std::vector<size_t>& aPieceIndices) const;
 
   /**
-   * Store meta data and lane border(s) for the given AutoStream lane.
+   * Get the buffer to which trace spans of the conversion are added.
    *
-   * @param[in] aLane AutoStream lane that contains data that must be stored.
-   * @param[in] aDrivingSide Driving side for current lane.
-   * @param[in] aStoreLeftBorder Boolean that indicates whether or not the left border must be
-   * stored (right border will always be stored).
-   * @param[out] aLaneData Object to which lane data must be added.
+   * @retval CTraceBuffer* Trace buffer, nullptr if tracing is disabled.
    */
-  void getLaneMetaDataAndBorders(const AutoStream::HdMap::HdRoad::CLaneOrTrajectory& aLane,
-                                 const AutoStream::HdMap::HdRoad::TDrivingSide       aDrivingSide,
-                                 bool                aStoreLeftBorder,
-                                 CAutoStreamArcData& aLaneData) const;
+  CTraceBuffer* getTraceBuffer() const noexcept;
 
   /**
-   * Get meta data from a given AutoStream lane in the appropriate format.
+   * Set the buffer to which trace spans of the conversion are added. The converter must only be
+   * used by the thread owning the buffer.
    *
-   * @param[in] aLane AutoStream lane that contains the required data.
-   * @param[in] aDrivingSide Driving side for current lane.
-   * @retval CAutoStreamLaneMetaData Converted lane data.
+   * @param[in] aTraceBuffer Trace buffer of the thread using the converter, nullptr to disable
+   * tracing.
    */
-  CAutoStreamLaneMetaData
-  getLaneMetaData(const AutoStream::HdMap::HdRoad::CLaneOrTrajectory& aLane,
-                  const AutoStream::HdMap::HdRoad::TDrivingSide       aDrivingSide) const;
-
-  /**
-   * Store lane borders for the given AutoStream lane in the given structure.
-   *
-   * @param[in] aLane Lane for which border or borders need to be stored.
-   * @param[in] aStoreSecondBorder Boolean indicating whether only the first (false) or both borders
-   * (true) must be stored.
-   * @param[in] aDrivingSide Driving side for given lane.
-   * @param[out] aLaneData Struct to which the lane borders will be added.
-   */
-  void storeLaneBorders(const AutoStream::HdMap::HdRoad::CLaneOrTrajectory& aLane,
-                        const bool                                          aStoreSecondBorder,
-                        const AutoStream::HdMap::HdRoad::TDrivingSide       aDrivingSide,
-                        CAutoStreamArcData&                                 aLaneData) const;
+  void setTraceBuffer(CTraceBuffer* aTraceBuffer) noexcept;
 
+private:
   std::unique_ptr<CAutoStreamLaneConverter> mLaneConverter;
+  CTraceBuffer*                             mTraceBuffer;
 };
 }
 }
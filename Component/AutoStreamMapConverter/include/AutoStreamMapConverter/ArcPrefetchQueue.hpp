@@ -0,0 +1,79 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#ifndef TOMTOM_AUTOSTREAM_MAP_CONVERTER_ARC_PREFETCH_QUEUE_H
+#define TOMTOM_AUTOSTREAM_MAP_CONVERTER_ARC_PREFETCH_QUEUE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+/**
+ * Bounded queue of arc indices between the stage that fetches arcs and the stage that converts
+ * them. The fetching stage blocks when the queue is full, such that it runs at most the capacity
+ * ahead of the converting stage and fetched tiles are still cached when they are converted.
+ */
+class CArcPrefetchQueue
+{
+public:
+  /**
+   * Delete default constructor.
+   */
+  CArcPrefetchQueue() = delete;
+
+  /**
+   * Constructor.
+   *
+   * @param[in] aCapacity Maximum number of queued arcs, values below one are treated as one.
+   */
+  explicit CArcPrefetchQueue(const size_t aCapacity);
+
+  /**
+   * Add an arc index, waiting while the queue is full.
+   *
+   * @param[in] aArcIdx Index of the fetched arc.
+   * @retval True If the index was added.
+   * @retval False If the queue has been closed.
+   */
+  bool push(const size_t aArcIdx);
+
+  /**
+   * Take the oldest arc index, waiting while the queue is empty and not closed.
+   *
+   * @param[out] aArcIdx Index of the oldest fetched arc.
+   * @retval True If an index was taken.
+   * @retval False If the queue is empty and has been closed.
+   */
+  bool pop(size_t& aArcIdx);
+
+  /**
+   * Close the queue, such that no further indices are added and waiting stages wake up. Indices
+   * already queued can still be taken.
+   */
+  void close();
+
+private:
+  const size_t            mCapacity;
+  std::deque<size_t>      mArcIndices;
+  bool                    mClosed;
+  std::mutex              mMutex;
+  std::condition_variable mNotFull;
+  std::condition_variable mNotEmpty;
+};
+}
+}
+}
+#endif
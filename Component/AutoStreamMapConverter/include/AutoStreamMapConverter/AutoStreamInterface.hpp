@@ -23,6 +23,7 @@
 #include "TomTom/AutoStream/Reference/HttpDataUsageLogger/HttpDataUsageLogger.h"
 #include "TomTom/AutoStream/Reference/SqlitePersistentTileCacheV2/SqlitePersistentTileCacheV2.h"
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -46,6 +47,14 @@ struct CAutoStreamParameters
   std::string   mUriBasePath;
 };
 
+/**
+ * Owning pointer to an HD map access object which destroys the object via the HD map it was created
+ * from.
+ */
+typedef std::unique_ptr<AutoStream::HdMap::CHdMapAccess,
+                        std::function<void(AutoStream::HdMap::CHdMapAccess*)>>
+  THdMapAccessPtr;
+
 /**
  * Class that performs the initialization of and interaction with AutoStream.
  */
@@ -78,6 +87,22 @@ public:
    */
   AutoStream::HdMap::CHdMapAccess* getHdMapAccess() const;
 
+  /**
+   * Create an additional map access object for the same layers and map version as the one returned
+   * by getHdMapAccess(). Map access objects must not be shared between threads, hence each worker
+   * thread needs its own one.
+   *
+   * @return THdMapAccessPtr Owning pointer to the new map access object, empty if creation failed.
+   */
+  THdMapAccessPtr createHdMapAccess() const;
+
+  /**
+   * Get the map version and hash that is used for accessing map data.
+   *
+   * @return const AutoStream::CMapVersionAndHash& Map version and hash.
+   */
+  const AutoStream::CMapVersionAndHash& getMapVersionAndHash() const noexcept;
+
   /**
    * Check if AutoStream has been initialized successfully.
    *
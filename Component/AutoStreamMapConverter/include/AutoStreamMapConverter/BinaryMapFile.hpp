@@ -0,0 +1,155 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#ifndef TOMTOM_AUTOSTREAM_MAP_CONVERTER_BINARY_MAP_FILE_H
+#define TOMTOM_AUTOSTREAM_MAP_CONVERTER_BINARY_MAP_FILE_H
+
+#include "BinaryMapFormat.hpp"
+
+#include <lanelet2_core/LaneletMap.h>
+#include <lanelet2_core/primitives/GPSPoint.h>
+#include <lanelet2_io/Io.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+/**
+ * Check whether a file is a binary map file, by its identification rather than its file name.
+ *
+ * @param[in] aFileName Name of the file, which may be gzip compressed.
+ * @retval True If the file starts with the identification of binary map files.
+ * @retval False If the file cannot be read or is not a binary map file.
+ */
+bool isBinaryMapFile(const std::string& aFileName);
+
+/**
+ * Read only view of a binary map file, see BinaryMapFormat.hpp for the layout. Plain files are
+ * memory mapped, such that opening a file costs validating it only and the tables are paged in
+ * while they are used. Gzip compressed files are decompressed into memory instead.
+ */
+class CBinaryMapFile
+{
+public:
+  /**
+   * Construct a view without file.
+   */
+  CBinaryMapFile();
+
+  /**
+   * Unmap the file, if any.
+   */
+  ~CBinaryMapFile();
+
+  CBinaryMapFile(const CBinaryMapFile&) = delete;
+  CBinaryMapFile& operator=(const CBinaryMapFile&) = delete;
+
+  /**
+   * Open a binary map file and validate its header and the references between its records.
+   *
+   * @param[in] aFileName Name of the file, gzip compressed if it ends with ".gz".
+   * @retval True If the file was opened and is a valid binary map file.
+   * @retval False If the file cannot be read or is not a valid binary map file of this version.
+   */
+  bool open(const std::string& aFileName);
+
+  /**
+   * Close the file, after which records obtained from it must no longer be used.
+   */
+  void close();
+
+  /**
+   * Get the origin of the local coordinates of the points.
+   *
+   * @retval lanelet::GPSPoint Origin the map was converted for.
+   */
+  lanelet::GPSPoint getOrigin() const;
+
+  /**
+   * Get the number of records in a table of the open file.
+   *
+   * @param[in] aTable Table of which the size is requested.
+   * @retval size_t Number of records in the table.
+   */
+  size_t getNumberOfRecords(const TBinaryMapTable aTable) const;
+
+  /**
+   * Get the records of a table of the open file, which remain valid until the file is closed.
+   *
+   * @param[in] aTable Table of which the records are requested.
+   * @retval const RecordT* First record of the table, RecordT must be the record type of the table.
+   */
+  template <typename RecordT>
+  const RecordT* getRecords(const TBinaryMapTable aTable) const
+  {
+    return reinterpret_cast<const RecordT*>(mData + getHeader().mTables[toIndex(aTable)].mOffset);
+  }
+
+  /**
+   * Create a lanelet map of the primitives in the open file. Points keep their stored coordinates
+   * if the projector has the origin of the file and are projected otherwise, which is slower.
+   *
+   * @param[in] aProjector Projector for the local coordinates of the created map.
+   * @retval lanelet::LaneletMapPtr Created map.
+   */
+  lanelet::LaneletMapPtr createLaneletMap(const lanelet::Projector& aProjector) const;
+
+private:
+  /**
+   * Get the index of a table in the header.
+   *
+   * @param[in] aTable Table of which the index is requested.
+   * @retval size_t Index of the table.
+   */
+  static size_t toIndex(const TBinaryMapTable aTable);
+
+  /**
+   * Get the header of the open file.
+   *
+   * @retval const CBinaryMapHeader& Header at the start of the file.
+   */
+  const CBinaryMapHeader& getHeader() const;
+
+  /**
+   * Check that the header matches this version of the format, that all tables lie within the
+   * file and that all records refer to existing records, such that the tables can be used
+   * without further checks.
+   *
+   * @retval True If the open file is a valid binary map file.
+   * @retval False If the open file is corrupt or of another version or byte order.
+   */
+  bool validate() const;
+
+  /**
+   * Set attributes from a range of the attribute table.
+   *
+   * @param[in] aFirstAttribute Index of the first attribute.
+   * @param[in] aNumberOfAttributes Number of attributes.
+   * @param[out] aAttributes Attributes that must be set.
+   */
+  void readAttributes(const uint32_t         aFirstAttribute,
+                      const uint32_t         aNumberOfAttributes,
+                      lanelet::AttributeMap& aAttributes) const;
+
+  const char*       mData;
+  size_t            mSize;
+  void*             mMapping;
+  std::vector<char> mBuffer;
+};
+}
+}
+}
+#endif
@@ -0,0 +1,184 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#ifndef TOMTOM_AUTOSTREAM_MAP_CONVERTER_BINARY_MAP_FORMAT_H
+#define TOMTOM_AUTOSTREAM_MAP_CONVERTER_BINARY_MAP_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+/*
+ * Layout of binary map files. A file starts with a CBinaryMapHeader, followed by flat tables of
+ * fixed size records. Tables are addressed by the offsets in the header and records refer to each
+ * other by their index in a table, such that a memory mapped file can be used without parsing.
+ * Every table starts at a multiple of eight bytes. All values are stored in the byte order of the
+ * writing machine, which is recorded in the header.
+ *
+ * Coordinates are the local UTM coordinates of the conversion, relative to the origin stored in the
+ * header. Line strings are stored in the order of their points, lanelets and areas record whether
+ * they use a line string inverted.
+ */
+
+/**
+ * Tables of a binary map file, in the order in which they are written.
+ */
+enum class TBinaryMapTable : uint32_t
+{
+  // CBinaryPoint records
+  Points,
+  // CBinaryLineString records of the line strings of lanelets and areas
+  LineStrings,
+  // CBinaryLineString records of polygons
+  Polygons,
+  // uint32_t indices in the point table, referred to by line strings and polygons
+  PointIndices,
+  // CBinaryLanelet records
+  Lanelets,
+  // CBinaryArea records
+  Areas,
+  // CBinaryAreaBound records, referred to by areas
+  AreaBounds,
+  // CBinaryAttribute records, referred to by all primitives
+  Attributes,
+  // Characters of attribute keys and values, referred to by attributes
+  Strings
+};
+
+constexpr size_t kNumberOfBinaryMapTables = static_cast<size_t>(TBinaryMapTable::Strings) + 1;
+
+// Identification of binary map files, including the terminating zero character
+constexpr char kBinaryMapMagic[8] = "LL2BMAP";
+
+constexpr uint32_t kBinaryMapVersion       = 1;
+constexpr uint32_t kBinaryMapByteOrderMark = 0x01020304;
+
+// Alignment of the tables in the file
+constexpr uint64_t kBinaryMapTableAlignment = 8;
+
+/**
+ * Location of a table in a binary map file.
+ */
+struct CBinaryMapTable
+{
+  uint64_t mOffset;
+  uint64_t mNumberOfRecords;
+};
+
+/**
+ * Header of a binary map file.
+ */
+struct CBinaryMapHeader
+{
+  // "LL2BMAP" followed by a zero character
+  char mMagic[8];
+
+  uint32_t mVersion;
+
+  // 0x01020304 as written, used for rejecting files of another byte order
+  uint32_t mByteOrderMark;
+
+  // Origin of the local UTM coordinates
+  double mOriginLatitude;
+  double mOriginLongitude;
+  double mOriginAltitude;
+
+  CBinaryMapTable mTables[kNumberOfBinaryMapTables];
+};
+
+/**
+ * Point with its local coordinates.
+ */
+struct CBinaryPoint
+{
+  int64_t  mId;
+  double   mX;
+  double   mY;
+  double   mZ;
+  uint32_t mFirstAttribute;
+  uint32_t mNumberOfAttributes;
+};
+
+/**
+ * Line string or polygon, of which the points are a range of the point index table.
+ */
+struct CBinaryLineString
+{
+  int64_t  mId;
+  uint32_t mFirstPointIndex;
+  uint32_t mNumberOfPoints;
+  uint32_t mFirstAttribute;
+  uint32_t mNumberOfAttributes;
+};
+
+/**
+ * Lanelet, of which the bounds are indices in the line string table.
+ */
+struct CBinaryLanelet
+{
+  int64_t  mId;
+  uint32_t mLeftBound;
+  uint32_t mRightBound;
+  uint32_t mLeftBoundInverted;
+  uint32_t mRightBoundInverted;
+  uint32_t mFirstAttribute;
+  uint32_t mNumberOfAttributes;
+};
+
+/**
+ * Area, of which the outer bounds are a range of the area bound table.
+ */
+struct CBinaryArea
+{
+  int64_t  mId;
+  uint32_t mFirstBound;
+  uint32_t mNumberOfBounds;
+  uint32_t mFirstAttribute;
+  uint32_t mNumberOfAttributes;
+};
+
+/**
+ * Outer bound of an area, as index in the line string table.
+ */
+struct CBinaryAreaBound
+{
+  uint32_t mLineString;
+  uint32_t mInverted;
+};
+
+/**
+ * Attribute, of which the key and value are ranges of the string table.
+ */
+struct CBinaryAttribute
+{
+  uint32_t mKeyOffset;
+  uint32_t mKeyLength;
+  uint32_t mValueOffset;
+  uint32_t mValueLength;
+};
+
+static_assert(sizeof(CBinaryMapHeader) % 8 == 0, "Tables must start aligned after the header");
+static_assert(std::is_trivially_copyable<CBinaryMapHeader>::value
+                && std::is_trivially_copyable<CBinaryPoint>::value
+                && std::is_trivially_copyable<CBinaryLineString>::value
+                && std::is_trivially_copyable<CBinaryLanelet>::value
+                && std::is_trivially_copyable<CBinaryArea>::value
+                && std::is_trivially_copyable<CBinaryAreaBound>::value
+                && std::is_trivially_copyable<CBinaryAttribute>::value,
+              "Binary map records are written and mapped as raw bytes");
+}
+}
+}
+#endif
@@ -0,0 +1,131 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#ifndef TOMTOM_AUTOSTREAM_MAP_CONVERTER_BINARY_MAP_WRITER_H
+#define TOMTOM_AUTOSTREAM_MAP_CONVERTER_BINARY_MAP_WRITER_H
+
+#include "BinaryMapFormat.hpp"
+
+#include <lanelet2_core/primitives/Area.h>
+#include <lanelet2_core/primitives/Lanelet.h>
+#include <lanelet2_core/primitives/Polygon.h>
+#include <lanelet2_projection/UTM.h>
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+/**
+ * Writes converted primitives as binary map file to an output stream, see BinaryMapFormat.hpp for
+ * the layout. The tables are assembled in memory and written at once, as the header holds their
+ * offsets. Primitives shared between lanelets and areas and attribute strings are stored once.
+ */
+class CBinaryMapWriter
+{
+public:
+  /**
+   * Constructor.
+   *
+   * @param[in] aOutput Stream to which the map must be written.
+   * @param[in] aUtmProjector Projector that was used for converting coordinates to UTM, of which
+   * the origin is stored.
+   */
+  CBinaryMapWriter(std::ostream& aOutput, const lanelet::projection::UtmProjector& aUtmProjector);
+
+  /**
+   * Write the given primitives as binary map.
+   *
+   * @param[in] aLanelets Lanelets that must be written.
+   * @param[in] aAreas Areas that must be written.
+   * @param[in] aPolygons Polygons that must be written.
+   * @retval True If writing succeeded.
+   * @retval False If writing to the output stream failed.
+   */
+  bool write(const std::vector<lanelet::Lanelet>&   aLanelets,
+             const std::vector<lanelet::Area>&      aAreas,
+             const std::vector<lanelet::Polygon3d>& aPolygons);
+
+private:
+  /**
+   * Add a point to the point table, unless it has been added already.
+   *
+   * @param[in] aPoint Point that must be added.
+   * @retval uint32_t Index of the point in the point table.
+   */
+  uint32_t addPoint(const lanelet::ConstPoint3d& aPoint);
+
+  /**
+   * Add a line string or polygon to a table, unless it has been added already. Points are added in
+   * the order in which they are stored, independent of the orientation of the given primitive.
+   *
+   * @param[in] aLineString Line string or polygon that must be added.
+   * @param[in, out] aTable Table to which the primitive must be added.
+   * @param[in, out] aIndices Indices in the table by primitive ID.
+   * @retval uint32_t Index of the primitive in the table.
+   */
+  template <typename LineStringT>
+  uint32_t addLineString(const LineStringT&                       aLineString,
+                         std::vector<CBinaryLineString>&          aTable,
+                         std::unordered_map<lanelet::Id, size_t>& aIndices);
+
+  /**
+   * Add attributes to the attribute table.
+   *
+   * @param[in] aAttributes Attributes that must be added.
+   * @param[out] aFirstAttribute Index of the first added attribute.
+   * @param[out] aNumberOfAttributes Number of added attributes.
+   */
+  void addAttributes(const lanelet::AttributeMap& aAttributes,
+                     uint32_t&                    aFirstAttribute,
+                     uint32_t&                    aNumberOfAttributes);
+
+  /**
+   * Add a string to the string table, unless it has been added already.
+   *
+   * @param[in] aString String that must be added.
+   * @retval uint32_t Offset of the string in the string table.
+   */
+  uint32_t addString(const std::string& aString);
+
+  /**
+   * Remove all tables.
+   */
+  void clear();
+
+  std::ostream&    mOutput;
+  CBinaryMapHeader mHeader;
+
+  std::vector<CBinaryPoint>      mPoints;
+  std::vector<CBinaryLineString> mLineStrings;
+  std::vector<CBinaryLineString> mPolygons;
+  std::vector<uint32_t>          mPointIndices;
+  std::vector<CBinaryLanelet>    mLanelets;
+  std::vector<CBinaryArea>       mAreas;
+  std::vector<CBinaryAreaBound>  mAreaBounds;
+  std::vector<CBinaryAttribute>  mAttributes;
+  std::string                    mStrings;
+
+  // Indices of added primitives by ID and offsets of added strings
+  std::unordered_map<lanelet::Id, size_t> mPointIndicesById;
+  std::unordered_map<lanelet::Id, size_t> mLineStringIndicesById;
+  std::unordered_map<lanelet::Id, size_t> mPolygonIndicesById;
+  std::unordered_map<std::string, size_t> mStringOffsets;
+};
+}
+}
+}
+#endif
@@ -0,0 +1,208 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#ifndef TOMTOM_AUTOSTREAM_MAP_CONVERTER_COMPRESSED_FILE_H
+#define TOMTOM_AUTOSTREAM_MAP_CONVERTER_COMPRESSED_FILE_H
+
+#include <lanelet2_core/LaneletMap.h>
+#include <lanelet2_io/Io.h>
+
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+// Handle of a zlib file, declared here such that users do not depend on zlib
+struct gzFile_s;
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+/**
+ * Compression of map files, chosen by the extension of the file name.
+ */
+enum class TMapFileCompression
+{
+  // Plain OSM XML
+  None,
+  // Gzip compressed OSM XML, for file names ending with ".gz"
+  Gzip
+};
+
+/**
+ * Get the compression of a map file from its file name.
+ *
+ * @param[in] aFileName Name of the map file.
+ * @retval TMapFileCompression Compression of the file.
+ */
+TMapFileCompression getMapFileCompression(const std::string& aFileName);
+
+/**
+ * Stream buffer that compresses written data to a gzip file or decompresses read data from a gzip
+ * file, while it is streamed.
+ */
+class CGzipFileBuffer : public std::streambuf
+{
+public:
+  /**
+   * Construct a buffer without file.
+   */
+  CGzipFileBuffer();
+
+  /**
+   * Close the file, if any.
+   */
+  ~CGzipFileBuffer() override;
+
+  CGzipFileBuffer(const CGzipFileBuffer&) = delete;
+  CGzipFileBuffer& operator=(const CGzipFileBuffer&) = delete;
+
+  /**
+   * Open a file for either reading or writing. A file opened for writing is truncated.
+   *
+   * @param[in] aFileName Name of the file.
+   * @param[in] aMode std::ios::in for reading or std::ios::out for writing.
+   * @retval True If opening succeeded.
+   * @retval False If a file is open already or the file could not be opened.
+   */
+  bool open(const std::string& aFileName, const std::ios::openmode aMode);
+
+  /**
+   * Compress the remaining data and close the file.
+   *
+   * @retval True If all data was written and the file was closed.
+   * @retval False If no file was open or writing failed.
+   */
+  bool close();
+
+protected:
+  /**
+   * Compress the buffered data and buffer the given character.
+   *
+   * @param[in] aCharacter Character that did not fit in the buffer, or EOF.
+   * @retval int_type The given character, or EOF if writing failed.
+   */
+  int_type overflow(int_type aCharacter) override;
+
+  /**
+   * Hand the buffered data to the compressor. The compressor is not flushed, such that the
+   * compression ratio does not suffer.
+   *
+   * @retval int Zero on success, -1 if writing failed.
+   */
+  int sync() override;
+
+  /**
+   * Decompress the next part of the file into the buffer.
+   *
+   * @retval int_type First character of the buffer, or EOF at the end of the file.
+   * @throw std::ios_base::failure If the file is corrupt or truncated, which sets the bad bit of
+   * the reading stream.
+   */
+  int_type underflow() override;
+
+private:
+  /**
+   * Compress the data that has been buffered for writing.
+   *
+   * @retval True If compressing succeeded.
+   * @retval False If writing to the file failed.
+   */
+  bool writeBuffer();
+
+  gzFile_s*         mFile;
+  bool              mWriting;
+  std::vector<char> mBuffer;
+};
+
+/**
+ * Output stream writing a map file, compressed according to the extension of the file name.
+ */
+class CMapOutputStream : public std::ostream
+{
+public:
+  /**
+   * Construct a stream without file.
+   */
+  CMapOutputStream();
+
+  CMapOutputStream(const CMapOutputStream&) = delete;
+  CMapOutputStream& operator=(const CMapOutputStream&) = delete;
+
+  /**
+   * Open a map file for writing, truncating it.
+   *
+   * @param[in] aFileName Name of the map file.
+   * @retval True If opening succeeded.
+   * @retval False If the file could not be opened.
+   */
+  bool open(const std::string& aFileName);
+
+  /**
+   * Write the remaining data and close the file.
+   *
+   * @retval True If all data was written.
+   * @retval False If writing failed.
+   */
+  bool close();
+
+private:
+  std::vector<char> mFileBufferMemory;
+  std::filebuf      mFileBuffer;
+  CGzipFileBuffer   mGzipBuffer;
+};
+
+/**
+ * Input stream reading a map file, decompressed according to the extension of the file name.
+ */
+class CMapInputStream : public std::istream
+{
+public:
+  /**
+   * Construct a stream without file.
+   */
+  CMapInputStream();
+
+  CMapInputStream(const CMapInputStream&) = delete;
+  CMapInputStream& operator=(const CMapInputStream&) = delete;
+
+  /**
+   * Open a map file for reading.
+   *
+   * @param[in] aFileName Name of the map file.
+   * @retval True If opening succeeded.
+   * @retval False If the file could not be opened.
+   */
+  bool open(const std::string& aFileName);
+
+private:
+  std::filebuf    mFileBuffer;
+  CGzipFileBuffer mGzipBuffer;
+};
+
+/**
+ * Load a converted map with lanelet2, decompressing it according to the extension of the file
+ * name. Compressed maps are decompressed to a temporary file first, as lanelet2 only reads files.
+ * Binary maps are recognized by their content and read with CBinaryMapFile instead.
+ *
+ * @param[in] aFileName Name of the map file.
+ * @param[in] aProjector Projector for the origin the map was converted for.
+ * @retval lanelet::LaneletMapPtr Loaded map, nullptr if loading failed.
+ */
+lanelet::LaneletMapPtr loadMapFile(const std::string&        aFileName,
+                                   const lanelet::Projector& aProjector);
+}
+}
+}
+#endif
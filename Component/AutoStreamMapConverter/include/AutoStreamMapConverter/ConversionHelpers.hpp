@@ -12,6 +12,10 @@
 #ifndef TOMTOM_AUTOSTREAM_MAP_CONVERTER_CONVERSION_HELPERS_H
 #define TOMTOM_AUTOSTREAM_MAP_CONVERTER_CONVERSION_HELPERS_H
 
+#include "DataTypes.hpp"
+#include "IdAllocator.hpp"
+#include "UtmBatchProjector.hpp"
+
 #include "TomTom/AutoStream/HdMap/HdMapSpeedRestrictions.h"
 #include "TomTom/AutoStream/HdMap/HdRoadDataTypes.h"
 #include "TomTom/AutoStream/HdMap/SpeedRestrictionDataTypes.h"
@@ -47,38 +51,45 @@ constexpr int kEarthRadiusMeters = 6378137;
  * @param[in] aLaneBorder Lane border containing required data.
  * @param[out] aConvertedLineString Line string for which type and subtype must be set.
  */
-void setTypeAndSubtype(const AutoStream::HdMap::HdRoad::CLaneBorder& aLaneBorder,
-                       lanelet::LineString3d&                        aConvertedLineString);
+void setTypeAndSubtype(const CAutoStreamLaneBorder& aLaneBorder,
+                       lanelet::LineString3d&       aConvertedLineString);
 
 /**
  * Convert given NDS coordinates to corresponding UTM coordinates.
  *
  * @param[in] aPointInNds NDS point to be converted to UTM.
  * @param[in] aUTMProjector Projector object that must be used for the conversion.
+ * @param[in, out] aIdAllocator Allocator providing the ID of the point.
  * @return lanelet::Point3d Corresponding point in UTM coordinates.
  */
 lanelet::Point3d toUtm(const AutoStream::TCoordinate3D          aPointInNds,
-                       const lanelet::projection::UtmProjector& aUTMProjector);
+                       const lanelet::projection::UtmProjector& aUTMProjector,
+                       CIdAllocator&                            aIdAllocator);
 
 /**
- * Convert a 3D line from AutoStream format to line string.
+ * Convert a 3D line from AutoStream format to line string. All points of the line are projected
+ * in a single batch.
  *
  * @param[in] aLineIn AutoStream vector of 3D coordinates that must be converted.
  * @param[in] aUTMProjector Projector that must be used for conversion.
+ * @param[in, out] aIdAllocator Allocator providing the IDs of the line string and its points.
  * @return lanelet::LineString3d Points converted to UTM and in lanelet line string format.
  */
-lanelet::LineString3d convertLine(const AutoStream::HdMap::HdRoad::CIterable3DShapePoints& aLineIn,
-                                  const lanelet::projection::UtmProjector& aUTMProjector);
+lanelet::LineString3d convertLine(const std::vector<AutoStream::TCoordinate3D>& aLineIn,
+                                  const CUtmBatchProjector&                     aUTMProjector,
+                                  CIdAllocator&                                 aIdAllocator);
 
 /**
  * Convert the given lane border to a line string.
  *
  * @param[in] aLaneBorder Lane border that must be converted.
  * @param[in] aUtmProjector Projector that must be used for conversion.
+ * @param[in, out] aIdAllocator Allocator providing the IDs of the line string and its points.
  * @retval lanelet::LineString3d Line string representing given lane border.
  */
-lanelet::LineString3d convertLaneBorder(const AutoStream::HdMap::HdRoad::CLaneBorder& aLaneBorder,
-                                        const lanelet::projection::UtmProjector& aUtmProjector);
+lanelet::LineString3d convertLaneBorder(const CAutoStreamLaneBorder& aLaneBorder,
+                                        const CUtmBatchProjector&    aUtmProjector,
+                                        CIdAllocator&                aIdAllocator);
 
 /**
  * Check if two 3D points are the same.
@@ -114,19 +125,24 @@ bool isArea(const AutoStream::HdMap::HdRoad::TLaneType aLaneType);
  *
  * @param[in] aLeftBorder Left lane border.
  * @param[in] aRightBorder Right lane border.
+ * @param[in, out] aIdAllocator Allocator providing the IDs of the created bounds.
  * @return std::array<lanelet::LineString3d, Constants::kNumberOfSidesArea> Array with area bounds
  * in fixed order: top, right, bottom, left.
  */
 std::array<lanelet::LineString3d, Constants::kNumberOfSidesArea>
-getAreaBounds(lanelet::LineString3d& aLeftBorder, lanelet::LineString3d& aRightBorder);
+getAreaBounds(lanelet::LineString3d& aLeftBorder,
+              lanelet::LineString3d& aRightBorder,
+              CIdAllocator&          aIdAllocator);
 
 /**
  * Create a line string which has same points as given line string but in reverse order.
  *
  * @param[in] aLineStringIn Line string that must be copied and flipped.
+ * @param[in, out] aIdAllocator Allocator providing the new ID.
  * @return lanelet::LineString3d Flipped line string with new unique id.
  */
-lanelet::LineString3d createFlippedLineString(const lanelet::LineString3d& aLineStringIn);
+lanelet::LineString3d createFlippedLineString(const lanelet::LineString3d& aLineStringIn,
+                                              CIdAllocator&                aIdAllocator);
 
 /**
  * Check if the given border type is a dashed line.
@@ -162,16 +178,15 @@ getVehicleType(const AutoStream::HdMap::HdRoad::TLaneType aLaneType);
  * @retval True If it is painted.
  * @retval False If it is not painted.
  */
-bool isPainted(const AutoStream::HdMap::HdRoad::CLaneBorder& aLaneBorder);
+bool isPainted(const CAutoStreamLaneBorder& aLaneBorder);
 
 /**
- * Get speed limit for given AutoStream lane speed restriction object as lanelet velocity.
+ * Get speed limit for given AutoStream lane speed limit as lanelet velocity.
  *
- * @param[in] aSpeedLimits Speed restrictions from AutoStream.
+ * @param[in] aSpeedLimit Speed limit from AutoStream.
  * @retval lanelet::Velocity Speed restriction as lanelet velocity object.
  */
-lanelet::Velocity getSpeedLimit(
-  const AutoStream::HdMap::HdMapSpeedRestrictionLayer::CLaneSpeedRestrictions& aSpeedLimits);
+lanelet::Velocity getSpeedLimit(const CAutoStreamSpeedLimit& aSpeedLimit);
 
 /**
  * Move a given coordinate a predefined distance in the direction of the given heading.
@@ -0,0 +1,237 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#ifndef TOMTOM_AUTOSTREAM_MAP_CONVERTER_CONVERSION_REPORT_H
+#define TOMTOM_AUTOSTREAM_MAP_CONVERTER_CONVERSION_REPORT_H
+
+#include <array>
+#include <bitset>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+/**
+ * Counters of the converted data in a conversion report.
+ */
+enum class TReportCounter : uint32_t
+{
+  // Converted arcs, arcs that failed to convert and AutoStream lanes of the converted arcs,
+  // including lanes converted to areas
+  Arcs,
+  FailedArcs,
+  ArcLanes,
+  // Points of the lane borders of converted arcs, before stitching
+  Points,
+  StitchedConnections,
+  FailedTrafficSigns,
+  // Primitives of the stored map
+  Lanelets,
+  Areas,
+  TrafficSigns,
+  IdRangeCollisions,
+  // Relations of the routing graph
+  RoutingSuccessors,
+  RoutingLaneChanges,
+  // Differences with the previous map
+  AddedLanelets,
+  RemovedLanelets,
+  ModifiedLanelets,
+  AddedAreas,
+  RemovedAreas,
+  ModifiedAreas,
+  AddedTrafficSigns,
+  RemovedTrafficSigns,
+  ModifiedTrafficSigns
+};
+
+// Number of values of TReportCounter
+constexpr size_t kNumberOfReportCounters =
+  static_cast<size_t>(TReportCounter::ModifiedTrafficSigns) + 1;
+
+/**
+ * Report of a single conversion, holding the time spent in each stage, the memory usage at the end
+ * of each stage and counters of the converted data. Stages are kept in the order in which they
+ * first occur and counters in the order of TReportCounter, such that reports of different
+ * conversions can be compared line by line. A report is only updated by the thread running the
+ * conversion. A disabled report ignores all updates, such that conversions without report do not
+ * pay for it.
+ */
+class CConversionReport
+{
+public:
+  typedef std::chrono::steady_clock TClock;
+
+  /**
+   * Structure that holds the memory usage of the process at the end of a stage. Live heap bytes are
+   * only available when an allocation hook counts allocations.
+   */
+  struct CMemoryUsage
+  {
+    size_t mResidentSetSize;
+    size_t mPeakResidentSetSize;
+    size_t mLiveHeapBytes;
+    size_t mPeakLiveHeapBytes;
+  };
+
+  /**
+   * Timer measuring a stage from its construction until its destruction. Stages that are entered
+   * multiple times accumulate their durations. The memory usage is sampled when the stage ends, the
+   * peaks are measured over the stage itself without resetting the peaks of enclosing stages. The
+   * peak resident set size of a stage is exact when the stage raised the peak of the conversion,
+   * otherwise it is the larger of the resident set sizes at the start and end of the stage.
+   */
+  class CStageTimer
+  {
+  public:
+    /**
+     * Constructing a CStageTimer object requires a report and a stage.
+     */
+    CStageTimer() = delete;
+
+    /**
+     * Start measuring a stage.
+     *
+     * @param[in, out] aReport Report to which the duration is added, must outlive the timer.
+     * @param[in] aStage Name of the stage.
+     */
+    CStageTimer(CConversionReport& aReport, const char* aStage);
+
+    /**
+     * Stop measuring and add the duration to the report.
+     */
+    ~CStageTimer();
+
+    CStageTimer(const CStageTimer&) = delete;
+    CStageTimer& operator=(const CStageTimer&) = delete;
+
+  private:
+    CConversionReport& mReport;
+    const char*        mStage;
+    TClock::time_point mStart;
+    size_t             mStartResidentSetSize;
+    size_t             mStartPeakResidentSetSize;
+    size_t             mEnclosingPeakLiveHeapBytes;
+  };
+
+  /**
+   * Construct an empty, disabled report, starting now.
+   */
+  CConversionReport();
+
+  /**
+   * Enable or disable updates of the report.
+   *
+   * @param[in] aEnabled True if stages and counters must be updated.
+   */
+  void setEnabled(const bool aEnabled) noexcept;
+
+  /**
+   * Check if the report is updated.
+   *
+   * @retval True If stages and counters are updated.
+   * @retval False If all updates are ignored.
+   */
+  bool isEnabled() const noexcept;
+
+  /**
+   * Remove all stages and counters, restart the total duration and, if the report is enabled,
+   * reset the peak resident set size of the process where supported.
+   */
+  void reset();
+
+  /**
+   * Add a duration to a stage and count the call.
+   *
+   * @param[in] aStage Name of the stage.
+   * @param[in] aDuration Duration of the call.
+   */
+  void addStageDuration(const std::string& aStage, const TClock::duration aDuration);
+
+  /**
+   * Set the memory usage at the end of a stage. Peaks are the maximum over all calls of the stage.
+   *
+   * @param[in] aStage Name of the stage.
+   * @param[in] aMemoryUsage Memory usage at the end of the call.
+   */
+  void setStageMemoryUsage(const std::string& aStage, const CMemoryUsage& aMemoryUsage);
+
+  /**
+   * Add a value to a counter, counters start at zero.
+   *
+   * @param[in] aCounter Counter.
+   * @param[in] aValue Value that must be added.
+   */
+  void addToCounter(const TReportCounter aCounter, const uint64_t aValue) noexcept;
+
+  /**
+   * Set a counter to a value.
+   *
+   * @param[in] aCounter Counter.
+   * @param[in] aValue Value of the counter.
+   */
+  void setCounter(const TReportCounter aCounter, const uint64_t aValue) noexcept;
+
+  /**
+   * Get the value of a counter.
+   *
+   * @param[in] aCounter Counter.
+   * @retval uint64_t Value of the counter, zero if it has not been set.
+   */
+  uint64_t getCounter(const TReportCounter aCounter) const noexcept;
+
+  /**
+   * Write the report as JSON. The total duration is measured from construction or the last reset,
+   * the peak resident set size of the process is sampled when writing and therefore covers the
+   * conversion from the last reset.
+   *
+   * @param[in] aFileName Name of the file to which the report must be written.
+   * @param[in] aOutputFileName Name of the converted map, which is included in the report.
+   * @retval True If the report was written.
+   * @retval False If writing the file failed.
+   */
+  bool store(const std::string& aFileName, const std::string& aOutputFileName) const;
+
+private:
+  /**
+   * Structure that holds the accumulated duration of a stage.
+   */
+  struct CStage
+  {
+    std::string      mName;
+    TClock::duration mDuration;
+    size_t           mNumberOfCalls;
+    CMemoryUsage     mMemoryUsage;
+  };
+
+  /**
+   * Find a stage, adding it if it does not exist yet.
+   *
+   * @param[in] aStage Name of the stage.
+   * @retval CStage& Stage with the given name.
+   */
+  CStage& findStage(const std::string& aStage);
+
+  bool                                          mEnabled;
+  TClock::time_point                            mStart;
+  std::vector<CStage>                           mStages;
+  std::array<uint64_t, kNumberOfReportCounters> mCounters;
+  std::bitset<kNumberOfReportCounters>          mSetCounters;
+};
+}
+}
+}
+#endif
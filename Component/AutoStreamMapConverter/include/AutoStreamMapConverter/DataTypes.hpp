@@ -15,7 +15,15 @@
 #include "TomTom/AutoStream/HdMap/HdMapAccess.h"
 #include "TomTom/AutoStream/HdMap/HdMapArc.h"
 #include "TomTom/AutoStream/HdMap/HdRoadDataTypes.h"
+#include "TomTom/AutoStream/HdMap/SpeedRestrictionDataTypes.h"
+#include "TomTom/AutoStream/HdMap/TrafficSignDataTypes.h"
+#include "TomTom/AutoStream/MapBaseTypes.h"
 
+#include <lanelet2_core/primitives/Area.h>
+#include <lanelet2_core/primitives/Lanelet.h>
+
+#include <cstddef>
+#include <cstdint>
 #include <utility>
 #include <vector>
 
@@ -34,6 +42,38 @@ struct CAutoStreamLaneMetaData
   uint32_t                                                     mLaneLengthCm;
   AutoStream::HdMap::HdRoad::TLaneType                         mType;
   std::vector<std::pair<AutoStream::HdMap::TArcKey, uint32_t>> mConnectionsOut;
+
+  // Set for diverging triangular lanes, which must not be used as outgoing connection
+  bool mInvalidConnectionOut;
+};
+
+/**
+ * Structure that holds a single line of a lane border, e.g. one of the lines of a double line.
+ */
+struct CAutoStreamLaneBorderComponent
+{
+  AutoStream::HdMap::HdRoad::TLaneBorderType  mType;
+  AutoStream::HdMap::HdRoad::TLaneBorderColor mColor;
+  std::vector<AutoStream::TCoordinate3D>      mLine;
+};
+
+/**
+ * Structure that holds the width and lines of a lane border.
+ */
+struct CAutoStreamLaneBorder
+{
+  uint32_t                                    mWidthCm;
+  std::vector<CAutoStreamLaneBorderComponent> mComponents;
+};
+
+/**
+ * Structure that holds the speed limit of a lane, only the first speed restriction is used.
+ */
+struct CAutoStreamSpeedLimit
+{
+  uint32_t                                                  mNumberOfRestrictions;
+  uint32_t                                                  mValue;
+  AutoStream::HdMap::HdMapSpeedRestrictionLayer::TSpeedUnit mUnit;
 };
 
 /**
@@ -64,8 +104,111 @@ struct CAutoStreamArcData
    */
   size_t size() const noexcept;
 
-  std::vector<AutoStream::HdMap::HdRoad::CLaneBorder> mLaneBorders;
-  std::vector<CAutoStreamLaneMetaData>                mLaneMetaData;
+  std::vector<CAutoStreamLaneBorder>   mLaneBorders;
+  std::vector<CAutoStreamLaneMetaData> mLaneMetaData;
+
+  // Speed limit of the vehicle type expected on each lane, one for each lane
+  std::vector<CAutoStreamSpeedLimit> mSpeedLimits;
+};
+
+/**
+ * Structure that holds the data needed for converting a traffic sign.
+ */
+struct CAutoStreamTrafficSignData
+{
+  AutoStream::TCoordinate3D                           mCenterOfMass;
+  double                                              mNormalDeg;
+  AutoStream::HdMap::HdMapTrafficSignLayer::TSignSize mSize;
+};
+
+/**
+ * Structure that holds the result of converting a single AutoStream arc, before connectivity
+ * between arcs has been taken into account.
+ */
+struct CAutoStreamArcConversionResult
+{
+  bool                                 mConverted;
+  std::vector<lanelet::Area>           mAreas;
+  std::vector<lanelet::Lanelet>        mLanelets;
+  std::vector<CAutoStreamLaneMetaData> mConnections;
+
+  // Fingerprint of the AutoStream data the result was converted from, see getArcFingerprint
+  uint64_t mFingerprint;
+};
+
+/**
+ * Flat table of converted arcs. Each arc is addressed by a dense index and the lanes of all arcs
+ * are stored contiguously, such that outgoing connections can be resolved to lane indices once and
+ * stitching does not need any lookups by arc key.
+ */
+struct CAutoStreamArcTable
+{
+  /**
+   * Add the lanes of a converted arc to the table. Arcs must be added in ascending key order.
+   *
+   * @param[in] aArcKey Key of the arc.
+   * @param[in] aLanelets Lanelets of the arc, one for each lane (invalid for lanes converted to
+   * areas).
+   * @param[in] aLaneMetaData Meta data of the arc, one for each lane.
+   * @retval True If the arc was added.
+   * @retval False If the number of lanelets differs from the number of lanes.
+   */
+  bool addArc(const AutoStream::HdMap::TArcKey&    aArcKey,
+              std::vector<lanelet::Lanelet>        aLanelets,
+              std::vector<CAutoStreamLaneMetaData> aLaneMetaData);
+
+  /**
+   * Find the index of the arc with the given key.
+   *
+   * @param[in] aArcKey Key of the arc.
+   * @param[out] aArcIdx Index of the arc.
+   * @retval True If the arc is present in the table.
+   * @retval False If the arc is not present in the table.
+   */
+  bool findArc(const AutoStream::HdMap::TArcKey& aArcKey, size_t& aArcIdx) const;
+
+  /**
+   * Resolve the outgoing connections of all lanes to lane indices. Connections to arcs that are
+   * not present in the table are skipped.
+   */
+  void resolveConnections();
+
+  /**
+   * Get number of arcs.
+   *
+   * @return size_t Number of arcs.
+   */
+  size_t getNumberOfArcs() const noexcept;
+
+  /**
+   * Get number of lanes of all arcs.
+   *
+   * @return size_t Number of lanes.
+   */
+  size_t getNumberOfLanes() const noexcept;
+
+  // One entry per arc, sorted by key
+  std::vector<AutoStream::HdMap::TArcKey> mArcKeys;
+  std::vector<size_t>                     mFirstLaneIdx;
+
+  // One entry per lane
+  std::vector<lanelet::Lanelet>        mLanelets;
+  std::vector<CAutoStreamLaneMetaData> mLaneMetaData;
+
+  // Resolved outgoing connections: lane indices connected to lane i are stored in
+  // mConnectedLaneIdx[mFirstConnectionIdx[i]] up to mConnectedLaneIdx[mFirstConnectionIdx[i + 1]]
+  std::vector<size_t> mFirstConnectionIdx;
+  std::vector<size_t> mConnectedLaneIdx;
+};
+
+/**
+ * Structure that summarizes which map data has been retrieved while warming up the tile cache.
+ */
+struct CTileCacheWarmUpStatistics
+{
+  size_t mNumberOfAreas;
+  size_t mNumberOfArcs;
+  size_t mNumberOfTrafficSigns;
 };
 }
 }
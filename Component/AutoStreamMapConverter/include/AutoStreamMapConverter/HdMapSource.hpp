@@ -0,0 +1,143 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#ifndef TOMTOM_AUTOSTREAM_MAP_CONVERTER_HD_MAP_SOURCE_H
+#define TOMTOM_AUTOSTREAM_MAP_CONVERTER_HD_MAP_SOURCE_H
+
+#include "AutoStreamInterface.hpp"
+#include "DataTypes.hpp"
+#include "MapSource.hpp"
+
+#include "TomTom/AutoStream/HdMap/HdMapAccess.h"
+#include "TomTom/AutoStream/HdMap/HdMapArc.h"
+#include "TomTom/AutoStream/HdMap/HdRoadDataTypes.h"
+
+#include <vector>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+/**
+ * Map source that serves map data retrieved from AutoStream through an HD map access object.
+ */
+class CAutoStreamHdMapSource : public CAutoStreamMapSource
+{
+public:
+  /**
+   * Constructing a CAutoStreamHdMapSource object requires a map access object.
+   */
+  CAutoStreamHdMapSource() = delete;
+
+  /**
+   * Construct a map source using a map access object that is owned by someone else, such as the
+   * AutoStream interface.
+   *
+   * @param[in] aMapAccess Map access that must be used, must outlive the map source.
+   * @param[in] aMapVersionAndHash Map version and hash of the map access.
+   */
+  CAutoStreamHdMapSource(const AutoStream::HdMap::CHdMapAccess* aMapAccess,
+                         const AutoStream::CMapVersionAndHash&  aMapVersionAndHash);
+
+  /**
+   * Construct a map source that owns its map access object.
+   *
+   * @param[in] aMapAccess Map access that must be used.
+   * @param[in] aMapVersionAndHash Map version and hash of the map access.
+   */
+  CAutoStreamHdMapSource(THdMapAccessPtr                       aMapAccess,
+                         const AutoStream::CMapVersionAndHash& aMapVersionAndHash);
+
+  AutoStream::CMapVersionAndHash getMapVersionAndHash() const override;
+
+  std::vector<AutoStream::HdMap::TArcKey>
+  getArcKeysInArea(const AutoStream::TBoundingBox& aArea) override;
+
+  CAutoStreamArcData getArc(const AutoStream::HdMap::TArcKey& aArcKey) override;
+
+  std::vector<AutoStream::HdMap::TTrafficSignKey>
+  getTrafficSignKeysInArea(const AutoStream::TBoundingBox& aArea) override;
+
+  CAutoStreamTrafficSignData
+  getTrafficSign(const AutoStream::HdMap::TTrafficSignKey& aTrafficSignKey) override;
+
+private:
+  /**
+   * Validate the map access pointer.
+   *
+   * @throw std::runtime_error If the map access is missing or invalid.
+   */
+  void validateMapAccess() const;
+
+  /**
+   * Store meta data and lane border(s) for the given AutoStream lane.
+   *
+   * @param[in] aLane AutoStream lane that contains data that must be stored.
+   * @param[in] aDrivingSide Driving side for current lane.
+   * @param[in] aStoreLeftBorder Boolean that indicates whether or not the left border must be
+   * stored (right border will always be stored).
+   * @param[out] aLaneData Object to which lane data must be added.
+   */
+  void getLaneMetaDataAndBorders(const AutoStream::HdMap::HdRoad::CLaneOrTrajectory& aLane,
+                                 const AutoStream::HdMap::HdRoad::TDrivingSide       aDrivingSide,
+                                 bool                aStoreLeftBorder,
+                                 CAutoStreamArcData& aLaneData) const;
+
+  /**
+   * Get meta data from a given AutoStream lane in the appropriate format.
+   *
+   * @param[in] aLane AutoStream lane that contains the required data.
+   * @param[in] aDrivingSide Driving side for current lane.
+   * @retval CAutoStreamLaneMetaData Converted lane data.
+   */
+  CAutoStreamLaneMetaData
+  getLaneMetaData(const AutoStream::HdMap::HdRoad::CLaneOrTrajectory& aLane,
+                  const AutoStream::HdMap::HdRoad::TDrivingSide       aDrivingSide) const;
+
+  /**
+   * Store lane borders for the given AutoStream lane in the given structure.
+   *
+   * @param[in] aLane Lane for which border or borders need to be stored.
+   * @param[in] aStoreSecondBorder Boolean indicating whether only the first (false) or both borders
+   * (true) must be stored.
+   * @param[in] aDrivingSide Driving side for given lane.
+   * @param[out] aLaneData Struct to which the lane borders will be added.
+   */
+  void storeLaneBorders(const AutoStream::HdMap::HdRoad::CLaneOrTrajectory& aLane,
+                        const bool                                          aStoreSecondBorder,
+                        const AutoStream::HdMap::HdRoad::TDrivingSide       aDrivingSide,
+                        CAutoStreamArcData&                                 aLaneData) const;
+
+  /**
+   * Copy the width and lines of an AutoStream lane border.
+   *
+   * @param[in] aLaneBorder Lane border that must be copied.
+   * @retval CAutoStreamLaneBorder Copy of the lane border.
+   */
+  CAutoStreamLaneBorder
+  getLaneBorder(const AutoStream::HdMap::HdRoad::CLaneBorder& aLaneBorder) const;
+
+  /**
+   * Store the speed limit of the vehicle type expected on each lane of an arc.
+   *
+   * @param[in] aArc Arc of which the speed limits must be retrieved.
+   * @param[in, out] aLaneData Data of the arc, speed limits are added for each lane.
+   */
+  void storeSpeedLimits(const AutoStream::HdMap::TArc& aArc, CAutoStreamArcData& aLaneData) const;
+
+  THdMapAccessPtr                        mOwnedMapAccess;
+  const AutoStream::HdMap::CHdMapAccess* mMapAccess;
+  AutoStream::CMapVersionAndHash         mMapVersionAndHash;
+};
+}
+}
+}
+#endif
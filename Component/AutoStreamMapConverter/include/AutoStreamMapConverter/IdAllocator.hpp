@@ -0,0 +1,126 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#ifndef TOMTOM_AUTOSTREAM_MAP_CONVERTER_ID_ALLOCATOR_H
+#define TOMTOM_AUTOSTREAM_MAP_CONVERTER_ID_ALLOCATOR_H
+
+#include "TomTom/AutoStream/HdMap/HdMapArc.h"
+#include "TomTom/AutoStream/HdMap/HdMapTrafficSign.h"
+
+#include <lanelet2_core/Forward.h>
+
+#include <cstddef>
+#include <unordered_set>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+/**
+ * Allocates the IDs of the primitives of a single arc or traffic sign from a range of IDs reserved
+ * for it. Every arc and traffic sign has a range derived from its key, such that threads convert
+ * without sharing an ID counter and unchanged arcs keep their IDs between conversions. All ranges
+ * lie between getRangeSize() and 2^62. An allocator is used by a single thread.
+ */
+class CIdAllocator
+{
+public:
+  /**
+   * Constructing a CIdAllocator object requires a range.
+   */
+  CIdAllocator() = delete;
+
+  /**
+   * Construct an allocator for a range of IDs.
+   *
+   * @param[in] aFirstId First ID of the range, as returned by getFirstIdOfArc(),
+   * getFirstIdOfTrafficSign() or CIdRangeTable::claim().
+   */
+  explicit CIdAllocator(const lanelet::Id aFirstId) noexcept;
+
+  /**
+   * Get the next unused ID of the range.
+   *
+   * @retval lanelet::Id New ID.
+   * @throw std::out_of_range If all IDs of the range have been used.
+   */
+  lanelet::Id getId();
+
+  /**
+   * Get the number of IDs in every range.
+   *
+   * @retval lanelet::Id Size of a range.
+   */
+  static lanelet::Id getRangeSize() noexcept;
+
+private:
+  lanelet::Id mNextId;
+  lanelet::Id mEndId;
+};
+
+/**
+ * Ranges of IDs claimed by the arcs and traffic signs of a single map. When the ranges derived
+ * from two keys coincide, the key claiming it last is moved to the next unclaimed range. Claiming
+ * in a fixed order therefore gives the same IDs for the same map data.
+ */
+class CIdRangeTable
+{
+public:
+  /**
+   * Construct a table without claimed ranges.
+   */
+  CIdRangeTable();
+
+  /**
+   * Claim a range of IDs.
+   *
+   * @param[in] aFirstId First ID of the preferred range.
+   * @retval lanelet::Id First ID of the claimed range, the preferred range if it was unclaimed.
+   */
+  lanelet::Id claim(const lanelet::Id aFirstId);
+
+  /**
+   * Get the number of claims that were moved to another range.
+   *
+   * @retval size_t Number of collisions.
+   */
+  size_t getNumberOfCollisions() const noexcept;
+
+  /**
+   * Release all ranges.
+   */
+  void clear();
+
+private:
+  std::unordered_set<lanelet::Id> mClaimedFirstIds;
+  size_t                          mNumberOfCollisions;
+};
+
+/**
+ * Get the first ID of the range derived from the key of an arc.
+ *
+ * @param[in] aArcKey Key of the arc.
+ * @retval lanelet::Id First ID of the range.
+ */
+lanelet::Id getFirstIdOfArc(const AutoStream::HdMap::TArcKey& aArcKey);
+
+/**
+ * Get the first ID of the range derived from the key of a traffic sign. Traffic signs and arcs
+ * with equal keys get different ranges.
+ *
+ * @param[in] aTrafficSignKey Key of the traffic sign.
+ * @retval lanelet::Id First ID of the range.
+ */
+lanelet::Id getFirstIdOfTrafficSign(const AutoStream::HdMap::TTrafficSignKey& aTrafficSignKey);
+}
+}
+}
+#endif
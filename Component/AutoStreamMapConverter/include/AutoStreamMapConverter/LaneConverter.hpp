@@ -13,8 +13,10 @@
 #define TOMTOM_AUTOSTREAM_MAP_CONVERTER_LANE_CONVERTER_H
 
 #include "DataTypes.hpp"
+#include "IdAllocator.hpp"
+#include "TraceRecorder.hpp"
+#include "UtmBatchProjector.hpp"
 
-#include "TomTom/AutoStream/HdMap/HdMapSpeedRestrictions.h"
 #include "TomTom/AutoStream/HdMap/HdRoadDataTypes.h"
 #include "TomTom/AutoStream/HdMap/HdRoadEnums.h"
 
@@ -50,49 +52,46 @@ public:
    * lanes.
    *
    * @param[in] aArcData AutoStream arc that must be converted.
-   * @param[in] aArc Arc to which lanes belong (needed for retrieving speed limits).
-   * @param[in] aSpeedRestrictions Speed restrictions object (needed for retrieving speed limits).
+   * @param[in, out] aIdAllocator Allocator providing the IDs of the created primitives.
    * @param[in,out] aAreas Areas created from the given lanes will be added to this vector.
    * @param[in,out] aLanelets Lanelets created from the given lanes will be added to this vector.
-   * @param[in, out] aInvalidConnectionsOut Ids of triangular lanelets that should not be used as
-   * outgoing connection.
    * @retval True If conversion succeeded.
    * @retval False If conversion failed.
    */
-  bool convertLanes(CAutoStreamArcData&                               aArcData,
-                    const AutoStream::HdMap::TArc&                    aArc,
-                    const AutoStream::HdMap::CHdMapSpeedRestrictions& aSpeedRestrictions,
-                    std::vector<lanelet::Area>&                       aAreas,
-                    std::vector<lanelet::Lanelet>&                    aLanelets,
-                    std::set<lanelet::Id>&                            aInvalidConnectionsOut);
+  bool convertLanes(CAutoStreamArcData&            aArcData,
+                    CIdAllocator&                  aIdAllocator,
+                    std::vector<lanelet::Area>&    aAreas,
+                    std::vector<lanelet::Lanelet>& aLanelets);
+
+  /**
+   * Set the buffer to which trace spans of the conversion are added.
+   *
+   * @param[in] aTraceBuffer Trace buffer of the thread using the converter, nullptr to disable
+   * tracing.
+   */
+  void setTraceBuffer(CTraceBuffer* aTraceBuffer) noexcept;
 
 private:
   /**
-   * Retrieve speed restriction and set it in the given lanelet.
+   * Set the speed limit of a lane in the given lanelet.
    *
-   * @param[in] aMapSpeedRestrictions AutoStream object containing speed restrictions.
-   * @param[in] aArc Arc from which speed restriction can be retrieved.
-   * @param[in] laneIdx Index of the lane for which speed restriction must be retrieved.
-   * @param[in] aLanelet Lane type for which the speed restriction must be retrieved.
+   * @param[in] aSpeedLimit Speed limit of the lane.
    * @param[out] aLanelet Lanelet to which the speed restriction must be added as a speed limit.
    */
-  void setSpeedLimit(const AutoStream::HdMap::CHdMapSpeedRestrictions& aMapSpeedRestrictions,
-                     const AutoStream::HdMap::TArc&                    aArc,
-                     const uint32_t                                    laneIdx,
-                     const AutoStream::HdMap::HdRoad::TLaneType        aLaneType,
-                     lanelet::Lanelet                                  aLanelet) const;
+  void setSpeedLimit(const CAutoStreamSpeedLimit& aSpeedLimit, lanelet::Lanelet aLanelet) const;
 
   /**
    * Convert all given borders to line strings.
    *
    * @param[in] aBorders Borders that require conversion.
+   * @param[in, out] aIdAllocator Allocator providing the IDs of the line strings and points.
    * @param[out] aLineStrings Vector in which converted borders will be stored.
    * @retval True If conversion succeeded.
    * @retval False If conversion failed.
    */
-  bool convertLaneBordersToLineStrings(
-    const std::vector<AutoStream::HdMap::HdRoad::CLaneBorder>& aBorders,
-    std::vector<lanelet::LineString3d>&                        aLineStrings) const;
+  bool convertLaneBordersToLineStrings(const std::vector<CAutoStreamLaneBorder>& aBorders,
+                                       CIdAllocator&                             aIdAllocator,
+                                       std::vector<lanelet::LineString3d>& aLineStrings) const;
 
   /**
    * Remove connections of this lane if both lane border lines end at the same position (converging
@@ -107,17 +106,16 @@ private:
                                                    CAutoStreamLaneMetaData& aLaneletMetaData) const;
 
   /**
-   * Store lane if both border lines start at the same position (diverging triangular lane).
+   * Mark lane as invalid connection if both border lines start at the same position (diverging
+   * triangular lane).
    *
    * @param[in] aLeft Left border line of the lanelet.
    * @param[in] aRight Right border line of the lanelet.
-   * @param[in] aLaneletId Id of the lanelet for which the border lines are provided.
-   * @param[in] aInvalidConnectionsOut Set in which IDs of inverse triangular lanes must be stored.
+   * @param[in, out] aLaneletMetaData Lanelet meta data.
    */
-  void storeIfDivergingTriangularLane(lanelet::LineString3d& aLeft,
-                                      lanelet::LineString3d& aRight,
-                                      lanelet::Id            aLaneletId,
-                                      std::set<lanelet::Id>& aInvalidConnectionsOut) const;
+  void markIfDivergingTriangularLane(lanelet::LineString3d&   aLeft,
+                                     lanelet::LineString3d&   aRight,
+                                     CAutoStreamLaneMetaData& aLaneletMetaData) const;
 
   /**
    * Create a lanelet with given borders and use meta data to set properties.
@@ -125,11 +123,13 @@ private:
    * @param[in] aLeftBorder Left border line of the lanelet.
    * @param[in] aRightBorder Right border line of the lanelet.
    * @param[in] aLaneMetaData Meta that can be used for setting lanelet attributes.
+   * @param[in, out] aIdAllocator Allocator providing the ID of the lanelet.
    * @retval lanelet::Lanelet Lanelet that has been created.
    */
   lanelet::Lanelet getLanelet(const lanelet::LineString3d&   aLeftBorder,
                               const lanelet::LineString3d&   aRightBorder,
-                              const CAutoStreamLaneMetaData& aLaneMetaData) const;
+                              const CAutoStreamLaneMetaData& aLaneMetaData,
+                              CIdAllocator&                  aIdAllocator) const;
 
   /**
    * Create an area using the given borders and use meta data to set properties.
@@ -137,14 +137,17 @@ private:
    * @param[in] aLeftBorder Left border line of the area.
    * @param[in] aRightBorder Right border line of the area.
    * @param[in] aLaneMetaData Meta that can be used for setting area attributes.
+   * @param[in, out] aIdAllocator Allocator providing the IDs of the area and its created bounds.
    * @retval lanelet::Area Area that has been created.
    */
   lanelet::Area getArea(lanelet::LineString3d&         aLeftBorder,
                         lanelet::LineString3d&         aRightBorder,
-                        const CAutoStreamLaneMetaData& aLaneMetaData) const;
+                        const CAutoStreamLaneMetaData& aLaneMetaData,
+                        CIdAllocator&                  aIdAllocator) const;
 
 private:
-  lanelet::projection::UtmProjector mUtmProjector;
+  CUtmBatchProjector mUtmProjector;
+  CTraceBuffer*      mTraceBuffer;
 };
 }
 }
@@ -12,8 +12,17 @@
 #ifndef TOMTOM_AUTOSTREAM_MAP_CONVERTER_MAP_CONVERTER_H
 #define TOMTOM_AUTOSTREAM_MAP_CONVERTER_MAP_CONVERTER_H
 
+#include "ArcCache.hpp"
 #include "ArcConverter.hpp"
 #include "AutoStreamInterface.hpp"
+#include "ConversionReport.hpp"
+#include "IdAllocator.hpp"
+#include "MapDelta.hpp"
+#include "MapRecording.hpp"
+#include "MapSource.hpp"
+#include "PointUnionFind.hpp"
+#include "RouteCorridor.hpp"
+#include "TraceRecorder.hpp"
 #include "TrafficSignConverter.hpp"
 
 #include <lanelet2_core/primitives/Area.h>
@@ -21,9 +30,13 @@
 #include <lanelet2_core/primitives/Polygon.h>
 #include <lanelet2_projection/UTM.h>
 
+#include <cstddef>
+#include <functional>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace TomTom {
@@ -32,6 +45,40 @@ namespace AutoStreamMapConverter {
 
 typedef std::map<lanelet::Id, std::vector<std::pair<lanelet::Id, lanelet::Id>>> TLinePointIdMap;
 
+/**
+ * Format in which converted maps are written.
+ */
+enum class TMapFileFormat
+{
+  // Lanelet2 OSM XML, see COsmWriter
+  Osm,
+  // Memory mappable tables, see CBinaryMapWriter
+  Binary
+};
+
+/**
+ * Bounding box that must be converted as part of a batch, together with the file to which the map
+ * must be written.
+ */
+struct CAutoStreamBatchJob
+{
+  AutoStream::TBoundingBox mBoundingBox;
+  std::string              mOutputFileName;
+};
+
+/**
+ * Conversion results shared by all maps of a batch. Maps are assembled from copies of the results,
+ * such that stitching one map does not modify the results used by the other maps.
+ */
+struct CAutoStreamBatchResults
+{
+  // Unstitched conversion results of all distinct arcs, including arcs that failed to convert
+  std::map<AutoStream::HdMap::TArcKey, CAutoStreamArcConversionResult> mArcs;
+
+  // Converted traffic signs with IDs from the range derived from their key, failed signs are absent
+  std::map<AutoStream::HdMap::TTrafficSignKey, lanelet::Polygon3d> mTrafficSigns;
+};
+
 /**
  * Class that performs the conversion of a map delivered via AutoStream to lanelet2 map for
  * Autoware.
@@ -63,6 +110,44 @@ public:
    */
   bool storeMap(const AutoStream::TBoundingBox& aBoundingBox);
 
+  /**
+   * Store a lanelet2 map for the corridor around a route. Arcs are searched in small bounding boxes
+   * along the route and only arcs with lane border geometry within the buffer distance of the route
+   * are converted, such that the amount of converted data grows with the length of the route.
+   * Traffic signs are converted if their center lies within the buffer distance.
+   *
+   * @param[in] aRoute Route as a polyline of WGS84 coordinates.
+   * @param[in] aBufferWidthMeter Distance from the route within which map data is converted.
+   * @retval True If map was stored successfully.
+   * @retval False If storing the map failed.
+   */
+  bool storeMap(const std::vector<AutoStream::TCoordinate>& aRoute, const double aBufferWidthMeter);
+
+  /**
+   * Store lanelet2 maps for a batch of bounding boxes. Every distinct arc of all bounding boxes is
+   * converted once, after which each map is assembled from copies of the shared conversion results
+   * and stitched on its own. All maps use the projection origin of the bounding box enclosing all
+   * jobs. The configured output file name is not used.
+   *
+   * @param[in] aJobs Bounding boxes and output files of the maps.
+   * @retval True If all maps were stored successfully.
+   * @retval False If storing one or more maps failed.
+   */
+  bool storeMaps(const std::vector<CAutoStreamBatchJob>& aJobs);
+
+  /**
+   * Retrieve all map data that is needed for converting the given areas, without converting it.
+   * The data ends up in the persistent tile cache, such that later conversions of the areas do not
+   * depend on the AutoStream server. Arcs are retrieved by the worker threads.
+   *
+   * @param[in] aAreas Areas for which map data must be retrieved.
+   * @param[out] aStatistics Number of areas, arcs and traffic signs for which data was retrieved.
+   * @retval True If all data was retrieved.
+   * @retval False If retrieving data failed.
+   */
+  bool warmUpTileCache(const std::vector<AutoStream::TBoundingBox>& aAreas,
+                       CTileCacheWarmUpStatistics&                  aStatistics);
+
   /**
    * Get the name of the output file.
    *
@@ -71,82 +156,557 @@ public:
   std::string getOutputFileName() const noexcept;
 
   /**
-   * Set the output file name that must be used for storing a converted map.
+   * Set the output file name that must be used for storing a converted map. Maps are compressed
+   * with gzip while they are written if the name ends with ".gz".
    *
    * @param[in] aOutputFileName Name of the output file.
    */
   void setOutputFileName(const std::string& aOutputFileName) noexcept;
 
+  /**
+   * Get the format in which converted maps are written.
+   *
+   * @retval TMapFileFormat Format of the output file.
+   */
+  TMapFileFormat getOutputFormat() const noexcept;
+
+  /**
+   * Set the format in which converted maps are written. Binary maps are loaded by CBinaryMapFile
+   * without parsing, change sets are only written for OSM maps.
+   *
+   * @param[in] aOutputFormat Format of the output file.
+   */
+  void setOutputFormat(const TMapFileFormat aOutputFormat) noexcept;
+
+  /**
+   * Get the number of worker threads used for converting arcs.
+   *
+   * @retval size_t Number of worker threads.
+   */
+  size_t getNumberOfWorkers() const noexcept;
+
+  /**
+   * Set the number of worker threads that must be used for converting arcs. Each worker uses its
+   * own map source and converters. The converted map does not depend on the number of
+   * workers.
+   *
+   * @param[in] aNumberOfWorkers Number of worker threads, values below one are treated as one.
+   */
+  void setNumberOfWorkers(const size_t aNumberOfWorkers) noexcept;
+
+  /**
+   * Get the grid in which bounding boxes are split into tiles.
+   *
+   * @param[out] aRows Number of rows of the grid.
+   * @param[out] aColumns Number of columns of the grid.
+   */
+  void getTileGrid(size_t& aRows, size_t& aColumns) const noexcept;
+
+  /**
+   * Set the grid in which bounding boxes are split into tiles. Tiles are converted concurrently by
+   * the worker threads, arcs crossing tile seams are converted once. A grid of one by one disables
+   * tiling. The converted map does not depend on the grid.
+   *
+   * @param[in] aRows Number of rows of the grid, values below one are treated as one.
+   * @param[in] aColumns Number of columns of the grid, values below one are treated as one.
+   */
+  void setTileGrid(const size_t aRows, const size_t aColumns) noexcept;
+
+  /**
+   * Get the name of the file in which converted arcs are cached between conversions.
+   *
+   * @retval std::string Name of the arc cache file, empty if incremental conversion is disabled.
+   */
+  std::string getArcCacheFileName() const noexcept;
+
+  /**
+   * Set the name of the file in which converted arcs are cached between conversions. Arcs that are
+   * found in the cache for the same map version, or of which the AutoStream data did not change
+   * since they were cached, are restored from the cache instead of being converted again. The cache
+   * is rewritten after each successful conversion.
+   *
+   * @param[in] aArcCacheFileName Name of the arc cache file, empty to disable incremental
+   * conversion.
+   */
+  void setArcCacheFileName(const std::string& aArcCacheFileName) noexcept;
+
+  /**
+   * Get the number of arcs that are fetched ahead of conversion.
+   *
+   * @retval size_t Prefetch depth, zero if fetching and converting are not pipelined.
+   */
+  size_t getPrefetchDepth() const noexcept;
+
+  /**
+   * Set the number of arcs that are fetched ahead of conversion. With a non-zero depth and a single
+   * worker thread, a separate thread retrieves the data of upcoming arcs while the current arc is
+   * converted, such that tile retrieval and conversion overlap. The converted map does not depend
+   * on the prefetch depth.
+   *
+   * @param[in] aPrefetchDepth Maximum number of arcs fetched ahead, zero to disable pipelining.
+   */
+  void setPrefetchDepth(const size_t aPrefetchDepth) noexcept;
+
+  /**
+   * Get the name of the file to which the AutoStream map data used by conversions is recorded.
+   *
+   * @retval std::string Name of the recording file, empty if recording is disabled.
+   */
+  std::string getRecordingFileName() const noexcept;
+
+  /**
+   * Set the name of the file to which the AutoStream map data used by conversions is recorded. The
+   * queried areas and the data of all arcs and traffic signs are written to the file after each
+   * successful conversion, replacing the recording of the previous conversion.
+   *
+   * @param[in] aRecordingFileName Name of the recording file, empty to disable recording.
+   */
+  void setRecordingFileName(const std::string& aRecordingFileName) noexcept;
+
+  /**
+   * Get the name of the recording file from which conversions are served.
+   *
+   * @retval std::string Name of the recording file, empty if AutoStream is used.
+   */
+  std::string getReplayFileName() const noexcept;
+
+  /**
+   * Set the name of a recording file from which conversions are served instead of AutoStream.
+   * AutoStream does not need to be initialized when replaying, and nothing is recorded. Replayed
+   * conversions must query the same areas as the recorded conversion, such as the same bounding
+   * box and tile grid, or the same route and buffer width.
+   *
+   * @param[in] aReplayFileName Name of the recording file, empty to use AutoStream.
+   */
+  void setReplayFileName(const std::string& aReplayFileName) noexcept;
+
+  /**
+   * Check whether conversions are served by map sources created by a map source factory.
+   *
+   * @retval True If a map source factory is set.
+   * @retval False If AutoStream or a replayed recording is used.
+   */
+  bool hasMapSourceFactory() const noexcept;
+
+  /**
+   * Set a factory creating the map sources from which conversions are served instead of AutoStream,
+   * such as a synthetic map. AutoStream does not need to be initialized when a factory is set. The
+   * served data is recorded when recording is enabled, a replayed recording takes precedence.
+   *
+   * @param[in] aMapSourceFactory Map source factory, empty to use AutoStream.
+   */
+  void setMapSourceFactory(const TMapSourceFactory& aMapSourceFactory);
+
+  /**
+   * Check whether a conversion report is written next to each converted map.
+   *
+   * @retval True If reports are written.
+   * @retval False If no reports are written.
+   */
+  bool isReportEnabled() const noexcept;
+
+  /**
+   * Enable or disable writing a conversion report next to each converted map. The report is written
+   * as JSON to the output file name with ".report.json" appended and holds the time spent in each
+   * stage of the conversion and the number of converted arcs, AutoStream lanes of the arcs, points,
+   * lanelets, areas and traffic signs, failed conversions and stitched connections.
+   *
+   * @param[in] aReportEnabled True if reports must be written.
+   */
+  void setReportEnabled(const bool aReportEnabled) noexcept;
+
+  /**
+   * Check whether a routing graph is written next to each converted map.
+   *
+   * @retval True If routing graphs are written.
+   * @retval False If no routing graphs are written.
+   */
+  bool isRoutingGraphEnabled() const noexcept;
+
+  /**
+   * Enable or disable writing the routing graph of each converted map, see CRoutingGraph. The graph
+   * is written to the output file name with ".routing" appended and can be loaded with
+   * CRoutingGraph::load, such that a planner does not have to derive it from the map geometry.
+   *
+   * @param[in] aRoutingGraphEnabled True if routing graphs must be written.
+   */
+  void setRoutingGraphEnabled(const bool aRoutingGraphEnabled) noexcept;
+
+  /**
+   * Get the name of the file to which a trace of each conversion is written.
+   *
+   * @retval std::string Name of the trace file, empty if conversions are not traced.
+   */
+  std::string getTraceFileName() const noexcept;
+
+  /**
+   * Set the name of the file to which a trace of each conversion is written. The trace holds a
+   * span for retrieving and converting every arc, converting its lanes and setting their speed
+   * limits, converting every traffic sign and writing the map, in the Chrome trace event format.
+   * Spans of arcs are tagged with the arc key and the number of lanes. A batch conversion writes a
+   * single trace.
+   *
+   * @param[in] aTraceFileName Name of the trace file, empty to disable tracing.
+   */
+  void setTraceFileName(const std::string& aTraceFileName) noexcept;
+
+  /**
+   * Get the name of the previous map against which a change set of each converted map is written.
+   *
+   * @retval std::string Name of the previous map, empty if no change sets are written.
+   */
+  std::string getDeltaBaseFileName() const noexcept;
+
+  /**
+   * Set the name of the previous map against which a change set of each converted map is written.
+   * The change set holds the added, modified and removed nodes, ways and relations and is written
+   * to the output file name with ".osc" appended, it can be applied to the previous map with the
+   * AutoStreamMapDelta tool. The previous map is read before the map is written, such that it may
+   * be the output file itself. Batch conversions do not write change sets.
+   *
+   * @param[in] aDeltaBaseFileName Name of the previous map, empty to disable change sets.
+   */
+  void setDeltaBaseFileName(const std::string& aDeltaBaseFileName) noexcept;
+
 private:
+  /**
+   * Function executed by each worker thread, using the worker's own map source and arc converter.
+   */
+  typedef std::function<void(CAutoStreamMapSource&, CAutoStreamArcConverter&)> TWorkerFunction;
+
   /**
    * Convert AutoStream arcs to lanelets and areas. Areas are solved without considering
-   * connectivity. Lanelets will be added to lanelet map and connectivity information will be
-   * provided in connection map.
+   * connectivity. Lanelets and lane meta data will be added to the arc table in order of the arc
+   * keys.
+   *
+   * @param[in] aArcKeys Sorted keys of arcs that must be converted.
+   * @param[in] aUtmProjector Projector that must be used for converting coordinates.
+   * @param[out] aArcTable Table containing the lanelets and meta data of the converted arcs.
+   */
+  void convertArcKeys(const std::vector<AutoStream::HdMap::TArcKey>& aArcKeys,
+                      const lanelet::projection::UtmProjector&       aUtmProjector,
+                      CAutoStreamArcTable&                           aArcTable);
+
+  /**
+   * Convert a single AutoStream arc without considering connectivity. When incremental conversion
+   * is enabled, the arc is restored from the previous arc cache if possible.
+   *
+   * @param[in] aArcKey Key of the arc that must be converted.
+   * @param[in] aMapSource Map source that must be used for retrieving the arc.
+   * @param[in] aArcConverter Converter that must be used for converting the arc.
+   * @param[out] aResult Conversion result for the arc.
+   */
+  void convertArc(const AutoStream::HdMap::TArcKey& aArcKey,
+                  CAutoStreamMapSource&             aMapSource,
+                  CAutoStreamArcConverter&          aArcConverter,
+                  CAutoStreamArcConversionResult&   aResult) const;
+
+  /**
+   * Convert the given AutoStream arcs using multiple worker threads. Every worker uses its own map
+   * source, UTM projector and converters. The result for each arc is stored at the index of
+   * its key, such that results can be merged independent of the order in which arcs are converted.
+   *
+   * @param[in] aArcKeys Keys of arcs that must be converted.
+   * @param[in] aUtmProjector Projector that must be used for converting coordinates.
+   * @param[out] aResults Conversion results, one for each arc key.
+   */
+  void convertArcsInParallel(const std::vector<AutoStream::HdMap::TArcKey>& aArcKeys,
+                             const lanelet::projection::UtmProjector&       aUtmProjector,
+                             std::vector<CAutoStreamArcConversionResult>&   aResults) const;
+
+  /**
+   * Check if an arc is restored from the arc cache without retrieving its data, which is the case
+   * if it is cached for the same map version. While recording, the data of every arc is retrieved,
+   * such that the recording can be replayed without the arc cache.
+   *
+   * @param[in] aArcKey Key of the arc.
+   * @retval True If the cached result of the arc is restored without looking at its data.
+   * @retval False If the data of the arc must be retrieved.
+   */
+  bool isRestoredWithoutArcData(const AutoStream::HdMap::TArcKey& aArcKey) const;
+
+  /**
+   * Convert the given AutoStream arcs in a pipeline: a prefetch thread with its own map source
+   * retrieves the data of the arcs in key order, at most the prefetch depth ahead of the
+   * conversion of the arcs on the calling thread.
+   *
+   * @param[in] aArcKeys Keys of arcs that must be converted.
+   * @param[in] aUtmProjector Projector that must be used for converting coordinates.
+   * @param[out] aResults Conversion results, one for each arc key.
+   */
+  void convertArcsPipelined(const std::vector<AutoStream::HdMap::TArcKey>& aArcKeys,
+                            const lanelet::projection::UtmProjector&       aUtmProjector,
+                            std::vector<CAutoStreamArcConversionResult>&   aResults) const;
+
+  /**
+   * Split the given bounding box into tiles and convert the arcs of the tiles using the worker
+   * threads. Arcs that are present in multiple tiles are converted once.
    *
-   * @param[in] aAutoStreamArcKeys Keys of arcs that must be converted.
-   * @param[out] aLaneletMap Map containing the lanelets associated with each of the AutoStream
-   * arcs.
-   * @param[out] aConnectionMap Map containing the connections associated with each of the
-   * AutoStream arcs.
-   * @param[in, out] aInvalidConnectionsOut Ids of triangular lanelets that should not be used as
-   * outgoing connection.
+   * @param[in] aBoundingBox Bounding box that must be converted.
+   * @param[in] aUtmProjector Projector that must be used for converting coordinates.
+   * @param[out] aArcKeys Keys of all arcs in the bounding box, sorted and without duplicates.
+   * @param[out] aResults Conversion results, one for each arc key.
    */
-  void arcSetToLanelet(
-    const AutoStream::HdMap::TArcKeys&                                          aAutoStreamArcKeys,
-    std::map<AutoStream::HdMap::TArcKey, std::vector<lanelet::Lanelet>>&        aLaneletMap,
-    std::map<AutoStream::HdMap::TArcKey, std::vector<CAutoStreamLaneMetaData>>& aConnectionMap,
-    std::set<lanelet::Id>& aInvalidConnectionsOut);
+  void convertArcsInTiles(const AutoStream::TBoundingBox&              aBoundingBox,
+                          const lanelet::projection::UtmProjector&     aUtmProjector,
+                          std::vector<AutoStream::HdMap::TArcKey>&     aArcKeys,
+                          std::vector<CAutoStreamArcConversionResult>& aResults) const;
 
   /**
-   * Store connectivity information for lanelets.
+   * Run the given function on multiple worker threads and wait until all of them are done. Every
+   * worker uses its own map source, UTM projector and arc converter. Exceptions thrown by
+   * a worker are rethrown after all workers finished.
    *
-   * @param[in] aLaneletMap Set of lanelets per arc for which the connectivity information
-   * should be stored.
-   * @param[in] aConnectionMap Map including connectivity information for outgoing connections.
-   * @param[in] aInvalidConnectionsOut Lanelet IDs of lanes to which no connections are allowed.
-   * @retval std::map<lanelet::Id, lanelet::Point3d> Connectivity information.
+   * @param[in] aNumberOfWorkers Number of worker threads.
+   * @param[in] aUtmProjector Projector that must be used for converting coordinates.
+   * @param[in] aWork Function that must be executed by each worker.
    */
-  std::map<lanelet::Id, lanelet::Point3d> storeLaneletConnectivity(
-    std::map<AutoStream::HdMap::TArcKey, std::vector<lanelet::Lanelet>>& aLaneletMap,
-    const std::map<AutoStream::HdMap::TArcKey, std::vector<CAutoStreamLaneMetaData>>&
-                                 aConnectionMap,
-    const std::set<lanelet::Id>& aInvalidConnectionsOut);
+  void runWorkers(const size_t                             aNumberOfWorkers,
+                  const lanelet::projection::UtmProjector& aUtmProjector,
+                  const TWorkerFunction&                   aWork) const;
+
+  /**
+   * Convert the AutoStream arcs with the given keys without adding them to an arc table. Depending
+   * on the settings, arcs are converted by the worker threads, pipelined or one by one.
+   *
+   * @param[in] aArcKeys Sorted keys of arcs that must be converted.
+   * @param[in] aUtmProjector Projector that must be used for converting coordinates.
+   * @param[out] aResults Conversion results, one for each arc key.
+   */
+  void convertArcs(const std::vector<AutoStream::HdMap::TArcKey>& aArcKeys,
+                   const lanelet::projection::UtmProjector&       aUtmProjector,
+                   std::vector<CAutoStreamArcConversionResult>&   aResults);
+
+  /**
+   * Add conversion results to the updated arc cache when incremental conversion is enabled. Must be
+   * called before the results are connected to other arcs.
+   *
+   * @param[in] aArcKeys Keys of the converted arcs.
+   * @param[in] aResults Conversion results, one for each arc key.
+   */
+  void addToArcCache(const std::vector<AutoStream::HdMap::TArcKey>&     aArcKeys,
+                     const std::vector<CAutoStreamArcConversionResult>& aResults);
+
+  /**
+   * Add conversion results to the arc table in order of the arc keys. Areas are stored directly.
+   *
+   * @param[in] aArcKeys Sorted keys of the converted arcs.
+   * @param[in, out] aResults Conversion results, one for each arc key. Lanelets and meta data are
+   * moved into the arc table.
+   * @param[out] aArcTable Table to which the lanelets and meta data must be added.
+   */
+  void storeConversionResults(const std::vector<AutoStream::HdMap::TArcKey>& aArcKeys,
+                              std::vector<CAutoStreamArcConversionResult>&   aResults,
+                              CAutoStreamArcTable&                           aArcTable);
+
+  /**
+   * Assign new IDs to all primitives of a converted arc in a fixed order. Converted and restored
+   * arcs create their primitives in a different order, renumbering makes their IDs equal, such that
+   * an unchanged arc keeps its IDs whether it is converted or restored from the arc cache.
+   *
+   * @param[in, out] aResult Conversion result of which the primitives must be renumbered.
+   * @param[in, out] aIdAllocator Allocator of the range claimed for the arc.
+   */
+  void renumberPrimitives(CAutoStreamArcConversionResult& aResult,
+                          CIdAllocator&                   aIdAllocator) const;
+
+  /**
+   * Store connectivity information for lanelets. Connections must have been resolved to lane
+   * indices in the arc table.
+   *
+   * @param[in] aArcTable Table with lanelets and resolved outgoing connections.
+   * @retval CPointUnionFind Connectivity information: sets of border points that must be merged.
+   */
+  CPointUnionFind storeLaneletConnectivity(CAutoStreamArcTable& aArcTable);
 
   /**
    * Convert all AutoStream arcs in the given bounding box.
    *
    * @param[in] aBoundingBox Area in which arcs must be retrieved and converted.
+   * @param[in] aUtmProjector Projector that must be used for converting coordinates.
    * @retval True If conversion succeeded.
    * @retval False If conversion failed.
    */
-  bool convertArcsInBoundingBox(const AutoStream::TBoundingBox& aBoundingBox);
+  bool convertArcsInBoundingBox(const AutoStream::TBoundingBox&          aBoundingBox,
+                                const lanelet::projection::UtmProjector& aUtmProjector);
 
   /**
-   * Convert all AutoStream traffic signs in the given bounding box.
+   * Convert the AutoStream arcs along the route of the given corridor.
    *
-   * @param[in] aBoundingBox Area in which traffic signs must be retrieved and converted.
+   * @param[in] aCorridor Corridor around the route.
+   * @param[in] aUtmProjector Projector that must be used for converting coordinates.
    * @retval True If conversion succeeded.
    * @retval False If conversion failed.
    */
-  bool convertTrafficSignsInBoundingBox(const AutoStream::TBoundingBox& aBoundingBox);
+  bool convertArcsInCorridor(const CRouteCorridor&                    aCorridor,
+                             const lanelet::projection::UtmProjector& aUtmProjector);
+
+  /**
+   * Select the arcs of which the lane border geometry lies within the given corridor. Arcs are
+   * searched in the bounding boxes of the corridor pieces and checked by the worker threads.
+   *
+   * @param[in] aCorridor Corridor around the route.
+   * @param[in] aUtmProjector Projector used for the arc converters of the worker threads.
+   * @retval std::vector<AutoStream::HdMap::TArcKey> Sorted keys of the selected arcs.
+   */
+  std::vector<AutoStream::HdMap::TArcKey>
+  selectArcsInCorridor(const CRouteCorridor&                    aCorridor,
+                       const lanelet::projection::UtmProjector& aUtmProjector) const;
+
+  /**
+   * Convert all AutoStream traffic signs of which the center lies within the given corridor.
+   *
+   * @param[in] aCorridor Corridor around the route.
+   * @retval True If conversion succeeded.
+   * @retval False If conversion failed.
+   */
+  bool convertTrafficSignsInCorridor(const CRouteCorridor& aCorridor);
+
+  /**
+   * Convert a single AutoStream traffic sign and store the resulting polygon.
+   *
+   * @param[in] aTrafficSignKey Key of the traffic sign, from which the IDs are derived.
+   * @param[in] aTrafficSign Data of the traffic sign that must be converted.
+   */
+  void convertTrafficSign(const AutoStream::HdMap::TTrafficSignKey& aTrafficSignKey,
+                          const CAutoStreamTrafficSignData&         aTrafficSign);
+
+  /**
+   * Check if conversions are served from a recording.
+   *
+   * @retval True If a replay file has been set.
+   * @retval False If AutoStream is used.
+   */
+  bool isReplaying() const noexcept;
+
+  /**
+   * Check if the AutoStream map data used by conversions is recorded.
+   *
+   * @retval True If a recording file has been set and conversions are not replayed.
+   * @retval False If nothing is recorded.
+   */
+  bool isRecording() const noexcept;
+
+  /**
+   * Store the recording of the current conversion when recording is enabled.
+   */
+  void storeRecording() const;
+
+  /**
+   * Add the size of the converted map to the conversion report and write it next to the output
+   * file, when reports are enabled.
+   */
+  void storeReport();
+
+  /**
+   * Build the routing graph of the converted lanelets and write it next to the output file, when
+   * routing graphs are enabled. The number of relations is added to the conversion report.
+   */
+  void storeRoutingGraph();
+
+  /**
+   * Check if conversions are traced.
+   *
+   * @retval True If a trace file has been set.
+   * @retval False If nothing is traced.
+   */
+  bool isTracing() const noexcept;
 
   /**
-   * Make sure all connection for a given arc are handled properly.
+   * Write the trace of the current conversion when tracing is enabled.
+   */
+  void storeTrace();
+
+  /**
+   * Compare the written map with the previous map, write the change set next to the output file and
+   * add its statistics to the conversion report.
+   *
+   * @param[in] aPreviousMap Previous map, loaded before the map was written.
+   */
+  void storeMapDelta(const COsmDocument& aPreviousMap);
+
+  /**
+   * Assemble, stitch and store the map of a single batch job from the shared conversion results.
+   *
+   * @param[in] aJob Batch job that must be stored.
+   * @param[in] aArcKeys Sorted keys of the arcs in the bounding box of the job.
+   * @param[in] aTrafficSignKeys Keys of the traffic signs in the bounding box of the job.
+   * @param[in] aSharedResults Conversion results of all arcs and traffic signs in the batch.
+   * @param[in] aUtmProjector Projector that was used for converting coordinates.
+   * @retval True If the map was stored.
+   * @retval False If assembling or writing the map failed.
+   */
+  bool storeBatchJob(const CAutoStreamBatchJob&                             aJob,
+                     const std::vector<AutoStream::HdMap::TArcKey>&         aArcKeys,
+                     const std::vector<AutoStream::HdMap::TTrafficSignKey>& aTrafficSignKeys,
+                     const CAutoStreamBatchResults&                         aSharedResults,
+                     const lanelet::projection::UtmProjector&               aUtmProjector);
+
+  /**
+   * Convert the traffic signs of all maps of a batch once, with IDs from the ranges derived from
+   * their keys.
    *
-   * @param[in] aCurrentArcLaneMetaData Meta data for current arc, contains connectivity
-   * information.
-   * @param[in] aCurrentArcLaneletVector Lanelets association with the current arc
-   * @param[in|out] aLaneletMap Set of all lanelets. Some will be updated to represent connectivity
-   * information.
-   * @param[in] aIdPointMap Map that contains point connections.
-   * @param[in] aInvalidConnectionsOut Lanelet IDs of lanes to which no connections are allowed.
+   * @param[in] aTrafficSignKeys Keys of the traffic signs of all maps, without duplicates.
+   * @param[out] aSharedResults Results to which the converted traffic signs are added.
    */
-  void addConnectionsToArc(
-    const std::vector<CAutoStreamLaneMetaData>&                          aCurrentArcLaneMetaData,
-    std::vector<lanelet::Lanelet>&                                       aCurrentArcLaneletVector,
-    std::map<AutoStream::HdMap::TArcKey, std::vector<lanelet::Lanelet>>& aLaneletMap,
-    std::map<lanelet::Id, lanelet::Point3d>&                             aIdPointMap,
-    const std::set<lanelet::Id>&                                         aInvalidConnectionsOut);
+  void
+  convertBatchTrafficSigns(const std::set<AutoStream::HdMap::TTrafficSignKey>& aTrafficSignKeys,
+                           CAutoStreamBatchResults&                            aSharedResults);
+
+  /**
+   * Add the shared converted traffic signs of a single batch job to the map. A traffic sign of
+   * which the range derived from its key has been claimed already is moved to the claimed range,
+   * such that it gets the IDs it would get when converting the map on its own.
+   *
+   * @param[in] aTrafficSignKeys Keys of the traffic signs in the bounding box of the job.
+   * @param[in] aSharedResults Conversion results of all traffic signs in the batch.
+   */
+  void addBatchTrafficSigns(const std::vector<AutoStream::HdMap::TTrafficSignKey>& aTrafficSignKeys,
+                            const CAutoStreamBatchResults&                         aSharedResults);
+
+  /**
+   * Check that AutoStream has been initialized and an output file has been given, and update the
+   * map source. When replaying, the recording is loaded instead.
+   *
+   * @param[in] aOutputFileName Name of the output file of the conversion.
+   * @retval True If a conversion can be started.
+   * @retval False If a precondition is not met.
+   */
+  bool checkConversionPreconditions(const std::string& aOutputFileName);
+
+  /**
+   * Create the converters for the given projector, prepare the arc cache and remove results of a
+   * previous conversion.
+   *
+   * @param[in] aUtmProjector Projector that will be used for converting coordinates.
+   */
+  void initializeConversion(const lanelet::projection::UtmProjector& aUtmProjector);
+
+  /**
+   * Write the converted map and update the arc cache.
+   *
+   * @param[in] aUtmProjector Projector that was used for converting coordinates.
+   * @retval True If the map was written.
+   * @retval False If writing the map failed.
+   */
+  bool finishConversion(const lanelet::projection::UtmProjector& aUtmProjector);
+
+  /**
+   * Resolve and stitch the connections between all arcs in the given table and store the valid
+   * lanelets.
+   *
+   * @param[in, out] aArcTable Table with all converted arcs.
+   */
+  void connectArcs(CAutoStreamArcTable& aArcTable);
+
+  /**
+   * Convert all AutoStream traffic signs in the given bounding box.
+   *
+   * @param[in] aBoundingBox Area in which traffic signs must be retrieved and converted.
+   * @retval True If conversion succeeded.
+   * @retval False If conversion failed.
+   */
+  bool convertTrafficSignsInBoundingBox(const AutoStream::TBoundingBox& aBoundingBox);
 
   /**
    * Add the point mapping for a line string with given ID to the lanelet point map.
@@ -161,9 +721,16 @@ private:
                 const lanelet::Id& aPointIdNew,
                 TLinePointIdMap&   aLaneletPointMap) const;
 
+  /**
+   * Store a converted area and register its outer bound line strings in the area index.
+   *
+   * @param[in] aArea Area that must be stored.
+   */
+  void addArea(const lanelet::Area& aArea);
+
   /**
    * Whenever an area contains the given line string, all points with the old ID must be replaced by
-   * a new point.
+   * a new point. Only areas registered for the line string in the area index are visited.
    *
    * @param[in] aLineStringId Areas with containing this line string need to be updated.
    * @param[in] aOldPointId ID of the point that must be replaced within the area.
@@ -174,64 +741,43 @@ private:
                            const lanelet::Point3d& aNewPoint);
 
   /**
-   * Store a connection between two lanes by adding a mapping between points to the point map. Skip
-   * invalid connections.
+   * Store a connection between two lanes by merging their border points in the point union-find
+   * structure.
    *
-   * @param[in] aConnectedArcKey AutoStream arc key of the connected arc.
-   * @param[in] aConnectedLaneIdx Lane index of the connected lane on the connected arc.
+   * @param[in] aConnectedLanelet Lanelet that follows the current lanelet.
    * @param[in] aCurrentLanelet Current lanelet for which connection must be added.
-   * @param[in|out] aLaneletMap Vector with all lanelets that needs to be updated.
-   * @param[in] aIdPointMap Map with connected points.
-   * @param[in] aInvalidConnectionsOut Lanelet IDs of lanes to which no connections are allowed.
+   * @param[in, out] aPointUnionFind Structure to which point connections are added.
    */
-  void
-  storeConnection(const AutoStream::HdMap::TArcKey& aConnectedArcKey,
-                  const uint32_t                    aConnectedLaneIdx,
-                  lanelet::Lanelet&                 aCurrentLanelet,
-                  std::map<AutoStream::HdMap::TArcKey, std::vector<lanelet::Lanelet>>& aLaneletMap,
-                  std::map<lanelet::Id, lanelet::Point3d>&                             aIdPointMap,
-                  const std::set<lanelet::Id>& aInvalidConnectionsOut);
+  void storeConnection(lanelet::Lanelet& aConnectedLanelet,
+                       lanelet::Lanelet& aCurrentLanelet,
+                       CPointUnionFind&  aPointUnionFind);
 
   /**
-   * Add connection given in point map to given lane border.
+   * Add connections given in point union-find structure to given lane border.
    * @param[in, out] aLaneBorder Lane border to which connections must be added.
-   * @param[in] aIdPointMap Map that contains point connection information.
+   * @param[in, out] aPointUnionFind Structure that contains point connection information.
    * @retval True If a connection has been added.
    * @retval False If no connection was added.
    */
-  bool addConnectionsToLaneBorder(lanelet::LineString3d&                   aLaneBorder,
-                                  std::map<lanelet::Id, lanelet::Point3d>& aIdPointMap) const;
+  bool addConnectionsToLaneBorder(lanelet::LineString3d& aLaneBorder,
+                                  CPointUnionFind&       aPointUnionFind) const;
 
   /**
    * Add the given connections to the given lanelets.
    *
-   * @param[in|out] aLaneletMap All lanelets some of which need to be updated to reflect
+   * @param[in|out] aArcTable Table with all lanelets some of which need to be updated to reflect
    * connections.
-   * @param[in] aIdPointMap Map with connections.
+   * @param[in, out] aPointUnionFind Structure with connections.
    */
-  void
-  addConnections(std::map<AutoStream::HdMap::TArcKey, std::vector<lanelet::Lanelet>>& aLaneletMap,
-                 std::map<lanelet::Id, lanelet::Point3d>& aIdPointMap) const;
+  void addConnections(CAutoStreamArcTable& aArcTable, CPointUnionFind& aPointUnionFind) const;
 
   /**
-   * Store the arcs in the given vector which have a valid ID within the appropriate member
+   * Store the lanelets in the given arc table which have a valid ID within the appropriate member
    * variable.
    *
-   * @param[in] aLaneletMap Vector with lanelets.
-   */
-  void storeValidLanelets(
-    const std::map<AutoStream::HdMap::TArcKey, std::vector<lanelet::Lanelet>>& aLaneletMap);
-
-  /**
-   * Add a mapping from the old point ID to the new point to the given map, recursively if needed.
-   *
-   * @param[in] aOldPointId Id of the point that must later be replaced.
-   * @param[in] aNewPoint Point that must replace the old point.
-   * @param[in, out] aIdPointMap Map to which the mapping must be added.
+   * @param[in] aArcTable Table with lanelets.
    */
-  void addPointToMapping(const lanelet::Id                        aOldPointId,
-                         const lanelet::Point3d                   aNewPoint,
-                         std::map<lanelet::Id, lanelet::Point3d>& aIdPointMap) const;
+  void storeValidLanelets(const CAutoStreamArcTable& aArcTable);
 
   /**
    * Get a UTM projector that can be used for converting coordinates for the given bounding box.
@@ -243,33 +789,95 @@ private:
   getUtmProjector(const AutoStream::TBoundingBox& aBoundingBox) const;
 
   /**
-   * Store a lanelet2 map that has been created using the given UTM projector.
+   * Store a lanelet2 map that has been created using the given UTM projector. The converted
+   * primitives are streamed to the output file without building a lanelet map first.
    *
    * @param[in] aUtmProjector UTM projector that was used while converting an AutoStream map to
    * lanelet format.
+   * @retval True If storing the map succeeded.
+   * @retval False If the output file could not be written.
    */
-  void storeMap(const lanelet::projection::UtmProjector& aUtmProjector) const;
+  bool storeMap(const lanelet::projection::UtmProjector& aUtmProjector) const;
 
   /**
-   * Update AutoStream HD map access pointer as member variable by retrieving it from the AutoStream
-   * interface.
+   * Update the map source used by the calling thread. The map source serves the replayed recording,
+   * is created by the map source factory or uses the HD map access of the AutoStream interface.
    *
    * @retval True If getting and updating access succeeded.
    * @retval False If getting access failed.
    */
-  bool updateMapAccess();
+  bool updateMapSource();
+
+  /**
+   * Create a map source for a worker thread. The map source serves the replayed recording, is
+   * created by the map source factory or uses its own HD map access object.
+   *
+   * @retval TMapSourcePtr New map source.
+   * @throw std::runtime_error If creating a map access object failed.
+   */
+  TMapSourcePtr createMapSource() const;
 
-  AutoStream::HdMap::CHdMapAccess* mMapAccess;
+  /**
+   * Wrap a map source such that the served data is recorded, when recording is enabled.
+   *
+   * @param[in] aMapSource Map source that must be wrapped.
+   * @retval TMapSourcePtr Recording map source, or the given map source if nothing is recorded.
+   */
+  TMapSourcePtr recordMapSource(TMapSourcePtr aMapSource) const;
+
+  /**
+   * Load the previous arc cache and prepare the updated arc cache for a conversion using the given
+   * UTM projector. Cached arcs converted for another origin are discarded.
+   *
+   * @param[in] aUtmProjector UTM projector that will be used for the conversion.
+   */
+  void prepareArcCache(const lanelet::projection::UtmProjector& aUtmProjector);
+
+  // Map source used by the calling thread, worker threads create their own
+  TMapSourcePtr     mMapSource;
+  TMapSourceFactory mMapSourceFactory;
 
   std::unique_ptr<CAutoStreamArcConverter>         mArcConverter;
   CAutoStreamInterface                             mAutoStreamInterface;
   std::unique_ptr<CAutoStreamTrafficSignConverter> mTrafficSignConverter;
 
-  std::string mOutputFilename;
+  std::string    mOutputFilename;
+  TMapFileFormat mOutputFormat;
+  std::string    mArcCacheFileName;
+  std::string    mRecordingFileName;
+  std::string    mReplayFileName;
+  std::string    mTraceFileName;
+  std::string    mDeltaBaseFileName;
+  size_t         mNumberOfWorkers;
+  size_t         mPrefetchDepth;
+  size_t         mTileRows;
+  size_t         mTileColumns;
+  bool           mRoutingGraphEnabled;
+
+  // Timings and counters of the current conversion
+  CConversionReport mReport;
+
+  // Spans of the current conversion, recorded by the calling thread and the worker threads
+  mutable CTraceRecorder        mTraceRecorder;
+  std::unique_ptr<CTraceBuffer> mTraceBuffer;
+
+  // Arcs cached by the previous conversion and arcs converted during the current conversion
+  CAutoStreamArcCache mPreviousArcCache;
+  CAutoStreamArcCache mUpdatedArcCache;
+  bool                mPreviousMapVersionMatches;
+
+  // ID ranges claimed by the arcs and traffic signs of the current map
+  CIdRangeTable mIdRanges;
+
+  // Map data recorded during or replayed by the current conversion, recorded by worker threads
+  mutable CAutoStreamMapRecording mRecording;
 
   std::vector<lanelet::Area>      mAreas;
   std::vector<lanelet::Lanelet>   mLanelets;
   std::vector<lanelet::Polygon3d> mTrafficSignPolygons;
+
+  // Indices in mAreas of the areas using a line string, by line string ID
+  std::unordered_map<lanelet::Id, std::vector<size_t>> mAreaIndicesByLineStringId;
 };
 }
 }
@@ -0,0 +1,225 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#ifndef TOMTOM_AUTOSTREAM_MAP_CONVERTER_MAP_DELTA_H
+#define TOMTOM_AUTOSTREAM_MAP_CONVERTER_MAP_DELTA_H
+
+#include <lanelet2_core/Forward.h>
+
+#include <array>
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+/**
+ * Types of the elements of an OSM document, in the order in which they are written.
+ */
+enum class TOsmElementType
+{
+  Node,
+  Way,
+  Relation
+};
+
+/**
+ * Sections of an OSM change set. Elements of a map are not part of any section.
+ */
+enum class TOsmChangeAction
+{
+  None,
+  Create,
+  Modify,
+  Delete
+};
+
+/**
+ * Structure that holds a single element of an OSM document.
+ */
+struct COsmElement
+{
+  TOsmElementType  mType;
+  lanelet::Id      mId;
+  TOsmChangeAction mAction;
+
+  // Complete text of the element as written, including its tags and trailing newline
+  std::string mText;
+};
+
+/**
+ * Elements of a map written by COsmWriter, indexed by type and ID. Elements are kept as written,
+ * such that elements of two maps can be compared without parsing their coordinates and tags.
+ */
+class COsmDocument
+{
+public:
+  /**
+   * Construct an empty document.
+   */
+  COsmDocument();
+
+  /**
+   * Load a map from file. The document is empty if the file cannot be read.
+   *
+   * @param[in] aFileName Name of the map file.
+   * @retval True If loading succeeded.
+   * @retval False If the file does not exist or is not a map written by COsmWriter.
+   */
+  bool load(const std::string& aFileName);
+
+  /**
+   * Remove all elements.
+   */
+  void clear();
+
+  /**
+   * Get all elements in the order in which they were written.
+   *
+   * @retval const std::vector<COsmElement>& Elements of the map.
+   */
+  const std::vector<COsmElement>& getElements() const noexcept;
+
+  /**
+   * Find an element.
+   *
+   * @param[in] aType Type of the element.
+   * @param[in] aId ID of the element.
+   * @retval const COsmElement* Element, nullptr if the map does not contain it.
+   */
+  const COsmElement* findElement(const TOsmElementType aType, const lanelet::Id aId) const;
+
+private:
+  std::vector<COsmElement> mElements;
+
+  // Indices of the elements, per element type
+  std::array<std::unordered_map<lanelet::Id, size_t>, 3> mElementIndices;
+};
+
+/**
+ * Structure that holds the number of changed lanelets, areas and traffic signs of a change set. A
+ * primitive is modified if its own element, one of its ways or one of their nodes changed.
+ */
+struct CMapDeltaStatistics
+{
+  size_t mNumberOfAddedLanelets;
+  size_t mNumberOfRemovedLanelets;
+  size_t mNumberOfModifiedLanelets;
+  size_t mNumberOfAddedAreas;
+  size_t mNumberOfRemovedAreas;
+  size_t mNumberOfModifiedAreas;
+  size_t mNumberOfAddedTrafficSigns;
+  size_t mNumberOfRemovedTrafficSigns;
+  size_t mNumberOfModifiedTrafficSigns;
+};
+
+/**
+ * Change set between two maps written by COsmWriter, holding the created, modified and deleted
+ * nodes, ways and relations. Elements are matched by ID, which is stable between conversions
+ * because IDs are derived from arc and traffic sign keys.
+ *
+ * The change set is stored in the layout of an OSM change file, with created and modified elements
+ * as written and deleted elements reduced to their ID. Applying it to the previous map yields the
+ * current map, with created elements following the existing elements of their type.
+ */
+class CMapDelta
+{
+public:
+  /**
+   * Construct an empty change set.
+   */
+  CMapDelta();
+
+  /**
+   * Compute the change set that turns a previous map into a current map.
+   *
+   * @param[in] aPrevious Previous map.
+   * @param[in] aCurrent Current map.
+   */
+  void compute(const COsmDocument& aPrevious, const COsmDocument& aCurrent);
+
+  /**
+   * Load a change set from file. The change set is empty if the file cannot be read. Statistics
+   * are only available for computed change sets.
+   *
+   * @param[in] aFileName Name of the change set file.
+   * @retval True If loading succeeded.
+   * @retval False If the file does not exist or is not a valid change set.
+   */
+  bool load(const std::string& aFileName);
+
+  /**
+   * Store the change set in a file.
+   *
+   * @param[in] aFileName Name of the change set file.
+   * @retval True If storing succeeded.
+   * @retval False If writing the file failed.
+   */
+  bool store(const std::string& aFileName) const;
+
+  /**
+   * Apply the change set to a map and write the resulting map. The change set must have been
+   * computed against the given map: modified and deleted elements must exist and created elements
+   * must not exist.
+   *
+   * @param[in] aBase Map to which the change set is applied.
+   * @param[in] aOutputFileName Name of the file to which the resulting map must be written, may be
+   * the file from which the base map was loaded.
+   * @retval True If applying succeeded.
+   * @retval False If the change set does not match the map or writing the file failed.
+   */
+  bool apply(const COsmDocument& aBase, const std::string& aOutputFileName) const;
+
+  /**
+   * Get the number of elements of a section of the change set.
+   *
+   * @param[in] aAction Section of the change set.
+   * @retval size_t Number of created, modified or deleted elements.
+   */
+  size_t getNumberOfElements(const TOsmChangeAction aAction) const noexcept;
+
+  /**
+   * Get the number of changed lanelets, areas and traffic signs.
+   *
+   * @retval const CMapDeltaStatistics& Statistics of the last computed change set.
+   */
+  const CMapDeltaStatistics& getStatistics() const noexcept;
+
+  /**
+   * Print the number of added, removed and modified lanelets, areas and traffic signs as part of a
+   * sentence, without line break.
+   *
+   * @param[in, out] aOutput Stream to which the statistics are written.
+   */
+  void printStatistics(std::ostream& aOutput) const;
+
+private:
+  /**
+   * Count the added, removed and modified lanelets, areas and traffic signs.
+   *
+   * @param[in] aPrevious Previous map, which holds the tags of deleted elements.
+   * @param[in] aCurrent Current map, which holds the references of unchanged elements.
+   */
+  void computeStatistics(const COsmDocument& aPrevious, const COsmDocument& aCurrent);
+
+  std::vector<COsmElement> mCreatedElements;
+  std::vector<COsmElement> mModifiedElements;
+  std::vector<COsmElement> mDeletedElements;
+  CMapDeltaStatistics      mStatistics;
+};
+}
+}
+}
+#endif
@@ -0,0 +1,195 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#ifndef TOMTOM_AUTOSTREAM_MAP_CONVERTER_MAP_RECORDING_H
+#define TOMTOM_AUTOSTREAM_MAP_CONVERTER_MAP_RECORDING_H
+
+#include "DataTypes.hpp"
+
+#include "TomTom/AutoStream/AutoStream.h"
+#include "TomTom/AutoStream/HdMap/HdMapArc.h"
+#include "TomTom/AutoStream/HdMap/HdMapTrafficSign.h"
+#include "TomTom/AutoStream/MapBaseTypes.h"
+
+#include <array>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+/**
+ * Recording of the AutoStream map data used by conversions, such that conversions can be replayed
+ * offline without network access: the keys of the arcs and traffic signs found in each queried
+ * area, and the data of each arc and traffic sign. The recording is tagged with the map version
+ * and hash it was recorded from.
+ *
+ * Areas are matched exactly, a replayed conversion must query the same areas as the recorded one.
+ * Adding data is thread-safe, such that worker threads can record while converting. Finding data
+ * is not synchronized with adding, a recording is either being recorded or being replayed.
+ */
+class CAutoStreamMapRecording
+{
+public:
+  /**
+   * Constructor.
+   */
+  CAutoStreamMapRecording();
+
+  /**
+   * Remove all data and set the map version of the recording.
+   *
+   * @param[in] aMapVersionAndHash Map version and hash the data is recorded from.
+   */
+  void reset(const AutoStream::CMapVersionAndHash& aMapVersionAndHash);
+
+  /**
+   * Load a recording from file. All data is removed if the file cannot be read.
+   *
+   * @param[in] aFileName Name of the recording file.
+   * @retval True If loading succeeded.
+   * @retval False If the file does not exist or is not a valid recording.
+   */
+  bool load(const std::string& aFileName);
+
+  /**
+   * Store the recording in a file.
+   *
+   * @param[in] aFileName Name of the recording file.
+   * @retval True If storing succeeded.
+   * @retval False If writing the file failed.
+   */
+  bool store(const std::string& aFileName) const;
+
+  /**
+   * Get the map version and hash the data was recorded from.
+   *
+   * @retval const AutoStream::CMapVersionAndHash& Map version and hash.
+   */
+  const AutoStream::CMapVersionAndHash& getMapVersionAndHash() const noexcept;
+
+  /**
+   * Add the keys of the arcs found in an area.
+   *
+   * @param[in] aArea Area that was queried.
+   * @param[in] aArcKeys Keys of the arcs in the area.
+   */
+  void addArcKeysInArea(const AutoStream::TBoundingBox&                aArea,
+                        const std::vector<AutoStream::HdMap::TArcKey>& aArcKeys);
+
+  /**
+   * Find the keys of the arcs found in an area.
+   *
+   * @param[in] aArea Area that was queried.
+   * @param[out] aArcKeys Sorted keys of the arcs in the area.
+   * @retval True If the area was recorded.
+   * @retval False If the area was not recorded.
+   */
+  bool findArcKeysInArea(const AutoStream::TBoundingBox&          aArea,
+                         std::vector<AutoStream::HdMap::TArcKey>& aArcKeys) const;
+
+  /**
+   * Add the data of an arc, an arc that was recorded before is kept.
+   *
+   * @param[in] aArcKey Key of the arc.
+   * @param[in] aArcData Data of the arc.
+   */
+  void addArc(const AutoStream::HdMap::TArcKey& aArcKey, const CAutoStreamArcData& aArcData);
+
+  /**
+   * Find the data of an arc.
+   *
+   * @param[in] aArcKey Key of the arc.
+   * @retval const CAutoStreamArcData* Data of the arc, null pointer if it was not recorded.
+   */
+  const CAutoStreamArcData* findArc(const AutoStream::HdMap::TArcKey& aArcKey) const;
+
+  /**
+   * Add the keys of the traffic signs found in an area.
+   *
+   * @param[in] aArea Area that was queried.
+   * @param[in] aTrafficSignKeys Keys of the traffic signs in the area.
+   */
+  void addTrafficSignKeysInArea(
+    const AutoStream::TBoundingBox&                        aArea,
+    const std::vector<AutoStream::HdMap::TTrafficSignKey>& aTrafficSignKeys);
+
+  /**
+   * Find the keys of the traffic signs found in an area.
+   *
+   * @param[in] aArea Area that was queried.
+   * @param[out] aTrafficSignKeys Sorted keys of the traffic signs in the area.
+   * @retval True If the area was recorded.
+   * @retval False If the area was not recorded.
+   */
+  bool findTrafficSignKeysInArea(
+    const AutoStream::TBoundingBox&                  aArea,
+    std::vector<AutoStream::HdMap::TTrafficSignKey>& aTrafficSignKeys) const;
+
+  /**
+   * Add the data of a traffic sign, a traffic sign that was recorded before is kept.
+   *
+   * @param[in] aTrafficSignKey Key of the traffic sign.
+   * @param[in] aTrafficSign Data of the traffic sign.
+   */
+  void addTrafficSign(const AutoStream::HdMap::TTrafficSignKey& aTrafficSignKey,
+                      const CAutoStreamTrafficSignData&         aTrafficSign);
+
+  /**
+   * Find the data of a traffic sign.
+   *
+   * @param[in] aTrafficSignKey Key of the traffic sign.
+   * @retval const CAutoStreamTrafficSignData* Data of the traffic sign, null pointer if it was not
+   * recorded.
+   */
+  const CAutoStreamTrafficSignData*
+  findTrafficSign(const AutoStream::HdMap::TTrafficSignKey& aTrafficSignKey) const;
+
+  /**
+   * Get number of recorded arcs.
+   *
+   * @retval size_t Number of arcs.
+   */
+  size_t getNumberOfArcs() const noexcept;
+
+  /**
+   * Get number of recorded traffic signs.
+   *
+   * @retval size_t Number of traffic signs.
+   */
+  size_t getNumberOfTrafficSigns() const noexcept;
+
+private:
+  // South west latitude and longitude, north east latitude and longitude in degrees
+  using TArea = std::array<double, 4>;
+
+  /**
+   * Get the corner coordinates of a bounding box, used for looking up recorded areas.
+   *
+   * @param[in] aBoundingBox Bounding box.
+   * @retval TArea Corner coordinates of the bounding box.
+   */
+  static TArea toArea(const AutoStream::TBoundingBox& aBoundingBox);
+
+  AutoStream::CMapVersionAndHash                                           mMapVersionAndHash;
+  std::map<TArea, std::vector<AutoStream::HdMap::TArcKey>>                 mArcKeysByArea;
+  std::map<TArea, std::vector<AutoStream::HdMap::TTrafficSignKey>>         mTrafficSignKeysByArea;
+  std::map<AutoStream::HdMap::TArcKey, CAutoStreamArcData>                 mArcs;
+  std::map<AutoStream::HdMap::TTrafficSignKey, CAutoStreamTrafficSignData> mTrafficSigns;
+  std::mutex                                                               mMutex;
+};
+}
+}
+}
+#endif
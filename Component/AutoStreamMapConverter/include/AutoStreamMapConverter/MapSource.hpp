@@ -0,0 +1,109 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#ifndef TOMTOM_AUTOSTREAM_MAP_CONVERTER_MAP_SOURCE_H
+#define TOMTOM_AUTOSTREAM_MAP_CONVERTER_MAP_SOURCE_H
+
+#include "DataTypes.hpp"
+
+#include "TomTom/AutoStream/AutoStream.h"
+#include "TomTom/AutoStream/HdMap/HdMapArc.h"
+#include "TomTom/AutoStream/HdMap/HdMapTrafficSign.h"
+#include "TomTom/AutoStream/MapBaseTypes.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+/**
+ * Source of the map data needed for converting a map. The converters only work on the data
+ * returned by a map source, such that the data can be served by AutoStream, by a recording or by
+ * any other backend. All data of an arc is returned by a single call.
+ *
+ * A map source is used by a single thread, every worker thread creates its own map source.
+ */
+class CAutoStreamMapSource
+{
+public:
+  /**
+   * Destructor.
+   */
+  virtual ~CAutoStreamMapSource() = default;
+
+  /**
+   * Get the map version and hash of the served data.
+   *
+   * @retval AutoStream::CMapVersionAndHash Map version and hash.
+   */
+  virtual AutoStream::CMapVersionAndHash getMapVersionAndHash() const = 0;
+
+  /**
+   * Get the keys of the arcs within an area.
+   *
+   * @param[in] aArea Area that must be queried.
+   * @retval std::vector<AutoStream::HdMap::TArcKey> Sorted keys of the arcs in the area.
+   * @throw std::runtime_error If the source cannot serve the area.
+   */
+  virtual std::vector<AutoStream::HdMap::TArcKey>
+  getArcKeysInArea(const AutoStream::TBoundingBox& aArea) = 0;
+
+  /**
+   * Get all data that is needed for converting an arc: lane meta data, connections, lane borders
+   * and speed limits.
+   *
+   * @param[in] aArcKey Key of the arc.
+   * @retval CAutoStreamArcData Data of the arc, empty if the arc is not a lane group.
+   * @throw std::runtime_error If the source cannot serve the arc.
+   */
+  virtual CAutoStreamArcData getArc(const AutoStream::HdMap::TArcKey& aArcKey) = 0;
+
+  /**
+   * Make sure the data of an arc can be served quickly by a later call of getArc, possibly by
+   * another map source of the same backend. By default the data is retrieved and dropped.
+   *
+   * @param[in] aArcKey Key of the arc.
+   * @throw std::runtime_error If the source cannot serve the arc.
+   */
+  virtual void prefetchArc(const AutoStream::HdMap::TArcKey& aArcKey);
+
+  /**
+   * Get the keys of the traffic signs within an area.
+   *
+   * @param[in] aArea Area that must be queried.
+   * @retval std::vector<AutoStream::HdMap::TTrafficSignKey> Sorted keys of the traffic signs.
+   * @throw std::runtime_error If the source cannot serve the area.
+   */
+  virtual std::vector<AutoStream::HdMap::TTrafficSignKey>
+  getTrafficSignKeysInArea(const AutoStream::TBoundingBox& aArea) = 0;
+
+  /**
+   * Get all data that is needed for converting a traffic sign.
+   *
+   * @param[in] aTrafficSignKey Key of the traffic sign.
+   * @retval CAutoStreamTrafficSignData Data of the traffic sign.
+   * @throw std::runtime_error If the source cannot serve the traffic sign.
+   */
+  virtual CAutoStreamTrafficSignData
+  getTrafficSign(const AutoStream::HdMap::TTrafficSignKey& aTrafficSignKey) = 0;
+};
+
+typedef std::unique_ptr<CAutoStreamMapSource> TMapSourcePtr;
+
+// Function creating a new map source, called once by the calling thread and once by each worker
+typedef std::function<TMapSourcePtr()> TMapSourceFactory;
+}
+}
+}
+#endif
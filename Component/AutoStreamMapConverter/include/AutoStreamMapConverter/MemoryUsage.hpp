@@ -0,0 +1,104 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#ifndef TOMTOM_AUTOSTREAM_MAP_CONVERTER_MEMORY_USAGE_H
+#define TOMTOM_AUTOSTREAM_MAP_CONVERTER_MEMORY_USAGE_H
+
+#include <cstddef>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+/**
+ * Get the resident set size of the process.
+ *
+ * @retval size_t Resident set size in bytes, zero if it cannot be determined.
+ */
+size_t getResidentSetSize();
+
+/**
+ * Get the peak resident set size of the process since it started or since the peak was reset.
+ *
+ * @retval size_t Peak resident set size in bytes, zero if it cannot be determined.
+ */
+size_t getPeakResidentSetSize();
+
+/**
+ * Reset the peak resident set size of the process to the current resident set size, such that
+ * the peak of a single conversion can be measured by a long running process.
+ *
+ * @retval True If the peak was reset.
+ * @retval False If the peak cannot be reset on this system.
+ */
+bool resetPeakResidentSetSize();
+
+/**
+ * Mark that heap allocations are counted. Must be called by an allocation hook that passes every
+ * allocation and deallocation of the process to countAllocation() and countDeallocation().
+ */
+void enableAllocationCounting() noexcept;
+
+/**
+ * Check if heap allocations are counted.
+ *
+ * @retval True If an allocation hook has been installed.
+ * @retval False If live heap bytes are not available.
+ */
+bool isAllocationCountingEnabled() noexcept;
+
+/**
+ * Count an allocation, called by the allocation hook.
+ *
+ * @param[in] aSize Size of the allocated memory block in bytes.
+ */
+void countAllocation(const size_t aSize) noexcept;
+
+/**
+ * Count a deallocation, called by the allocation hook.
+ *
+ * @param[in] aSize Size of the released memory block in bytes, as counted when allocating it.
+ */
+void countDeallocation(const size_t aSize) noexcept;
+
+/**
+ * Get the number of heap bytes that are currently allocated.
+ *
+ * @retval size_t Live heap bytes, zero if allocations are not counted.
+ */
+size_t getLiveHeapBytes() noexcept;
+
+/**
+ * Get the maximum number of live heap bytes since the peak was last restarted.
+ *
+ * @retval size_t Peak live heap bytes, zero if allocations are not counted.
+ */
+size_t getPeakLiveHeapBytes() noexcept;
+
+/**
+ * Restart measuring the peak of the live heap bytes from the current number of live heap bytes.
+ * Nested measurements pass the returned peak to mergePeakLiveHeapBytes() when they end, such that
+ * the enclosing measurement keeps its peak.
+ *
+ * @retval size_t Peak live heap bytes before restarting.
+ */
+size_t restartPeakLiveHeapBytes() noexcept;
+
+/**
+ * Raise the peak of the live heap bytes to at least the given value.
+ *
+ * @param[in] aPeakLiveHeapBytes Peak returned by restartPeakLiveHeapBytes().
+ */
+void mergePeakLiveHeapBytes(const size_t aPeakLiveHeapBytes) noexcept;
+}
+}
+}
+#endif
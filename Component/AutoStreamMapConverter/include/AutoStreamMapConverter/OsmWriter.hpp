@@ -0,0 +1,147 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#ifndef TOMTOM_AUTOSTREAM_MAP_CONVERTER_OSM_WRITER_H
+#define TOMTOM_AUTOSTREAM_MAP_CONVERTER_OSM_WRITER_H
+
+#include <lanelet2_core/primitives/Area.h>
+#include <lanelet2_core/primitives/Lanelet.h>
+#include <lanelet2_core/primitives/Polygon.h>
+#include <lanelet2_projection/UTM.h>
+
+#include <ostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+/**
+ * Writes converted primitives in the lanelet2 OSM format directly to an output stream, without
+ * building a lanelet map first. Primitives are visited three times: once for writing all nodes,
+ * once for all ways and once for all relations. Primitives shared between lanelets and areas are
+ * written once.
+ */
+class COsmWriter
+{
+public:
+  /**
+   * Constructor.
+   *
+   * @param[in] aOutput Stream to which the map must be written.
+   * @param[in] aUtmProjector Projector that was used for converting coordinates to UTM.
+   */
+  COsmWriter(std::ostream& aOutput, const lanelet::projection::UtmProjector& aUtmProjector);
+
+  /**
+   * Write the given primitives as OSM document.
+   *
+   * @param[in] aLanelets Lanelets that must be written.
+   * @param[in] aAreas Areas that must be written.
+   * @param[in] aPolygons Polygons that must be written.
+   * @retval True If writing succeeded.
+   * @retval False If writing to the output stream failed.
+   */
+  bool write(const std::vector<lanelet::Lanelet>&   aLanelets,
+             const std::vector<lanelet::Area>&      aAreas,
+             const std::vector<lanelet::Polygon3d>& aPolygons);
+
+private:
+  /**
+   * Write the nodes of all points of a line string or polygon that have not been written yet.
+   *
+   * @param[in] aLineString Line string or polygon of which the points must be written.
+   */
+  template <typename LineStringT>
+  void writeNodes(const LineStringT& aLineString);
+
+  /**
+   * Write a line string or polygon as way, unless it has been written already. Points are written
+   * in the order in which they are stored, independent of the orientation of the given primitive.
+   *
+   * @param[in] aLineString Line string or polygon that must be written.
+   * @param[in] aIsArea Whether the way represents a polygon.
+   */
+  template <typename LineStringT>
+  void writeWay(const LineStringT& aLineString, bool aIsArea);
+
+  /**
+   * Write a lanelet as relation with its left and right bound as members.
+   *
+   * @param[in] aLanelet Lanelet that must be written.
+   */
+  void writeLanelet(const lanelet::ConstLanelet& aLanelet);
+
+  /**
+   * Write an area as multipolygon relation with its outer bound as members.
+   *
+   * @param[in] aArea Area that must be written.
+   */
+  void writeArea(const lanelet::ConstArea& aArea);
+
+  /**
+   * Write a member of a relation.
+   *
+   * @param[in] aRole Role of the member.
+   * @param[in] aId ID of the way that is member of the relation.
+   */
+  void writeMember(const char* aRole, lanelet::Id aId);
+
+  /**
+   * Write the attributes of a primitive as tags. The given type is written unless the attributes
+   * define a type themselves.
+   *
+   * @param[in] aAttributes Attributes that must be written.
+   * @param[in] aType Type of the primitive, may be a null pointer if there is none.
+   */
+  void writeTags(const lanelet::AttributeMap& aAttributes, const char* aType);
+
+  /**
+   * Write a single tag.
+   *
+   * @param[in] aKey Key of the tag.
+   * @param[in] aValue Value of the tag.
+   */
+  void writeTag(const std::string& aKey, const std::string& aValue);
+
+  /**
+   * Write a floating point number without depending on the locale of the stream.
+   *
+   * @param[in] aValue Value that must be written.
+   */
+  void writeNumber(double aValue);
+
+  /**
+   * Write a string as XML attribute value, replacing characters that must be escaped.
+   *
+   * @param[in] aValue Value that must be written.
+   */
+  void writeEscaped(const std::string& aValue);
+
+  /**
+   * Check if a primitive still has to be written and remember that it has been written.
+   *
+   * @param[in] aId ID of the primitive.
+   * @retval True If the primitive has not been written before.
+   * @retval False If the primitive has been written already.
+   */
+  bool markWritten(lanelet::Id aId);
+
+  std::ostream&                     mOutput;
+  lanelet::projection::UtmProjector mUtmProjector;
+  std::unordered_set<lanelet::Id>   mWrittenIds;
+};
+}
+}
+}
+#endif
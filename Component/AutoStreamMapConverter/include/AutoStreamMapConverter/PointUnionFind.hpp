@@ -0,0 +1,87 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#ifndef TOMTOM_AUTOSTREAM_MAP_CONVERTER_POINT_UNION_FIND_H
+#define TOMTOM_AUTOSTREAM_MAP_CONVERTER_POINT_UNION_FIND_H
+
+#include <lanelet2_core/primitives/Point.h>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+/**
+ * Disjoint-set structure over point IDs, used to keep track of which lanelet border points must be
+ * merged when connecting lanelets. Every set has one representative point that replaces all other
+ * points in the set. Uses path compression and union by rank.
+ */
+class CPointUnionFind
+{
+public:
+  /**
+   * Merge the set containing the old point with the set containing the new point. The new point
+   * becomes the representative of the merged set.
+   *
+   * @param[in] aOldPoint Point that must be replaced.
+   * @param[in] aNewPoint Point that must replace the old point.
+   */
+  void merge(const lanelet::Point3d& aOldPoint, const lanelet::Point3d& aNewPoint);
+
+  /**
+   * Get the point that must replace the point with the given ID.
+   *
+   * @param[in] aPointId ID of the point for which the replacement is requested.
+   * @param[out] aReplacement Representative of the set containing the point.
+   * @retval True If the point must be replaced.
+   * @retval False If the point is not merged with another point or represents its set itself.
+   */
+  bool find(const lanelet::Id aPointId, lanelet::Point3d& aReplacement);
+
+  /**
+   * Check if no points have been merged.
+   *
+   * @retval True If no points have been merged.
+   * @retval False If points have been merged.
+   */
+  bool empty() const noexcept;
+
+private:
+  /**
+   * Get the index of the given point, add the point as a set of its own if it is not known yet.
+   *
+   * @param[in] aPoint Point for which index must be retrieved.
+   * @retval size_t Index of the point.
+   */
+  size_t getIndex(const lanelet::Point3d& aPoint);
+
+  /**
+   * Find the root of the set containing the element with given index and compress the path.
+   *
+   * @param[in] aIdx Index of the element.
+   * @retval size_t Index of the root element.
+   */
+  size_t findRoot(size_t aIdx);
+
+  std::unordered_map<lanelet::Id, size_t> mIndexById;
+  std::vector<size_t>                     mParent;
+  std::vector<uint8_t>                    mRank;
+
+  // Representative point of each set, only valid at the index of the root element
+  std::vector<lanelet::Point3d> mRepresentatives;
+};
+}
+}
+}
+#endif
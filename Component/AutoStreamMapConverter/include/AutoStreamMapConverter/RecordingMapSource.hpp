@@ -0,0 +1,120 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#ifndef TOMTOM_AUTOSTREAM_MAP_CONVERTER_RECORDING_MAP_SOURCE_H
+#define TOMTOM_AUTOSTREAM_MAP_CONVERTER_RECORDING_MAP_SOURCE_H
+
+#include "DataTypes.hpp"
+#include "MapRecording.hpp"
+#include "MapSource.hpp"
+
+#include <vector>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+/**
+ * Map source that forwards all queries to another map source and adds the returned data to a map
+ * recording. Multiple recording map sources can add to the same recording concurrently.
+ */
+class CAutoStreamRecordingMapSource : public CAutoStreamMapSource
+{
+public:
+  /**
+   * Constructing a CAutoStreamRecordingMapSource object requires a source and a recording.
+   */
+  CAutoStreamRecordingMapSource() = delete;
+
+  /**
+   * Construct a map source recording the data served by another map source.
+   *
+   * @param[in] aSource Map source of which the data must be recorded.
+   * @param[in, out] aRecording Recording to which data is added, must outlive the map source.
+   */
+  CAutoStreamRecordingMapSource(TMapSourcePtr aSource, CAutoStreamMapRecording& aRecording);
+
+  AutoStream::CMapVersionAndHash getMapVersionAndHash() const override;
+
+  std::vector<AutoStream::HdMap::TArcKey>
+  getArcKeysInArea(const AutoStream::TBoundingBox& aArea) override;
+
+  CAutoStreamArcData getArc(const AutoStream::HdMap::TArcKey& aArcKey) override;
+
+  void prefetchArc(const AutoStream::HdMap::TArcKey& aArcKey) override;
+
+  std::vector<AutoStream::HdMap::TTrafficSignKey>
+  getTrafficSignKeysInArea(const AutoStream::TBoundingBox& aArea) override;
+
+  CAutoStreamTrafficSignData
+  getTrafficSign(const AutoStream::HdMap::TTrafficSignKey& aTrafficSignKey) override;
+
+private:
+  TMapSourcePtr            mSource;
+  CAutoStreamMapRecording& mRecording;
+};
+
+/**
+ * Map source that serves the data of a map recording, such that a recorded conversion can be
+ * replayed without AutoStream.
+ */
+class CAutoStreamReplayMapSource : public CAutoStreamMapSource
+{
+public:
+  /**
+   * Constructing a CAutoStreamReplayMapSource object requires a recording.
+   */
+  CAutoStreamReplayMapSource() = delete;
+
+  /**
+   * Construct a map source serving the data of a recording.
+   *
+   * @param[in] aRecording Recording that must be served, must outlive the map source.
+   */
+  explicit CAutoStreamReplayMapSource(const CAutoStreamMapRecording& aRecording);
+
+  AutoStream::CMapVersionAndHash getMapVersionAndHash() const override;
+
+  /**
+   * @throw std::runtime_error If the area was not queried by the recorded conversion.
+   */
+  std::vector<AutoStream::HdMap::TArcKey>
+  getArcKeysInArea(const AutoStream::TBoundingBox& aArea) override;
+
+  /**
+   * @throw std::runtime_error If the arc was not retrieved by the recorded conversion.
+   */
+  CAutoStreamArcData getArc(const AutoStream::HdMap::TArcKey& aArcKey) override;
+
+  /**
+   * Recorded data is kept in memory, nothing needs to be prefetched.
+   */
+  void prefetchArc(const AutoStream::HdMap::TArcKey& aArcKey) override;
+
+  /**
+   * @throw std::runtime_error If the area was not queried by the recorded conversion.
+   */
+  std::vector<AutoStream::HdMap::TTrafficSignKey>
+  getTrafficSignKeysInArea(const AutoStream::TBoundingBox& aArea) override;
+
+  /**
+   * @throw std::runtime_error If the traffic sign was not retrieved by the recorded conversion.
+   */
+  CAutoStreamTrafficSignData
+  getTrafficSign(const AutoStream::HdMap::TTrafficSignKey& aTrafficSignKey) override;
+
+private:
+  const CAutoStreamMapRecording& mRecording;
+};
+}
+}
+}
+#endif
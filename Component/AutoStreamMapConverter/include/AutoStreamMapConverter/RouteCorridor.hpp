@@ -0,0 +1,120 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#ifndef TOMTOM_AUTOSTREAM_MAP_CONVERTER_ROUTE_CORRIDOR_H
+#define TOMTOM_AUTOSTREAM_MAP_CONVERTER_ROUTE_CORRIDOR_H
+
+#include "TomTom/AutoStream/MapBaseTypes.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+/**
+ * Corridor within a buffer distance around a route polyline. Every route segment is split into
+ * pieces of at most twice the buffer width, each piece is covered by its own small bounding box
+ * extended by the buffer width. The covered area therefore grows with the length of the route
+ * instead of with the area of the bounding box of the whole route.
+ *
+ * Distances are approximated in a local plane per piece, which is accurate enough for buffers of up
+ * to a few kilometres.
+ */
+class CRouteCorridor
+{
+public:
+  /**
+   * Delete default constructor.
+   */
+  CRouteCorridor() = delete;
+
+  /**
+   * Construct the corridor around a route.
+   *
+   * @param[in] aRoute Route as a polyline of WGS84 coordinates. A single point results in a
+   * circular corridor, an empty route in an empty corridor.
+   * @param[in] aBufferWidthMeter Distance from the route that belongs to the corridor, in meters.
+   */
+  CRouteCorridor(const std::vector<AutoStream::TCoordinate>& aRoute,
+                 const double                                aBufferWidthMeter);
+
+  /**
+   * Check if the corridor is empty.
+   *
+   * @retval True If the route was empty.
+   * @retval False If the corridor has at least one piece.
+   */
+  bool empty() const noexcept;
+
+  /**
+   * Get the bounding boxes covering the pieces of the corridor, in route order.
+   *
+   * @retval const std::vector<AutoStream::TBoundingBox>& Bounding box of each piece.
+   */
+  const std::vector<AutoStream::TBoundingBox>& getBoundingBoxes() const noexcept;
+
+  /**
+   * Get the bounding box of the whole corridor.
+   *
+   * @retval AutoStream::TBoundingBox Bounding box containing all pieces.
+   */
+  AutoStream::TBoundingBox getBoundingBox() const;
+
+  /**
+   * Check if a line segment comes within the buffer distance of the given piece of the route.
+   * A single point can be checked by passing it as start and end.
+   *
+   * @param[in] aPieceIdx Index of the piece, equal to the index of its bounding box.
+   * @param[in] aStart Start of the line segment.
+   * @param[in] aEnd End of the line segment.
+   * @retval True If the segment is within the buffer distance of the piece.
+   * @retval False If the segment is further away.
+   */
+  bool isSegmentWithinPiece(const size_t                   aPieceIdx,
+                            const AutoStream::TCoordinate& aStart,
+                            const AutoStream::TCoordinate& aEnd) const;
+
+  /**
+   * Check if a point lies within the corridor.
+   *
+   * @param[in] aPoint Point that must be checked.
+   * @retval True If the point is within the buffer distance of the route.
+   * @retval False If the point is further away.
+   */
+  bool contains(const AutoStream::TCoordinate& aPoint) const;
+
+private:
+  /**
+   * Route piece in a local plane with the start of the piece as origin, in meters.
+   */
+  struct CPiece
+  {
+    double mStartLat;
+    double mStartLon;
+    double mMeterPerLonDegree;
+    double mEndX;
+    double mEndY;
+  };
+
+  double                                mBufferWidthMeter;
+  std::vector<CPiece>                   mPieces;
+  std::vector<AutoStream::TBoundingBox> mBoundingBoxes;
+  double                                mSouthLat;
+  double                                mWestLon;
+  double                                mNorthLat;
+  double                                mEastLon;
+};
+}
+}
+}
+#endif
@@ -0,0 +1,177 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#ifndef TOMTOM_AUTOSTREAM_MAP_CONVERTER_ROUTING_GRAPH_H
+#define TOMTOM_AUTOSTREAM_MAP_CONVERTER_ROUTING_GRAPH_H
+
+#include <lanelet2_core/primitives/Lanelet.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+/**
+ * Relation from one lanelet to another in the routing graph, named after the relations of the
+ * lanelet2 routing graph for vehicles.
+ */
+enum class TRoutingRelation : uint32_t
+{
+  // The other lanelet starts where the lanelet ends
+  Successor,
+  // The other lanelet shares the left bound and may be changed to
+  Left,
+  // The other lanelet shares the right bound and may be changed to
+  Right,
+  // The other lanelet shares the left bound, but the bound must not be crossed
+  AdjacentLeft,
+  // The other lanelet shares the right bound, but the bound must not be crossed
+  AdjacentRight,
+  // The bounds of the lanelets cross, while they share neither a bound nor an end point
+  Conflicting,
+  // The other lanelet ends where the lanelet ends
+  Merging,
+  // The other lanelet starts where the lanelet starts
+  Diverging
+};
+
+/**
+ * Lanelet of the routing graph, of which the outgoing relations are a range of the relation table.
+ * Both directions of a two-way lanelet are part of the graph, the opposite direction as inverted
+ * lanelet with the same ID.
+ */
+struct CRoutingGraphLanelet
+{
+  int64_t  mId;
+  double   mLengthMeter;
+  uint32_t mFirstRelation;
+  uint32_t mNumberOfRelations;
+  // One for the opposite direction of a two-way lanelet, zero otherwise
+  uint32_t mInverted;
+  // Unused, keeps the record free of padding
+  uint32_t mReserved;
+};
+
+/**
+ * Outgoing relation of a lanelet, to another lanelet given as index in the lanelet table.
+ */
+struct CRoutingGraphRelation
+{
+  uint32_t         mLanelet;
+  TRoutingRelation mRelation;
+};
+
+/**
+ * Routing graph of the converted lanelets for vehicles. Successors follow from the stitched
+ * outgoing lane connections, merging and diverging lanelets from shared end points and neighbours
+ * from the lane borders that lanelets share, such that the graph is built while converting instead
+ * of geometrically by every consumer. Only conflicts are found geometrically, by crossing bounds of
+ * lanelets that are close to each other. Lanelets, successors and lane changes follow the lanelet2
+ * vehicle traffic rules, which leave out lanelets that vehicles must not use and add the opposite
+ * direction of two-way lanelets.
+ *
+ * Lanelets are stored sorted by ID and direction, their relations sorted by kind and target. The
+ * graph is stored as a small header followed by both tables as raw records, compressed with gzip
+ * if the file name ends with ".gz".
+ */
+class CRoutingGraph
+{
+public:
+  /**
+   * Construct an empty graph.
+   */
+  CRoutingGraph();
+
+  /**
+   * Build the graph of the given lanelets, replacing the current graph.
+   *
+   * @param[in] aLanelets Lanelets of the map, after connections have been stitched.
+   */
+  void build(const std::vector<lanelet::Lanelet>& aLanelets);
+
+  /**
+   * Remove all lanelets and relations.
+   */
+  void clear();
+
+  /**
+   * Store the graph.
+   *
+   * @param[in] aFileName Name of the file to which the graph must be written.
+   * @retval True If storing succeeded.
+   * @retval False If the file could not be written.
+   */
+  bool store(const std::string& aFileName) const;
+
+  /**
+   * Load a graph written by store, replacing the current graph.
+   *
+   * @param[in] aFileName Name of the file from which the graph must be read.
+   * @retval True If loading succeeded.
+   * @retval False If the file does not exist, is of another version or is corrupt.
+   */
+  bool load(const std::string& aFileName);
+
+  /**
+   * Find the index of a direction of the lanelet with the given ID.
+   *
+   * @param[in] aId ID of the lanelet.
+   * @param[in] aInverted True for the opposite direction of a two-way lanelet.
+   * @param[out] aLaneletIdx Index of the lanelet in the lanelet table.
+   * @retval True If the lanelet can be driven in that direction.
+   * @retval False If the lanelet is not part of the graph in that direction.
+   */
+  bool findLanelet(const lanelet::Id aId, const bool aInverted, size_t& aLaneletIdx) const;
+
+  /**
+   * Get the lanelets to which a lanelet has a relation of the given kind.
+   *
+   * @param[in] aLaneletIdx Index of the lanelet in the lanelet table.
+   * @param[in] aRelation Kind of relation.
+   * @retval std::vector<size_t> Indices of the related lanelets, empty if the index is invalid.
+   */
+  std::vector<size_t> getRelatedLanelets(const size_t           aLaneletIdx,
+                                         const TRoutingRelation aRelation) const;
+
+  /**
+   * Count the relations of the given kind.
+   *
+   * @param[in] aRelation Kind of relation.
+   * @retval size_t Number of relations of that kind.
+   */
+  size_t getNumberOfRelations(const TRoutingRelation aRelation) const;
+
+  /**
+   * Get the lanelets of the graph.
+   *
+   * @retval const std::vector<CRoutingGraphLanelet>& Lanelets sorted by ID and direction.
+   */
+  const std::vector<CRoutingGraphLanelet>& getLanelets() const noexcept;
+
+  /**
+   * Get the relations of all lanelets.
+   *
+   * @retval const std::vector<CRoutingGraphRelation>& Relations, grouped by lanelet.
+   */
+  const std::vector<CRoutingGraphRelation>& getRelations() const noexcept;
+
+private:
+  std::vector<CRoutingGraphLanelet>  mLanelets;
+  std::vector<CRoutingGraphRelation> mRelations;
+};
+}
+}
+}
+#endif
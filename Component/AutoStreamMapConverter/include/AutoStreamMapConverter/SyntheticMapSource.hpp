@@ -0,0 +1,312 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#ifndef TOMTOM_AUTOSTREAM_MAP_CONVERTER_SYNTHETIC_MAP_SOURCE_H
+#define TOMTOM_AUTOSTREAM_MAP_CONVERTER_SYNTHETIC_MAP_SOURCE_H
+
+#include "DataTypes.hpp"
+#include "MapSource.hpp"
+
+#include "TomTom/AutoStream/MapBaseTypes.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+/**
+ * Marking of a lane border of a synthetic map.
+ */
+enum class TSyntheticBorderMarking
+{
+  // White painted lines
+  LongDashedLine,
+  ShortDashedLine,
+  SolidLine,
+  // Yellow solid line with a long dashed line next to it, of which only the first is converted
+  DoubleLine,
+  // Border without marking
+  NoMarking,
+  // Physical borders
+  Curb,
+  Guardrail,
+  Fence
+};
+
+/**
+ * Structure that holds the parameters of a synthetic map. The map consists of straight roads
+ * running east, stacked from south to north. Each road is a chain of lane group arcs of which the
+ * lanes are connected to the lanes of the next arc, except at configured connection gaps.
+ */
+struct CSyntheticMapParameters
+{
+  /**
+   * Construct parameters of a small map with a bit of everything.
+   */
+  CSyntheticMapParameters();
+
+  // Total number of arcs and number of arcs chained along each road
+  size_t mNumberOfArcs;
+  size_t mArcsPerRoad;
+
+  // Number of regular lanes of each arc, excluding parking areas and triangular lanes
+  uint32_t mNumberOfLanes;
+
+  // Arc geometry
+  double   mArcLengthMeter;
+  double   mLaneWidthMeter;
+  uint32_t mPointsPerBorder;
+
+  // Every n-th arc of a road has a parking area right of the lanes, zero for none
+  size_t mParkingAreaInterval;
+
+  // Every n-th arc of a road ends with a converging triangular lane that starts as a diverging
+  // triangular lane in the preceding arc, zero for none. Intervals below three are ignored.
+  size_t mTriangularLaneInterval;
+
+  // Number of traffic signs along each kilometer of road
+  double mTrafficSignsPerKilometer;
+
+  // Outer borders of every road
+  TSyntheticBorderMarking mRightBorder;
+  TSyntheticBorderMarking mLeftBorder;
+
+  // Markings of the borders between regular lanes, used in turn from right to left and shifted by
+  // one border on every next road. Long dashed lines are used if empty.
+  std::vector<TSyntheticBorderMarking> mInnerBorders;
+
+  // Every n-th arc of a road has no outgoing lane connections, such that the road is split into
+  // unconnected parts, zero for none
+  size_t mConnectionGapInterval;
+
+  // Every n-th road has lanes on which opposing traffic is allowed, zero for none
+  size_t mTwoWayRoadInterval;
+
+  // South-west corner of the map
+  double mOriginLatDeg;
+  double mOriginLonDeg;
+};
+
+/**
+ * Map source that serves a generated map instead of AutoStream data, such that conversion can be
+ * run and measured for any map size without network access. The same parameters always generate
+ * the same map. Arcs and traffic signs are generated on request, nothing is kept in memory.
+ */
+class CAutoStreamSyntheticMapSource : public CAutoStreamMapSource
+{
+public:
+  /**
+   * Constructing a CAutoStreamSyntheticMapSource object requires map parameters.
+   */
+  CAutoStreamSyntheticMapSource() = delete;
+
+  /**
+   * Construct a map source generating a map with the given parameters.
+   *
+   * @param[in] aParameters Parameters of the map.
+   */
+  explicit CAutoStreamSyntheticMapSource(const CSyntheticMapParameters& aParameters);
+
+  /**
+   * Get the bounding box enclosing all arcs and traffic signs of the map.
+   *
+   * @retval AutoStream::TBoundingBox Bounding box of the map.
+   */
+  AutoStream::TBoundingBox getBoundingBox() const;
+
+  /**
+   * Get the map version, which is derived from the map parameters, such that cached conversion
+   * results of maps with other parameters are not reused.
+   *
+   * @retval AutoStream::CMapVersionAndHash Map version and hash.
+   */
+  AutoStream::CMapVersionAndHash getMapVersionAndHash() const override;
+
+  std::vector<AutoStream::HdMap::TArcKey>
+  getArcKeysInArea(const AutoStream::TBoundingBox& aArea) override;
+
+  /**
+   * @throw std::runtime_error If the key does not belong to an arc of the map.
+   */
+  CAutoStreamArcData getArc(const AutoStream::HdMap::TArcKey& aArcKey) override;
+
+  /**
+   * Arcs are generated on request, nothing needs to be prefetched.
+   */
+  void prefetchArc(const AutoStream::HdMap::TArcKey& aArcKey) override;
+
+  std::vector<AutoStream::HdMap::TTrafficSignKey>
+  getTrafficSignKeysInArea(const AutoStream::TBoundingBox& aArea) override;
+
+  /**
+   * @throw std::runtime_error If the key does not belong to a traffic sign of the map.
+   */
+  CAutoStreamTrafficSignData
+  getTrafficSign(const AutoStream::HdMap::TTrafficSignKey& aTrafficSignKey) override;
+
+private:
+  /**
+   * Structure that describes which lanes an arc has, from right to left: an optional parking
+   * area, the regular lanes and an optional triangular lane.
+   */
+  struct CArcLayout
+  {
+    bool mParkingArea;
+    bool mDivergingLane;
+    bool mConvergingLane;
+
+    /**
+     * Get the index of the right-most regular lane.
+     *
+     * @retval uint32_t Lane index.
+     */
+    uint32_t getFirstRegularLane() const noexcept;
+
+    /**
+     * Get the number of lanes of the arc, including parking areas and triangular lanes.
+     *
+     * @param[in] aNumberOfRegularLanes Number of regular lanes.
+     * @retval uint32_t Number of lanes.
+     */
+    uint32_t getNumberOfLanes(const uint32_t aNumberOfRegularLanes) const noexcept;
+  };
+
+  /**
+   * Get the lanes of the arc at the given position along its road.
+   *
+   * @param[in] aPosition Position of the arc along its road.
+   * @retval CArcLayout Layout of the arc.
+   */
+  CArcLayout getArcLayout(const size_t aPosition) const noexcept;
+
+  /**
+   * Get the number of arcs along a road, the last road may be shorter than the others.
+   *
+   * @param[in] aRoad Index of the road.
+   * @retval size_t Number of arcs.
+   */
+  size_t getNumberOfArcsOnRoad(const size_t aRoad) const noexcept;
+
+  /**
+   * Get the number of traffic signs along a road.
+   *
+   * @param[in] aRoad Index of the road.
+   * @retval size_t Number of traffic signs.
+   */
+  size_t getNumberOfTrafficSignsOnRoad(const size_t aRoad) const noexcept;
+
+  /**
+   * Get the lateral offset of a lane border from the right border of the regular lanes.
+   *
+   * @param[in] aLayout Layout of the arc.
+   * @param[in] aBorderIdx Index of the border, from right to left.
+   * @param[in] aFraction Fraction of the arc length at which the offset must be computed.
+   * @retval double Offset in meters, positive towards the north.
+   */
+  double getBorderOffset(const CArcLayout& aLayout,
+                         const uint32_t    aBorderIdx,
+                         const double      aFraction) const noexcept;
+
+  /**
+   * Get the marking of a lane border of an arc: the outer borders are configured, a parking area
+   * is separated by a solid line and a triangular lane by a short dashed line.
+   *
+   * @param[in] aRoad Index of the road of the arc.
+   * @param[in] aLayout Layout of the arc.
+   * @param[in] aBorderIdx Index of the border, from right to left.
+   * @retval TSyntheticBorderMarking Marking of the border.
+   */
+  TSyntheticBorderMarking getBorderMarking(const size_t      aRoad,
+                                           const CArcLayout& aLayout,
+                                           const uint32_t    aBorderIdx) const noexcept;
+
+  /**
+   * Generate a lane border of an arc.
+   *
+   * @param[in] aRoad Index of the road of the arc.
+   * @param[in] aPosition Position of the arc along its road.
+   * @param[in] aLayout Layout of the arc.
+   * @param[in] aBorderIdx Index of the border, from right to left.
+   * @retval CAutoStreamLaneBorder Lane border.
+   */
+  CAutoStreamLaneBorder getLaneBorder(const size_t      aRoad,
+                                      const size_t      aPosition,
+                                      const CArcLayout& aLayout,
+                                      const uint32_t    aBorderIdx) const;
+
+  /**
+   * Generate the meta data and speed limit of a lane, including its outgoing connections.
+   *
+   * @param[in] aArcIdx Index of the arc.
+   * @param[in] aLayout Layout of the arc.
+   * @param[in] aLaneIdx Index of the lane, from right to left.
+   * @param[out] aArcData Arc data to which the lane must be added.
+   */
+  void addLane(const size_t        aArcIdx,
+               const CArcLayout&   aLayout,
+               const uint32_t      aLaneIdx,
+               CAutoStreamArcData& aArcData) const;
+
+  /**
+   * Convert a position relative to the south-west corner of the map to WGS84.
+   *
+   * @param[in] aEastMeter Distance to the east.
+   * @param[in] aNorthMeter Distance to the north.
+   * @retval AutoStream::TCoordinate Coordinate of the position.
+   */
+  AutoStream::TCoordinate toCoordinate(const double aEastMeter, const double aNorthMeter) const;
+
+  /**
+   * Convert a bounding box to distances relative to the south-west corner of the map.
+   *
+   * @param[in] aArea Bounding box.
+   * @param[out] aWestMeter Western border.
+   * @param[out] aSouthMeter Southern border.
+   * @param[out] aEastMeter Eastern border.
+   * @param[out] aNorthMeter Northern border.
+   */
+  void toMeters(const AutoStream::TBoundingBox& aArea,
+                double&                         aWestMeter,
+                double&                         aSouthMeter,
+                double&                         aEastMeter,
+                double&                         aNorthMeter) const;
+
+  /**
+   * Get the range of roads of which the given band of lateral offsets overlaps an area.
+   *
+   * @param[in] aSouthMeter Southern border of the area.
+   * @param[in] aNorthMeter Northern border of the area.
+   * @param[in] aMinOffsetMeter Smallest offset from the right border of the regular lanes.
+   * @param[in] aMaxOffsetMeter Largest offset from the right border of the regular lanes.
+   * @param[out] aFirstRoad First road in range.
+   * @param[out] aEndRoad Road after the last road in range.
+   */
+  void getRoadsInArea(const double aSouthMeter,
+                      const double aNorthMeter,
+                      const double aMinOffsetMeter,
+                      const double aMaxOffsetMeter,
+                      size_t&      aFirstRoad,
+                      size_t&      aEndRoad) const noexcept;
+
+  CSyntheticMapParameters        mParameters;
+  AutoStream::CMapVersionAndHash mMapVersionAndHash;
+  size_t                         mNumberOfRoads;
+  size_t                         mTrafficSignsPerRoad;
+  double                         mRoadSpacingMeter;
+  double                         mMetersPerDegreeLon;
+};
+}
+}
+}
+#endif
@@ -0,0 +1,202 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#ifndef TOMTOM_AUTOSTREAM_MAP_CONVERTER_TRACE_RECORDER_H
+#define TOMTOM_AUTOSTREAM_MAP_CONVERTER_TRACE_RECORDER_H
+
+#include "TomTom/AutoStream/HdMap/HdMapArc.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+typedef std::chrono::steady_clock TTraceClock;
+
+/**
+ * Structure that holds a single span of a trace.
+ */
+struct CTraceEvent
+{
+  // Name of the span, must be a string literal
+  const char* mName;
+
+  // Start and duration of the span, the start is relative to the start of the trace
+  int64_t mStartNs;
+  int64_t mDurationNs;
+
+  // Thread that recorded the span, zero for the thread running the conversion
+  uint32_t mThreadId;
+
+  // Optional tags of the span
+  bool                       mHasArcKey;
+  AutoStream::HdMap::TArcKey mArcKey;
+  bool                       mHasLaneCount;
+  uint32_t                   mLaneCount;
+};
+
+/**
+ * Collects the spans recorded by all threads of a conversion and writes them in the Chrome trace
+ * event format, which can be opened with chrome://tracing or Perfetto. Threads record spans in a
+ * CTraceBuffer of their own, which is handed to the recorder in large chunks, such that recording
+ * a span does not take a lock. The number of kept spans is limited, later spans are dropped.
+ */
+class CTraceRecorder
+{
+public:
+  /**
+   * Construct an empty recorder.
+   */
+  CTraceRecorder();
+
+  /**
+   * Remove all recorded spans and restart the trace clock.
+   */
+  void start();
+
+  /**
+   * Get the time at which the trace started.
+   *
+   * @retval TTraceClock::time_point Start of the trace.
+   */
+  TTraceClock::time_point getStart() const noexcept;
+
+  /**
+   * Add spans recorded by a thread. May be called by multiple threads concurrently.
+   *
+   * @param[in, out] aEvents Spans that must be added, cleared afterwards.
+   */
+  void addEvents(std::vector<CTraceEvent>& aEvents);
+
+  /**
+   * Write all spans in the Chrome trace event format.
+   *
+   * @param[in] aFileName Name of the file to which the trace must be written.
+   * @retval True If the trace was written.
+   * @retval False If writing the file failed.
+   */
+  bool store(const std::string& aFileName) const;
+
+private:
+  TTraceClock::time_point  mStart;
+  std::vector<CTraceEvent> mEvents;
+  size_t                   mNumberOfDroppedEvents;
+  uint32_t                 mMaxThreadId;
+  mutable std::mutex       mMutex;
+};
+
+/**
+ * Buffer of the spans recorded by a single thread. Spans are handed to the recorder when the buffer
+ * is full, flushed or destroyed.
+ */
+class CTraceBuffer
+{
+public:
+  /**
+   * Constructing a CTraceBuffer object requires a recorder.
+   */
+  CTraceBuffer() = delete;
+
+  /**
+   * Construct a buffer for a thread.
+   *
+   * @param[in, out] aRecorder Recorder to which spans are handed, must outlive the buffer.
+   * @param[in] aThreadId Identifier of the thread in the trace.
+   */
+  CTraceBuffer(CTraceRecorder& aRecorder, const uint32_t aThreadId);
+
+  /**
+   * Hand the remaining spans to the recorder.
+   */
+  ~CTraceBuffer();
+
+  CTraceBuffer(const CTraceBuffer&) = delete;
+  CTraceBuffer& operator=(const CTraceBuffer&) = delete;
+
+  /**
+   * Add a span.
+   *
+   * @param[in] aEvent Span that must be added, the thread and start are set by the buffer.
+   * @param[in] aStart Start of the span.
+   * @param[in] aEnd End of the span.
+   */
+  void addSpan(CTraceEvent                   aEvent,
+               const TTraceClock::time_point aStart,
+               const TTraceClock::time_point aEnd);
+
+  /**
+   * Hand all buffered spans to the recorder.
+   */
+  void flush();
+
+private:
+  CTraceRecorder&          mRecorder;
+  const uint32_t           mThreadId;
+  std::vector<CTraceEvent> mEvents;
+};
+
+/**
+ * Span measured from its construction until its destruction. Nothing is measured without buffer,
+ * such that spans can be left in place when tracing is disabled.
+ */
+class CTraceSpan
+{
+public:
+  /**
+   * Constructing a CTraceSpan object requires a name.
+   */
+  CTraceSpan() = delete;
+
+  /**
+   * Start a span.
+   *
+   * @param[in, out] aBuffer Buffer to which the span is added, nullptr if tracing is disabled.
+   * @param[in] aName Name of the span, must be a string literal.
+   */
+  CTraceSpan(CTraceBuffer* aBuffer, const char* aName);
+
+  /**
+   * End the span and add it to the buffer.
+   */
+  ~CTraceSpan();
+
+  CTraceSpan(const CTraceSpan&) = delete;
+  CTraceSpan& operator=(const CTraceSpan&) = delete;
+
+  /**
+   * Tag the span with the key of the arc it works on.
+   *
+   * @param[in] aArcKey Key of the arc.
+   */
+  void setArcKey(const AutoStream::HdMap::TArcKey& aArcKey) noexcept;
+
+  /**
+   * Tag the span with the number of lanes it works on.
+   *
+   * @param[in] aLaneCount Number of lanes.
+   */
+  void setLaneCount(const size_t aLaneCount) noexcept;
+
+private:
+  CTraceBuffer*           mBuffer;
+  CTraceEvent             mEvent;
+  TTraceClock::time_point mStart;
+};
+}
+}
+}
+#endif
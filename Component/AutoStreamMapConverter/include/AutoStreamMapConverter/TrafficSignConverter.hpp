@@ -12,8 +12,9 @@
 #ifndef TOMTOM_AUTOSTREAM_MAP_CONVERTER_TRAFFIC_SIGN_CONVERTER_H
 #define TOMTOM_AUTOSTREAM_MAP_CONVERTER_TRAFFIC_SIGN_CONVERTER_H
 
-#include "TomTom/AutoStream/HdMap/HdMapAccess.h"
-#include "TomTom/AutoStream/HdMap/HdMapTrafficSign.h"
+#include "DataTypes.hpp"
+#include "IdAllocator.hpp"
+
 #include "TomTom/AutoStream/HdMap/TrafficSignDataTypes.h"
 
 #include <lanelet2_core/primitives/Polygon.h>
@@ -43,18 +44,18 @@ public:
   explicit CAutoStreamTrafficSignConverter(const lanelet::projection::UtmProjector& aUtmProjector);
 
   /**
-   * Convert a given traffic sign to a polygon.
+   * Convert the data of a traffic sign to a polygon.
    *
-   * @param[in] aTrafficSign Traffic sign that must be converted.
-   * @param[in] aMapAccess Map access that can be used to retrieve required information.
+   * @param[in] aTrafficSign Data of the traffic sign that must be converted.
+   * @param[in, out] aIdAllocator Allocator providing the IDs of the polygon and its points.
    * @param[out] aTrafficSignPolygon Instance used to store converted traffic
    * sign.
    * @retval True If conversion succeeded.
    * @retval False If conversion failed.
    */
-  bool convertTrafficSign(const AutoStream::HdMap::TTrafficSign& aTrafficSign,
-                          const AutoStream::HdMap::CHdMapAccess* aMapAccess,
-                          lanelet::Polygon3d&                    aTrafficSignPolygon) const;
+  bool convertTrafficSign(const CAutoStreamTrafficSignData& aTrafficSign,
+                          CIdAllocator&                     aIdAllocator,
+                          lanelet::Polygon3d&               aTrafficSignPolygon) const;
 
 private:
   /**
@@ -64,12 +65,14 @@ private:
    * @param[in] aPosition Traffic sign center of mass position.
    * @param[in] aNormal Traffic sign normal in degrees with respect to north.
    * @param[in] aSize Traffic sign size.
+   * @param[in, out] aIdAllocator Allocator providing the IDs of the polygon and its points.
    * @retval lanelet::Polygon3d Polygon representing the traffic sign bounding box.
    */
   lanelet::Polygon3d
   getTrafficSignBoundingBox(const AutoStream::TCoordinate3D&                           aPosition,
                             const double&                                              aNormal,
-                            const AutoStream::HdMap::HdMapTrafficSignLayer::TSignSize& aSize) const;
+                            const AutoStream::HdMap::HdMapTrafficSignLayer::TSignSize& aSize,
+                            CIdAllocator& aIdAllocator) const;
 
   /**
    * Transform a normal in deg from AutoStream (azimuth of the sign face relative to the Equator) to
@@ -0,0 +1,119 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#ifndef TOMTOM_AUTOSTREAM_MAP_CONVERTER_UTM_BATCH_PROJECTOR_H
+#define TOMTOM_AUTOSTREAM_MAP_CONVERTER_UTM_BATCH_PROJECTOR_H
+
+#include <lanelet2_projection/UTM.h>
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+/**
+ * Projects sequences of WGS84 coordinates to the frame of a lanelet2 UTM projector. The Transverse
+ * Mercator series (Krüger, sixth order in the third flattening, as evaluated by GeographicLib) is
+ * set up once for the UTM zone of the projector origin, such that a whole sequence is projected in
+ * a single loop over plain arrays without calls into GeographicLib. The offset of the UTM projector
+ * is taken from its projection of the origin, such that projectors with and without offset are
+ * reproduced.
+ *
+ * Points in the polar regions or on the hemisphere opposite to the origin, and all points of a
+ * projector with its origin in a polar region, are projected one by one using the UTM projector.
+ */
+class CUtmBatchProjector
+{
+public:
+  /**
+   * Constructor.
+   *
+   * @param[in] aUtmProjector Projector of which the results must be reproduced.
+   */
+  explicit CUtmBatchProjector(const lanelet::projection::UtmProjector& aUtmProjector);
+
+  /**
+   * Project the given coordinates to UTM. Heights are not affected by the projection.
+   *
+   * @param[in] aLatDeg Latitudes in degrees.
+   * @param[in] aLonDeg Longitudes in degrees, one for each latitude.
+   * @param[out] aX Projected x coordinates in meters, one for each latitude.
+   * @param[out] aY Projected y coordinates in meters, one for each latitude.
+   */
+  void forward(const std::vector<double>& aLatDeg,
+               const std::vector<double>& aLonDeg,
+               std::vector<double>&       aX,
+               std::vector<double>&       aY) const;
+
+  /**
+   * Check if the series is used for projecting points.
+   *
+   * @retval True If points are projected using the series.
+   * @retval False If points are projected one by one using the UTM projector.
+   */
+  bool isSeriesUsed() const noexcept;
+
+  /**
+   * Get the UTM projector of which the results are reproduced.
+   *
+   * @return const lanelet::projection::UtmProjector& UTM projector.
+   */
+  const lanelet::projection::UtmProjector& getUtmProjector() const noexcept;
+
+private:
+  // Order of the series in the third flattening
+  static constexpr size_t kSeriesOrder = 6;
+
+  /**
+   * Project coordinates using the series, without checking whether they can be projected to the
+   * zone and hemisphere of the origin.
+   *
+   * @param[in] aLatDeg Latitudes in degrees.
+   * @param[in] aLonDeg Longitudes in degrees.
+   * @param[in] aSize Number of coordinates.
+   * @param[out] aX Projected x coordinates in meters.
+   * @param[out] aY Projected y coordinates in meters.
+   */
+  void forwardSeries(const double* aLatDeg,
+                     const double* aLonDeg,
+                     size_t        aSize,
+                     double*       aX,
+                     double*       aY) const;
+
+  /**
+   * Check if a coordinate can be projected using the series. Coordinates in the polar regions and
+   * on the hemisphere opposite to the origin are left to the UTM projector.
+   *
+   * @param[in] aLatDeg Latitude in degrees.
+   * @retval True If the coordinate can be projected using the series.
+   * @retval False If the coordinate must be projected using the UTM projector.
+   */
+  bool isCoveredBySeries(double aLatDeg) const noexcept;
+
+  lanelet::projection::UtmProjector mUtmProjector;
+
+  bool   mUseSeries;
+  bool   mNorthernHemisphere;
+  double mCentralMeridianDeg;
+
+  // Series coefficients, rectifying radius multiplied by the UTM scale factor and origin offset
+  std::array<double, kSeriesOrder> mAlpha;
+  double                           mScaledRectifyingRadius;
+  double                           mOffsetX;
+  double                           mOffsetY;
+};
+}
+}
+}
+#endif
@@ -0,0 +1,651 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#include "AutoStreamMapConverter/ArcCache.hpp"
+
+#include <lanelet2_core/LaneletMap.h>
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <type_traits>
+#include <unordered_map>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+namespace Constants {
+// Identification of cache files, the version must be increased whenever the format or the
+// conversion itself changes
+constexpr char     kArcCacheMagic[]   = "ASLLARCC";
+constexpr uint32_t kArcCacheVersion   = 1;
+constexpr size_t   kArcCacheMagicSize = sizeof(kArcCacheMagic) - 1;
+}
+
+static_assert(std::is_trivially_copyable<AutoStream::HdMap::TArcKey>::value,
+              "Arc keys are stored as raw bytes");
+static_assert(std::is_trivially_copyable<AutoStream::CMapVersionAndHash>::value,
+              "Map versions are stored as raw bytes");
+
+/**
+ * Append the bytes of a value to a buffer.
+ *
+ * @param[in] aValue Value that must be appended, must be trivially copyable.
+ * @param[in, out] aBuffer Buffer to which the value must be appended.
+ */
+template <typename T>
+void appendValue(const T& aValue, std::string& aBuffer)
+{
+  static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be appended");
+  aBuffer.append(reinterpret_cast<const char*>(&aValue), sizeof(T));
+}
+
+/**
+ * Append a string, preceded by its length, to a buffer.
+ *
+ * @param[in] aValue String that must be appended.
+ * @param[in, out] aBuffer Buffer to which the string must be appended.
+ */
+void appendString(const std::string& aValue, std::string& aBuffer)
+{
+  appendValue(static_cast<uint32_t>(aValue.size()), aBuffer);
+  aBuffer.append(aValue);
+}
+
+/**
+ * Append the attributes of a primitive to a buffer.
+ *
+ * @param[in] aAttributes Attributes that must be appended.
+ * @param[in, out] aBuffer Buffer to which the attributes must be appended.
+ */
+void appendAttributes(const lanelet::AttributeMap& aAttributes, std::string& aBuffer)
+{
+  appendValue(static_cast<uint32_t>(aAttributes.size()), aBuffer);
+  for (const auto& attribute : aAttributes)
+  {
+    appendString(attribute.first, aBuffer);
+    appendString(attribute.second.value(), aBuffer);
+  }
+}
+
+/**
+ * Sequential reader of values appended to a buffer. Reading beyond the end of the buffer fails
+ * and leaves the target unchanged.
+ */
+class CBufferReader
+{
+public:
+  /**
+   * Constructor.
+   *
+   * @param[in] aBuffer Buffer that must be read, must outlive the reader.
+   */
+  explicit CBufferReader(const std::string& aBuffer)
+    : mBuffer(aBuffer)
+    , mPosition(0)
+  {
+  }
+
+  /**
+   * Read a value.
+   *
+   * @param[out] aValue Value that has been read.
+   * @retval True If reading succeeded.
+   * @retval False If the buffer is too short.
+   */
+  template <typename T>
+  bool read(T& aValue)
+  {
+    static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be read");
+    if (mBuffer.size() - mPosition < sizeof(T))
+    {
+      return false;
+    }
+
+    std::memcpy(&aValue, mBuffer.data() + mPosition, sizeof(T));
+    mPosition += sizeof(T);
+    return true;
+  }
+
+  /**
+   * Read a string preceded by its length.
+   *
+   * @param[out] aValue String that has been read.
+   * @retval True If reading succeeded.
+   * @retval False If the buffer is too short.
+   */
+  bool readString(std::string& aValue)
+  {
+    uint32_t length = 0;
+    if (!read(length) || mBuffer.size() - mPosition < length)
+    {
+      return false;
+    }
+
+    aValue.assign(mBuffer, mPosition, length);
+    mPosition += length;
+    return true;
+  }
+
+  /**
+   * Read attributes of a primitive.
+   *
+   * @param[out] aAttributes Attributes that have been read.
+   * @retval True If reading succeeded.
+   * @retval False If the buffer is too short.
+   */
+  bool readAttributes(lanelet::AttributeMap& aAttributes)
+  {
+    uint32_t numberOfAttributes = 0;
+    if (!read(numberOfAttributes))
+    {
+      return false;
+    }
+
+    for (uint32_t idx = 0; idx < numberOfAttributes; ++idx)
+    {
+      std::string key, value;
+      if (!readString(key) || !readString(value))
+      {
+        return false;
+      }
+      aAttributes[key] = value;
+    }
+
+    return true;
+  }
+
+private:
+  const std::string& mBuffer;
+  size_t             mPosition;
+};
+
+/**
+ * Builds the tables of points and line strings of a conversion result. Points and line strings are
+ * shared between lanelets and areas of an arc, they are stored once and referred to by index.
+ */
+class CPrimitiveTables
+{
+public:
+  /**
+   * Append a reference to a line string to a buffer, adding the line string to the table first if
+   * needed. The orientation of the reference is stored as well.
+   *
+   * @param[in] aLineString Line string that is referred to.
+   * @param[in, out] aBuffer Buffer to which the reference must be appended.
+   */
+  void appendLineStringReference(const lanelet::ConstLineString3d& aLineString,
+                                 std::string&                      aBuffer)
+  {
+    const lanelet::ConstLineString3d lineString =
+      aLineString.inverted() ? aLineString.invert() : aLineString;
+
+    auto lineStringIdx = mLineStringIndices.find(lineString.id());
+    if (lineStringIdx == mLineStringIndices.end())
+    {
+      lineStringIdx =
+        mLineStringIndices.emplace(lineString.id(), static_cast<uint32_t>(mLineStrings.size()))
+          .first;
+      mLineStrings.push_back(lineString);
+      for (size_t idx = 0; idx < lineString.size(); ++idx)
+      {
+        const lanelet::ConstPoint3d point = lineString[idx];
+        if (mPointIndices.emplace(point.id(), static_cast<uint32_t>(mPoints.size())).second)
+        {
+          mPoints.push_back(point);
+        }
+      }
+    }
+
+    appendValue(lineStringIdx->second, aBuffer);
+    appendValue(static_cast<uint8_t>(aLineString.inverted()), aBuffer);
+  }
+
+  /**
+   * Append the tables of points and line strings to a buffer.
+   *
+   * @param[in, out] aBuffer Buffer to which the tables must be appended.
+   */
+  void appendTables(std::string& aBuffer) const
+  {
+    appendValue(static_cast<uint32_t>(mPoints.size()), aBuffer);
+    for (const auto& point : mPoints)
+    {
+      appendValue(point.x(), aBuffer);
+      appendValue(point.y(), aBuffer);
+      appendValue(point.z(), aBuffer);
+      appendAttributes(point.attributes(), aBuffer);
+    }
+
+    appendValue(static_cast<uint32_t>(mLineStrings.size()), aBuffer);
+    for (const auto& lineString : mLineStrings)
+    {
+      appendValue(static_cast<uint32_t>(lineString.size()), aBuffer);
+      for (size_t idx = 0; idx < lineString.size(); ++idx)
+      {
+        appendValue(mPointIndices.at(lineString[idx].id()), aBuffer);
+      }
+      appendAttributes(lineString.attributes(), aBuffer);
+    }
+  }
+
+private:
+  std::vector<lanelet::ConstPoint3d>        mPoints;
+  std::vector<lanelet::ConstLineString3d>   mLineStrings;
+  std::unordered_map<lanelet::Id, uint32_t> mPointIndices;
+  std::unordered_map<lanelet::Id, uint32_t> mLineStringIndices;
+};
+
+/**
+ * Read a line string reference and resolve it using the given table.
+ *
+ * @param[in, out] aReader Reader from which the reference must be read.
+ * @param[in] aLineStrings Table of line strings.
+ * @param[out] aLineString Referred line string, in the stored orientation.
+ * @retval True If reading succeeded.
+ * @retval False If the entry is corrupt.
+ */
+bool readLineStringReference(CBufferReader&                            aReader,
+                             const std::vector<lanelet::LineString3d>& aLineStrings,
+                             lanelet::LineString3d&                    aLineString)
+{
+  uint32_t lineStringIdx = 0;
+  uint8_t  inverted      = 0;
+  if (!aReader.read(lineStringIdx) || !aReader.read(inverted)
+      || lineStringIdx >= aLineStrings.size())
+  {
+    return false;
+  }
+
+  aLineString = inverted != 0 ? aLineStrings[lineStringIdx].invert() : aLineStrings[lineStringIdx];
+  return true;
+}
+
+CAutoStreamArcCache::CAutoStreamArcCache()
+  : mMapVersionAndHash()
+  , mOriginLat(0.)
+  , mOriginLon(0.)
+{
+}
+
+void CAutoStreamArcCache::reset(const AutoStream::CMapVersionAndHash& aMapVersionAndHash,
+                                const lanelet::GPSPoint&              aOrigin)
+{
+  mMapVersionAndHash = aMapVersionAndHash;
+  mOriginLat         = aOrigin.lat;
+  mOriginLon         = aOrigin.lon;
+  mEntries.clear();
+}
+
+bool CAutoStreamArcCache::load(const std::string& aFileName)
+{
+  mEntries.clear();
+
+  std::ifstream file(aFileName, std::ios::binary);
+  if (!file.is_open())
+  {
+    return false;
+  }
+
+  // The size of the file limits the data sizes of the entries, such that a corrupt size is detected
+  // before anything is allocated for it
+  file.seekg(0, std::ios::end);
+  const std::streamoff fileSize = file.tellg();
+  file.seekg(0, std::ios::beg);
+
+  char     magic[Constants::kArcCacheMagicSize];
+  uint32_t version         = 0;
+  uint64_t numberOfEntries = 0;
+  file.read(magic, sizeof(magic));
+  file.read(reinterpret_cast<char*>(&version), sizeof(version));
+  if (!file || std::memcmp(magic, Constants::kArcCacheMagic, sizeof(magic)) != 0
+      || version != Constants::kArcCacheVersion)
+  {
+    std::cerr << "Arc cache " << aFileName << " has an unsupported format, ignoring it."
+              << std::endl;
+    return false;
+  }
+
+  file.read(reinterpret_cast<char*>(&mMapVersionAndHash), sizeof(mMapVersionAndHash));
+  file.read(reinterpret_cast<char*>(&mOriginLat), sizeof(mOriginLat));
+  file.read(reinterpret_cast<char*>(&mOriginLon), sizeof(mOriginLon));
+  file.read(reinterpret_cast<char*>(&numberOfEntries), sizeof(numberOfEntries));
+
+  for (uint64_t entryIdx = 0; file && entryIdx < numberOfEntries; ++entryIdx)
+  {
+    AutoStream::HdMap::TArcKey key;
+    CAutoStreamArcCacheEntry   entry;
+    uint64_t                   dataSize = 0;
+    file.read(reinterpret_cast<char*>(&key), sizeof(key));
+    file.read(reinterpret_cast<char*>(&entry.mFingerprint), sizeof(entry.mFingerprint));
+    file.read(reinterpret_cast<char*>(&dataSize), sizeof(dataSize));
+    const std::streamoff position = file.tellg();
+    if (!file || position < 0 || fileSize < position
+        || dataSize > static_cast<uint64_t>(fileSize - position))
+    {
+      file.setstate(std::ios::failbit);
+      break;
+    }
+
+    if (dataSize > 0)
+    {
+      entry.mData.resize(dataSize);
+      file.read(&entry.mData[0], static_cast<std::streamsize>(dataSize));
+    }
+    mEntries.emplace(key, std::move(entry));
+  }
+
+  if (!file)
+  {
+    std::cerr << "Arc cache " << aFileName << " is truncated or corrupt, ignoring it." << std::endl;
+    mEntries.clear();
+    return false;
+  }
+
+  return true;
+}
+
+bool CAutoStreamArcCache::store(const std::string& aFileName) const
+{
+  std::ofstream file(aFileName, std::ios::binary | std::ios::trunc);
+  if (!file.is_open())
+  {
+    std::cerr << "Opening arc cache " << aFileName << " for writing failed." << std::endl;
+    return false;
+  }
+
+  const uint64_t numberOfEntries = mEntries.size();
+  file.write(Constants::kArcCacheMagic, Constants::kArcCacheMagicSize);
+  file.write(reinterpret_cast<const char*>(&Constants::kArcCacheVersion),
+             sizeof(Constants::kArcCacheVersion));
+  file.write(reinterpret_cast<const char*>(&mMapVersionAndHash), sizeof(mMapVersionAndHash));
+  file.write(reinterpret_cast<const char*>(&mOriginLat), sizeof(mOriginLat));
+  file.write(reinterpret_cast<const char*>(&mOriginLon), sizeof(mOriginLon));
+  file.write(reinterpret_cast<const char*>(&numberOfEntries), sizeof(numberOfEntries));
+
+  for (const auto& keyAndEntry : mEntries)
+  {
+    const uint64_t dataSize = keyAndEntry.second.mData.size();
+    file.write(reinterpret_cast<const char*>(&keyAndEntry.first), sizeof(keyAndEntry.first));
+    file.write(reinterpret_cast<const char*>(&keyAndEntry.second.mFingerprint),
+               sizeof(keyAndEntry.second.mFingerprint));
+    file.write(reinterpret_cast<const char*>(&dataSize), sizeof(dataSize));
+    file.write(keyAndEntry.second.mData.data(), static_cast<std::streamsize>(dataSize));
+  }
+
+  file.flush();
+  if (!file)
+  {
+    std::cerr << "Writing arc cache " << aFileName << " failed." << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool CAutoStreamArcCache::hasMapVersion(
+  const AutoStream::CMapVersionAndHash& aMapVersionAndHash) const noexcept
+{
+  return std::memcmp(&mMapVersionAndHash, &aMapVersionAndHash, sizeof(mMapVersionAndHash)) == 0;
+}
+
+bool CAutoStreamArcCache::hasOrigin(const lanelet::GPSPoint& aOrigin) const noexcept
+{
+  return mOriginLat == aOrigin.lat && mOriginLon == aOrigin.lon;
+}
+
+const CAutoStreamArcCacheEntry*
+CAutoStreamArcCache::find(const AutoStream::HdMap::TArcKey& aArcKey) const
+{
+  const auto entry = mEntries.find(aArcKey);
+  return entry == mEntries.end() ? nullptr : &entry->second;
+}
+
+void CAutoStreamArcCache::add(const AutoStream::HdMap::TArcKey&     aArcKey,
+                              const CAutoStreamArcConversionResult& aResult)
+{
+  // Lanelets, areas and meta data refer to the tables, which are therefore stored in front of them
+  CPrimitiveTables tables;
+  std::string      primitives;
+
+  appendValue(static_cast<uint8_t>(aResult.mConverted), primitives);
+
+  appendValue(static_cast<uint32_t>(aResult.mLanelets.size()), primitives);
+  for (const auto& lanelet : aResult.mLanelets)
+  {
+    const bool valid = lanelet.id() != lanelet::InvalId;
+    appendValue(static_cast<uint8_t>(valid), primitives);
+    if (valid)
+    {
+      tables.appendLineStringReference(lanelet.leftBound(), primitives);
+      tables.appendLineStringReference(lanelet.rightBound(), primitives);
+      appendAttributes(lanelet.attributes(), primitives);
+    }
+  }
+
+  appendValue(static_cast<uint32_t>(aResult.mAreas.size()), primitives);
+  for (const auto& area : aResult.mAreas)
+  {
+    const auto outerBound = area.outerBound();
+    appendValue(static_cast<uint32_t>(outerBound.size()), primitives);
+    for (const auto& border : outerBound)
+    {
+      tables.appendLineStringReference(border, primitives);
+    }
+    appendAttributes(area.attributes(), primitives);
+  }
+
+  appendValue(static_cast<uint32_t>(aResult.mConnections.size()), primitives);
+  for (const auto& metaData : aResult.mConnections)
+  {
+    appendValue(metaData.mDrivingSide, primitives);
+    appendValue(static_cast<uint8_t>(metaData.mOpposingTrafficAllowed), primitives);
+    appendValue(metaData.mLaneWidthCm, primitives);
+    appendValue(metaData.mLaneLengthCm, primitives);
+    appendValue(metaData.mType, primitives);
+    appendValue(static_cast<uint8_t>(metaData.mInvalidConnectionOut), primitives);
+    appendValue(static_cast<uint32_t>(metaData.mConnectionsOut.size()), primitives);
+    for (const auto& connection : metaData.mConnectionsOut)
+    {
+      appendValue(connection.first, primitives);
+      appendValue(connection.second, primitives);
+    }
+  }
+
+  CAutoStreamArcCacheEntry& entry = mEntries[aArcKey];
+  entry.mFingerprint              = aResult.mFingerprint;
+  entry.mData.clear();
+  tables.appendTables(entry.mData);
+  entry.mData.append(primitives);
+}
+
+bool CAutoStreamArcCache::restore(const CAutoStreamArcCacheEntry& aEntry,
+                                  CIdAllocator&                   aIdAllocator,
+                                  CAutoStreamArcConversionResult& aResult)
+{
+  CBufferReader reader(aEntry.mData);
+
+  // Points
+  uint32_t numberOfPoints = 0;
+  if (!reader.read(numberOfPoints))
+  {
+    return false;
+  }
+
+  std::vector<lanelet::Point3d> points;
+  for (uint32_t pointIdx = 0; pointIdx < numberOfPoints; ++pointIdx)
+  {
+    double x = 0., y = 0., z = 0.;
+    if (!reader.read(x) || !reader.read(y) || !reader.read(z))
+    {
+      return false;
+    }
+
+    points.emplace_back(aIdAllocator.getId(), x, y, z);
+    if (!reader.readAttributes(points.back().attributes()))
+    {
+      return false;
+    }
+  }
+
+  // Line strings
+  uint32_t numberOfLineStrings = 0;
+  if (!reader.read(numberOfLineStrings))
+  {
+    return false;
+  }
+
+  std::vector<lanelet::LineString3d> lineStrings;
+  for (uint32_t lineStringIdx = 0; lineStringIdx < numberOfLineStrings; ++lineStringIdx)
+  {
+    uint32_t numberOfLineStringPoints = 0;
+    if (!reader.read(numberOfLineStringPoints))
+    {
+      return false;
+    }
+
+    lanelet::Points3d lineStringPoints;
+    for (uint32_t idx = 0; idx < numberOfLineStringPoints; ++idx)
+    {
+      uint32_t pointIdx = 0;
+      if (!reader.read(pointIdx) || pointIdx >= points.size())
+      {
+        return false;
+      }
+      lineStringPoints.push_back(points[pointIdx]);
+    }
+
+    lineStrings.emplace_back(aIdAllocator.getId(), lineStringPoints);
+    if (!reader.readAttributes(lineStrings.back().attributes()))
+    {
+      return false;
+    }
+  }
+
+  // Lanelets
+  uint8_t  converted        = 0;
+  uint32_t numberOfLanelets = 0;
+  if (!reader.read(converted) || !reader.read(numberOfLanelets))
+  {
+    return false;
+  }
+
+  aResult.mConverted = converted != 0;
+  aResult.mLanelets.clear();
+  for (uint32_t laneletIdx = 0; laneletIdx < numberOfLanelets; ++laneletIdx)
+  {
+    uint8_t valid = 0;
+    if (!reader.read(valid))
+    {
+      return false;
+    }
+
+    if (valid == 0)
+    {
+      aResult.mLanelets.emplace_back(lanelet::InvalId);
+      continue;
+    }
+
+    lanelet::LineString3d left, right;
+    if (!readLineStringReference(reader, lineStrings, left)
+        || !readLineStringReference(reader, lineStrings, right))
+    {
+      return false;
+    }
+
+    aResult.mLanelets.emplace_back(aIdAllocator.getId(), left, right);
+    if (!reader.readAttributes(aResult.mLanelets.back().attributes()))
+    {
+      return false;
+    }
+  }
+
+  // Areas
+  uint32_t numberOfAreas = 0;
+  if (!reader.read(numberOfAreas))
+  {
+    return false;
+  }
+
+  aResult.mAreas.clear();
+  for (uint32_t areaIdx = 0; areaIdx < numberOfAreas; ++areaIdx)
+  {
+    uint32_t numberOfBorders = 0;
+    if (!reader.read(numberOfBorders))
+    {
+      return false;
+    }
+
+    lanelet::LineStrings3d outerBound(numberOfBorders);
+    for (auto& border : outerBound)
+    {
+      if (!readLineStringReference(reader, lineStrings, border))
+      {
+        return false;
+      }
+    }
+
+    aResult.mAreas.emplace_back(aIdAllocator.getId(), outerBound);
+    if (!reader.readAttributes(aResult.mAreas.back().attributes()))
+    {
+      return false;
+    }
+  }
+
+  // Lane meta data
+  uint32_t numberOfLanes = 0;
+  if (!reader.read(numberOfLanes))
+  {
+    return false;
+  }
+
+  aResult.mConnections.clear();
+  for (uint32_t laneIdx = 0; laneIdx < numberOfLanes; ++laneIdx)
+  {
+    CAutoStreamLaneMetaData metaData;
+    uint8_t                 opposingTrafficAllowed = 0;
+    uint8_t                 invalidConnectionOut   = 0;
+    uint32_t                numberOfConnections    = 0;
+    if (!reader.read(metaData.mDrivingSide) || !reader.read(opposingTrafficAllowed)
+        || !reader.read(metaData.mLaneWidthCm) || !reader.read(metaData.mLaneLengthCm)
+        || !reader.read(metaData.mType) || !reader.read(invalidConnectionOut)
+        || !reader.read(numberOfConnections))
+    {
+      return false;
+    }
+
+    metaData.mOpposingTrafficAllowed = opposingTrafficAllowed != 0;
+    metaData.mInvalidConnectionOut   = invalidConnectionOut != 0;
+    for (uint32_t connectionIdx = 0; connectionIdx < numberOfConnections; ++connectionIdx)
+    {
+      std::pair<AutoStream::HdMap::TArcKey, uint32_t> connection;
+      if (!reader.read(connection.first) || !reader.read(connection.second))
+      {
+        return false;
+      }
+      metaData.mConnectionsOut.push_back(connection);
+    }
+
+    aResult.mConnections.push_back(metaData);
+  }
+
+  aResult.mFingerprint = aEntry.mFingerprint;
+  return true;
+}
+
+size_t CAutoStreamArcCache::size() const noexcept
+{
+  return mEntries.size();
+}
+}
+}
+}
@@ -10,42 +10,59 @@
  */
 
 #include "AutoStreamMapConverter/ArcConverter.hpp"
+#include "AutoStreamMapConverter/ConversionHelpers.hpp"
 
-#include "TomTom/AutoStream/HdMap/HdMapSpeedRestrictions.h"
+#include <algorithm>
+#include <type_traits>
 
 namespace TomTom {
 namespace AutoStreamForAutoware {
 namespace AutoStreamMapConverter {
 
+namespace Constants {
+// Parameters of the 64-bit FNV-1a hash used for fingerprints
+constexpr uint64_t kFingerprintOffsetBasis = 14695981039346656037ULL;
+constexpr uint64_t kFingerprintPrime       = 1099511628211ULL;
+}
+
+/**
+ * Add the bytes of a value to a fingerprint.
+ *
+ * @param[in] aValue Value that must be added, must be trivially copyable.
+ * @param[in, out] aFingerprint Fingerprint to which the value must be added.
+ */
+template <typename T>
+void addToFingerprint(const T& aValue, uint64_t& aFingerprint)
+{
+  static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be fingerprinted");
+
+  const auto* bytes = reinterpret_cast<const unsigned char*>(&aValue);
+  for (size_t idx = 0; idx < sizeof(T); ++idx)
+  {
+    aFingerprint = (aFingerprint ^ bytes[idx]) * Constants::kFingerprintPrime;
+  }
+}
+
 CAutoStreamArcConverter::CAutoStreamArcConverter(
   const lanelet::projection::UtmProjector& aUtmProjector)
+  : mTraceBuffer(nullptr)
 {
   mLaneConverter = std::make_unique<CAutoStreamLaneConverter>(aUtmProjector);
 }
 
-bool CAutoStreamArcConverter::convertArc(const AutoStream::HdMap::TArc&         aArc,
-                                         const AutoStream::HdMap::CHdMapAccess* aMapAccess,
-                                         std::vector<lanelet::Area>&            aAreas,
-                                         std::vector<lanelet::Lanelet>&         aLanelets,
-                                         std::vector<CAutoStreamLaneMetaData>&  aConnections,
-                                         std::set<lanelet::Id>& aInvalidConnectionsOut)
+bool CAutoStreamArcConverter::convertArc(CAutoStreamArcData&                   aArcData,
+                                         CIdAllocator&                         aIdAllocator,
+                                         std::vector<lanelet::Area>&           aAreas,
+                                         std::vector<lanelet::Lanelet>&        aLanelets,
+                                         std::vector<CAutoStreamLaneMetaData>& aConnections)
 {
-  if (!validateMapAccess(aMapAccess))
-  {
-    return false;
-  }
-
   try
   {
-    // Get speed restrictions
-    const AutoStream::HdMap::CHdMapSpeedRestrictions& speedRestrictions =
-      aMapAccess->getSpeedRestrictions();
-
-    // Get and convert lane borders
-    CAutoStreamArcData laneData = getLanes(aArc, aMapAccess);
-    mLaneConverter->convertLanes(
-      laneData, aArc, speedRestrictions, aAreas, aLanelets, aInvalidConnectionsOut);
-    aConnections = laneData.mLaneMetaData;
+    // Convert lane borders
+    CTraceSpan span(mTraceBuffer, "convertLanes");
+    span.setLaneCount(aArcData.mLaneMetaData.size());
+    mLaneConverter->convertLanes(aArcData, aIdAllocator, aAreas, aLanelets);
+    aConnections = aArcData.mLaneMetaData;
   }
   catch (const std::exception& e)
   {
@@ -56,108 +73,110 @@ bool CAutoStreamArcConverter::convertArc(const AutoStream::HdMap::TArc&
   return true;
 }
 
-CAutoStreamArcData
-CAutoStreamArcConverter::getLanes(const AutoStream::HdMap::TArc&         aArc,
-                                  const AutoStream::HdMap::CHdMapAccess* aMapAccess) const
+uint64_t CAutoStreamArcConverter::getArcFingerprint(const CAutoStreamArcData& aArcData) const
 {
-  CAutoStreamArcData laneData;
+  uint64_t fingerprint = Constants::kFingerprintOffsetBasis;
+  addToFingerprint(aArcData.mLaneMetaData.size(), fingerprint);
+  addToFingerprint(aArcData.mLaneBorders.size(), fingerprint);
+  addToFingerprint(aArcData.mSpeedLimits.size(), fingerprint);
 
-  // Only lane groups can be converted
-  const auto arcType = aMapAccess->arcType(aArc);
-  if (arcType != AutoStream::HdMap::HdRoad::TArcType::kArcTypeLaneGroup)
+  for (const auto& metaData : aArcData.mLaneMetaData)
   {
-    std::cerr << "Only lane groups can be converted, conversion of arc with type " << arcType
-              << " failed." << std::endl;
-    return laneData;
+    addToFingerprint(metaData.mDrivingSide, fingerprint);
+    addToFingerprint(metaData.mOpposingTrafficAllowed, fingerprint);
+    addToFingerprint(metaData.mLaneWidthCm, fingerprint);
+    addToFingerprint(metaData.mLaneLengthCm, fingerprint);
+    addToFingerprint(metaData.mType, fingerprint);
+    addToFingerprint(metaData.mConnectionsOut.size(), fingerprint);
+    for (const auto& connection : metaData.mConnectionsOut)
+    {
+      addToFingerprint(connection.first, fingerprint);
+      addToFingerprint(connection.second, fingerprint);
+    }
   }
 
-  // Iterate over lanes, from right to left
-  uint32_t    numberOfLanes = aMapAccess->nrOfLanesOrTrajectories(aArc);
-  const auto& drivingSide   = aMapAccess->drivingSide(aArc);
-  for (uint32_t idx = 0; idx < numberOfLanes; ++idx)
+  for (const auto& speedLimit : aArcData.mSpeedLimits)
   {
-    // Get lane with given index from arc and store data
-    auto lane = aMapAccess->getLaneOrTrajectory(aArc, idx);
-
-    // For last lane, store left border as well
-    getLaneMetaDataAndBorders(lane, drivingSide, idx == numberOfLanes - 1, laneData);
+    addToFingerprint(speedLimit.mNumberOfRestrictions, fingerprint);
+    if (speedLimit.mNumberOfRestrictions > 0)
+    {
+      addToFingerprint(speedLimit.mValue, fingerprint);
+      addToFingerprint(speedLimit.mUnit, fingerprint);
+    }
   }
 
-  return laneData;
-}
-
-bool CAutoStreamArcConverter::validateMapAccess(
-  const AutoStream::HdMap::CHdMapAccess* aMapAccess) const noexcept
-{
-  if (!aMapAccess)
+  for (const auto& border : aArcData.mLaneBorders)
   {
-    std::cerr << "Invalid map access pointer." << std::endl;
-    return false;
-  }
-
-  if (!aMapAccess->isValid())
-  {
-    std::cerr << "Provided map access is invalid." << std::endl;
-    return false;
+    addToFingerprint(border.mComponents.size(), fingerprint);
+    addToFingerprint(border.mWidthCm, fingerprint);
+    for (const auto& component : border.mComponents)
+    {
+      addToFingerprint(component.mType, fingerprint);
+      addToFingerprint(component.mColor, fingerprint);
+      for (const AutoStream::TCoordinate3D& point : component.mLine)
+      {
+        addToFingerprint(point.getXY().getLatDegree(), fingerprint);
+        addToFingerprint(point.getXY().getLonDegree(), fingerprint);
+        addToFingerprint(point.getHeight(), fingerprint);
+      }
+    }
   }
 
-  return true;
-}
-
-void CAutoStreamArcConverter::getLaneMetaDataAndBorders(
-  const AutoStream::HdMap::HdRoad::CLaneOrTrajectory& aLane,
-  const AutoStream::HdMap::HdRoad::TDrivingSide       aDrivingSide,
-  bool                                                aStoreLeftBorder,
-  CAutoStreamArcData&                                 aLaneData) const
-{
-  // Store all data
-  aLaneData.mLaneMetaData.emplace_back(getLaneMetaData(aLane, aDrivingSide));
-  storeLaneBorders(aLane, aStoreLeftBorder, aDrivingSide, aLaneData);
+  return fingerprint;
 }
 
-CAutoStreamLaneMetaData CAutoStreamArcConverter::getLaneMetaData(
-  const AutoStream::HdMap::HdRoad::CLaneOrTrajectory& aLane,
-  const AutoStream::HdMap::HdRoad::TDrivingSide       aDrivingSide) const
+bool CAutoStreamArcConverter::isArcInCorridor(const CAutoStreamArcData&  aArcData,
+                                              const CRouteCorridor&      aCorridor,
+                                              const std::vector<size_t>& aPieceIndices) const
 {
-  // Add meta data
-  CAutoStreamLaneMetaData metaData;
-  metaData.mDrivingSide            = aDrivingSide;
-  metaData.mLaneWidthCm            = aLane.laneWidth();
-  metaData.mLaneLengthCm           = aLane.laneLength();
-  metaData.mType                   = aLane.laneType();
-  metaData.mOpposingTrafficAllowed = aLane.isOpposingTrafficPossible();
-  for (uint32_t conIdx = 0; conIdx < aLane.nrOfOutgoingLaneConnections(); ++conIdx)
+  const auto isSegmentInCorridor = [&](const AutoStream::TCoordinate& aStart,
+                                       const AutoStream::TCoordinate& aEnd) {
+    return std::any_of(aPieceIndices.begin(), aPieceIndices.end(), [&](const size_t aPieceIdx) {
+      return aCorridor.isSegmentWithinPiece(aPieceIdx, aStart, aEnd);
+    });
+  };
+
+  for (const auto& border : aArcData.mLaneBorders)
   {
-    metaData.mConnectionsOut.emplace_back(aLane.outgoingLaneConnection(conIdx));
+    for (const auto& component : border.mComponents)
+    {
+      // Check the segments between consecutive points, a single point is checked on its own
+      const auto& line = component.mLine;
+      if (line.empty())
+      {
+        continue;
+      }
+
+      AutoStream::TCoordinate previous = line.front().getXY();
+      if (isSegmentInCorridor(previous, previous))
+      {
+        return true;
+      }
+
+      for (size_t pointIdx = 1; pointIdx < line.size(); ++pointIdx)
+      {
+        const AutoStream::TCoordinate current = line[pointIdx].getXY();
+        if (isSegmentInCorridor(previous, current))
+        {
+          return true;
+        }
+        previous = current;
+      }
+    }
   }
 
-  return metaData;
+  return false;
 }
 
-void CAutoStreamArcConverter::storeLaneBorders(
-  const AutoStream::HdMap::HdRoad::CLaneOrTrajectory& aLane,
-  const bool                                          aStoreSecondBorder,
-  const AutoStream::HdMap::HdRoad::TDrivingSide       aDrivingSide,
-  CAutoStreamArcData&                                 aLaneData) const
+CTraceBuffer* CAutoStreamArcConverter::getTraceBuffer() const noexcept
 {
-  auto firstBorder  = AutoStream::HdMap::HdRoad::CLaneOrTrajectory::kBorderSideRight;
-  auto secondBorder = AutoStream::HdMap::HdRoad::CLaneOrTrajectory::kBorderSideLeft;
-
-  if (aDrivingSide == AutoStream::HdMap::HdRoad::TDrivingSide::kDrivingSideLeft)
-  {
-    firstBorder  = AutoStream::HdMap::HdRoad::CLaneOrTrajectory::kBorderSideLeft;
-    secondBorder = AutoStream::HdMap::HdRoad::CLaneOrTrajectory::kBorderSideRight;
-  }
-
-  // Store first lane border (e.g. left border is same as right border next lane when driving on the
-  // right)
-  aLaneData.mLaneBorders.emplace_back(aLane.laneBorder(firstBorder));
+  return mTraceBuffer;
+}
 
-  // Store second border if needed
-  if (aStoreSecondBorder)
-  {
-    aLaneData.mLaneBorders.emplace_back(aLane.laneBorder(secondBorder));
-  }
+void CAutoStreamArcConverter::setTraceBuffer(CTraceBuffer* aTraceBuffer) noexcept
+{
+  mTraceBuffer = aTraceBuffer;
+  mLaneConverter->setTraceBuffer(aTraceBuffer);
 }
 }
 }
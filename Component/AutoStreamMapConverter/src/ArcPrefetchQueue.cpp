@@ -0,0 +1,64 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#include "AutoStreamMapConverter/ArcPrefetchQueue.hpp"
+
+#include <algorithm>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+CArcPrefetchQueue::CArcPrefetchQueue(const size_t aCapacity)
+  : mCapacity(std::max<size_t>(aCapacity, 1))
+  , mClosed(false)
+{
+}
+
+bool CArcPrefetchQueue::push(const size_t aArcIdx)
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  mNotFull.wait(lock, [this]() { return mClosed || mArcIndices.size() < mCapacity; });
+  if (mClosed)
+  {
+    return false;
+  }
+
+  mArcIndices.push_back(aArcIdx);
+  mNotEmpty.notify_one();
+  return true;
+}
+
+bool CArcPrefetchQueue::pop(size_t& aArcIdx)
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  mNotEmpty.wait(lock, [this]() { return mClosed || !mArcIndices.empty(); });
+  if (mArcIndices.empty())
+  {
+    return false;
+  }
+
+  aArcIdx = mArcIndices.front();
+  mArcIndices.pop_front();
+  mNotFull.notify_one();
+  return true;
+}
+
+void CArcPrefetchQueue::close()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mClosed = true;
+  mNotFull.notify_all();
+  mNotEmpty.notify_all();
+}
+}
+}
+}
@@ -123,6 +123,38 @@ AutoStream::HdMap::CHdMapAccess* CAutoStreamInterface::getHdMapAccess() const
   return mHdMapAccess;
 }
 
+THdMapAccessPtr CAutoStreamInterface::createHdMapAccess() const
+{
+  const AutoStream::HdMap::CHdMap* hdMap = mHdMap;
+  if (!hdMap || !hdMap->isValid())
+  {
+    std::cerr << "HD map object is invalid, cannot create map access." << std::endl;
+    return THdMapAccessPtr();
+  }
+
+  THdMapAccessPtr mapAccess(
+    hdMap->createHdMapAccess(kMapLayer, mMapVersionAndHash.mapVersion),
+    [hdMap](AutoStream::HdMap::CHdMapAccess* aMapAccess) {
+      if (aMapAccess->isValid())
+      {
+        hdMap->destroyHdMapAccess(aMapAccess);
+      }
+    });
+
+  if (!mapAccess || !mapAccess->isValid())
+  {
+    std::cerr << "Failed to acquire valid map access object." << std::endl;
+    return THdMapAccessPtr();
+  }
+
+  return mapAccess;
+}
+
+const AutoStream::CMapVersionAndHash& CAutoStreamInterface::getMapVersionAndHash() const noexcept
+{
+  return mMapVersionAndHash;
+}
+
 bool CAutoStreamInterface::startAutoStream(const CAutoStreamParameters& aAutoStreamParams)
 {
   AutoStream::CAutoStreamSettings settings;
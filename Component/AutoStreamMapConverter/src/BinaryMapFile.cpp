@@ -0,0 +1,443 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#include "AutoStreamMapConverter/BinaryMapFile.hpp"
+#include "AutoStreamMapConverter/CompressedFile.hpp"
+
+#include <lanelet2_core/primitives/Area.h>
+#include <lanelet2_core/primitives/Lanelet.h>
+#include <lanelet2_core/primitives/Polygon.h>
+#include <lanelet2_projection/UTM.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <memory>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+namespace Constants {
+// Size of the blocks in which compressed binary map files are decompressed into memory
+constexpr size_t kBinaryMapReadBlockSize = 1 << 20;
+}
+
+/**
+ * Check whether a range of records lies within a table.
+ *
+ * @param[in] aFirst Index of the first record of the range.
+ * @param[in] aNumber Number of records in the range.
+ * @param[in] aTableSize Number of records in the table.
+ * @retval True If the range lies within the table.
+ * @retval False If the range exceeds the table.
+ */
+bool isRecordRangeValid(const uint64_t aFirst, const uint64_t aNumber, const uint64_t aTableSize)
+{
+  return aFirst <= aTableSize && aNumber <= aTableSize - aFirst;
+}
+
+bool isBinaryMapFile(const std::string& aFileName)
+{
+  CMapInputStream input;
+  char            magic[sizeof(kBinaryMapMagic)];
+  return input.open(aFileName) && input.read(magic, sizeof(magic))
+         && std::memcmp(magic, kBinaryMapMagic, sizeof(magic)) == 0;
+}
+
+CBinaryMapFile::CBinaryMapFile()
+  : mData(nullptr)
+  , mSize(0)
+  , mMapping(nullptr)
+  , mBuffer()
+{
+}
+
+CBinaryMapFile::~CBinaryMapFile()
+{
+  close();
+}
+
+bool CBinaryMapFile::open(const std::string& aFileName)
+{
+  close();
+
+  if (getMapFileCompression(aFileName) == TMapFileCompression::Gzip)
+  {
+    CMapInputStream input;
+    if (!input.open(aFileName))
+    {
+      std::cerr << "Opening binary map " << aFileName << " failed." << std::endl;
+      return false;
+    }
+
+    // The buffer of a vector is aligned for all record types
+    size_t size = 0;
+    do
+    {
+      mBuffer.resize(size + Constants::kBinaryMapReadBlockSize);
+      input.read(mBuffer.data() + size, static_cast<std::streamsize>(mBuffer.size() - size));
+      size += static_cast<size_t>(input.gcount());
+    } while (input);
+
+    if (input.bad())
+    {
+      std::cerr << "Decompressing binary map " << aFileName << " failed." << std::endl;
+      mBuffer.clear();
+      return false;
+    }
+    mBuffer.resize(size);
+
+    mData = mBuffer.data();
+    mSize = mBuffer.size();
+  }
+  else
+  {
+    const int fileDescriptor = ::open(aFileName.c_str(), O_RDONLY);
+    struct stat status;
+    if (fileDescriptor < 0 || ::fstat(fileDescriptor, &status) != 0)
+    {
+      std::cerr << "Opening binary map " << aFileName << " failed." << std::endl;
+      if (fileDescriptor >= 0)
+      {
+        ::close(fileDescriptor);
+      }
+      return false;
+    }
+
+    mSize = static_cast<size_t>(status.st_size);
+    if (mSize > 0)
+    {
+      // The mapping keeps the file open, the descriptor is not needed anymore
+      mMapping = ::mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    }
+    ::close(fileDescriptor);
+
+    if (mMapping == MAP_FAILED || mMapping == nullptr)
+    {
+      std::cerr << "Mapping binary map " << aFileName << " failed." << std::endl;
+      mMapping = nullptr;
+      mSize    = 0;
+      return false;
+    }
+
+    mData = static_cast<const char*>(mMapping);
+  }
+
+  if (!validate())
+  {
+    std::cerr << aFileName << " is not a valid binary map of version " << kBinaryMapVersion << "."
+              << std::endl;
+    close();
+    return false;
+  }
+
+  return true;
+}
+
+void CBinaryMapFile::close()
+{
+  if (mMapping != nullptr)
+  {
+    ::munmap(mMapping, mSize);
+    mMapping = nullptr;
+  }
+
+  mBuffer.clear();
+  mBuffer.shrink_to_fit();
+  mData = nullptr;
+  mSize = 0;
+}
+
+lanelet::GPSPoint CBinaryMapFile::getOrigin() const
+{
+  const CBinaryMapHeader& header = getHeader();
+
+  lanelet::GPSPoint origin;
+  origin.lat = header.mOriginLatitude;
+  origin.lon = header.mOriginLongitude;
+  origin.ele = header.mOriginAltitude;
+  return origin;
+}
+
+size_t CBinaryMapFile::getNumberOfRecords(const TBinaryMapTable aTable) const
+{
+  return static_cast<size_t>(getHeader().mTables[toIndex(aTable)].mNumberOfRecords);
+}
+
+lanelet::LaneletMapPtr CBinaryMapFile::createLaneletMap(const lanelet::Projector& aProjector) const
+{
+  const lanelet::GPSPoint                 origin          = getOrigin();
+  const lanelet::GPSPoint&                projectorOrigin = aProjector.origin().position;
+  const lanelet::projection::UtmProjector fileProjector((lanelet::Origin(origin)));
+
+  const bool isSameOrigin = origin.lat == projectorOrigin.lat && origin.lon == projectorOrigin.lon
+                            && origin.ele == projectorOrigin.ele;
+
+  lanelet::Id maxId = 0;
+
+  const CBinaryPoint* pointRecords = getRecords<CBinaryPoint>(TBinaryMapTable::Points);
+  std::vector<lanelet::Point3d> points;
+  points.reserve(getNumberOfRecords(TBinaryMapTable::Points));
+  for (size_t pointIdx = 0; pointIdx < getNumberOfRecords(TBinaryMapTable::Points); ++pointIdx)
+  {
+    const CBinaryPoint&   record = pointRecords[pointIdx];
+    lanelet::BasicPoint3d position(record.mX, record.mY, record.mZ);
+    if (!isSameOrigin)
+    {
+      position = aProjector.forward(fileProjector.reverse(position));
+    }
+
+    points.emplace_back(record.mId, position.x(), position.y(), position.z());
+    readAttributes(record.mFirstAttribute, record.mNumberOfAttributes, points.back().attributes());
+    maxId = std::max(maxId, record.mId);
+  }
+
+  const uint32_t* pointIndices = getRecords<uint32_t>(TBinaryMapTable::PointIndices);
+  const auto      getPoints    = [&points, pointIndices](const CBinaryLineString& aRecord) {
+    lanelet::Points3d lineStringPoints;
+    lineStringPoints.reserve(aRecord.mNumberOfPoints);
+    for (uint32_t idx = 0; idx < aRecord.mNumberOfPoints; ++idx)
+    {
+      lineStringPoints.push_back(points[pointIndices[aRecord.mFirstPointIndex + idx]]);
+    }
+    return lineStringPoints;
+  };
+
+  const CBinaryLineString* lineStringRecords =
+    getRecords<CBinaryLineString>(TBinaryMapTable::LineStrings);
+  std::vector<lanelet::LineString3d> lineStrings;
+  lineStrings.reserve(getNumberOfRecords(TBinaryMapTable::LineStrings));
+  for (size_t lineStringIdx = 0; lineStringIdx < getNumberOfRecords(TBinaryMapTable::LineStrings);
+       ++lineStringIdx)
+  {
+    const CBinaryLineString& record = lineStringRecords[lineStringIdx];
+    lineStrings.emplace_back(record.mId, getPoints(record));
+    readAttributes(record.mFirstAttribute,
+                   record.mNumberOfAttributes,
+                   lineStrings.back().attributes());
+    maxId = std::max(maxId, record.mId);
+  }
+
+  auto map = std::make_shared<lanelet::LaneletMap>();
+
+  const CBinaryLanelet* laneletRecords = getRecords<CBinaryLanelet>(TBinaryMapTable::Lanelets);
+  for (size_t laneletIdx = 0; laneletIdx < getNumberOfRecords(TBinaryMapTable::Lanelets);
+       ++laneletIdx)
+  {
+    const CBinaryLanelet&        record     = laneletRecords[laneletIdx];
+    const lanelet::LineString3d& leftBound  = lineStrings[record.mLeftBound];
+    const lanelet::LineString3d& rightBound = lineStrings[record.mRightBound];
+
+    lanelet::Lanelet lanelet(record.mId,
+                             record.mLeftBoundInverted != 0 ? leftBound.invert() : leftBound,
+                             record.mRightBoundInverted != 0 ? rightBound.invert() : rightBound);
+    readAttributes(record.mFirstAttribute, record.mNumberOfAttributes, lanelet.attributes());
+    map->add(lanelet);
+    maxId = std::max(maxId, record.mId);
+  }
+
+  const CBinaryArea*      areaRecords = getRecords<CBinaryArea>(TBinaryMapTable::Areas);
+  const CBinaryAreaBound* areaBounds  = getRecords<CBinaryAreaBound>(TBinaryMapTable::AreaBounds);
+  for (size_t areaIdx = 0; areaIdx < getNumberOfRecords(TBinaryMapTable::Areas); ++areaIdx)
+  {
+    const CBinaryArea& record = areaRecords[areaIdx];
+
+    lanelet::LineStrings3d outerBound;
+    outerBound.reserve(record.mNumberOfBounds);
+    for (uint32_t boundIdx = 0; boundIdx < record.mNumberOfBounds; ++boundIdx)
+    {
+      const CBinaryAreaBound&      bound      = areaBounds[record.mFirstBound + boundIdx];
+      const lanelet::LineString3d& lineString = lineStrings[bound.mLineString];
+      outerBound.push_back(bound.mInverted != 0 ? lineString.invert() : lineString);
+    }
+
+    lanelet::Area area(record.mId, outerBound);
+    readAttributes(record.mFirstAttribute, record.mNumberOfAttributes, area.attributes());
+    map->add(area);
+    maxId = std::max(maxId, record.mId);
+  }
+
+  const CBinaryLineString* polygonRecords =
+    getRecords<CBinaryLineString>(TBinaryMapTable::Polygons);
+  for (size_t polygonIdx = 0; polygonIdx < getNumberOfRecords(TBinaryMapTable::Polygons);
+       ++polygonIdx)
+  {
+    const CBinaryLineString& record = polygonRecords[polygonIdx];
+
+    lanelet::Polygon3d polygon(record.mId, getPoints(record));
+    readAttributes(record.mFirstAttribute, record.mNumberOfAttributes, polygon.attributes());
+    map->add(polygon);
+    maxId = std::max(maxId, record.mId);
+  }
+
+  // New primitives created by the user of the map must not reuse the IDs of the file. Converted
+  // IDs stay below 2^62, the largest ID is only possible in a corrupt file and cannot be followed.
+  if (maxId < std::numeric_limits<lanelet::Id>::max())
+  {
+    lanelet::utils::registerId(maxId);
+  }
+
+  return map;
+}
+
+size_t CBinaryMapFile::toIndex(const TBinaryMapTable aTable)
+{
+  return static_cast<size_t>(aTable);
+}
+
+const CBinaryMapHeader& CBinaryMapFile::getHeader() const
+{
+  return *reinterpret_cast<const CBinaryMapHeader*>(mData);
+}
+
+bool CBinaryMapFile::validate() const
+{
+  if (mData == nullptr || mSize < sizeof(CBinaryMapHeader))
+  {
+    return false;
+  }
+
+  const CBinaryMapHeader& header = getHeader();
+  if (std::memcmp(header.mMagic, kBinaryMapMagic, sizeof(header.mMagic)) != 0
+      || header.mVersion != kBinaryMapVersion || header.mByteOrderMark != kBinaryMapByteOrderMark)
+  {
+    return false;
+  }
+
+  const uint64_t recordSizes[kNumberOfBinaryMapTables] = {
+    sizeof(CBinaryPoint),     sizeof(CBinaryLineString), sizeof(CBinaryLineString),
+    sizeof(uint32_t),         sizeof(CBinaryLanelet),    sizeof(CBinaryArea),
+    sizeof(CBinaryAreaBound), sizeof(CBinaryAttribute),  sizeof(char)
+  };
+  for (size_t tableIdx = 0; tableIdx < kNumberOfBinaryMapTables; ++tableIdx)
+  {
+    const CBinaryMapTable& table = header.mTables[tableIdx];
+    if (table.mOffset % kBinaryMapTableAlignment != 0 || table.mOffset < sizeof(CBinaryMapHeader)
+        || table.mOffset > mSize
+        || table.mNumberOfRecords > (mSize - table.mOffset) / recordSizes[tableIdx])
+    {
+      return false;
+    }
+  }
+
+  const uint64_t numberOfPoints       = getNumberOfRecords(TBinaryMapTable::Points);
+  const uint64_t numberOfPointIndices = getNumberOfRecords(TBinaryMapTable::PointIndices);
+  const uint64_t numberOfLineStrings  = getNumberOfRecords(TBinaryMapTable::LineStrings);
+  const uint64_t numberOfAreaBounds   = getNumberOfRecords(TBinaryMapTable::AreaBounds);
+  const uint64_t numberOfAttributes   = getNumberOfRecords(TBinaryMapTable::Attributes);
+  const uint64_t numberOfCharacters   = getNumberOfRecords(TBinaryMapTable::Strings);
+
+  const CBinaryAttribute* attributes = getRecords<CBinaryAttribute>(TBinaryMapTable::Attributes);
+  for (size_t idx = 0; idx < numberOfAttributes; ++idx)
+  {
+    if (!isRecordRangeValid(attributes[idx].mKeyOffset, attributes[idx].mKeyLength,
+                            numberOfCharacters)
+        || !isRecordRangeValid(attributes[idx].mValueOffset, attributes[idx].mValueLength,
+                               numberOfCharacters))
+    {
+      return false;
+    }
+  }
+
+  const CBinaryPoint* points = getRecords<CBinaryPoint>(TBinaryMapTable::Points);
+  for (size_t idx = 0; idx < numberOfPoints; ++idx)
+  {
+    if (!isRecordRangeValid(points[idx].mFirstAttribute, points[idx].mNumberOfAttributes,
+                            numberOfAttributes))
+    {
+      return false;
+    }
+  }
+
+  const uint32_t* pointIndices = getRecords<uint32_t>(TBinaryMapTable::PointIndices);
+  for (size_t idx = 0; idx < numberOfPointIndices; ++idx)
+  {
+    if (pointIndices[idx] >= numberOfPoints)
+    {
+      return false;
+    }
+  }
+
+  for (const TBinaryMapTable table : {TBinaryMapTable::LineStrings, TBinaryMapTable::Polygons})
+  {
+    const CBinaryLineString* lineStrings = getRecords<CBinaryLineString>(table);
+    for (size_t idx = 0; idx < getNumberOfRecords(table); ++idx)
+    {
+      if (!isRecordRangeValid(lineStrings[idx].mFirstPointIndex, lineStrings[idx].mNumberOfPoints,
+                              numberOfPointIndices)
+          || !isRecordRangeValid(lineStrings[idx].mFirstAttribute,
+                                 lineStrings[idx].mNumberOfAttributes,
+                                 numberOfAttributes))
+      {
+        return false;
+      }
+    }
+  }
+
+  const CBinaryLanelet* lanelets = getRecords<CBinaryLanelet>(TBinaryMapTable::Lanelets);
+  for (size_t idx = 0; idx < getNumberOfRecords(TBinaryMapTable::Lanelets); ++idx)
+  {
+    if (lanelets[idx].mLeftBound >= numberOfLineStrings
+        || lanelets[idx].mRightBound >= numberOfLineStrings
+        || !isRecordRangeValid(lanelets[idx].mFirstAttribute, lanelets[idx].mNumberOfAttributes,
+                               numberOfAttributes))
+    {
+      return false;
+    }
+  }
+
+  const CBinaryAreaBound* areaBounds = getRecords<CBinaryAreaBound>(TBinaryMapTable::AreaBounds);
+  for (size_t idx = 0; idx < numberOfAreaBounds; ++idx)
+  {
+    if (areaBounds[idx].mLineString >= numberOfLineStrings)
+    {
+      return false;
+    }
+  }
+
+  const CBinaryArea* areas = getRecords<CBinaryArea>(TBinaryMapTable::Areas);
+  for (size_t idx = 0; idx < getNumberOfRecords(TBinaryMapTable::Areas); ++idx)
+  {
+    if (!isRecordRangeValid(areas[idx].mFirstBound, areas[idx].mNumberOfBounds,
+                            numberOfAreaBounds)
+        || !isRecordRangeValid(areas[idx].mFirstAttribute, areas[idx].mNumberOfAttributes,
+                               numberOfAttributes))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void CBinaryMapFile::readAttributes(const uint32_t         aFirstAttribute,
+                                    const uint32_t         aNumberOfAttributes,
+                                    lanelet::AttributeMap& aAttributes) const
+{
+  const CBinaryAttribute* attributes = getRecords<CBinaryAttribute>(TBinaryMapTable::Attributes);
+  const char*             strings    = getRecords<char>(TBinaryMapTable::Strings);
+  for (uint32_t idx = 0; idx < aNumberOfAttributes; ++idx)
+  {
+    const CBinaryAttribute& attribute = attributes[aFirstAttribute + idx];
+    aAttributes[std::string(strings + attribute.mKeyOffset, attribute.mKeyLength)] =
+      lanelet::Attribute(std::string(strings + attribute.mValueOffset, attribute.mValueLength));
+  }
+}
+}
+}
+}
@@ -0,0 +1,248 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#include "AutoStreamMapConverter/BinaryMapWriter.hpp"
+
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+/**
+ * Round a file offset up to the alignment of tables.
+ *
+ * @param[in] aOffset Offset in the file.
+ * @retval uint64_t Smallest aligned offset that is not smaller than the given offset.
+ */
+uint64_t alignTableOffset(const uint64_t aOffset)
+{
+  return (aOffset + kBinaryMapTableAlignment - 1)
+         / kBinaryMapTableAlignment * kBinaryMapTableAlignment;
+}
+
+/**
+ * Write the records of a table as raw bytes, followed by the padding up to the next table.
+ *
+ * @param[in, out] aOutput Stream to which the table must be written.
+ * @param[in] aRecords Records of the table.
+ * @param[in] aNumberOfRecords Number of records.
+ */
+template <typename RecordT>
+void writeTableRecords(std::ostream&  aOutput,
+                       const RecordT* aRecords,
+                       const size_t   aNumberOfRecords)
+{
+  const uint64_t size = aNumberOfRecords * sizeof(RecordT);
+  aOutput.write(reinterpret_cast<const char*>(aRecords), static_cast<std::streamsize>(size));
+
+  const char padding[kBinaryMapTableAlignment] = {};
+  aOutput.write(padding, static_cast<std::streamsize>(alignTableOffset(size) - size));
+}
+
+CBinaryMapWriter::CBinaryMapWriter(std::ostream&                            aOutput,
+                                   const lanelet::projection::UtmProjector& aUtmProjector)
+  : mOutput(aOutput)
+  , mHeader()
+{
+  std::memcpy(mHeader.mMagic, kBinaryMapMagic, sizeof(mHeader.mMagic));
+  mHeader.mVersion         = kBinaryMapVersion;
+  mHeader.mByteOrderMark   = kBinaryMapByteOrderMark;
+  mHeader.mOriginLatitude  = aUtmProjector.origin().position.lat;
+  mHeader.mOriginLongitude = aUtmProjector.origin().position.lon;
+  mHeader.mOriginAltitude  = aUtmProjector.origin().position.ele;
+}
+
+bool CBinaryMapWriter::write(const std::vector<lanelet::Lanelet>&   aLanelets,
+                             const std::vector<lanelet::Area>&      aAreas,
+                             const std::vector<lanelet::Polygon3d>& aPolygons)
+{
+  clear();
+
+  for (const auto& lanelet : aLanelets)
+  {
+    const auto leftBound  = lanelet.leftBound();
+    const auto rightBound = lanelet.rightBound();
+
+    CBinaryLanelet record {};
+    record.mId                 = lanelet.id();
+    record.mLeftBound          = addLineString(leftBound, mLineStrings, mLineStringIndicesById);
+    record.mRightBound         = addLineString(rightBound, mLineStrings, mLineStringIndicesById);
+    record.mLeftBoundInverted  = leftBound.inverted() ? 1 : 0;
+    record.mRightBoundInverted = rightBound.inverted() ? 1 : 0;
+    addAttributes(lanelet.attributes(), record.mFirstAttribute, record.mNumberOfAttributes);
+    mLanelets.push_back(record);
+  }
+
+  for (const auto& area : aAreas)
+  {
+    CBinaryArea record {};
+    record.mId         = area.id();
+    record.mFirstBound = static_cast<uint32_t>(mAreaBounds.size());
+    for (const auto& border : area.outerBound())
+    {
+      const uint32_t lineString = addLineString(border, mLineStrings, mLineStringIndicesById);
+      mAreaBounds.push_back(CBinaryAreaBound { lineString, border.inverted() ? 1U : 0U });
+    }
+    record.mNumberOfBounds = static_cast<uint32_t>(mAreaBounds.size()) - record.mFirstBound;
+    addAttributes(area.attributes(), record.mFirstAttribute, record.mNumberOfAttributes);
+    mAreas.push_back(record);
+  }
+
+  for (const auto& polygon : aPolygons)
+  {
+    addLineString(polygon, mPolygons, mPolygonIndicesById);
+  }
+
+  // Records refer to each other by 32 bit indices
+  const size_t maxTableSize = std::numeric_limits<uint32_t>::max();
+  if (mPoints.size() > maxTableSize || mPointIndices.size() > maxTableSize
+      || mAttributes.size() > maxTableSize || mStrings.size() > maxTableSize)
+  {
+    std::cerr << "Map is too large for the binary map format." << std::endl;
+    return false;
+  }
+
+  // Tables are placed in the order of TBinaryMapTable
+  const uint64_t numberOfRecords[kNumberOfBinaryMapTables] = {
+    mPoints.size(),       mLineStrings.size(), mPolygons.size(),
+    mPointIndices.size(), mLanelets.size(),    mAreas.size(),
+    mAreaBounds.size(),   mAttributes.size(),  mStrings.size()
+  };
+  const uint64_t recordSizes[kNumberOfBinaryMapTables] = {
+    sizeof(CBinaryPoint),     sizeof(CBinaryLineString), sizeof(CBinaryLineString),
+    sizeof(uint32_t),         sizeof(CBinaryLanelet),    sizeof(CBinaryArea),
+    sizeof(CBinaryAreaBound), sizeof(CBinaryAttribute),  sizeof(char)
+  };
+
+  uint64_t offset = sizeof(CBinaryMapHeader);
+  for (size_t tableIdx = 0; tableIdx < kNumberOfBinaryMapTables; ++tableIdx)
+  {
+    mHeader.mTables[tableIdx] = CBinaryMapTable { offset, numberOfRecords[tableIdx] };
+    offset = alignTableOffset(offset + numberOfRecords[tableIdx] * recordSizes[tableIdx]);
+  }
+
+  mOutput.write(reinterpret_cast<const char*>(&mHeader), sizeof(mHeader));
+  writeTableRecords(mOutput, mPoints.data(), mPoints.size());
+  writeTableRecords(mOutput, mLineStrings.data(), mLineStrings.size());
+  writeTableRecords(mOutput, mPolygons.data(), mPolygons.size());
+  writeTableRecords(mOutput, mPointIndices.data(), mPointIndices.size());
+  writeTableRecords(mOutput, mLanelets.data(), mLanelets.size());
+  writeTableRecords(mOutput, mAreas.data(), mAreas.size());
+  writeTableRecords(mOutput, mAreaBounds.data(), mAreaBounds.size());
+  writeTableRecords(mOutput, mAttributes.data(), mAttributes.size());
+  writeTableRecords(mOutput, mStrings.data(), mStrings.size());
+  mOutput.flush();
+
+  clear();
+
+  if (!mOutput)
+  {
+    std::cerr << "Writing binary map output failed." << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+uint32_t CBinaryMapWriter::addPoint(const lanelet::ConstPoint3d& aPoint)
+{
+  const auto inserted = mPointIndicesById.emplace(aPoint.id(), mPoints.size());
+  if (inserted.second)
+  {
+    CBinaryPoint record {};
+    record.mId = aPoint.id();
+    record.mX  = aPoint.x();
+    record.mY  = aPoint.y();
+    record.mZ  = aPoint.z();
+    addAttributes(aPoint.attributes(), record.mFirstAttribute, record.mNumberOfAttributes);
+    mPoints.push_back(record);
+  }
+
+  return static_cast<uint32_t>(inserted.first->second);
+}
+
+template <typename LineStringT>
+uint32_t CBinaryMapWriter::addLineString(const LineStringT&                       aLineString,
+                                         std::vector<CBinaryLineString>&          aTable,
+                                         std::unordered_map<lanelet::Id, size_t>& aIndices)
+{
+  const auto inserted = aIndices.emplace(aLineString.id(), aTable.size());
+  if (!inserted.second)
+  {
+    return static_cast<uint32_t>(inserted.first->second);
+  }
+
+  CBinaryLineString record {};
+  record.mId              = aLineString.id();
+  record.mFirstPointIndex = static_cast<uint32_t>(mPointIndices.size());
+  record.mNumberOfPoints  = static_cast<uint32_t>(aLineString.size());
+
+  const size_t size = aLineString.size();
+  for (size_t idx = 0; idx < size; ++idx)
+  {
+    const size_t pointIdx = aLineString.inverted() ? size - 1 - idx : idx;
+    mPointIndices.push_back(addPoint(aLineString[pointIdx]));
+  }
+
+  addAttributes(aLineString.attributes(), record.mFirstAttribute, record.mNumberOfAttributes);
+  aTable.push_back(record);
+  return static_cast<uint32_t>(inserted.first->second);
+}
+
+void CBinaryMapWriter::addAttributes(const lanelet::AttributeMap& aAttributes,
+                                     uint32_t&                    aFirstAttribute,
+                                     uint32_t&                    aNumberOfAttributes)
+{
+  aFirstAttribute = static_cast<uint32_t>(mAttributes.size());
+  for (const auto& attribute : aAttributes)
+  {
+    const std::string& value = attribute.second.value();
+    mAttributes.push_back(CBinaryAttribute { addString(attribute.first),
+                                             static_cast<uint32_t>(attribute.first.size()),
+                                             addString(value),
+                                             static_cast<uint32_t>(value.size()) });
+  }
+  aNumberOfAttributes = static_cast<uint32_t>(mAttributes.size()) - aFirstAttribute;
+}
+
+uint32_t CBinaryMapWriter::addString(const std::string& aString)
+{
+  const auto inserted = mStringOffsets.emplace(aString, mStrings.size());
+  if (inserted.second)
+  {
+    mStrings.append(aString);
+  }
+
+  return static_cast<uint32_t>(inserted.first->second);
+}
+
+void CBinaryMapWriter::clear()
+{
+  mPoints.clear();
+  mLineStrings.clear();
+  mPolygons.clear();
+  mPointIndices.clear();
+  mLanelets.clear();
+  mAreas.clear();
+  mAreaBounds.clear();
+  mAttributes.clear();
+  mStrings.clear();
+  mPointIndicesById.clear();
+  mLineStringIndicesById.clear();
+  mPolygonIndicesById.clear();
+  mStringOffsets.clear();
+}
+}
+}
+}
@@ -0,0 +1,311 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#include "AutoStreamMapConverter/CompressedFile.hpp"
+#include "AutoStreamMapConverter/BinaryMapFile.hpp"
+
+#include <zlib.h>
+
+#include <unistd.h>
+
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+namespace Constants {
+// Size of the buffers between the streams and the files
+constexpr size_t kMapFileBufferSize = 1 << 20;
+
+// Fastest gzip compression, which keeps up with writing the map and still shrinks OSM XML
+// several times
+constexpr const char* kGzipWriteMode = "wb1";
+
+// Extension of gzip compressed map files
+constexpr const char* kGzipExtension = ".gz";
+}
+
+TMapFileCompression getMapFileCompression(const std::string& aFileName)
+{
+  const std::string extension = Constants::kGzipExtension;
+  if (aFileName.size() > extension.size()
+      && aFileName.compare(aFileName.size() - extension.size(), extension.size(), extension) == 0)
+  {
+    return TMapFileCompression::Gzip;
+  }
+
+  return TMapFileCompression::None;
+}
+
+CGzipFileBuffer::CGzipFileBuffer()
+  : mFile(nullptr)
+  , mWriting(false)
+  , mBuffer(Constants::kMapFileBufferSize)
+{
+}
+
+CGzipFileBuffer::~CGzipFileBuffer()
+{
+  close();
+}
+
+bool CGzipFileBuffer::open(const std::string& aFileName, const std::ios::openmode aMode)
+{
+  if (mFile != nullptr)
+  {
+    return false;
+  }
+
+  mWriting = (aMode & std::ios::out) != 0;
+  mFile    = gzopen(aFileName.c_str(), mWriting ? Constants::kGzipWriteMode : "rb");
+  if (mFile == nullptr)
+  {
+    return false;
+  }
+
+  // The internal buffer of zlib matches ours, such that data is compressed in large blocks
+  gzbuffer(mFile, static_cast<unsigned>(mBuffer.size()));
+
+  char* const buffer = mBuffer.data();
+  if (mWriting)
+  {
+    setp(buffer, buffer + mBuffer.size());
+  }
+  else
+  {
+    setg(buffer, buffer, buffer);
+  }
+
+  return true;
+}
+
+bool CGzipFileBuffer::close()
+{
+  if (mFile == nullptr)
+  {
+    return false;
+  }
+
+  const bool written = !mWriting || writeBuffer();
+  const int  result  = gzclose(mFile);
+  mFile              = nullptr;
+  setp(nullptr, nullptr);
+  setg(nullptr, nullptr, nullptr);
+
+  return written && result == Z_OK;
+}
+
+CGzipFileBuffer::int_type CGzipFileBuffer::overflow(const int_type aCharacter)
+{
+  if (mFile == nullptr || !mWriting || !writeBuffer())
+  {
+    return traits_type::eof();
+  }
+
+  if (!traits_type::eq_int_type(aCharacter, traits_type::eof()))
+  {
+    *pptr() = traits_type::to_char_type(aCharacter);
+    pbump(1);
+  }
+
+  return traits_type::not_eof(aCharacter);
+}
+
+int CGzipFileBuffer::sync()
+{
+  if (mFile == nullptr || !mWriting)
+  {
+    return 0;
+  }
+
+  return writeBuffer() ? 0 : -1;
+}
+
+CGzipFileBuffer::int_type CGzipFileBuffer::underflow()
+{
+  if (mFile == nullptr || mWriting)
+  {
+    return traits_type::eof();
+  }
+
+  const int length = gzread(mFile, mBuffer.data(), static_cast<unsigned>(mBuffer.size()));
+  if (length <= 0)
+  {
+    // A truncated file ends without data and Z_BUF_ERROR instead of a negative length
+    int         error   = Z_OK;
+    const char* message = gzerror(mFile, &error);
+    if (length < 0 || error != Z_OK)
+    {
+      // The input stream catches the exception and sets its bad bit
+      std::cerr << "Decompressing gzip file failed: " << message << std::endl;
+      throw std::ios_base::failure(message);
+    }
+
+    return traits_type::eof();
+  }
+
+  char* const buffer = mBuffer.data();
+  setg(buffer, buffer, buffer + length);
+  return traits_type::to_int_type(*buffer);
+}
+
+bool CGzipFileBuffer::writeBuffer()
+{
+  const int length = static_cast<int>(pptr() - pbase());
+  if (length > 0 && gzwrite(mFile, pbase(), static_cast<unsigned>(length)) != length)
+  {
+    return false;
+  }
+
+  pbump(-length);
+  return true;
+}
+
+CMapOutputStream::CMapOutputStream()
+  : std::ostream(nullptr)
+  , mFileBufferMemory()
+  , mFileBuffer()
+  , mGzipBuffer()
+{
+}
+
+bool CMapOutputStream::open(const std::string& aFileName)
+{
+  if (getMapFileCompression(aFileName) == TMapFileCompression::Gzip)
+  {
+    if (!mGzipBuffer.open(aFileName, std::ios::out))
+    {
+      setstate(std::ios::failbit);
+      return false;
+    }
+
+    rdbuf(&mGzipBuffer);
+    return true;
+  }
+
+  // Write through a large buffer, such that writing is bound by I/O rather than by small writes
+  mFileBufferMemory.resize(Constants::kMapFileBufferSize);
+  mFileBuffer.pubsetbuf(mFileBufferMemory.data(),
+                        static_cast<std::streamsize>(mFileBufferMemory.size()));
+  if (mFileBuffer.open(aFileName, std::ios::out | std::ios::trunc) == nullptr)
+  {
+    setstate(std::ios::failbit);
+    return false;
+  }
+
+  rdbuf(&mFileBuffer);
+  return true;
+}
+
+bool CMapOutputStream::close()
+{
+  if (rdbuf() == nullptr)
+  {
+    return false;
+  }
+
+  const bool flushed = static_cast<bool>(flush());
+  const bool closed =
+    rdbuf() == &mGzipBuffer ? mGzipBuffer.close() : mFileBuffer.close() != nullptr;
+  rdbuf(nullptr);
+
+  return flushed && closed;
+}
+
+CMapInputStream::CMapInputStream()
+  : std::istream(nullptr)
+  , mFileBuffer()
+  , mGzipBuffer()
+{
+}
+
+bool CMapInputStream::open(const std::string& aFileName)
+{
+  if (getMapFileCompression(aFileName) == TMapFileCompression::Gzip)
+  {
+    if (!mGzipBuffer.open(aFileName, std::ios::in))
+    {
+      setstate(std::ios::failbit);
+      return false;
+    }
+
+    rdbuf(&mGzipBuffer);
+    return true;
+  }
+
+  if (mFileBuffer.open(aFileName, std::ios::in) == nullptr)
+  {
+    setstate(std::ios::failbit);
+    return false;
+  }
+
+  rdbuf(&mFileBuffer);
+  return true;
+}
+
+lanelet::LaneletMapPtr loadMapFile(const std::string&        aFileName,
+                                   const lanelet::Projector& aProjector)
+{
+  if (isBinaryMapFile(aFileName))
+  {
+    CBinaryMapFile binaryMap;
+    return binaryMap.open(aFileName) ? binaryMap.createLaneletMap(aProjector) : nullptr;
+  }
+
+  std::string fileName = aFileName;
+  if (getMapFileCompression(aFileName) == TMapFileCompression::Gzip)
+  {
+    // lanelet2 chooses its parser by extension, the temporary file must end with ".osm"
+    const char* temporaryDirectory = std::getenv("TMPDIR");
+    fileName = std::string(temporaryDirectory != nullptr ? temporaryDirectory : "/tmp")
+               + "/autostream_map_XXXXXX.osm";
+    const int fileDescriptor = ::mkstemps(&fileName[0], 4);
+    if (fileDescriptor < 0)
+    {
+      std::cerr << "Creating temporary file for decompressing " << aFileName << " failed."
+                << std::endl;
+      return nullptr;
+    }
+    ::close(fileDescriptor);
+
+    CMapInputStream input;
+    std::ofstream   output(fileName, std::ios::out | std::ios::trunc);
+    if (!input.open(aFileName) || !output || !(output << input.rdbuf()) || !output.flush())
+    {
+      std::cerr << "Decompressing map " << aFileName << " failed." << std::endl;
+      ::unlink(fileName.c_str());
+      return nullptr;
+    }
+  }
+
+  lanelet::LaneletMapPtr map;
+  try
+  {
+    map = lanelet::load(fileName, aProjector);
+  }
+  catch (const std::exception& exception)
+  {
+    std::cerr << "Loading map " << aFileName << " failed: " << exception.what() << std::endl;
+  }
+
+  if (fileName != aFileName)
+  {
+    ::unlink(fileName.c_str());
+  }
+
+  return map;
+}
+}
+}
+}
@@ -16,6 +16,7 @@
 #include <lanelet2_core/utility/Units.h>
 
 #include <map>
+#include <vector>
 
 namespace TomTom {
 namespace AutoStreamForAutoware {
@@ -162,7 +163,8 @@ getLaneTypeVehicleMapping()
 }
 
 lanelet::Point3d toUtm(const AutoStream::TCoordinate3D          aPointInNds,
-                       const lanelet::projection::UtmProjector& aUTMProjector)
+                       const lanelet::projection::UtmProjector& aUTMProjector,
+                       CIdAllocator&                            aIdAllocator)
 {
   lanelet::GPSPoint pointInWGS84 { aPointInNds.getXY().getLatDegree(),
                                    aPointInNds.getXY().getLonDegree(),
@@ -170,27 +172,24 @@ lanelet::Point3d toUtm(const AutoStream::TCoordinate3D          aPointInNds,
 
   const auto pointInUTM = aUTMProjector.forward(pointInWGS84);
 
-  lanelet::Point3d utmPoint3D(
-    lanelet::utils::getId(), pointInUTM.x(), pointInUTM.y(), pointInUTM.z());
-
-  return lanelet::Point3d(lanelet::utils::getId(), pointInUTM.x(), pointInUTM.y(), pointInUTM.z());
+  return lanelet::Point3d(aIdAllocator.getId(), pointInUTM.x(), pointInUTM.y(), pointInUTM.z());
 }
 
-lanelet::LineString3d convertLaneBorder(const AutoStream::HdMap::HdRoad::CLaneBorder& aLaneBorder,
-                                        const lanelet::projection::UtmProjector&      aUtmProjector)
+lanelet::LineString3d convertLaneBorder(const CAutoStreamLaneBorder& aLaneBorder,
+                                        const CUtmBatchProjector&    aUtmProjector,
+                                        CIdAllocator&                aIdAllocator)
 {
   auto convertedLineString = convertLine(
-    aLaneBorder.getLaneBorderComponent(Constants::kRelevantBorderIndex).laneBorderLine(),
-    aUtmProjector);
+    aLaneBorder.mComponents[Constants::kRelevantBorderIndex].mLine, aUtmProjector, aIdAllocator);
 
   setTypeAndSubtype(aLaneBorder, convertedLineString);
 
   // Remaining attributes
-  convertedLineString.attributes()["width"] = aLaneBorder.width() * Constants::kCm2meter;
+  convertedLineString.attributes()["width"] = aLaneBorder.mWidthCm * Constants::kCm2meter;
   if (isPainted(aLaneBorder))
   {
     convertedLineString.attributes()["color"] =
-      aLaneBorder.getLaneBorderComponent(Constants::kRelevantBorderIndex).laneBorderColor()
+      aLaneBorder.mComponents[Constants::kRelevantBorderIndex].mColor
           == AutoStream::HdMap::HdRoad::kLaneBorderColorYellow
         ? "yellow"
         : "white";
@@ -207,18 +206,17 @@ bool isSame(const lanelet::Point3d& aPoint1, const lanelet::Point3d& aPoint2, do
   return dx * dx + dy * dy + dz * dz < aThreshold * aThreshold;
 }
 
-void setTypeAndSubtype(const AutoStream::HdMap::HdRoad::CLaneBorder& aLaneBorder,
-                       lanelet::LineString3d&                        aConvertedLineString)
+void setTypeAndSubtype(const CAutoStreamLaneBorder& aLaneBorder,
+                       lanelet::LineString3d&       aConvertedLineString)
 {
   static auto laneBorderTypeMap    = getLaneBorderTypeMapping();
   static auto laneBorderSubTypeMap = getLaneBorderSubTypeMapping();
 
-  bool singleBorderLine = aLaneBorder.getSize() == 1;
+  bool singleBorderLine = aLaneBorder.mComponents.size() == 1;
 
   if (singleBorderLine)
   {
-    auto type =
-      aLaneBorder.getLaneBorderComponent(Constants::kRelevantBorderIndex).laneBorderType();
+    auto type = aLaneBorder.mComponents[Constants::kRelevantBorderIndex].mType;
     if (laneBorderTypeMap.find(type) == laneBorderTypeMap.end())
     {
       std::cerr << "No support for converting AutoStream borders of type " << toString(type)
@@ -248,12 +246,12 @@ void setTypeAndSubtype(const AutoStream::HdMap::HdRoad::CLaneBorder& aLaneBorder
       lanelet::AttributeValueString::LineThin;
 
     // Lanelet2 only support solid/solid, dashed/solid, solid/dashed
-    if (isDashed(aLaneBorder.getLaneBorderComponent(0).laneBorderType()))
+    if (isDashed(aLaneBorder.mComponents[0].mType))
     {
       aConvertedLineString.attributes()[lanelet::AttributeName::Subtype] =
         lanelet::AttributeValueString::DashedSolid;
     }
-    else if (isDashed(aLaneBorder.getLaneBorderComponent(1).laneBorderType()))
+    else if (isDashed(aLaneBorder.mComponents[1].mType))
     {
       aConvertedLineString.attributes()[lanelet::AttributeName::Subtype] =
         lanelet::AttributeValueString::SolidDashed;
@@ -266,14 +264,30 @@ void setTypeAndSubtype(const AutoStream::HdMap::HdRoad::CLaneBorder& aLaneBorder
   }
 }
 
-lanelet::LineString3d convertLine(const AutoStream::HdMap::HdRoad::CIterable3DShapePoints& aLineIn,
-                                  const lanelet::projection::UtmProjector& aUTMProjector)
+lanelet::LineString3d convertLine(const std::vector<AutoStream::TCoordinate3D>& aLineIn,
+                                  const CUtmBatchProjector&                     aUTMProjector,
+                                  CIdAllocator&                                 aIdAllocator)
 {
-  lanelet::LineString3d lineString;
-  lineString.setId(lanelet::utils::getId());
+  // Gather coordinates such that the whole line is projected at once
+  std::vector<double> latDeg;
+  std::vector<double> lonDeg;
+  std::vector<double> heightMeter;
   for (const AutoStream::TCoordinate3D& point : aLineIn)
   {
-    lineString.push_back(toUtm(point, aUTMProjector));
+    latDeg.push_back(point.getXY().getLatDegree());
+    lonDeg.push_back(point.getXY().getLonDegree());
+    heightMeter.push_back(point.getHeight() * Constants::kMm2meter);
+  }
+
+  std::vector<double> x;
+  std::vector<double> y;
+  aUTMProjector.forward(latDeg, lonDeg, x, y);
+
+  lanelet::LineString3d lineString;
+  lineString.setId(aIdAllocator.getId());
+  for (size_t idx = 0; idx < x.size(); ++idx)
+  {
+    lineString.push_back(lanelet::Point3d(aIdAllocator.getId(), x[idx], y[idx], heightMeter[idx]));
   }
 
   return lineString;
@@ -295,31 +309,34 @@ bool isArea(const AutoStream::HdMap::HdRoad::TLaneType aLaneType)
 }
 
 std::array<lanelet::LineString3d, Constants::kNumberOfSidesArea>
-getAreaBounds(lanelet::LineString3d& aLeftBorder, lanelet::LineString3d& aRightBorder)
+getAreaBounds(lanelet::LineString3d& aLeftBorder,
+              lanelet::LineString3d& aRightBorder,
+              CIdAllocator&          aIdAllocator)
 {
   // Bottom line string of area is equal to right border flipped
-  lanelet::LineString3d bottomBound = createFlippedLineString(aRightBorder);
+  lanelet::LineString3d bottomBound = createFlippedLineString(aRightBorder, aIdAllocator);
 
   // Clockwise ordering: create borders
   lanelet::LineString3d leftBound, rightBound;
   rightBound.push_back(aLeftBorder.back());
   rightBound.push_back(aRightBorder.back());
-  rightBound.setId(lanelet::utils::getId());
+  rightBound.setId(aIdAllocator.getId());
   leftBound.push_back(aRightBorder.front());
   leftBound.push_back(aLeftBorder.front());
-  leftBound.setId(lanelet::utils::getId());
+  leftBound.setId(aIdAllocator.getId());
 
   // Top line string is equal to the left border
   return { aLeftBorder, rightBound, bottomBound, leftBound };
 }
 
-lanelet::LineString3d createFlippedLineString(const lanelet::LineString3d& aLineStringIn)
+lanelet::LineString3d createFlippedLineString(const lanelet::LineString3d& aLineStringIn,
+                                              CIdAllocator&                aIdAllocator)
 {
   // Copy line string, but reverse order of points
   lanelet::LineString3d flippedLineString = aLineStringIn.invert();
 
   // Set unique ID
-  flippedLineString.setId(lanelet::utils::getId());
+  flippedLineString.setId(aIdAllocator.getId());
 
   return flippedLineString;
 }
@@ -362,20 +379,19 @@ getVehicleType(const AutoStream::HdMap::HdRoad::TLaneType aLaneType)
   return type;
 }
 
-bool isPainted(const AutoStream::HdMap::HdRoad::CLaneBorder& aLaneBorder)
+bool isPainted(const CAutoStreamLaneBorder& aLaneBorder)
 {
-  auto type = aLaneBorder.getLaneBorderComponent(Constants::kRelevantBorderIndex).laneBorderType();
+  auto type = aLaneBorder.mComponents[Constants::kRelevantBorderIndex].mType;
   return type == AutoStream::HdMap::HdRoad::kLaneBorderTypeRoadSurfaceSingleSolidLine
          || type == AutoStream::HdMap::HdRoad::kLaneBorderTypeRoadSurfaceLongDashedLine
          || type == AutoStream::HdMap::HdRoad::kLaneBorderTypeRoadSurfaceShadedAreaMarking
          || type == AutoStream::HdMap::HdRoad::kLaneBorderTypeRoadSurfaceShortDashedLine;
 }
 
-lanelet::Velocity getSpeedLimit(
-  const AutoStream::HdMap::HdMapSpeedRestrictionLayer::CLaneSpeedRestrictions& aSpeedLimits)
+lanelet::Velocity getSpeedLimit(const CAutoStreamSpeedLimit& aSpeedLimit)
 {
-  auto limit = static_cast<double>(aSpeedLimits.getSpeedLimitValue(0));
-  if (aSpeedLimits.getSpeedUnit(0) == AutoStream::HdMap::HdMapSpeedRestrictionLayer::kSpeedUnitMph)
+  auto limit = static_cast<double>(aSpeedLimit.mValue);
+  if (aSpeedLimit.mUnit == AutoStream::HdMap::HdMapSpeedRestrictionLayer::kSpeedUnitMph)
   {
     return lanelet::Velocity { limit * lanelet::units::MPH() };
   }
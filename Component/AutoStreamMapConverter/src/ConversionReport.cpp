@@ -0,0 +1,283 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#include "AutoStreamMapConverter/ConversionReport.hpp"
+#include "AutoStreamMapConverter/MemoryUsage.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+namespace Constants {
+// Names of the counters in the written report, in the order of TReportCounter
+constexpr const char* kReportCounterNames[] = { "arcs",
+                                                "failedArcs",
+                                                "arcLanes",
+                                                "points",
+                                                "stitchedConnections",
+                                                "failedTrafficSigns",
+                                                "lanelets",
+                                                "areas",
+                                                "trafficSigns",
+                                                "idRangeCollisions",
+                                                "routingSuccessors",
+                                                "routingLaneChanges",
+                                                "addedLanelets",
+                                                "removedLanelets",
+                                                "modifiedLanelets",
+                                                "addedAreas",
+                                                "removedAreas",
+                                                "modifiedAreas",
+                                                "addedTrafficSigns",
+                                                "removedTrafficSigns",
+                                                "modifiedTrafficSigns" };
+static_assert(sizeof(kReportCounterNames) / sizeof(kReportCounterNames[0])
+                == kNumberOfReportCounters,
+              "Every counter needs a name");
+}
+
+/**
+ * Write a string as a JSON string literal, escaping quotes, backslashes and control characters.
+ *
+ * @param[in, out] aOutput Stream to which the literal must be written.
+ * @param[in] aValue String that must be written.
+ */
+void writeJsonString(std::ostream& aOutput, const std::string& aValue)
+{
+  aOutput << '"';
+  for (const char character : aValue)
+  {
+    if (character == '"' || character == '\\')
+    {
+      aOutput << '\\' << character;
+    }
+    else if (static_cast<unsigned char>(character) < 0x20)
+    {
+      aOutput << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+              << static_cast<int>(character) << std::dec << std::setfill(' ');
+    }
+    else
+    {
+      aOutput << character;
+    }
+  }
+  aOutput << '"';
+}
+
+/**
+ * Convert a duration to milliseconds.
+ *
+ * @param[in] aDuration Duration.
+ * @retval double Duration in milliseconds.
+ */
+double toMilliseconds(const CConversionReport::TClock::duration aDuration)
+{
+  return std::chrono::duration<double, std::milli>(aDuration).count();
+}
+
+CConversionReport::CStageTimer::CStageTimer(CConversionReport& aReport, const char* aStage)
+  : mReport(aReport)
+  , mStage(aStage)
+  , mStart(aReport.isEnabled() ? TClock::now() : TClock::time_point())
+  , mStartResidentSetSize(0)
+  , mStartPeakResidentSetSize(0)
+  , mEnclosingPeakLiveHeapBytes(0)
+{
+  if (mReport.isEnabled())
+  {
+    // The peak resident set size of the process is only reset when a conversion starts, such that
+    // it covers the whole conversion and nested stages do not affect each other
+    mStartResidentSetSize       = getResidentSetSize();
+    mStartPeakResidentSetSize   = getPeakResidentSetSize();
+    mEnclosingPeakLiveHeapBytes = restartPeakLiveHeapBytes();
+  }
+}
+
+CConversionReport::CStageTimer::~CStageTimer()
+{
+  if (!mReport.isEnabled())
+  {
+    return;
+  }
+
+  mReport.addStageDuration(mStage, TClock::now() - mStart);
+
+  const size_t peakLiveHeapBytes = getPeakLiveHeapBytes();
+  mergePeakLiveHeapBytes(mEnclosingPeakLiveHeapBytes);
+
+  // A peak above the peak at the start of the stage was reached within the stage, otherwise the
+  // stage stayed below it and the resident set size at its start and end is the best estimate
+  const size_t residentSetSize     = getResidentSetSize();
+  const size_t peakResidentSetSize = getPeakResidentSetSize();
+  const size_t stagePeakResidentSetSize =
+    peakResidentSetSize > mStartPeakResidentSetSize
+      ? peakResidentSetSize
+      : std::max(mStartResidentSetSize, residentSetSize);
+
+  mReport.setStageMemoryUsage(
+    mStage,
+    CMemoryUsage { residentSetSize, stagePeakResidentSetSize, getLiveHeapBytes(),
+                   peakLiveHeapBytes });
+}
+
+CConversionReport::CConversionReport()
+  : mEnabled(false)
+  , mStart(TClock::now())
+  , mCounters()
+{
+}
+
+void CConversionReport::setEnabled(const bool aEnabled) noexcept
+{
+  mEnabled = aEnabled;
+}
+
+bool CConversionReport::isEnabled() const noexcept
+{
+  return mEnabled;
+}
+
+void CConversionReport::reset()
+{
+  mStart = TClock::now();
+  mStages.clear();
+  mCounters.fill(0);
+  mSetCounters.reset();
+
+  // Without reset, the peak resident set size includes previous conversions of the process. Stages
+  // never reset it, such that the peak of the report covers the whole conversion. The peak is
+  // process-wide, so it is left alone for conversions without report.
+  if (mEnabled)
+  {
+    resetPeakResidentSetSize();
+  }
+}
+
+void CConversionReport::addStageDuration(const std::string&     aStage,
+                                         const TClock::duration aDuration)
+{
+  CStage& stage = findStage(aStage);
+  stage.mDuration += aDuration;
+  ++stage.mNumberOfCalls;
+}
+
+void CConversionReport::setStageMemoryUsage(const std::string&  aStage,
+                                            const CMemoryUsage& aMemoryUsage)
+{
+  CMemoryUsage& memoryUsage    = findStage(aStage).mMemoryUsage;
+  memoryUsage.mResidentSetSize = aMemoryUsage.mResidentSetSize;
+  memoryUsage.mLiveHeapBytes   = aMemoryUsage.mLiveHeapBytes;
+
+  memoryUsage.mPeakResidentSetSize =
+    std::max(memoryUsage.mPeakResidentSetSize, aMemoryUsage.mPeakResidentSetSize);
+  memoryUsage.mPeakLiveHeapBytes =
+    std::max(memoryUsage.mPeakLiveHeapBytes, aMemoryUsage.mPeakLiveHeapBytes);
+}
+
+void CConversionReport::addToCounter(const TReportCounter aCounter, const uint64_t aValue) noexcept
+{
+  if (mEnabled)
+  {
+    const size_t counterIdx = static_cast<size_t>(aCounter);
+    mCounters[counterIdx] += aValue;
+    mSetCounters.set(counterIdx);
+  }
+}
+
+void CConversionReport::setCounter(const TReportCounter aCounter, const uint64_t aValue) noexcept
+{
+  if (mEnabled)
+  {
+    const size_t counterIdx = static_cast<size_t>(aCounter);
+    mCounters[counterIdx]   = aValue;
+    mSetCounters.set(counterIdx);
+  }
+}
+
+uint64_t CConversionReport::getCounter(const TReportCounter aCounter) const noexcept
+{
+  return mCounters[static_cast<size_t>(aCounter)];
+}
+
+bool CConversionReport::store(const std::string& aFileName,
+                              const std::string& aOutputFileName) const
+{
+  std::ofstream output(aFileName, std::ios::out | std::ios::trunc);
+  if (!output)
+  {
+    return false;
+  }
+
+  output << std::fixed << std::setprecision(3);
+  output << "{\n  \"outputFile\": ";
+  writeJsonString(output, aOutputFileName);
+  output << ",\n  \"totalMs\": " << toMilliseconds(TClock::now() - mStart);
+  output << ",\n  \"peakRssBytes\": " << getPeakResidentSetSize();
+
+  const bool allocationCounting = isAllocationCountingEnabled();
+  output << ",\n  \"allocationCounting\": " << (allocationCounting ? "true" : "false");
+
+  output << ",\n  \"stages\": [";
+  for (size_t stageIdx = 0; stageIdx < mStages.size(); ++stageIdx)
+  {
+    const CStage& stage = mStages[stageIdx];
+    output << (stageIdx == 0 ? "\n" : ",\n") << "    { \"name\": ";
+    writeJsonString(output, stage.mName);
+    output << ", \"calls\": " << stage.mNumberOfCalls
+           << ", \"ms\": " << toMilliseconds(stage.mDuration)
+           << ", \"rssBytes\": " << stage.mMemoryUsage.mResidentSetSize
+           << ", \"peakRssBytes\": " << stage.mMemoryUsage.mPeakResidentSetSize;
+    if (allocationCounting)
+    {
+      output << ", \"liveBytes\": " << stage.mMemoryUsage.mLiveHeapBytes
+             << ", \"peakLiveBytes\": " << stage.mMemoryUsage.mPeakLiveHeapBytes;
+    }
+    output << " }";
+  }
+  output << (mStages.empty() ? "]" : "\n  ]");
+
+  output << ",\n  \"counters\": {";
+  bool firstCounter = true;
+  for (size_t counterIdx = 0; counterIdx < kNumberOfReportCounters; ++counterIdx)
+  {
+    if (mSetCounters.test(counterIdx))
+    {
+      output << (firstCounter ? "\n    " : ",\n    ");
+      writeJsonString(output, Constants::kReportCounterNames[counterIdx]);
+      output << ": " << mCounters[counterIdx];
+      firstCounter = false;
+    }
+  }
+  output << (mSetCounters.none() ? "}" : "\n  }") << "\n}\n";
+
+  return static_cast<bool>(output);
+}
+
+CConversionReport::CStage& CConversionReport::findStage(const std::string& aStage)
+{
+  for (CStage& stage : mStages)
+  {
+    if (stage.mName == aStage)
+    {
+      return stage;
+    }
+  }
+
+  mStages.push_back(CStage { aStage, TClock::duration::zero(), 0, CMemoryUsage { 0, 0, 0, 0 } });
+  return mStages.back();
+}
+}
+}
+}
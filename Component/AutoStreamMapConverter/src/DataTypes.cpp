@@ -11,6 +11,9 @@
 
 #include "AutoStreamMapConverter/DataTypes.hpp"
 
+#include <algorithm>
+#include <iostream>
+
 namespace TomTom {
 namespace AutoStreamForAutoware {
 namespace AutoStreamMapConverter {
@@ -22,13 +25,92 @@ bool CAutoStreamArcData::empty() const noexcept
 
 bool CAutoStreamArcData::isValid() const noexcept
 {
-  return mLaneBorders.size() - 1 == mLaneMetaData.size();
+  return mLaneBorders.size() - 1 == mLaneMetaData.size()
+         && mSpeedLimits.size() == mLaneMetaData.size();
 }
 
 size_t CAutoStreamArcData::size() const noexcept
 {
   return mLaneMetaData.size();
 }
+
+bool CAutoStreamArcTable::addArc(const AutoStream::HdMap::TArcKey&    aArcKey,
+                                 std::vector<lanelet::Lanelet>        aLanelets,
+                                 std::vector<CAutoStreamLaneMetaData> aLaneMetaData)
+{
+  if (aLanelets.size() != aLaneMetaData.size())
+  {
+    std::cerr << "Error in conversion: number of AutoStream lanes differs from number of lanelets"
+              << std::endl;
+    return false;
+  }
+
+  if (mFirstLaneIdx.empty())
+  {
+    mFirstLaneIdx.push_back(0);
+  }
+
+  mArcKeys.push_back(aArcKey);
+  std::move(aLanelets.begin(), aLanelets.end(), std::back_inserter(mLanelets));
+  std::move(aLaneMetaData.begin(), aLaneMetaData.end(), std::back_inserter(mLaneMetaData));
+  mFirstLaneIdx.push_back(mLanelets.size());
+
+  return true;
+}
+
+bool CAutoStreamArcTable::findArc(const AutoStream::HdMap::TArcKey& aArcKey, size_t& aArcIdx) const
+{
+  const auto arcKey = std::lower_bound(mArcKeys.begin(), mArcKeys.end(), aArcKey);
+  if (arcKey == mArcKeys.end() || aArcKey < *arcKey)
+  {
+    return false;
+  }
+
+  aArcIdx = static_cast<size_t>(arcKey - mArcKeys.begin());
+  return true;
+}
+
+void CAutoStreamArcTable::resolveConnections()
+{
+  mFirstConnectionIdx.clear();
+  mConnectedLaneIdx.clear();
+  mFirstConnectionIdx.reserve(mLaneMetaData.size() + 1);
+
+  for (const auto& metaData : mLaneMetaData)
+  {
+    mFirstConnectionIdx.push_back(mConnectedLaneIdx.size());
+    for (const auto& c : metaData.mConnectionsOut)
+    {
+      size_t connectedArcIdx = 0;
+      if (!findArc(c.first, connectedArcIdx))
+      {
+        continue;
+      }
+
+      const size_t numberOfLanes =
+        mFirstLaneIdx[connectedArcIdx + 1] - mFirstLaneIdx[connectedArcIdx];
+      if (c.second >= numberOfLanes)
+      {
+        std::cerr << "Connected to lane with ID " << c.second << ", but arc has only "
+                  << numberOfLanes << " lanelets. Skip connection." << std::endl;
+        continue;
+      }
+
+      mConnectedLaneIdx.push_back(mFirstLaneIdx[connectedArcIdx] + c.second);
+    }
+  }
+  mFirstConnectionIdx.push_back(mConnectedLaneIdx.size());
+}
+
+size_t CAutoStreamArcTable::getNumberOfArcs() const noexcept
+{
+  return mArcKeys.size();
+}
+
+size_t CAutoStreamArcTable::getNumberOfLanes() const noexcept
+{
+  return mLanelets.size();
+}
 }
 }
 }
\ No newline at end of file
@@ -0,0 +1,238 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#include "AutoStreamMapConverter/HdMapSource.hpp"
+#include "AutoStreamMapConverter/ConversionHelpers.hpp"
+
+#include "TomTom/AutoStream/HdMap/HdMapSpeedRestrictions.h"
+#include "TomTom/AutoStream/HdMap/HdMapTrafficSigns.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+CAutoStreamHdMapSource::CAutoStreamHdMapSource(
+  const AutoStream::HdMap::CHdMapAccess* aMapAccess,
+  const AutoStream::CMapVersionAndHash&  aMapVersionAndHash)
+  : mMapAccess(aMapAccess)
+  , mMapVersionAndHash(aMapVersionAndHash)
+{
+}
+
+CAutoStreamHdMapSource::CAutoStreamHdMapSource(
+  THdMapAccessPtr                       aMapAccess,
+  const AutoStream::CMapVersionAndHash& aMapVersionAndHash)
+  : mOwnedMapAccess(std::move(aMapAccess))
+  , mMapAccess(mOwnedMapAccess.get())
+  , mMapVersionAndHash(aMapVersionAndHash)
+{
+}
+
+AutoStream::CMapVersionAndHash CAutoStreamHdMapSource::getMapVersionAndHash() const
+{
+  return mMapVersionAndHash;
+}
+
+std::vector<AutoStream::HdMap::TArcKey>
+CAutoStreamHdMapSource::getArcKeysInArea(const AutoStream::TBoundingBox& aArea)
+{
+  validateMapAccess();
+
+  const AutoStream::HdMap::TArcKeys arcKeys =
+    mMapAccess->arcKeysInArea(aArea, AutoStream::CCallParameters());
+  std::vector<AutoStream::HdMap::TArcKey> keys(arcKeys.getSet().begin(), arcKeys.getSet().end());
+  std::sort(keys.begin(), keys.end());
+  return keys;
+}
+
+CAutoStreamArcData CAutoStreamHdMapSource::getArc(const AutoStream::HdMap::TArcKey& aArcKey)
+{
+  validateMapAccess();
+
+  CAutoStreamArcData             laneData;
+  const AutoStream::HdMap::TArc& arc = mMapAccess->key2Arc(aArcKey, AutoStream::CCallParameters());
+
+  // Only lane groups can be converted
+  const auto arcType = mMapAccess->arcType(arc);
+  if (arcType != AutoStream::HdMap::HdRoad::TArcType::kArcTypeLaneGroup)
+  {
+    std::cerr << "Only lane groups can be converted, conversion of arc with type " << arcType
+              << " failed." << std::endl;
+    return laneData;
+  }
+
+  // Iterate over lanes, from right to left
+  uint32_t    numberOfLanes = mMapAccess->nrOfLanesOrTrajectories(arc);
+  const auto& drivingSide   = mMapAccess->drivingSide(arc);
+  for (uint32_t idx = 0; idx < numberOfLanes; ++idx)
+  {
+    // Get lane with given index from arc and store data
+    auto lane = mMapAccess->getLaneOrTrajectory(arc, idx);
+
+    // For last lane, store left border as well
+    getLaneMetaDataAndBorders(lane, drivingSide, idx == numberOfLanes - 1, laneData);
+  }
+
+  storeSpeedLimits(arc, laneData);
+  return laneData;
+}
+
+std::vector<AutoStream::HdMap::TTrafficSignKey>
+CAutoStreamHdMapSource::getTrafficSignKeysInArea(const AutoStream::TBoundingBox& aArea)
+{
+  validateMapAccess();
+
+  const AutoStream::HdMap::TTrafficSignKeys trafficSignKeys =
+    mMapAccess->getTrafficSigns().trafficSignKeysInArea(aArea, AutoStream::CCallParameters());
+  std::vector<AutoStream::HdMap::TTrafficSignKey> keys(trafficSignKeys.getSet().begin(),
+                                                       trafficSignKeys.getSet().end());
+  std::sort(keys.begin(), keys.end());
+  return keys;
+}
+
+CAutoStreamTrafficSignData
+CAutoStreamHdMapSource::getTrafficSign(const AutoStream::HdMap::TTrafficSignKey& aTrafficSignKey)
+{
+  validateMapAccess();
+
+  // Collect data needed for reconstructing bounding box around traffic sign
+  const AutoStream::HdMap::CHdMapTrafficSigns& trafficSigns = mMapAccess->getTrafficSigns();
+  const AutoStream::HdMap::TTrafficSign&       trafficSign =
+    trafficSigns.key2TrafficSign(aTrafficSignKey, AutoStream::CCallParameters());
+  return CAutoStreamTrafficSignData { trafficSigns.getCenterOfMass(trafficSign),
+                                      trafficSigns.getNormal(trafficSign)
+                                        * Constants::kMilliDeg2deg,
+                                      trafficSigns.getSize(trafficSign) };
+}
+
+void CAutoStreamHdMapSource::validateMapAccess() const
+{
+  if (!mMapAccess)
+  {
+    throw std::runtime_error("Invalid map access pointer.");
+  }
+
+  if (!mMapAccess->isValid())
+  {
+    throw std::runtime_error("Provided map access is invalid.");
+  }
+}
+
+void CAutoStreamHdMapSource::getLaneMetaDataAndBorders(
+  const AutoStream::HdMap::HdRoad::CLaneOrTrajectory& aLane,
+  const AutoStream::HdMap::HdRoad::TDrivingSide       aDrivingSide,
+  bool                                                aStoreLeftBorder,
+  CAutoStreamArcData&                                 aLaneData) const
+{
+  // Store all data
+  aLaneData.mLaneMetaData.emplace_back(getLaneMetaData(aLane, aDrivingSide));
+  storeLaneBorders(aLane, aStoreLeftBorder, aDrivingSide, aLaneData);
+}
+
+CAutoStreamLaneMetaData CAutoStreamHdMapSource::getLaneMetaData(
+  const AutoStream::HdMap::HdRoad::CLaneOrTrajectory& aLane,
+  const AutoStream::HdMap::HdRoad::TDrivingSide       aDrivingSide) const
+{
+  // Add meta data
+  CAutoStreamLaneMetaData metaData;
+  metaData.mDrivingSide            = aDrivingSide;
+  metaData.mLaneWidthCm            = aLane.laneWidth();
+  metaData.mLaneLengthCm           = aLane.laneLength();
+  metaData.mType                   = aLane.laneType();
+  metaData.mOpposingTrafficAllowed = aLane.isOpposingTrafficPossible();
+  metaData.mInvalidConnectionOut   = false;
+  for (uint32_t conIdx = 0; conIdx < aLane.nrOfOutgoingLaneConnections(); ++conIdx)
+  {
+    metaData.mConnectionsOut.emplace_back(aLane.outgoingLaneConnection(conIdx));
+  }
+
+  return metaData;
+}
+
+void CAutoStreamHdMapSource::storeLaneBorders(
+  const AutoStream::HdMap::HdRoad::CLaneOrTrajectory& aLane,
+  const bool                                          aStoreSecondBorder,
+  const AutoStream::HdMap::HdRoad::TDrivingSide       aDrivingSide,
+  CAutoStreamArcData&                                 aLaneData) const
+{
+  auto firstBorder  = AutoStream::HdMap::HdRoad::CLaneOrTrajectory::kBorderSideRight;
+  auto secondBorder = AutoStream::HdMap::HdRoad::CLaneOrTrajectory::kBorderSideLeft;
+
+  if (aDrivingSide == AutoStream::HdMap::HdRoad::TDrivingSide::kDrivingSideLeft)
+  {
+    firstBorder  = AutoStream::HdMap::HdRoad::CLaneOrTrajectory::kBorderSideLeft;
+    secondBorder = AutoStream::HdMap::HdRoad::CLaneOrTrajectory::kBorderSideRight;
+  }
+
+  // Store first lane border (e.g. left border is same as right border next lane when driving on the
+  // right)
+  aLaneData.mLaneBorders.emplace_back(getLaneBorder(aLane.laneBorder(firstBorder)));
+
+  // Store second border if needed
+  if (aStoreSecondBorder)
+  {
+    aLaneData.mLaneBorders.emplace_back(getLaneBorder(aLane.laneBorder(secondBorder)));
+  }
+}
+
+CAutoStreamLaneBorder CAutoStreamHdMapSource::getLaneBorder(
+  const AutoStream::HdMap::HdRoad::CLaneBorder& aLaneBorder) const
+{
+  CAutoStreamLaneBorder laneBorder;
+  laneBorder.mWidthCm = aLaneBorder.width();
+  for (uint32_t componentIdx = 0; componentIdx < aLaneBorder.getSize(); ++componentIdx)
+  {
+    const auto component = aLaneBorder.getLaneBorderComponent(componentIdx);
+
+    CAutoStreamLaneBorderComponent componentData;
+    componentData.mType  = component.laneBorderType();
+    componentData.mColor = component.laneBorderColor();
+    for (const AutoStream::TCoordinate3D& point : component.laneBorderLine())
+    {
+      componentData.mLine.push_back(point);
+    }
+    laneBorder.mComponents.push_back(std::move(componentData));
+  }
+
+  return laneBorder;
+}
+
+void CAutoStreamHdMapSource::storeSpeedLimits(const AutoStream::HdMap::TArc& aArc,
+                                              CAutoStreamArcData&            aLaneData) const
+{
+  // Get speed limits for the vehicle type expected on each lane
+  const AutoStream::HdMap::CHdMapSpeedRestrictions& speedRestrictions =
+    mMapAccess->getSpeedRestrictions();
+  for (uint32_t laneIdx = 0; laneIdx < aLaneData.mLaneMetaData.size(); ++laneIdx)
+  {
+    const auto laneSpeedRestrictions =
+      speedRestrictions.getSpeedRestrictions(aArc,
+                                             laneIdx,
+                                             getVehicleType(aLaneData.mLaneMetaData[laneIdx].mType),
+                                             AutoStream::CCallParameters());
+
+    CAutoStreamSpeedLimit speedLimit {};
+    speedLimit.mNumberOfRestrictions = laneSpeedRestrictions.getNrLaneSpeedRestrictions();
+    if (speedLimit.mNumberOfRestrictions > 0)
+    {
+      const auto restriction = laneSpeedRestrictions.getLaneSpeedRestrictions(0);
+      speedLimit.mValue      = restriction.getSpeedLimitValue(0);
+      speedLimit.mUnit       = restriction.getSpeedUnit(0);
+    }
+    aLaneData.mSpeedLimits.push_back(speedLimit);
+  }
+}
+}
+}
+}
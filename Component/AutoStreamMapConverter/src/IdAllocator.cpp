@@ -0,0 +1,139 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#include "AutoStreamMapConverter/IdAllocator.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+namespace Constants {
+// IDs are split into a range index and an index within the range. 2^20 IDs per range suffice for
+// the points of any arc, 2^42 ranges make equal ranges of different keys rare and keep the end of
+// the last range at 2^62, such that IDs and range ends never overflow and lanelet2 can register
+// the ID after the largest one. Range zero is unused, such that no ID is zero (lanelet::InvalId).
+constexpr int      kIdRangeBits      = 20;
+constexpr uint64_t kNumberOfIdRanges = uint64_t(1) << 42;
+
+// FNV-1a parameters, the kind of key is hashed first such that arcs and traffic signs differ
+constexpr uint64_t kIdHashOffsetBasis  = 14695981039346656037ULL;
+constexpr uint64_t kIdHashPrime        = 1099511628211ULL;
+constexpr uint8_t  kArcKeyKind         = 1;
+constexpr uint8_t  kTrafficSignKeyKind = 2;
+}
+
+/**
+ * Get the first ID of the range derived from the bytes of a key.
+ *
+ * @param[in] aKind Kind of the key.
+ * @param[in] aKey Key of an arc or traffic sign.
+ * @retval lanelet::Id First ID of the range.
+ */
+template <typename KeyT>
+lanelet::Id getFirstIdOfKey(const uint8_t aKind, const KeyT& aKey)
+{
+  static_assert(std::is_trivially_copyable<KeyT>::value, "Only plain keys can be hashed");
+
+  uint64_t hash = (Constants::kIdHashOffsetBasis ^ aKind) * Constants::kIdHashPrime;
+
+  const auto* bytes = reinterpret_cast<const unsigned char*>(&aKey);
+  for (size_t idx = 0; idx < sizeof(KeyT); ++idx)
+  {
+    hash = (hash ^ bytes[idx]) * Constants::kIdHashPrime;
+  }
+
+  const uint64_t rangeIdx = hash % (Constants::kNumberOfIdRanges - 1) + 1;
+  return static_cast<lanelet::Id>(rangeIdx << Constants::kIdRangeBits);
+}
+
+/**
+ * Get the first ID of the range following the given range, skipping the unused range zero after
+ * the last range.
+ *
+ * @param[in] aFirstId First ID of a range.
+ * @retval lanelet::Id First ID of the next range.
+ */
+lanelet::Id getFirstIdOfNextRange(const lanelet::Id aFirstId)
+{
+  const uint64_t rangeIdx     = static_cast<uint64_t>(aFirstId) >> Constants::kIdRangeBits;
+  const uint64_t nextRangeIdx = rangeIdx % (Constants::kNumberOfIdRanges - 1) + 1;
+  return static_cast<lanelet::Id>(nextRangeIdx << Constants::kIdRangeBits);
+}
+
+CIdAllocator::CIdAllocator(const lanelet::Id aFirstId) noexcept
+  : mNextId(aFirstId)
+  , mEndId(aFirstId + getRangeSize())
+{
+}
+
+lanelet::Id CIdAllocator::getId()
+{
+  if (mNextId == mEndId)
+  {
+    throw std::out_of_range("All IDs reserved for an arc or traffic sign have been used.");
+  }
+
+  return mNextId++;
+}
+
+lanelet::Id CIdAllocator::getRangeSize() noexcept
+{
+  return lanelet::Id(1) << Constants::kIdRangeBits;
+}
+
+CIdRangeTable::CIdRangeTable()
+  : mNumberOfCollisions(0)
+{
+}
+
+lanelet::Id CIdRangeTable::claim(const lanelet::Id aFirstId)
+{
+  lanelet::Id firstId = aFirstId;
+  if (mClaimedFirstIds.count(firstId) > 0)
+  {
+    ++mNumberOfCollisions;
+  }
+
+  while (!mClaimedFirstIds.insert(firstId).second)
+  {
+    firstId = getFirstIdOfNextRange(firstId);
+  }
+
+  return firstId;
+}
+
+size_t CIdRangeTable::getNumberOfCollisions() const noexcept
+{
+  return mNumberOfCollisions;
+}
+
+void CIdRangeTable::clear()
+{
+  mClaimedFirstIds.clear();
+  mNumberOfCollisions = 0;
+}
+
+lanelet::Id getFirstIdOfArc(const AutoStream::HdMap::TArcKey& aArcKey)
+{
+  return getFirstIdOfKey(Constants::kArcKeyKind, aArcKey);
+}
+
+lanelet::Id getFirstIdOfTrafficSign(const AutoStream::HdMap::TTrafficSignKey& aTrafficSignKey)
+{
+  return getFirstIdOfKey(Constants::kTrafficSignKeyKind, aTrafficSignKey);
+}
+}
+}
+}
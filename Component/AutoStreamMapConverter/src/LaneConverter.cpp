@@ -25,16 +25,14 @@ namespace AutoStreamMapConverter {
 CAutoStreamLaneConverter::CAutoStreamLaneConverter(
   const lanelet::projection::UtmProjector& aUtmProjector)
   : mUtmProjector(aUtmProjector)
+  , mTraceBuffer(nullptr)
 {
 }
 
-bool CAutoStreamLaneConverter::convertLanes(
-  CAutoStreamArcData&                               aArcData,
-  const AutoStream::HdMap::TArc&                    aArc,
-  const AutoStream::HdMap::CHdMapSpeedRestrictions& aSpeedRestrictions,
-  std::vector<lanelet::Area>&                       aAreas,
-  std::vector<lanelet::Lanelet>&                    aLanelets,
-  std::set<lanelet::Id>&                            aInvalidConnectionsOut)
+bool CAutoStreamLaneConverter::convertLanes(CAutoStreamArcData&            aArcData,
+                                            CIdAllocator&                  aIdAllocator,
+                                            std::vector<lanelet::Area>&    aAreas,
+                                            std::vector<lanelet::Lanelet>& aLanelets)
 {
   if (!aArcData.isValid())
   {
@@ -48,7 +46,7 @@ bool CAutoStreamLaneConverter::convertLanes(
 
   // Converting all borders to line strings, for double lines, only the first line is converted.
   std::vector<lanelet::LineString3d> lineStrings;
-  if (!convertLaneBordersToLineStrings(aArcData.mLaneBorders, lineStrings))
+  if (!convertLaneBordersToLineStrings(aArcData.mLaneBorders, aIdAllocator, lineStrings))
   {
     return false;
   }
@@ -68,22 +66,23 @@ bool CAutoStreamLaneConverter::convertLanes(
 
       if (metaData.mDrivingSide == AutoStream::HdMap::HdRoad::TDrivingSide::kDrivingSideRight)
       {
-        aLanelets.emplace_back(getLanelet(leftBorder, rightBorder, metaData));
+        aLanelets.emplace_back(getLanelet(leftBorder, rightBorder, metaData, aIdAllocator));
       }
       else
       {
-        aLanelets.emplace_back(getLanelet(rightBorder, leftBorder, metaData));
+        aLanelets.emplace_back(getLanelet(rightBorder, leftBorder, metaData, aIdAllocator));
       }
 
-      storeIfDivergingTriangularLane(
-        leftBorder, rightBorder, aLanelets.back().id(), aInvalidConnectionsOut);
-      setSpeedLimit(aSpeedRestrictions, aArc, laneIdx, metaData.mType, aLanelets.back());
+      markIfDivergingTriangularLane(leftBorder, rightBorder, metaData);
+
+      CTraceSpan span(mTraceBuffer, "setSpeedLimit");
+      setSpeedLimit(aArcData.mSpeedLimits[laneIdx], aLanelets.back());
     }
     else
     {
       if (isArea(metaData.mType))
       {
-        lanelet::Area areaIdx = getArea(leftBorder, rightBorder, metaData);
+        lanelet::Area areaIdx = getArea(leftBorder, rightBorder, metaData, aIdAllocator);
         aAreas.emplace_back(areaIdx);
       }
 
@@ -117,11 +116,10 @@ void CAutoStreamLaneConverter::removeConnectionsIfConvergingTriangularLane(
   }
 }
 
-void CAutoStreamLaneConverter::storeIfDivergingTriangularLane(
-  lanelet::LineString3d& aLeft,
-  lanelet::LineString3d& aRight,
-  lanelet::Id            aLaneletId,
-  std::set<lanelet::Id>& aInvalidConnectionsOut) const
+void CAutoStreamLaneConverter::markIfDivergingTriangularLane(
+  lanelet::LineString3d&   aLeft,
+  lanelet::LineString3d&   aRight,
+  CAutoStreamLaneMetaData& aLaneletMetaData) const
 {
   /* Diverging triangular lanes (e.g. B) may be an outgoing connections in AutoStream (from A),
    * however, lanelets only have connections if both lane border end points are shared.
@@ -134,22 +132,20 @@ void CAutoStreamLaneConverter::storeIfDivergingTriangularLane(
    */
   if (isSame(aLeft.front(), aRight.front()))
   {
-    aInvalidConnectionsOut.insert(aLaneletId);
-    aLeft.front() = aRight.front();
+    aLaneletMetaData.mInvalidConnectionOut = true;
+    aLeft.front()                          = aRight.front();
   }
 }
 
-void CAutoStreamLaneConverter::setSpeedLimit(
-  const AutoStream::HdMap::CHdMapSpeedRestrictions& aMapSpeedRestrictions,
-  const AutoStream::HdMap::TArc&                    aArc,
-  const uint32_t                                    laneIdx,
-  const AutoStream::HdMap::HdRoad::TLaneType        aLaneType,
-  lanelet::Lanelet                                  aLanelet) const
+void CAutoStreamLaneConverter::setTraceBuffer(CTraceBuffer* aTraceBuffer) noexcept
 {
-  auto speedRestrictions = aMapSpeedRestrictions.getSpeedRestrictions(
-    aArc, laneIdx, getVehicleType(aLaneType), AutoStream::CCallParameters());
+  mTraceBuffer = aTraceBuffer;
+}
 
-  uint32_t numberOfRestrictions = speedRestrictions.getNrLaneSpeedRestrictions();
+void CAutoStreamLaneConverter::setSpeedLimit(const CAutoStreamSpeedLimit& aSpeedLimit,
+                                             lanelet::Lanelet             aLanelet) const
+{
+  uint32_t numberOfRestrictions = aSpeedLimit.mNumberOfRestrictions;
   if (numberOfRestrictions == 0)
   {
     return;
@@ -162,24 +158,24 @@ void CAutoStreamLaneConverter::setSpeedLimit(
   }
 
   // Set speed limit (only the first one)
-  auto laneSpeedRestriction = speedRestrictions.getLaneSpeedRestrictions(0);
-  aLanelet.attributes()[lanelet::AttributeName::SpeedLimit] = getSpeedLimit(laneSpeedRestriction);
+  aLanelet.attributes()[lanelet::AttributeName::SpeedLimit] = getSpeedLimit(aSpeedLimit);
 }
 
 bool CAutoStreamLaneConverter::convertLaneBordersToLineStrings(
-  const std::vector<AutoStream::HdMap::HdRoad::CLaneBorder>& aBorders,
-  std::vector<lanelet::LineString3d>&                        aLineStrings) const
+  const std::vector<CAutoStreamLaneBorder>& aBorders,
+  CIdAllocator&                             aIdAllocator,
+  std::vector<lanelet::LineString3d>&       aLineStrings) const
 {
   for (const auto& laneBorder : aBorders)
   {
-    if (laneBorder.getSize() == 0)
+    if (laneBorder.mComponents.empty())
     {
       std::cerr << "Lane border without components: not supported." << std::endl;
       return false;
     }
 
     // Store line string
-    aLineStrings.emplace_back(convertLaneBorder(laneBorder, mUtmProjector));
+    aLineStrings.emplace_back(convertLaneBorder(laneBorder, mUtmProjector, aIdAllocator));
   }
   return true;
 }
@@ -187,9 +183,10 @@ bool CAutoStreamLaneConverter::convertLaneBordersToLineStrings(
 lanelet::Lanelet
 CAutoStreamLaneConverter::getLanelet(const lanelet::LineString3d&   aLeftBorder,
                                      const lanelet::LineString3d&   aRightBorder,
-                                     const CAutoStreamLaneMetaData& aLaneMetaData) const
+                                     const CAutoStreamLaneMetaData& aLaneMetaData,
+                                     CIdAllocator&                  aIdAllocator) const
 {
-  lanelet::Lanelet lanelet(lanelet::utils::getId(), aLeftBorder, aRightBorder);
+  lanelet::Lanelet lanelet(aIdAllocator.getId(), aLeftBorder, aRightBorder);
 
   // Set lanelet attributes
   lanelet.attributes()[lanelet::AttributeName::OneWay]  = !aLaneMetaData.mOpposingTrafficAllowed;
@@ -200,13 +197,14 @@ CAutoStreamLaneConverter::getLanelet(const lanelet::LineString3d&   aLeftBorder,
 
 lanelet::Area CAutoStreamLaneConverter::getArea(lanelet::LineString3d&         aLeftBorder,
                                                 lanelet::LineString3d&         aRightBorder,
-                                                const CAutoStreamLaneMetaData& aLaneMetaData) const
+                                                const CAutoStreamLaneMetaData& aLaneMetaData,
+                                                CIdAllocator&                  aIdAllocator) const
 {
   // Get area bounds
-  auto areaBounds = getAreaBounds(aLeftBorder, aRightBorder);
+  auto areaBounds = getAreaBounds(aLeftBorder, aRightBorder, aIdAllocator);
 
   // Connect line strings in clockwise order
-  lanelet::Area area(lanelet::utils::getId(),
+  lanelet::Area area(aIdAllocator.getId(),
                      { areaBounds[0], areaBounds[1], areaBounds[2], areaBounds[3] });
 
   // Set area attributes
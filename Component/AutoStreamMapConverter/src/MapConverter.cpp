@@ -10,17 +10,269 @@
  */
 
 #include "AutoStreamMapConverter/MapConverter.hpp"
+#include "AutoStreamMapConverter/ArcPrefetchQueue.hpp"
+#include "AutoStreamMapConverter/BinaryMapWriter.hpp"
+#include "AutoStreamMapConverter/CompressedFile.hpp"
+#include "AutoStreamMapConverter/HdMapSource.hpp"
+#include "AutoStreamMapConverter/OsmWriter.hpp"
+#include "AutoStreamMapConverter/RecordingMapSource.hpp"
+#include "AutoStreamMapConverter/RoutingGraph.hpp"
 
 #include "TomTom/AutoStream/HdMap/HdMapArc.h"
-#include "TomTom/AutoStream/HdMap/HdMapTrafficSigns.h"
 
-#include <lanelet2_io/Io.h>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <unordered_set>
 
 namespace TomTom {
 namespace AutoStreamForAutoware {
 namespace AutoStreamMapConverter {
 
-CAutoStreamMapConverter::CAutoStreamMapConverter() {}
+namespace Constants {
+// Suffix of the conversion report file name, appended to the output file name
+constexpr const char* kReportFileSuffix = ".report.json";
+
+// Suffix appended to the output file name for the change set against the previous map
+constexpr const char* kDeltaFileSuffix = ".osc";
+
+// Suffix appended to the output file name for the routing graph of the map
+constexpr const char* kRoutingGraphFileSuffix = ".routing";
+}
+
+/**
+ * Assign a new ID to the given primitive, unless it has been renumbered already. Primitives are
+ * shared between lanelets and areas, their data is used to visit each of them once. New IDs are
+ * taken from the same range as the old ones, such that IDs cannot tell renumbered primitives.
+ *
+ * @param[in, out] aPrimitive Primitive that must be renumbered.
+ * @param[in, out] aIdAllocator Allocator providing the new IDs.
+ * @param[in, out] aRenumbered Data of the primitives that have been renumbered.
+ */
+template <typename PrimitiveT>
+void renumber(PrimitiveT&                      aPrimitive,
+              CIdAllocator&                    aIdAllocator,
+              std::unordered_set<const void*>& aRenumbered)
+{
+  if (aPrimitive.id() == lanelet::InvalId
+      || !aRenumbered.insert(aPrimitive.constData().get()).second)
+  {
+    return;
+  }
+
+  aPrimitive.setId(aIdAllocator.getId());
+}
+
+/**
+ * Assign new IDs to a line string and its points.
+ *
+ * @param[in, out] aLineString Line string that must be renumbered.
+ * @param[in, out] aIdAllocator Allocator providing the new IDs.
+ * @param[in, out] aRenumbered Data of the primitives that have been renumbered.
+ */
+void renumberLineString(lanelet::LineString3d&           aLineString,
+                        CIdAllocator&                    aIdAllocator,
+                        std::unordered_set<const void*>& aRenumbered)
+{
+  renumber(aLineString, aIdAllocator, aRenumbered);
+  for (size_t idx = 0; idx < aLineString.size(); ++idx)
+  {
+    lanelet::Point3d point = aLineString[idx];
+    renumber(point, aIdAllocator, aRenumbered);
+  }
+}
+
+/**
+ * Copy a line string for stitching a single map of a batch. Line strings are shared between
+ * lanelets and areas of an arc, their data is used to copy each of them once. Points are not
+ * copied: stitching replaces the points of line strings, but never modifies the points themselves,
+ * and renumbering assigns the IDs of all points again for every map.
+ *
+ * @param[in] aLineString Line string that must be copied.
+ * @param[in, out] aCopies Copies made so far, by data of the original line string.
+ * @retval lanelet::LineString3d Copy, inverted if the original is inverted.
+ */
+lanelet::LineString3d
+copyLineString(lanelet::LineString3d                                   aLineString,
+               std::unordered_map<const void*, lanelet::LineString3d>& aCopies)
+{
+  lanelet::LineString3d lineString = aLineString.inverted() ? aLineString.invert() : aLineString;
+
+  auto copy = aCopies.find(lineString.constData().get());
+  if (copy == aCopies.end())
+  {
+    const lanelet::Points3d     points(lineString.begin(), lineString.end());
+    const lanelet::LineString3d newLineString(lineString.id(), points, lineString.attributes());
+    copy = aCopies.emplace(lineString.constData().get(), newLineString).first;
+  }
+
+  return aLineString.inverted() ? copy->second.invert() : copy->second;
+}
+
+/**
+ * Copy the conversion result of an arc for stitching a single map of a batch, see copyLineString.
+ *
+ * @param[in] aResult Unstitched conversion result of the arc.
+ * @retval CAutoStreamArcConversionResult Copy of which the lanelets and areas can be stitched.
+ */
+CAutoStreamArcConversionResult copyConversionResult(const CAutoStreamArcConversionResult& aResult)
+{
+  CAutoStreamArcConversionResult copy;
+  copy.mConverted   = aResult.mConverted;
+  copy.mConnections = aResult.mConnections;
+  copy.mFingerprint = aResult.mFingerprint;
+
+  std::unordered_map<const void*, lanelet::LineString3d> lineStrings;
+  for (lanelet::Lanelet lanelet : aResult.mLanelets)
+  {
+    if (lanelet.id() == lanelet::InvalId)
+    {
+      // Lanes converted to areas keep an invalid lanelet without bounds
+      copy.mLanelets.emplace_back(lanelet::InvalId);
+      continue;
+    }
+
+    copy.mLanelets.emplace_back(lanelet.id(),
+                                copyLineString(lanelet.leftBound(), lineStrings),
+                                copyLineString(lanelet.rightBound(), lineStrings),
+                                lanelet.attributes());
+  }
+
+  for (lanelet::Area area : aResult.mAreas)
+  {
+    lanelet::LineStrings3d outerBound;
+    for (const auto& border : area.outerBound())
+    {
+      outerBound.push_back(copyLineString(border, lineStrings));
+    }
+    copy.mAreas.emplace_back(area.id(), outerBound, area.innerBounds(), area.attributes());
+  }
+
+  return copy;
+}
+
+/**
+ * Copy a converted traffic sign to another range of IDs. IDs are allocated in order from a range,
+ * moving them by the distance between the ranges gives the IDs of converting into the other range.
+ *
+ * @param[in] aTrafficSign Converted traffic sign.
+ * @param[in] aIdOffset Distance between the first IDs of the ranges.
+ * @retval lanelet::Polygon3d Copy with new points and IDs.
+ */
+lanelet::Polygon3d copyToIdRange(const lanelet::Polygon3d& aTrafficSign,
+                                 const lanelet::Id         aIdOffset)
+{
+  lanelet::Points3d points;
+  for (const auto& point : aTrafficSign)
+  {
+    points.emplace_back(point.id() + aIdOffset, point.basicPoint(), point.attributes());
+  }
+
+  return lanelet::Polygon3d(aTrafficSign.id() + aIdOffset, points, aTrafficSign.attributes());
+}
+
+/**
+ * Count the points of the lane borders of the lanelets and areas of a converted arc. Points shared
+ * by neighbouring lanelets are counted once for each lanelet.
+ *
+ * @param[in] aResult Conversion result of the arc.
+ * @retval size_t Number of points.
+ */
+size_t countPoints(const CAutoStreamArcConversionResult& aResult)
+{
+  size_t numberOfPoints = 0;
+  for (const auto& lanelet : aResult.mLanelets)
+  {
+    if (lanelet.id() != lanelet::InvalId)
+    {
+      numberOfPoints += lanelet.leftBound().size() + lanelet.rightBound().size();
+    }
+  }
+
+  for (const auto& area : aResult.mAreas)
+  {
+    for (const auto& border : area.outerBound())
+    {
+      numberOfPoints += border.size();
+    }
+  }
+
+  return numberOfPoints;
+}
+
+/**
+ * Split a bounding box into a grid of equally sized tiles. Neighbouring tiles share their borders.
+ *
+ * @param[in] aBoundingBox Bounding box that must be split.
+ * @param[in] aRows Number of rows of the grid, from south to north.
+ * @param[in] aColumns Number of columns of the grid, from west to east.
+ * @retval std::vector<AutoStream::TBoundingBox> Tiles, row by row.
+ */
+std::vector<AutoStream::TBoundingBox> splitBoundingBox(const AutoStream::TBoundingBox& aBoundingBox,
+                                                       const size_t                    aRows,
+                                                       const size_t                    aColumns)
+{
+  const double southLat   = aBoundingBox.getCornerSW().getLatDegree();
+  const double westLon    = aBoundingBox.getCornerSW().getLonDegree();
+  const double tileHeight = (aBoundingBox.getCornerNE().getLatDegree() - southLat) / aRows;
+  const double tileWidth  = (aBoundingBox.getCornerNE().getLonDegree() - westLon) / aColumns;
+
+  std::vector<AutoStream::TBoundingBox> tiles;
+  tiles.reserve(aRows * aColumns);
+  for (size_t row = 0; row < aRows; ++row)
+  {
+    for (size_t column = 0; column < aColumns; ++column)
+    {
+      tiles.emplace_back(
+        AutoStream::TCoordinate::createFromDegrees(southLat + row * tileHeight,
+                                                   westLon + column * tileWidth),
+        AutoStream::TCoordinate::createFromDegrees(southLat + (row + 1) * tileHeight,
+                                                   westLon + (column + 1) * tileWidth));
+    }
+  }
+
+  return tiles;
+}
+
+/**
+ * Get the bounding box enclosing the bounding boxes of all given batch jobs.
+ *
+ * @param[in] aJobs Batch jobs, must not be empty.
+ * @retval AutoStream::TBoundingBox Enclosing bounding box.
+ */
+AutoStream::TBoundingBox getEnclosingBoundingBox(const std::vector<CAutoStreamBatchJob>& aJobs)
+{
+  double southLat = aJobs.front().mBoundingBox.getCornerSW().getLatDegree();
+  double westLon  = aJobs.front().mBoundingBox.getCornerSW().getLonDegree();
+  double northLat = aJobs.front().mBoundingBox.getCornerNE().getLatDegree();
+  double eastLon  = aJobs.front().mBoundingBox.getCornerNE().getLonDegree();
+  for (const auto& job : aJobs)
+  {
+    southLat = std::min(southLat, job.mBoundingBox.getCornerSW().getLatDegree());
+    westLon  = std::min(westLon, job.mBoundingBox.getCornerSW().getLonDegree());
+    northLat = std::max(northLat, job.mBoundingBox.getCornerNE().getLatDegree());
+    eastLon  = std::max(eastLon, job.mBoundingBox.getCornerNE().getLonDegree());
+  }
+
+  return AutoStream::TBoundingBox(AutoStream::TCoordinate::createFromDegrees(southLat, westLon),
+                                  AutoStream::TCoordinate::createFromDegrees(northLat, eastLon));
+}
+
+CAutoStreamMapConverter::CAutoStreamMapConverter()
+  : mOutputFormat(TMapFileFormat::Osm)
+  , mNumberOfWorkers(1)
+  , mPrefetchDepth(0)
+  , mTileRows(1)
+  , mTileColumns(1)
+  , mRoutingGraphEnabled(false)
+  , mPreviousMapVersionMatches(false)
+{
+}
 
 bool CAutoStreamMapConverter::initializeAutoStream(const CAutoStreamParameters& aAutoStreamParams)
 {
@@ -35,399 +287,1432 @@ bool CAutoStreamMapConverter::storeMap(const AutoStream::TBoundingBox& aBounding
     return false;
   }
 
-  if (!mAutoStreamInterface.isInitialized())
+  if (!checkConversionPreconditions(mOutputFilename))
   {
-    std::cerr << "AutoStream was not initialized, storing map failed." << std::endl;
     return false;
   }
 
-  if (mOutputFilename.empty())
+  // Initialize converters for given bounding box
+  auto utmProjector = getUtmProjector(aBoundingBox);
+  initializeConversion(utmProjector);
+
+  if (!convertArcsInBoundingBox(aBoundingBox, utmProjector))
+  {
+    std::cerr << "Converting AutoStream arcs failed, storing map failed." << std::endl;
+    return false;
+  }
+
+  if (!convertTrafficSignsInBoundingBox(aBoundingBox))
+  {
+    std::cerr << "Converting AutoStream traffic signs failed, storing map failed." << std::endl;
+    return false;
+  }
+
+  return finishConversion(utmProjector);
+}
+
+bool CAutoStreamMapConverter::storeMap(const std::vector<AutoStream::TCoordinate>& aRoute,
+                                       const double aBufferWidthMeter)
+{
+  const CRouteCorridor corridor(aRoute, aBufferWidthMeter);
+  if (corridor.empty())
+  {
+    std::cerr << "Route is empty, storing map failed." << std::endl;
+    return false;
+  }
+
+  if (!checkConversionPreconditions(mOutputFilename))
+  {
+    return false;
+  }
+
+  // Initialize converters for the area around the route
+  auto utmProjector = getUtmProjector(corridor.getBoundingBox());
+  initializeConversion(utmProjector);
+
+  if (!convertArcsInCorridor(corridor, utmProjector))
+  {
+    std::cerr << "Converting AutoStream arcs failed, storing map failed." << std::endl;
+    return false;
+  }
+
+  if (!convertTrafficSignsInCorridor(corridor))
+  {
+    std::cerr << "Converting AutoStream traffic signs failed, storing map failed." << std::endl;
+    return false;
+  }
+
+  return finishConversion(utmProjector);
+}
+
+bool CAutoStreamMapConverter::storeMaps(const std::vector<CAutoStreamBatchJob>& aJobs)
+{
+  if (aJobs.empty())
+  {
+    std::cerr << "No batch jobs given, storing maps failed." << std::endl;
+    return false;
+  }
+
+  for (const auto& job : aJobs)
+  {
+    if (!job.mBoundingBox.isValid() || job.mOutputFileName.empty())
+    {
+      std::cerr << "Batch job for " << job.mOutputFileName
+                << " has an invalid bounding box or no output file name, storing maps failed."
+                << std::endl;
+      return false;
+    }
+  }
+
+  if (!checkConversionPreconditions(aJobs.front().mOutputFileName))
+  {
+    return false;
+  }
+
+  // All maps share one projection, such that every arc has to be converted once
+  auto utmProjector = getUtmProjector(getEnclosingBoundingBox(aJobs));
+  initializeConversion(utmProjector);
+
+  std::vector<std::vector<AutoStream::HdMap::TArcKey>>         jobArcKeys(aJobs.size());
+  std::vector<std::vector<AutoStream::HdMap::TTrafficSignKey>> jobTrafficSignKeys(aJobs.size());
+  CAutoStreamBatchResults                                      sharedResults;
+  try
+  {
+    std::set<AutoStream::HdMap::TArcKey>         allArcKeys;
+    std::set<AutoStream::HdMap::TTrafficSignKey> allTrafficSignKeys;
+    {
+      const CConversionReport::CStageTimer timer(mReport, "arcKeysInArea");
+      for (size_t jobIdx = 0; jobIdx < aJobs.size(); ++jobIdx)
+      {
+        jobArcKeys[jobIdx] = mMapSource->getArcKeysInArea(aJobs[jobIdx].mBoundingBox);
+        allArcKeys.insert(jobArcKeys[jobIdx].begin(), jobArcKeys[jobIdx].end());
+
+        jobTrafficSignKeys[jobIdx] =
+          mMapSource->getTrafficSignKeysInArea(aJobs[jobIdx].mBoundingBox);
+        allTrafficSignKeys.insert(jobTrafficSignKeys[jobIdx].begin(),
+                                  jobTrafficSignKeys[jobIdx].end());
+      }
+    }
+
+    // Convert the union of all areas and keep the unstitched results
+    const std::vector<AutoStream::HdMap::TArcKey> arcKeys(allArcKeys.begin(), allArcKeys.end());
+    std::vector<CAutoStreamArcConversionResult>   results;
+    convertArcs(arcKeys, utmProjector, results);
+    for (size_t arcIdx = 0; arcIdx < arcKeys.size(); ++arcIdx)
+    {
+      sharedResults.mArcs.emplace(arcKeys[arcIdx], std::move(results[arcIdx]));
+    }
+
+    convertBatchTrafficSigns(allTrafficSignKeys, sharedResults);
+
+    std::cout << "Converted " << arcKeys.size() << " distinct arcs and "
+              << allTrafficSignKeys.size() << " distinct traffic signs for " << aJobs.size()
+              << " maps." << std::endl;
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Exception thrown when converting AutoStream map data: " << e.what() << std::endl;
+    return false;
+  }
+
+  // The report of every job includes the shared conversion
+  const CConversionReport sharedReport   = mReport;
+  const std::string       outputFileName = mOutputFilename;
+  bool                    allStored      = true;
+  for (size_t jobIdx = 0; jobIdx < aJobs.size(); ++jobIdx)
+  {
+    mReport = sharedReport;
+    if (!storeBatchJob(aJobs[jobIdx],
+                       jobArcKeys[jobIdx],
+                       jobTrafficSignKeys[jobIdx],
+                       sharedResults,
+                       utmProjector))
+    {
+      std::cerr << "Storing map " << aJobs[jobIdx].mOutputFileName << " failed." << std::endl;
+      allStored = false;
+    }
+  }
+  mOutputFilename = outputFileName;
+
+  if (!mArcCacheFileName.empty() && !mUpdatedArcCache.store(mArcCacheFileName))
+  {
+    std::cerr << "Storing arc cache " << mArcCacheFileName << " failed." << std::endl;
+  }
+
+  storeRecording();
+  storeTrace();
+  return allStored;
+}
+
+bool CAutoStreamMapConverter::storeBatchJob(
+  const CAutoStreamBatchJob&                             aJob,
+  const std::vector<AutoStream::HdMap::TArcKey>&         aArcKeys,
+  const std::vector<AutoStream::HdMap::TTrafficSignKey>& aTrafficSignKeys,
+  const CAutoStreamBatchResults&                         aSharedResults,
+  const lanelet::projection::UtmProjector&               aUtmProjector)
+{
+  mLanelets.clear();
+  mAreas.clear();
+  mAreaIndicesByLineStringId.clear();
+  mTrafficSignPolygons.clear();
+  mIdRanges.clear();
+
+  try
+  {
+    // Stitching modifies primitives, every map is therefore built from its own copy
+    std::vector<CAutoStreamArcConversionResult> results;
+    {
+      const CConversionReport::CStageTimer timer(mReport, "copyConversionResults");
+      results.reserve(aArcKeys.size());
+      for (const auto& key : aArcKeys)
+      {
+        results.push_back(copyConversionResult(aSharedResults.mArcs.at(key)));
+      }
+    }
+
+    CAutoStreamArcTable arcTable;
+    storeConversionResults(aArcKeys, results, arcTable);
+    connectArcs(arcTable);
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Exception thrown when assembling AutoStream arcs: " << e.what() << std::endl;
+    return false;
+  }
+
+  addBatchTrafficSigns(aTrafficSignKeys, aSharedResults);
+
+  mOutputFilename = aJob.mOutputFileName;
+  {
+    const CConversionReport::CStageTimer timer(mReport, "writeMap");
+    const CTraceSpan                     span(mTraceBuffer.get(), "writeMap");
+    if (!storeMap(aUtmProjector))
+    {
+      return false;
+    }
+  }
+
+  storeRoutingGraph();
+  storeReport();
+  return true;
+}
+
+bool CAutoStreamMapConverter::checkConversionPreconditions(const std::string& aOutputFileName)
+{
+  mReport.reset();
+  if (isTracing())
+  {
+    mTraceRecorder.start();
+  }
+
+  if (aOutputFileName.empty())
   {
     std::cerr << "No output file name set, storing map failed." << std::endl;
     return false;
   }
 
-  if (!updateMapAccess())
+  // A replayed conversion does not use AutoStream at all
+  if (isReplaying())
+  {
+    if (!mRecording.load(mReplayFileName))
+    {
+      std::cerr << "Loading map recording " << mReplayFileName << " failed." << std::endl;
+      return false;
+    }
+
+    return updateMapSource();
+  }
+
+  if (!hasMapSourceFactory() && !mAutoStreamInterface.isInitialized())
+  {
+    std::cerr << "AutoStream was not initialized, storing map failed." << std::endl;
+    return false;
+  }
+
+  if (!updateMapSource())
+  {
+    std::cerr << "Getting valid map access failed." << std::endl;
+    return false;
+  }
+
+  if (isRecording())
+  {
+    mRecording.reset(mMapSource->getMapVersionAndHash());
+  }
+
+  return true;
+}
+
+void CAutoStreamMapConverter::initializeConversion(
+  const lanelet::projection::UtmProjector& aUtmProjector)
+{
+  mArcConverter         = std::make_unique<CAutoStreamArcConverter>(aUtmProjector);
+  mTrafficSignConverter = std::make_unique<CAutoStreamTrafficSignConverter>(aUtmProjector);
+
+  // The calling thread is the first thread of the trace, worker threads follow
+  mTraceBuffer = isTracing() ? std::make_unique<CTraceBuffer>(mTraceRecorder, 0) : nullptr;
+  mArcConverter->setTraceBuffer(mTraceBuffer.get());
+
+  if (!mArcCacheFileName.empty())
+  {
+    prepareArcCache(aUtmProjector);
+  }
+
+  mLanelets.clear();
+  mAreas.clear();
+  mAreaIndicesByLineStringId.clear();
+  mTrafficSignPolygons.clear();
+  mIdRanges.clear();
+}
+
+bool CAutoStreamMapConverter::finishConversion(
+  const lanelet::projection::UtmProjector& aUtmProjector)
+{
+  // The previous map is read first, as it may be overwritten by the current map
+  COsmDocument previousMap;
+  bool         previousMapLoaded = false;
+  if (!mDeltaBaseFileName.empty() && mOutputFormat != TMapFileFormat::Osm)
+  {
+    std::cerr << "Change sets are only written for OSM maps, no change set is written."
+              << std::endl;
+  }
+  else if (!mDeltaBaseFileName.empty())
+  {
+    const CConversionReport::CStageTimer timer(mReport, "loadPreviousMap");
+    previousMapLoaded = previousMap.load(mDeltaBaseFileName);
+    if (!previousMapLoaded)
+    {
+      std::cerr << "Loading previous map " << mDeltaBaseFileName
+                << " failed, no change set is written." << std::endl;
+    }
+  }
+
+  {
+    const CConversionReport::CStageTimer timer(mReport, "writeMap");
+    const CTraceSpan                     span(mTraceBuffer.get(), "writeMap");
+    if (!storeMap(aUtmProjector))
+    {
+      std::cerr << "Writing map to " << mOutputFilename << " failed." << std::endl;
+      return false;
+    }
+  }
+
+  if (previousMapLoaded)
+  {
+    const CConversionReport::CStageTimer timer(mReport, "storeMapDelta");
+    storeMapDelta(previousMap);
+  }
+
+  storeRoutingGraph();
+
+  if (!mArcCacheFileName.empty())
+  {
+    const CConversionReport::CStageTimer timer(mReport, "storeArcCache");
+    if (!mUpdatedArcCache.store(mArcCacheFileName))
+    {
+      std::cerr << "Storing arc cache " << mArcCacheFileName << " failed." << std::endl;
+    }
+  }
+
+  {
+    const CConversionReport::CStageTimer timer(mReport, "storeRecording");
+    storeRecording();
+  }
+
+  storeReport();
+  storeTrace();
+  return true;
+}
+
+void CAutoStreamMapConverter::storeMapDelta(const COsmDocument& aPreviousMap)
+{
+  COsmDocument currentMap;
+  if (!currentMap.load(mOutputFilename))
+  {
+    std::cerr << "Reading map " << mOutputFilename << " failed, no change set is written."
+              << std::endl;
+    return;
+  }
+
+  CMapDelta delta;
+  delta.compute(aPreviousMap, currentMap);
+
+  const std::string deltaFileName = mOutputFilename + Constants::kDeltaFileSuffix;
+  if (!delta.store(deltaFileName))
+  {
+    std::cerr << "Storing change set " << deltaFileName << " failed." << std::endl;
+    return;
+  }
+
+  std::cout << "Stored change set against " << mDeltaBaseFileName << " with ";
+  delta.printStatistics(std::cout);
+  std::cout << "." << std::endl;
+
+  const CMapDeltaStatistics& statistics = delta.getStatistics();
+
+  mReport.setCounter(TReportCounter::AddedLanelets, statistics.mNumberOfAddedLanelets);
+  mReport.setCounter(TReportCounter::RemovedLanelets, statistics.mNumberOfRemovedLanelets);
+  mReport.setCounter(TReportCounter::ModifiedLanelets, statistics.mNumberOfModifiedLanelets);
+  mReport.setCounter(TReportCounter::AddedAreas, statistics.mNumberOfAddedAreas);
+  mReport.setCounter(TReportCounter::RemovedAreas, statistics.mNumberOfRemovedAreas);
+  mReport.setCounter(TReportCounter::ModifiedAreas, statistics.mNumberOfModifiedAreas);
+  mReport.setCounter(TReportCounter::AddedTrafficSigns, statistics.mNumberOfAddedTrafficSigns);
+  mReport.setCounter(TReportCounter::RemovedTrafficSigns, statistics.mNumberOfRemovedTrafficSigns);
+  mReport.setCounter(TReportCounter::ModifiedTrafficSigns,
+                     statistics.mNumberOfModifiedTrafficSigns);
+}
+
+void CAutoStreamMapConverter::prepareArcCache(
+  const lanelet::projection::UtmProjector& aUtmProjector)
+{
+  const lanelet::GPSPoint& origin = aUtmProjector.origin().position;
+
+  // A missing cache is expected for the first conversion, all arcs are converted in that case
+  if (mPreviousArcCache.load(mArcCacheFileName) && !mPreviousArcCache.hasOrigin(origin))
+  {
+    std::cout << "Arc cache was created for another origin, converting all arcs." << std::endl;
+    mPreviousArcCache.reset(AutoStream::CMapVersionAndHash(), origin);
+  }
+
+  const AutoStream::CMapVersionAndHash mapVersionAndHash = mMapSource->getMapVersionAndHash();
+  mPreviousMapVersionMatches = mPreviousArcCache.hasMapVersion(mapVersionAndHash);
+  mUpdatedArcCache.reset(mapVersionAndHash, origin);
+}
+
+bool CAutoStreamMapConverter::warmUpTileCache(
+  const std::vector<AutoStream::TBoundingBox>& aAreas,
+  CTileCacheWarmUpStatistics&                  aStatistics)
+{
+  aStatistics = CTileCacheWarmUpStatistics();
+
+  if (!hasMapSourceFactory() && !mAutoStreamInterface.isInitialized())
+  {
+    std::cerr << "AutoStream was not initialized, warming up tile cache failed." << std::endl;
+    return false;
+  }
+
+  if (!updateMapSource())
+  {
+    std::cerr << "Getting valid map access failed." << std::endl;
+    return false;
+  }
+
+  try
+  {
+    // Collect keys of all areas, areas along a route overlap
+    std::set<AutoStream::HdMap::TArcKey>         arcKeys;
+    std::set<AutoStream::HdMap::TTrafficSignKey> trafficSignKeys;
+    for (const auto& area : aAreas)
+    {
+      const std::vector<AutoStream::HdMap::TArcKey> areaArcKeys =
+        mMapSource->getArcKeysInArea(area);
+      arcKeys.insert(areaArcKeys.begin(), areaArcKeys.end());
+
+      const std::vector<AutoStream::HdMap::TTrafficSignKey> areaTrafficSignKeys =
+        mMapSource->getTrafficSignKeysInArea(area);
+      trafficSignKeys.insert(areaTrafficSignKeys.begin(), areaTrafficSignKeys.end());
+    }
+
+    // Retrieve everything the arc converter would retrieve
+    const std::vector<AutoStream::HdMap::TArcKey> keys(arcKeys.begin(), arcKeys.end());
+    if (!keys.empty())
+    {
+      std::atomic<size_t> nextArcIdx(0);
+      runWorkers(std::min(mNumberOfWorkers, keys.size()),
+                 getUtmProjector(aAreas.front()),
+                 [&](CAutoStreamMapSource& aMapSource, CAutoStreamArcConverter&) {
+                   for (size_t arcIdx = nextArcIdx++; arcIdx < keys.size(); arcIdx = nextArcIdx++)
+                   {
+                     aMapSource.prefetchArc(keys[arcIdx]);
+                   }
+                 });
+    }
+
+    for (const auto& key : trafficSignKeys)
+    {
+      mMapSource->getTrafficSign(key);
+    }
+
+    aStatistics.mNumberOfAreas        = aAreas.size();
+    aStatistics.mNumberOfArcs         = keys.size();
+    aStatistics.mNumberOfTrafficSigns = trafficSignKeys.size();
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Exception thrown when warming up tile cache: " << e.what() << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool CAutoStreamMapConverter::convertArcsInBoundingBox(
+  const AutoStream::TBoundingBox&          aBoundingBox,
+  const lanelet::projection::UtmProjector& aUtmProjector)
+{
+  if (!mArcConverter)
+  {
+    std::cerr << "Arc converter has not been initialized." << std::endl;
+    return false;
+  }
+
+  try
+  {
+    // Convert arcs without considering connections
+    CAutoStreamArcTable arcTable;
+    if (mTileRows * mTileColumns > 1)
+    {
+      // Arc keys are retrieved per tile by the worker threads
+      std::vector<AutoStream::HdMap::TArcKey>     keys;
+      std::vector<CAutoStreamArcConversionResult> results;
+      {
+        const CConversionReport::CStageTimer timer(mReport, "convertArcs");
+        convertArcsInTiles(aBoundingBox, aUtmProjector, keys, results);
+        addToArcCache(keys, results);
+      }
+      storeConversionResults(keys, results, arcTable);
+    }
+    else
+    {
+      // Retrieve arc keys within bounding box
+      std::vector<AutoStream::HdMap::TArcKey> keys;
+      {
+        const CConversionReport::CStageTimer timer(mReport, "arcKeysInArea");
+        keys = mMapSource->getArcKeysInArea(aBoundingBox);
+      }
+      convertArcKeys(keys, aUtmProjector, arcTable);
+    }
+
+    // Stitch connections over the whole table, such that connections across tile seams are kept
+    connectArcs(arcTable);
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Exception thrown when converting AutoStream arcs: " << e.what() << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool CAutoStreamMapConverter::convertArcsInCorridor(
+  const CRouteCorridor&                    aCorridor,
+  const lanelet::projection::UtmProjector& aUtmProjector)
+{
+  if (!mArcConverter)
+  {
+    std::cerr << "Arc converter has not been initialized." << std::endl;
+    return false;
+  }
+
+  try
+  {
+    std::vector<AutoStream::HdMap::TArcKey> keys;
+    {
+      const CConversionReport::CStageTimer timer(mReport, "selectArcsInCorridor");
+      keys = selectArcsInCorridor(aCorridor, aUtmProjector);
+    }
+
+    CAutoStreamArcTable arcTable;
+    convertArcKeys(keys, aUtmProjector, arcTable);
+    connectArcs(arcTable);
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Exception thrown when converting AutoStream arcs: " << e.what() << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+std::vector<AutoStream::HdMap::TArcKey>
+CAutoStreamMapConverter::selectArcsInCorridor(
+  const CRouteCorridor&                    aCorridor,
+  const lanelet::projection::UtmProjector& aUtmProjector) const
+{
+  // Remember which pieces of the corridor found each arc. An arc within the buffer of a piece is
+  // found by the bounding box of that piece, so only these pieces have to be checked.
+  const auto&                                               boxes = aCorridor.getBoundingBoxes();
+  std::map<AutoStream::HdMap::TArcKey, std::vector<size_t>> piecesByKey;
+  for (size_t pieceIdx = 0; pieceIdx < boxes.size(); ++pieceIdx)
+  {
+    for (const auto& key : mMapSource->getArcKeysInArea(boxes[pieceIdx]))
+    {
+      piecesByKey[key].push_back(pieceIdx);
+    }
+  }
+
+  std::vector<AutoStream::HdMap::TArcKey> candidateKeys;
+  std::vector<std::vector<size_t>>        candidatePieces;
+  for (auto& keyAndPieces : piecesByKey)
+  {
+    candidateKeys.push_back(keyAndPieces.first);
+    candidatePieces.push_back(std::move(keyAndPieces.second));
+  }
+
+  // Checking the geometry retrieves the arcs, which is done by the worker threads
+  std::vector<char> selected(candidateKeys.size(), 0);
+  if (!candidateKeys.empty())
+  {
+    std::atomic<size_t> nextIdx(0);
+    runWorkers(std::min(mNumberOfWorkers, candidateKeys.size()),
+               aUtmProjector,
+               [&](CAutoStreamMapSource& aMapSource, CAutoStreamArcConverter& aArcConverter) {
+                 for (size_t idx = nextIdx++; idx < candidateKeys.size(); idx = nextIdx++)
+                 {
+                   const CAutoStreamArcData arcData = aMapSource.getArc(candidateKeys[idx]);
+                   selected[idx] =
+                     aArcConverter.isArcInCorridor(arcData, aCorridor, candidatePieces[idx]);
+                 }
+               });
+  }
+
+  // Keys stay sorted, such that the conversion result does not depend on the workers
+  std::vector<AutoStream::HdMap::TArcKey> keys;
+  for (size_t idx = 0; idx < candidateKeys.size(); ++idx)
+  {
+    if (selected[idx] != 0)
+    {
+      keys.push_back(candidateKeys[idx]);
+    }
+  }
+
+  std::cout << "Selected " << keys.size() << " of " << candidateKeys.size()
+            << " arcs found along the route." << std::endl;
+  return keys;
+}
+
+void CAutoStreamMapConverter::connectArcs(CAutoStreamArcTable& aArcTable)
+{
+  CPointUnionFind pointUnionFind;
+  {
+    const CConversionReport::CStageTimer timer(mReport, "storeLaneletConnectivity");
+    aArcTable.resolveConnections();
+    pointUnionFind = storeLaneletConnectivity(aArcTable);
+  }
+
+  const CConversionReport::CStageTimer timer(mReport, "addConnections");
+  addConnections(aArcTable, pointUnionFind);
+  storeValidLanelets(aArcTable);
+}
+
+void CAutoStreamMapConverter::addConnections(CAutoStreamArcTable& aArcTable,
+                                             CPointUnionFind&     aPointUnionFind) const
+{
+  for (auto& lanelet : aArcTable.mLanelets)
+  {
+    lanelet::LineString3d left  = lanelet.leftBound();
+    lanelet::LineString3d right = lanelet.rightBound();
+
+    const bool leftChanged  = addConnectionsToLaneBorder(left, aPointUnionFind);
+    const bool rightChanged = addConnectionsToLaneBorder(right, aPointUnionFind);
+
+    if (leftChanged || rightChanged)
+    {
+      lanelet::Lanelet newLanelet(lanelet.id(), left, right);
+      newLanelet.attributes() = lanelet.attributes();
+      lanelet                 = newLanelet;
+    }
+  }
+}
+
+bool CAutoStreamMapConverter::addConnectionsToLaneBorder(lanelet::LineString3d& aLaneBorder,
+                                                         CPointUnionFind& aPointUnionFind) const
+{
+  bool changed = false;
+
+  if (!aLaneBorder.empty())
+  {
+    lanelet::Point3d replacement;
+    if (aPointUnionFind.find(aLaneBorder.front().id(), replacement))
+    {
+      aLaneBorder.front() = replacement;
+      changed             = true;
+    }
+    if (aPointUnionFind.find(aLaneBorder.back().id(), replacement))
+    {
+      aLaneBorder.back() = replacement;
+      changed            = true;
+    }
+  }
+  return changed;
+}
+
+void CAutoStreamMapConverter::convertArcKeys(
+  const std::vector<AutoStream::HdMap::TArcKey>& aArcKeys,
+  const lanelet::projection::UtmProjector&       aUtmProjector,
+  CAutoStreamArcTable&                           aArcTable)
+{
+  std::vector<CAutoStreamArcConversionResult> results;
+  convertArcs(aArcKeys, aUtmProjector, results);
+  storeConversionResults(aArcKeys, results, aArcTable);
+}
+
+void CAutoStreamMapConverter::convertArcs(const std::vector<AutoStream::HdMap::TArcKey>& aArcKeys,
+                                          const lanelet::projection::UtmProjector& aUtmProjector,
+                                          std::vector<CAutoStreamArcConversionResult>& aResults)
+{
+  const CConversionReport::CStageTimer timer(mReport, "convertArcs");
+  aResults.clear();
+  aResults.resize(aArcKeys.size());
+
+  if (mNumberOfWorkers > 1 && aArcKeys.size() > 1)
+  {
+    convertArcsInParallel(aArcKeys, aUtmProjector, aResults);
+  }
+  else if (mPrefetchDepth > 0 && aArcKeys.size() > 1)
+  {
+    convertArcsPipelined(aArcKeys, aUtmProjector, aResults);
+  }
+  else
+  {
+    for (size_t arcIdx = 0; arcIdx < aArcKeys.size(); ++arcIdx)
+    {
+      convertArc(aArcKeys[arcIdx], *mMapSource, *mArcConverter, aResults[arcIdx]);
+    }
+  }
+
+  addToArcCache(aArcKeys, aResults);
+}
+
+void CAutoStreamMapConverter::addToArcCache(
+  const std::vector<AutoStream::HdMap::TArcKey>&     aArcKeys,
+  const std::vector<CAutoStreamArcConversionResult>& aResults)
+{
+  if (mArcCacheFileName.empty())
+  {
+    return;
+  }
+
+  for (size_t arcIdx = 0; arcIdx < aArcKeys.size(); ++arcIdx)
+  {
+    if (aResults[arcIdx].mConverted)
+    {
+      mUpdatedArcCache.add(aArcKeys[arcIdx], aResults[arcIdx]);
+    }
+  }
+}
+
+void CAutoStreamMapConverter::storeConversionResults(
+  const std::vector<AutoStream::HdMap::TArcKey>& aArcKeys,
+  std::vector<CAutoStreamArcConversionResult>&   aResults,
+  CAutoStreamArcTable&                           aArcTable)
+{
+  const CConversionReport::CStageTimer timer(mReport, "storeConversionResults");
+  mReport.addToCounter(TReportCounter::Arcs, aArcKeys.size());
+
+  // Merge results in order of the arc keys, such that the map does not depend on scheduling
+  for (size_t arcIdx = 0; arcIdx < aArcKeys.size(); ++arcIdx)
+  {
+    auto& result = aResults[arcIdx];
+    if (!result.mConverted)
+    {
+      std::cerr << "Converting arc failed" << std::endl;
+      mReport.addToCounter(TReportCounter::FailedArcs, 1);
+      continue;
+    }
+
+    CIdAllocator idAllocator(mIdRanges.claim(getFirstIdOfArc(aArcKeys[arcIdx])));
+    renumberPrimitives(result, idAllocator);
+    mReport.addToCounter(TReportCounter::ArcLanes, result.mLanelets.size());
+    mReport.addToCounter(TReportCounter::Points, countPoints(result));
+
+    for (const auto& area : result.mAreas)
+    {
+      addArea(area);
+    }
+
+    // Store such that connections can later be handled properly
+    aArcTable.addArc(aArcKeys[arcIdx], std::move(result.mLanelets), std::move(result.mConnections));
+  }
+}
+
+void CAutoStreamMapConverter::convertArc(const AutoStream::HdMap::TArcKey& aArcKey,
+                                         CAutoStreamMapSource&             aMapSource,
+                                         CAutoStreamArcConverter&          aArcConverter,
+                                         CAutoStreamArcConversionResult&   aResult) const
+{
+  const bool                      incremental = !mArcCacheFileName.empty();
+  const CAutoStreamArcCacheEntry* cachedEntry =
+    incremental ? mPreviousArcCache.find(aArcKey) : nullptr;
+
+  // IDs are taken from the range of the arc, final IDs are assigned when the result is stored
+  CIdAllocator idAllocator(getFirstIdOfArc(aArcKey));
+
+  // Arc keys refer to the same data within a map version, no need to look at the arc at all
+  if (isRestoredWithoutArcData(aArcKey)
+      && CAutoStreamArcCache::restore(*cachedEntry, idAllocator, aResult))
+  {
+    return;
+  }
+
+  CTraceSpan span(aArcConverter.getTraceBuffer(), "convertArc");
+  span.setArcKey(aArcKey);
+
+  CAutoStreamArcData arcData;
+  {
+    CTraceSpan getArcSpan(aArcConverter.getTraceBuffer(), "getArc");
+    getArcSpan.setArcKey(aArcKey);
+    arcData = aMapSource.getArc(aArcKey);
+    getArcSpan.setLaneCount(arcData.mLaneMetaData.size());
+  }
+  span.setLaneCount(arcData.mLaneMetaData.size());
+
+  if (incremental)
+  {
+    const uint64_t fingerprint = aArcConverter.getArcFingerprint(arcData);
+    if (cachedEntry != nullptr && cachedEntry->mFingerprint == fingerprint
+        && CAutoStreamArcCache::restore(*cachedEntry, idAllocator, aResult))
+    {
+      return;
+    }
+
+    // Restoring may have failed halfway
+    aResult              = CAutoStreamArcConversionResult();
+    aResult.mFingerprint = fingerprint;
+  }
+
+  aResult.mConverted = aArcConverter.convertArc(
+    arcData, idAllocator, aResult.mAreas, aResult.mLanelets, aResult.mConnections);
+}
+
+bool CAutoStreamMapConverter::isRestoredWithoutArcData(
+  const AutoStream::HdMap::TArcKey& aArcKey) const
+{
+  return !mArcCacheFileName.empty() && mPreviousMapVersionMatches && !isRecording()
+         && mPreviousArcCache.find(aArcKey) != nullptr;
+}
+
+void CAutoStreamMapConverter::convertArcsPipelined(
+  const std::vector<AutoStream::HdMap::TArcKey>& aArcKeys,
+  const lanelet::projection::UtmProjector&       aUtmProjector,
+  std::vector<CAutoStreamArcConversionResult>&   aResults) const
+{
+  CArcPrefetchQueue  prefetchQueue(mPrefetchDepth);
+  std::exception_ptr prefetchError;
+
+  std::thread prefetcher([&]() {
+    try
+    {
+      TMapSourcePtr mapSource = createMapSource();
+
+      for (size_t arcIdx = 0; arcIdx < aArcKeys.size(); ++arcIdx)
+      {
+        // Arcs restored from the arc cache without looking at them need no data
+        if (!isRestoredWithoutArcData(aArcKeys[arcIdx]))
+        {
+          mapSource->prefetchArc(aArcKeys[arcIdx]);
+        }
+
+        if (!prefetchQueue.push(arcIdx))
+        {
+          break;
+        }
+      }
+    }
+    catch (...)
+    {
+      prefetchError = std::current_exception();
+    }
+    prefetchQueue.close();
+  });
+
+  try
+  {
+    size_t arcIdx = 0;
+    while (prefetchQueue.pop(arcIdx))
+    {
+      convertArc(aArcKeys[arcIdx], *mMapSource, *mArcConverter, aResults[arcIdx]);
+    }
+  }
+  catch (...)
+  {
+    // Stop the prefetch thread before leaving
+    prefetchQueue.close();
+    prefetcher.join();
+    throw;
+  }
+
+  prefetcher.join();
+  if (prefetchError)
+  {
+    std::rethrow_exception(prefetchError);
+  }
+}
+
+void CAutoStreamMapConverter::convertArcsInParallel(
+  const std::vector<AutoStream::HdMap::TArcKey>& aArcKeys,
+  const lanelet::projection::UtmProjector&       aUtmProjector,
+  std::vector<CAutoStreamArcConversionResult>&   aResults) const
+{
+  // Arcs are handed out one by one, since conversion time differs a lot between arcs
+  std::atomic<size_t> nextArcIdx(0);
+
+  runWorkers(std::min(mNumberOfWorkers, aArcKeys.size()),
+             aUtmProjector,
+             [&](CAutoStreamMapSource& aMapSource, CAutoStreamArcConverter& aArcConverter) {
+               for (size_t arcIdx = nextArcIdx++; arcIdx < aArcKeys.size(); arcIdx = nextArcIdx++)
+               {
+                 convertArc(aArcKeys[arcIdx], aMapSource, aArcConverter, aResults[arcIdx]);
+               }
+             });
+}
+
+void CAutoStreamMapConverter::convertArcsInTiles(
+  const AutoStream::TBoundingBox&              aBoundingBox,
+  const lanelet::projection::UtmProjector&     aUtmProjector,
+  std::vector<AutoStream::HdMap::TArcKey>&     aArcKeys,
+  std::vector<CAutoStreamArcConversionResult>& aResults) const
+{
+  const std::vector<AutoStream::TBoundingBox> tiles =
+    splitBoundingBox(aBoundingBox, mTileRows, mTileColumns);
+
+  // Arcs crossing a tile seam are returned for each of the tiles, the first tile that claims an
+  // arc converts it. Elements of a std::map are not moved by insertions, such that a claimed
+  // result can be filled without holding the lock.
+  std::mutex                                                             claimMutex;
+  std::map<AutoStream::HdMap::TArcKey, CAutoStreamArcConversionResult> resultsByKey;
+  std::atomic<size_t>                                                    nextTileIdx(0);
+
+  runWorkers(std::min(mNumberOfWorkers, tiles.size()),
+             aUtmProjector,
+             [&](CAutoStreamMapSource& aMapSource, CAutoStreamArcConverter& aArcConverter) {
+               for (size_t tileIdx = nextTileIdx++; tileIdx < tiles.size(); tileIdx = nextTileIdx++)
+               {
+                 for (const auto& key : aMapSource.getArcKeysInArea(tiles[tileIdx]))
+                 {
+                   CAutoStreamArcConversionResult* result = nullptr;
+                   {
+                     std::lock_guard<std::mutex> lock(claimMutex);
+                     const auto claim = resultsByKey.emplace(key, CAutoStreamArcConversionResult());
+                     if (!claim.second)
+                     {
+                       continue;
+                     }
+                     result = &claim.first->second;
+                   }
+
+                   convertArc(key, aMapSource, aArcConverter, *result);
+                 }
+               }
+             });
+
+  aArcKeys.clear();
+  aResults.clear();
+  aArcKeys.reserve(resultsByKey.size());
+  aResults.reserve(resultsByKey.size());
+  for (auto& keyAndResult : resultsByKey)
+  {
+    aArcKeys.push_back(keyAndResult.first);
+    aResults.push_back(std::move(keyAndResult.second));
+  }
+}
+
+void CAutoStreamMapConverter::runWorkers(const size_t                             aNumberOfWorkers,
+                                         const lanelet::projection::UtmProjector& aUtmProjector,
+                                         const TWorkerFunction&                   aWork) const
+{
+  std::vector<std::exception_ptr> workerErrors(aNumberOfWorkers);
+  std::vector<std::thread>        workers;
+
+  for (size_t workerIdx = 0; workerIdx < aNumberOfWorkers; ++workerIdx)
+  {
+    workers.emplace_back([&, workerIdx]() {
+      try
+      {
+        TMapSourcePtr                           mapSource = createMapSource();
+        const lanelet::projection::UtmProjector utmProjector(aUtmProjector);
+        std::unique_ptr<CTraceBuffer>           traceBuffer;
+        CAutoStreamArcConverter                 arcConverter(utmProjector);
+
+        if (isTracing())
+        {
+          traceBuffer = std::make_unique<CTraceBuffer>(mTraceRecorder, workerIdx + 1);
+          arcConverter.setTraceBuffer(traceBuffer.get());
+        }
+
+        aWork(*mapSource, arcConverter);
+      }
+      catch (...)
+      {
+        workerErrors[workerIdx] = std::current_exception();
+      }
+    });
+  }
+
+  for (auto& worker : workers)
+  {
+    worker.join();
+  }
+
+  for (const auto& error : workerErrors)
+  {
+    if (error)
+    {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+void CAutoStreamMapConverter::renumberPrimitives(CAutoStreamArcConversionResult& aResult,
+                                                 CIdAllocator&                   aIdAllocator) const
+{
+  std::unordered_set<const void*> renumbered;
+
+  for (auto& lanelet : aResult.mLanelets)
+  {
+    if (lanelet.id() == lanelet::InvalId)
+    {
+      continue;
+    }
+
+    lanelet::LineString3d left  = lanelet.leftBound();
+    lanelet::LineString3d right = lanelet.rightBound();
+    renumberLineString(left, aIdAllocator, renumbered);
+    renumberLineString(right, aIdAllocator, renumbered);
+    renumber(lanelet, aIdAllocator, renumbered);
+  }
+
+  for (auto& area : aResult.mAreas)
+  {
+    for (auto& border : area.outerBound())
+    {
+      renumberLineString(border, aIdAllocator, renumbered);
+    }
+    renumber(area, aIdAllocator, renumbered);
+  }
+}
+
+CPointUnionFind CAutoStreamMapConverter::storeLaneletConnectivity(CAutoStreamArcTable& aArcTable)
+{
+  CPointUnionFind pointUnionFind;
+  uint64_t        numberOfStitchedConnections = 0;
+
+  for (size_t laneIdx = 0; laneIdx < aArcTable.getNumberOfLanes(); ++laneIdx)
+  {
+    auto& currentLanelet = aArcTable.mLanelets[laneIdx];
+    if (currentLanelet.id() == lanelet::InvalId)
+    {
+      // Current AutoStream lane was converted to area, connections of areas will be skipped
+      continue;
+    }
+
+    for (size_t connectionIdx = aArcTable.mFirstConnectionIdx[laneIdx];
+         connectionIdx < aArcTable.mFirstConnectionIdx[laneIdx + 1];
+         ++connectionIdx)
+    {
+      const size_t connectedLaneIdx = aArcTable.mConnectedLaneIdx[connectionIdx];
+      auto&        connectedLanelet = aArcTable.mLanelets[connectedLaneIdx];
+      if (connectedLanelet.id() == lanelet::InvalId
+          || aArcTable.mLaneMetaData[connectedLaneIdx].mInvalidConnectionOut)
+      {
+        continue;
+      }
+
+      storeConnection(connectedLanelet, currentLanelet, pointUnionFind);
+      ++numberOfStitchedConnections;
+    }
+  }
+
+  mReport.addToCounter(TReportCounter::StitchedConnections, numberOfStitchedConnections);
+  return pointUnionFind;
+}
+
+void CAutoStreamMapConverter::storeValidLanelets(const CAutoStreamArcTable& aArcTable)
+{
+  for (const auto& l : aArcTable.mLanelets)
+  {
+    if (l.id() != lanelet::InvalId)
+    {
+      mLanelets.emplace_back(l);
+    }
+  }
+}
+
+void CAutoStreamMapConverter::storeConnection(lanelet::Lanelet& aConnectedLanelet,
+                                              lanelet::Lanelet& aCurrentLanelet,
+                                              CPointUnionFind&  aPointUnionFind)
+{
+  lanelet::LineString3d connectedLeft  = aConnectedLanelet.leftBound();
+  lanelet::LineString3d connectedRight = aConnectedLanelet.rightBound();
+
+  // Store connection between lanelets
+  lanelet::Id      oldIdLeft     = connectedLeft.front().id();
+  lanelet::Id      oldIdRight    = connectedRight.front().id();
+  lanelet::Point3d newFirstLeft  = aCurrentLanelet.leftBound().back();
+  lanelet::Point3d newFirstRight = aCurrentLanelet.rightBound().back();
+  aPointUnionFind.merge(connectedLeft.front(), newFirstLeft);
+  aPointUnionFind.merge(connectedRight.front(), newFirstRight);
+
+  // Update areas accordingly
+  replacePointInAreas(connectedLeft.id(), oldIdLeft, newFirstLeft);
+  replacePointInAreas(connectedRight.id(), oldIdRight, newFirstRight);
+}
+
+void CAutoStreamMapConverter::addToMap(const lanelet::Id& aLineStringId,
+                                       const lanelet::Id& aPointIdOld,
+                                       const lanelet::Id& aPointIdNew,
+                                       TLinePointIdMap&   aLaneletPointMap) const
+{
+  if (aLaneletPointMap.find(aLineStringId) == aLaneletPointMap.end())
+  {
+    aLaneletPointMap[aLineStringId] = {};
+  }
+  aLaneletPointMap.emplace(aPointIdOld, aPointIdNew);
+}
+
+void CAutoStreamMapConverter::addArea(const lanelet::Area& aArea)
+{
+  const size_t areaIdx = mAreas.size();
+  mAreas.emplace_back(aArea);
+
+  for (const auto& border : aArea.outerBound())
+  {
+    auto& areaIndices = mAreaIndicesByLineStringId[border.id()];
+    if (areaIndices.empty() || areaIndices.back() != areaIdx)
+    {
+      areaIndices.push_back(areaIdx);
+    }
+  }
+}
+
+void CAutoStreamMapConverter::replacePointInAreas(const lanelet::Id       aLineStringId,
+                                                  const lanelet::Id       aOldPointId,
+                                                  const lanelet::Point3d& aNewPoint)
+{
+  const auto areaIndices = mAreaIndicesByLineStringId.find(aLineStringId);
+  if (areaIndices == mAreaIndicesByLineStringId.end())
+  {
+    return;
+  }
+
+  for (const size_t areaIdx : areaIndices->second)
+  {
+    for (lanelet::LineString3d& border : mAreas[areaIdx].outerBound())
+    {
+      // Replace old point by new one (if present)
+      for (size_t idx = 0; idx < border.size(); ++idx)
+      {
+        if (border[idx].id() == aOldPointId)
+        {
+          border[idx] = aNewPoint;
+        }
+      }
+    }
+  }
+}
+
+bool CAutoStreamMapConverter::convertTrafficSignsInBoundingBox(
+  const AutoStream::TBoundingBox& aBoundingBox)
+{
+  if (!mTrafficSignConverter)
   {
-    std::cerr << "Getting valid map access failed." << std::endl;
+    std::cerr << "Traffic sign converter has not been initialized." << std::endl;
     return false;
   }
 
-  // Initialize converters for given bounding box
-  auto utmProjector     = getUtmProjector(aBoundingBox);
-  mArcConverter         = std::make_unique<CAutoStreamArcConverter>(utmProjector);
-  mTrafficSignConverter = std::make_unique<CAutoStreamTrafficSignConverter>(utmProjector);
-
-  mLanelets.clear();
-  mAreas.clear();
-  mTrafficSignPolygons.clear();
-
-  if (!convertArcsInBoundingBox(aBoundingBox))
+  const CConversionReport::CStageTimer timer(mReport, "convertTrafficSigns");
+  try
   {
-    std::cerr << "Converting AutoStream arcs failed, storing map failed." << std::endl;
-    return false;
+    // Convert traffic signs within bounding box one by one
+    for (const auto& key : mMapSource->getTrafficSignKeysInArea(aBoundingBox))
+    {
+      convertTrafficSign(key, mMapSource->getTrafficSign(key));
+    }
   }
-
-  if (!convertTrafficSignsInBoundingBox(aBoundingBox))
+  catch (const std::exception& e)
   {
-    std::cerr << "Converting AutoStream traffic signs failed, storing map failed." << std::endl;
+    std::cerr << "Exception thrown when converting AutoStream traffic signs: " << e.what()
+              << std::endl;
     return false;
   }
 
-  storeMap(utmProjector);
-
   return true;
 }
 
-bool CAutoStreamMapConverter::convertArcsInBoundingBox(const AutoStream::TBoundingBox& aBoundingBox)
+bool CAutoStreamMapConverter::convertTrafficSignsInCorridor(const CRouteCorridor& aCorridor)
 {
-  if (!mArcConverter)
+  if (!mTrafficSignConverter)
   {
-    std::cerr << "Arc converter has not been initialized." << std::endl;
+    std::cerr << "Traffic sign converter has not been initialized." << std::endl;
     return false;
   }
 
+  const CConversionReport::CStageTimer timer(mReport, "convertTrafficSigns");
   try
   {
-    // Retrieve arc keys within bounding box
-    const AutoStream::CCallParameters callParams;
-    const AutoStream::HdMap::TArcKeys keys = mMapAccess->arcKeysInArea(aBoundingBox, callParams);
-
-    // Convert arcs without considering connections
-    std::map<AutoStream::HdMap::TArcKey, std::vector<lanelet::Lanelet>>        laneletMap;
-    std::map<AutoStream::HdMap::TArcKey, std::vector<CAutoStreamLaneMetaData>> connectionMap;
-    std::set<lanelet::Id> invalidConnectionsOut;
-
-    arcSetToLanelet(keys, laneletMap, connectionMap, invalidConnectionsOut);
-    std::map<lanelet::Id, lanelet::Point3d> idPointMap =
-      storeLaneletConnectivity(laneletMap, connectionMap, invalidConnectionsOut);
-    addConnections(laneletMap, idPointMap);
+    // Retrieve traffic sign keys along the route, without duplicates
+    std::set<AutoStream::HdMap::TTrafficSignKey> keys;
+    for (const auto& boundingBox : aCorridor.getBoundingBoxes())
+    {
+      const std::vector<AutoStream::HdMap::TTrafficSignKey> boxKeys =
+        mMapSource->getTrafficSignKeysInArea(boundingBox);
+      keys.insert(boxKeys.begin(), boxKeys.end());
+    }
 
-    storeValidLanelets(laneletMap);
+    // Convert traffic signs of which the center lies within the corridor
+    for (const auto& key : keys)
+    {
+      const CAutoStreamTrafficSignData trafficSign = mMapSource->getTrafficSign(key);
+      if (aCorridor.contains(trafficSign.mCenterOfMass.getXY()))
+      {
+        convertTrafficSign(key, trafficSign);
+      }
+    }
   }
   catch (const std::exception& e)
   {
-    std::cerr << "Exception thrown when converting AutoStream arcs: " << e.what() << std::endl;
+    std::cerr << "Exception thrown when converting AutoStream traffic signs: " << e.what()
+              << std::endl;
     return false;
   }
 
   return true;
 }
 
-void CAutoStreamMapConverter::addConnections(
-  std::map<AutoStream::HdMap::TArcKey, std::vector<lanelet::Lanelet>>& aLaneletMap,
-  std::map<lanelet::Id, lanelet::Point3d>&                             aIdPointMap) const
+void CAutoStreamMapConverter::convertTrafficSign(
+  const AutoStream::HdMap::TTrafficSignKey& aTrafficSignKey,
+  const CAutoStreamTrafficSignData&         aTrafficSign)
 {
-  for (auto& laneletPair : aLaneletMap)
-  {
-    auto arcKey = laneletPair.first;
-    for (size_t laneIdx = 0; laneIdx < laneletPair.second.size(); ++laneIdx)
-    {
-      lanelet::LineString3d left  = aLaneletMap[arcKey][laneIdx].leftBound();
-      lanelet::LineString3d right = aLaneletMap[arcKey][laneIdx].rightBound();
+  const CTraceSpan span(mTraceBuffer.get(), "convertTrafficSign");
 
-      const bool leftChanged  = addConnectionsToLaneBorder(left, aIdPointMap);
-      const bool rightChanged = addConnectionsToLaneBorder(right, aIdPointMap);
+  // Traffic signs are converted in a fixed order, their ranges can be claimed right away
+  CIdAllocator idAllocator(mIdRanges.claim(getFirstIdOfTrafficSign(aTrafficSignKey)));
 
-      if (leftChanged || rightChanged)
-      {
-        lanelet::Lanelet& oldLanelet = aLaneletMap[arcKey][laneIdx];
-        lanelet::Lanelet  newLanelet(oldLanelet.id(), left, right);
-        newLanelet.attributes()      = oldLanelet.attributes();
-        aLaneletMap[arcKey][laneIdx] = newLanelet;
-      }
-    }
+  lanelet::Polygon3d trafficSign;
+  if (mTrafficSignConverter->convertTrafficSign(aTrafficSign, idAllocator, trafficSign))
+  {
+    mTrafficSignPolygons.emplace_back(trafficSign);
+  }
+  else
+  {
+    std::cerr << "Converting traffic sign failed" << std::endl;
+    mReport.addToCounter(TReportCounter::FailedTrafficSigns, 1);
   }
 }
 
-bool CAutoStreamMapConverter::addConnectionsToLaneBorder(
-  lanelet::LineString3d& aLaneBorder, std::map<lanelet::Id, lanelet::Point3d>& aIdPointMap) const
+void CAutoStreamMapConverter::convertBatchTrafficSigns(
+  const std::set<AutoStream::HdMap::TTrafficSignKey>& aTrafficSignKeys,
+  CAutoStreamBatchResults&                            aSharedResults)
 {
-  bool changed = false;
+  if (!mTrafficSignConverter)
+  {
+    throw std::logic_error("Traffic sign converter has not been initialized.");
+  }
 
-  if (!aLaneBorder.empty())
+  const CConversionReport::CStageTimer timer(mReport, "convertTrafficSigns");
+  for (const auto& key : aTrafficSignKeys)
   {
-    if (aIdPointMap.find(aLaneBorder.front().id()) != aIdPointMap.end())
+    const CTraceSpan span(mTraceBuffer.get(), "convertTrafficSign");
+
+    CIdAllocator       idAllocator(getFirstIdOfTrafficSign(key));
+    lanelet::Polygon3d trafficSign;
+    if (mTrafficSignConverter->convertTrafficSign(
+          mMapSource->getTrafficSign(key), idAllocator, trafficSign))
     {
-      aLaneBorder.front() = aIdPointMap[aLaneBorder.front().id()];
-      changed             = true;
+      aSharedResults.mTrafficSigns.emplace(key, trafficSign);
     }
-    if (aIdPointMap.find(aLaneBorder.back().id()) != aIdPointMap.end())
+    else
     {
-      aLaneBorder.back() = aIdPointMap[aLaneBorder.back().id()];
-      changed            = true;
+      std::cerr << "Converting traffic sign failed" << std::endl;
     }
   }
-  return changed;
 }
 
-void CAutoStreamMapConverter::arcSetToLanelet(
-  const AutoStream::HdMap::TArcKeys&                                          aAutoStreamArcKeys,
-  std::map<AutoStream::HdMap::TArcKey, std::vector<lanelet::Lanelet>>&        aLaneletMap,
-  std::map<AutoStream::HdMap::TArcKey, std::vector<CAutoStreamLaneMetaData>>& aConnectionMap,
-  std::set<lanelet::Id>& aInvalidConnectionsOut)
+void CAutoStreamMapConverter::addBatchTrafficSigns(
+  const std::vector<AutoStream::HdMap::TTrafficSignKey>& aTrafficSignKeys,
+  const CAutoStreamBatchResults&                         aSharedResults)
 {
-  const AutoStream::CCallParameters callParams;
-  for (const auto& key : aAutoStreamArcKeys.getSet())
+  for (const auto& key : aTrafficSignKeys)
   {
-    std::vector<lanelet::Lanelet>        lanelets;
-    std::vector<CAutoStreamLaneMetaData> connections;
-    const AutoStream::HdMap::TArc&       arc = mMapAccess->key2Arc(key, callParams);
-    if (!mArcConverter->convertArc(
-          arc, mMapAccess, mAreas, lanelets, connections, aInvalidConnectionsOut))
+    // Claim in the same order as a single conversion, such that the maps get the same IDs
+    const lanelet::Id firstId        = getFirstIdOfTrafficSign(key);
+    const lanelet::Id claimedFirstId = mIdRanges.claim(firstId);
+
+    const auto trafficSign = aSharedResults.mTrafficSigns.find(key);
+    if (trafficSign == aSharedResults.mTrafficSigns.end())
     {
-      std::cerr << "Converting arc failed" << std::endl;
-      continue;
+      mReport.addToCounter(TReportCounter::FailedTrafficSigns, 1);
+    }
+    else if (claimedFirstId == firstId)
+    {
+      mTrafficSignPolygons.push_back(trafficSign->second);
     }
+    else
+    {
+      mTrafficSignPolygons.push_back(copyToIdRange(trafficSign->second, claimedFirstId - firstId));
+    }
+  }
+}
 
-    // Store such that connections can later be handled properly
-    aLaneletMap[key]    = lanelets;
-    aConnectionMap[key] = connections;
+bool CAutoStreamMapConverter::isReplaying() const noexcept
+{
+  return !mReplayFileName.empty();
+}
+
+bool CAutoStreamMapConverter::isRecording() const noexcept
+{
+  return !mRecordingFileName.empty() && !isReplaying();
+}
+
+void CAutoStreamMapConverter::storeRecording() const
+{
+  if (!isRecording())
+  {
+    return;
+  }
+
+  if (mRecording.store(mRecordingFileName))
+  {
+    std::cout << "Recorded " << mRecording.getNumberOfArcs() << " arcs and "
+              << mRecording.getNumberOfTrafficSigns() << " traffic signs to "
+              << mRecordingFileName << "." << std::endl;
+  }
+  else
+  {
+    std::cerr << "Storing map recording " << mRecordingFileName << " failed." << std::endl;
   }
 }
 
-std::map<lanelet::Id, lanelet::Point3d> CAutoStreamMapConverter::storeLaneletConnectivity(
-  std::map<AutoStream::HdMap::TArcKey, std::vector<lanelet::Lanelet>>&              aLaneletMap,
-  const std::map<AutoStream::HdMap::TArcKey, std::vector<CAutoStreamLaneMetaData>>& aConnectionMap,
-  const std::set<lanelet::Id>& aInvalidConnectionsOut)
+bool CAutoStreamMapConverter::updateMapSource()
 {
-  std::map<lanelet::Id, lanelet::Point3d> idPointMap;
+  if (isReplaying())
+  {
+    mMapSource = std::make_unique<CAutoStreamReplayMapSource>(mRecording);
+    return true;
+  }
 
-  for (const auto& p : aConnectionMap)
+  if (hasMapSourceFactory())
   {
-    const auto& currentArcKey = p.first;
-    if (aLaneletMap.find(currentArcKey) == aLaneletMap.end())
+    TMapSourcePtr mapSource = mMapSourceFactory();
+    if (!mapSource)
     {
-      std::cerr
-        << "Cannot check connectivity for unconverted arc! (how did it end up in connection map?)"
-        << std::endl;
-      continue;
+      std::cerr << "Failed creating a map source." << std::endl;
+      return false;
     }
 
-    const auto& currentArcLaneMetaData  = p.second;
-    auto&       currentArcLaneletVector = aLaneletMap[currentArcKey];
-    if (currentArcLaneMetaData.size() != currentArcLaneletVector.size())
-    {
-      std::cerr << "Error in conversion: number of AutoStream lanes differs from number of lanelets"
-                << std::endl;
-      continue;
-    }
+    mMapSource = recordMapSource(std::move(mapSource));
+    return true;
+  }
 
-    addConnectionsToArc(currentArcLaneMetaData,
-                        currentArcLaneletVector,
-                        aLaneletMap,
-                        idPointMap,
-                        aInvalidConnectionsOut);
+  const AutoStream::HdMap::CHdMapAccess* mapAccess = mAutoStreamInterface.getHdMapAccess();
+  if (!mapAccess)
+  {
+    std::cerr << "Failed retrieving a map handle." << std::endl;
+    return false;
   }
 
-  return idPointMap;
+  mMapSource = recordMapSource(std::make_unique<CAutoStreamHdMapSource>(
+    mapAccess, mAutoStreamInterface.getMapVersionAndHash()));
+  return true;
 }
 
-void CAutoStreamMapConverter::addConnectionsToArc(
-  const std::vector<CAutoStreamLaneMetaData>&                          aCurrentArcLaneMetaData,
-  std::vector<lanelet::Lanelet>&                                       aCurrentArcLaneletVector,
-  std::map<AutoStream::HdMap::TArcKey, std::vector<lanelet::Lanelet>>& aLaneletMap,
-  std::map<lanelet::Id, lanelet::Point3d>&                             aIdPointMap,
-  const std::set<lanelet::Id>&                                         aInvalidConnectionsOut)
+TMapSourcePtr CAutoStreamMapConverter::createMapSource() const
 {
-  for (size_t laneIdx = 0; laneIdx < aCurrentArcLaneMetaData.size(); ++laneIdx)
+  if (isReplaying())
   {
-    auto& currentLanelet = aCurrentArcLaneletVector[laneIdx];
-    if (currentLanelet.id() == lanelet::InvalId)
-    {
-      // Current AutoStream lane was converted to area, connections of areas will be skipped
-      continue;
-    }
+    return std::make_unique<CAutoStreamReplayMapSource>(mRecording);
+  }
 
-    for (const auto& c : aCurrentArcLaneMetaData[laneIdx].mConnectionsOut)
+  if (hasMapSourceFactory())
+  {
+    TMapSourcePtr mapSource = mMapSourceFactory();
+    if (!mapSource)
     {
-      auto connectedArcKey  = c.first;
-      auto connectedLaneIdx = c.second;
-      if (aLaneletMap.find(connectedArcKey) != aLaneletMap.end())
-      {
-        storeConnection(connectedArcKey,
-                        connectedLaneIdx,
-                        currentLanelet,
-                        aLaneletMap,
-                        aIdPointMap,
-                        aInvalidConnectionsOut);
-      }
+      throw std::runtime_error("Failed to create map source for worker thread.");
     }
+
+    return recordMapSource(std::move(mapSource));
   }
-}
 
-void CAutoStreamMapConverter::storeValidLanelets(
-  const std::map<AutoStream::HdMap::TArcKey, std::vector<lanelet::Lanelet>>& aLaneletMap)
-{
-  for (const auto& p : aLaneletMap)
+  THdMapAccessPtr mapAccess = mAutoStreamInterface.createHdMapAccess();
+  if (!mapAccess)
   {
-    for (const auto& l : p.second)
-    {
-      if (l.id() != lanelet::InvalId)
-      {
-        mLanelets.emplace_back(l);
-      }
-    }
+    throw std::runtime_error("Failed to create map access for worker thread.");
   }
+
+  return recordMapSource(std::make_unique<CAutoStreamHdMapSource>(
+    std::move(mapAccess), mAutoStreamInterface.getMapVersionAndHash()));
 }
 
-void CAutoStreamMapConverter::storeConnection(
-  const AutoStream::HdMap::TArcKey&                                    aConnectedArcKey,
-  const uint32_t                                                       aConnectedLaneIdx,
-  lanelet::Lanelet&                                                    aCurrentLanelet,
-  std::map<AutoStream::HdMap::TArcKey, std::vector<lanelet::Lanelet>>& aLaneletMap,
-  std::map<lanelet::Id, lanelet::Point3d>&                             aIdPointMap,
-  const std::set<lanelet::Id>&                                         aInvalidConnectionsOut)
+void CAutoStreamMapConverter::storeReport()
 {
-  auto connectedArcLaneletVector = aLaneletMap.at(aConnectedArcKey);
-
-  if (aConnectedLaneIdx >= connectedArcLaneletVector.size())
+  if (!mReport.isEnabled())
   {
-    std::cerr << "Connected to lane with ID " << aConnectedLaneIdx << ", but arc has only "
-              << connectedArcLaneletVector.size() << " lanelets. Skip connection." << std::endl;
     return;
   }
 
-  auto connectedLanelet = connectedArcLaneletVector[aConnectedLaneIdx];
+  mReport.setCounter(TReportCounter::Lanelets, mLanelets.size());
+  mReport.setCounter(TReportCounter::Areas, mAreas.size());
+  mReport.setCounter(TReportCounter::TrafficSigns, mTrafficSignPolygons.size());
+  mReport.setCounter(TReportCounter::IdRangeCollisions, mIdRanges.getNumberOfCollisions());
 
-  if (connectedLanelet.id() == lanelet::InvalId
-      || aInvalidConnectionsOut.find(connectedLanelet.id()) != aInvalidConnectionsOut.end())
+  const std::string reportFileName = mOutputFilename + Constants::kReportFileSuffix;
+  if (!mReport.store(reportFileName, mOutputFilename))
   {
-    return;
+    std::cerr << "Storing conversion report " << reportFileName << " failed." << std::endl;
   }
-
-  lanelet::LineString3d connectedLeft  = connectedLanelet.leftBound();
-  lanelet::LineString3d connectedRight = connectedLanelet.rightBound();
-
-  // Store connection between lanelets
-  lanelet::Id      oldIdLeft     = connectedLeft.front().id();
-  lanelet::Id      oldIdRight    = connectedRight.front().id();
-  lanelet::Point3d newFirstLeft  = aCurrentLanelet.leftBound().back();
-  lanelet::Point3d newFirstRight = aCurrentLanelet.rightBound().back();
-  addPointToMapping(oldIdLeft, newFirstLeft, aIdPointMap);
-  addPointToMapping(oldIdRight, newFirstRight, aIdPointMap);
-
-  // Update areas accordingly
-  replacePointInAreas(connectedLeft.id(), oldIdLeft, newFirstLeft);
-  replacePointInAreas(connectedRight.id(), oldIdRight, newFirstRight);
 }
 
-void CAutoStreamMapConverter::addPointToMapping(
-  const lanelet::Id                        aOldPointId,
-  const lanelet::Point3d                   aNewPoint,
-  std::map<lanelet::Id, lanelet::Point3d>& aIdPointMap) const
+void CAutoStreamMapConverter::storeRoutingGraph()
 {
-  /* If key exists, value of this key must be added as a key with new value as well
-   *  aIdPointMap[1] = 2
-   * If we want to add 1 -> 3, the desired outcome is
-   *  aIdPointMap[1] = 3
-   *  aIdPointMap[2] = 3
-   * to avoid other users of point 2 will still cause duplicate points.
-   */
-  if (aIdPointMap.find(aOldPointId) != aIdPointMap.end())
+  if (!mRoutingGraphEnabled)
   {
-    addPointToMapping(aIdPointMap[aOldPointId].id(), aNewPoint, aIdPointMap);
+    return;
   }
 
-  aIdPointMap[aOldPointId] = aNewPoint;
-}
+  const CConversionReport::CStageTimer timer(mReport, "storeRoutingGraph");
+  const CTraceSpan                     span(mTraceBuffer.get(), "storeRoutingGraph");
 
-void CAutoStreamMapConverter::addToMap(const lanelet::Id& aLineStringId,
-                                       const lanelet::Id& aPointIdOld,
-                                       const lanelet::Id& aPointIdNew,
-                                       TLinePointIdMap&   aLaneletPointMap) const
-{
-  if (aLaneletPointMap.find(aLineStringId) == aLaneletPointMap.end())
+  CRoutingGraph routingGraph;
+  routingGraph.build(mLanelets);
+
+  const std::string routingGraphFileName = mOutputFilename + Constants::kRoutingGraphFileSuffix;
+  if (!routingGraph.store(routingGraphFileName))
   {
-    aLaneletPointMap[aLineStringId] = {};
+    std::cerr << "Storing routing graph " << routingGraphFileName << " failed." << std::endl;
+    return;
   }
-  aLaneletPointMap.emplace(aPointIdOld, aPointIdNew);
+
+  mReport.setCounter(TReportCounter::RoutingSuccessors,
+                     routingGraph.getNumberOfRelations(TRoutingRelation::Successor));
+  mReport.setCounter(TReportCounter::RoutingLaneChanges,
+                     routingGraph.getNumberOfRelations(TRoutingRelation::Left)
+                       + routingGraph.getNumberOfRelations(TRoutingRelation::Right));
 }
 
-void CAutoStreamMapConverter::replacePointInAreas(const lanelet::Id       aLineStringId,
-                                                  const lanelet::Id       aOldPointId,
-                                                  const lanelet::Point3d& aNewPoint)
+bool CAutoStreamMapConverter::isTracing() const noexcept
 {
-  for (lanelet::Area a : mAreas)
-  {
-    auto outerBound = a.outerBound();
-
-    bool lineStringUsedInArea = false;
-    for (const auto& border : outerBound)
-    {
-      lineStringUsedInArea |= border.id() == aLineStringId;
-    }
-
-    if (lineStringUsedInArea)
-    {
-      for (lanelet::LineString3d& border : outerBound)
-      {
-        // Replace old point by new one (if present)
-        for (size_t idx = 0; idx < border.size(); ++idx)
-        {
-          if (border[idx].id() == aOldPointId)
-          {
-            border[idx] = aNewPoint;
-          }
-        }
-      }
-    }
-  }
+  return !mTraceFileName.empty();
 }
 
-bool CAutoStreamMapConverter::convertTrafficSignsInBoundingBox(
-  const AutoStream::TBoundingBox& aBoundingBox)
+void CAutoStreamMapConverter::storeTrace()
 {
-  if (!mTrafficSignConverter)
+  if (!isTracing())
   {
-    std::cerr << "Traffic sign converter has not been initialized." << std::endl;
-    return false;
+    return;
   }
 
-  try
+  if (mTraceBuffer)
   {
-    // Retrieve traffic sign keys within bounding box
-    const AutoStream::CCallParameters         callParams;
-    const AutoStream::HdMap::TTrafficSignKeys keys =
-      mMapAccess->getTrafficSigns().trafficSignKeysInArea(aBoundingBox, callParams);
-
-    // Convert traffic signs one by one
-    for (const auto& key : keys.getSet())
-    {
-      const AutoStream::HdMap::TTrafficSign& signAutoStream =
-        mMapAccess->getTrafficSigns().key2TrafficSign(key, callParams);
-
-      lanelet::Polygon3d trafficSign;
-      if (mTrafficSignConverter->convertTrafficSign(signAutoStream, mMapAccess, trafficSign))
-      {
-        mTrafficSignPolygons.emplace_back(trafficSign);
-      }
-      else
-      {
-        std::cerr << "Converting traffic sign failed" << std::endl;
-      }
-    }
+    mTraceBuffer->flush();
   }
-  catch (const std::exception& e)
+
+  if (!mTraceRecorder.store(mTraceFileName))
   {
-    std::cerr << "Exception thrown when converting AutoStream traffic signs: " << e.what()
-              << std::endl;
-    return false;
+    std::cerr << "Storing conversion trace " << mTraceFileName << " failed." << std::endl;
   }
-
-  return true;
 }
 
-bool CAutoStreamMapConverter::updateMapAccess()
+TMapSourcePtr CAutoStreamMapConverter::recordMapSource(TMapSourcePtr aMapSource) const
 {
-  mMapAccess = mAutoStreamInterface.getHdMapAccess();
-  if (!mMapAccess)
+  if (!isRecording())
   {
-    std::cerr << "Failed retrieving a map handle." << std::endl;
-    return false;
+    return aMapSource;
   }
 
-  return true;
+  return std::make_unique<CAutoStreamRecordingMapSource>(std::move(aMapSource), mRecording);
 }
 
 std::string CAutoStreamMapConverter::getOutputFileName() const noexcept
@@ -440,6 +1725,128 @@ void CAutoStreamMapConverter::setOutputFileName(const std::string& aOutputFileNa
   mOutputFilename = aOutputFileName;
 }
 
+TMapFileFormat CAutoStreamMapConverter::getOutputFormat() const noexcept
+{
+  return mOutputFormat;
+}
+
+void CAutoStreamMapConverter::setOutputFormat(const TMapFileFormat aOutputFormat) noexcept
+{
+  mOutputFormat = aOutputFormat;
+}
+
+size_t CAutoStreamMapConverter::getNumberOfWorkers() const noexcept
+{
+  return mNumberOfWorkers;
+}
+
+void CAutoStreamMapConverter::setNumberOfWorkers(const size_t aNumberOfWorkers) noexcept
+{
+  mNumberOfWorkers = std::max<size_t>(aNumberOfWorkers, 1);
+}
+
+void CAutoStreamMapConverter::getTileGrid(size_t& aRows, size_t& aColumns) const noexcept
+{
+  aRows    = mTileRows;
+  aColumns = mTileColumns;
+}
+
+void CAutoStreamMapConverter::setTileGrid(const size_t aRows, const size_t aColumns) noexcept
+{
+  mTileRows    = std::max<size_t>(aRows, 1);
+  mTileColumns = std::max<size_t>(aColumns, 1);
+}
+
+std::string CAutoStreamMapConverter::getArcCacheFileName() const noexcept
+{
+  return mArcCacheFileName;
+}
+
+void CAutoStreamMapConverter::setArcCacheFileName(const std::string& aArcCacheFileName) noexcept
+{
+  mArcCacheFileName = aArcCacheFileName;
+}
+
+size_t CAutoStreamMapConverter::getPrefetchDepth() const noexcept
+{
+  return mPrefetchDepth;
+}
+
+void CAutoStreamMapConverter::setPrefetchDepth(const size_t aPrefetchDepth) noexcept
+{
+  mPrefetchDepth = aPrefetchDepth;
+}
+
+std::string CAutoStreamMapConverter::getRecordingFileName() const noexcept
+{
+  return mRecordingFileName;
+}
+
+void CAutoStreamMapConverter::setRecordingFileName(const std::string& aRecordingFileName) noexcept
+{
+  mRecordingFileName = aRecordingFileName;
+}
+
+std::string CAutoStreamMapConverter::getReplayFileName() const noexcept
+{
+  return mReplayFileName;
+}
+
+void CAutoStreamMapConverter::setReplayFileName(const std::string& aReplayFileName) noexcept
+{
+  mReplayFileName = aReplayFileName;
+}
+
+bool CAutoStreamMapConverter::isReportEnabled() const noexcept
+{
+  return mReport.isEnabled();
+}
+
+void CAutoStreamMapConverter::setReportEnabled(const bool aReportEnabled) noexcept
+{
+  mReport.setEnabled(aReportEnabled);
+}
+
+bool CAutoStreamMapConverter::isRoutingGraphEnabled() const noexcept
+{
+  return mRoutingGraphEnabled;
+}
+
+void CAutoStreamMapConverter::setRoutingGraphEnabled(const bool aRoutingGraphEnabled) noexcept
+{
+  mRoutingGraphEnabled = aRoutingGraphEnabled;
+}
+
+std::string CAutoStreamMapConverter::getTraceFileName() const noexcept
+{
+  return mTraceFileName;
+}
+
+void CAutoStreamMapConverter::setTraceFileName(const std::string& aTraceFileName) noexcept
+{
+  mTraceFileName = aTraceFileName;
+}
+
+std::string CAutoStreamMapConverter::getDeltaBaseFileName() const noexcept
+{
+  return mDeltaBaseFileName;
+}
+
+void CAutoStreamMapConverter::setDeltaBaseFileName(const std::string& aDeltaBaseFileName) noexcept
+{
+  mDeltaBaseFileName = aDeltaBaseFileName;
+}
+
+bool CAutoStreamMapConverter::hasMapSourceFactory() const noexcept
+{
+  return static_cast<bool>(mMapSourceFactory);
+}
+
+void CAutoStreamMapConverter::setMapSourceFactory(const TMapSourceFactory& aMapSourceFactory)
+{
+  mMapSourceFactory = aMapSourceFactory;
+}
+
 lanelet::projection::UtmProjector
 CAutoStreamMapConverter::getUtmProjector(const AutoStream::TBoundingBox& aBoundingBox) const
 {
@@ -450,27 +1857,35 @@ CAutoStreamMapConverter::getUtmProjector(const AutoStream::TBoundingBox& aBoundi
   return lanelet::projection::UtmProjector(origin);
 }
 
-void CAutoStreamMapConverter::storeMap(const lanelet::projection::UtmProjector& aUtmProjector) const
+bool CAutoStreamMapConverter::storeMap(const lanelet::projection::UtmProjector& aUtmProjector) const
 {
-  auto map = std::make_unique<lanelet::LaneletMap>();
-
-  for (const auto& lanelet : mLanelets)
-  {
-    map->add(lanelet);
-  }
-
-  for (const auto& area : mAreas)
+  // The map is compressed while it is written when the output file name asks for it
+  CMapOutputStream output;
+  if (!output.open(mOutputFilename))
   {
-    map->add(area);
+    std::cerr << "Opening output file " << mOutputFilename << " failed." << std::endl;
+    return false;
   }
 
-  for (const auto& sign : mTrafficSignPolygons)
+  bool written = false;
+  switch (mOutputFormat)
   {
-    map->add(sign);
+    case TMapFileFormat::Osm:
+    {
+      COsmWriter writer(output, aUtmProjector);
+      written = writer.write(mLanelets, mAreas, mTrafficSignPolygons);
+      break;
+    }
+    case TMapFileFormat::Binary:
+    {
+      CBinaryMapWriter writer(output, aUtmProjector);
+      written = writer.write(mLanelets, mAreas, mTrafficSignPolygons);
+      break;
+    }
   }
 
-  lanelet::write(mOutputFilename, *map, aUtmProjector);
+  return output.close() && written;
+}
 }
 }
 }
-}
\ No newline at end of file
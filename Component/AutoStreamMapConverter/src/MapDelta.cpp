@@ -0,0 +1,639 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#include "AutoStreamMapConverter/MapDelta.hpp"
+#include "AutoStreamMapConverter/CompressedFile.hpp"
+
+#include <lanelet2_core/Attribute.h>
+
+#include <cstdlib>
+#include <initializer_list>
+#include <iostream>
+#include <unordered_set>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+namespace Constants {
+// Names of the element types, indexed by TOsmElementType
+const char* const kOsmElementNames[] = { "node", "way", "relation" };
+
+// Names of the change set sections, indexed by TOsmChangeAction
+const char* const kOsmChangeSectionNames[] = { "", "create", "modify", "delete" };
+
+const TOsmElementType kOsmElementTypes[] = { TOsmElementType::Node, TOsmElementType::Way,
+                                             TOsmElementType::Relation };
+}
+
+/**
+ * Kinds of converted primitives that are represented by an element.
+ */
+enum class TPrimitiveKind
+{
+  Lanelet,
+  Area,
+  TrafficSign,
+  Other
+};
+
+/**
+ * Get the name of an element type.
+ *
+ * @param[in] aType Type of the element.
+ * @retval std::string Name of the element type as used in OSM documents.
+ */
+std::string getElementName(const TOsmElementType aType)
+{
+  return Constants::kOsmElementNames[static_cast<size_t>(aType)];
+}
+
+/**
+ * Check if a line holds a tag at the given position.
+ *
+ * @param[in] aLine Line of an OSM document.
+ * @param[in] aPosition Position of the first character of the line that is not a space.
+ * @param[in] aTag Tag that must be checked, including its angle brackets.
+ * @retval True If the line holds the tag and nothing else.
+ * @retval False If the line holds something else.
+ */
+bool isTagLine(const std::string& aLine, const size_t aPosition, const std::string& aTag)
+{
+  return aLine.compare(aPosition, std::string::npos, aTag) == 0;
+}
+
+/**
+ * Parse the start of an element.
+ *
+ * @param[in] aLine Line of an OSM document.
+ * @param[in] aPosition Position of the first character of the line that is not a space.
+ * @param[out] aType Type of the element.
+ * @param[out] aId ID of the element.
+ * @retval True If the line starts an element.
+ * @retval False If the line does not start an element or the element has no ID.
+ */
+bool parseElementStart(const std::string& aLine,
+                       const size_t       aPosition,
+                       TOsmElementType&   aType,
+                       lanelet::Id&       aId)
+{
+  for (const TOsmElementType type : Constants::kOsmElementTypes)
+  {
+    const std::string start = "<" + getElementName(type) + " ";
+    if (aLine.compare(aPosition, start.size(), start) != 0)
+    {
+      continue;
+    }
+
+    const size_t idPosition = aLine.find(" id=\"", aPosition);
+    if (idPosition == std::string::npos)
+    {
+      return false;
+    }
+
+    aType = type;
+    aId   = std::strtoll(aLine.c_str() + idPosition + 5, nullptr, 10);
+    return true;
+  }
+
+  return false;
+}
+
+/**
+ * Read the elements of a map or change set written as OSM document. Only the line layout written
+ * by COsmWriter and CMapDelta is supported: every element starts on a line of its own and ends on
+ * that line or on a line holding its closing tag.
+ *
+ * @param[in] aFileName Name of the file.
+ * @param[out] aElements Elements in the order in which they are written, tagged with the section
+ * of the change set they are part of.
+ * @retval True If reading succeeded.
+ * @retval False If the file could not be read or holds an element without ID or closing tag.
+ */
+bool readOsmElements(const std::string& aFileName, std::vector<COsmElement>& aElements)
+{
+  aElements.clear();
+  CMapInputStream file;
+  if (!file.open(aFileName))
+  {
+    return false;
+  }
+
+  TOsmChangeAction action    = TOsmChangeAction::None;
+  bool             inElement = false;
+  COsmElement      element;
+  std::string      closingTag;
+  std::string      line;
+  while (getline(file, line))
+  {
+    const size_t position = line.find_first_not_of(' ');
+    if (position == std::string::npos)
+    {
+      continue;
+    }
+
+    if (inElement)
+    {
+      element.mText.append(line).push_back('\n');
+      if (isTagLine(line, position, closingTag))
+      {
+        aElements.push_back(std::move(element));
+        inElement = false;
+      }
+      continue;
+    }
+
+    if (parseElementStart(line, position, element.mType, element.mId))
+    {
+      element.mAction = action;
+      element.mText   = line + "\n";
+      if (line.compare(line.size() - 2, 2, "/>") == 0)
+      {
+        aElements.push_back(std::move(element));
+      }
+      else
+      {
+        closingTag = "</" + getElementName(element.mType) + ">";
+        inElement  = true;
+      }
+      continue;
+    }
+
+    if (line[position + 1] == '/')
+    {
+      action = TOsmChangeAction::None;
+      continue;
+    }
+
+    // Lines other than elements and sections, such as the document element, are skipped
+    for (const TOsmChangeAction section :
+         { TOsmChangeAction::Create, TOsmChangeAction::Modify, TOsmChangeAction::Delete })
+    {
+      const std::string tag =
+        std::string("<") + Constants::kOsmChangeSectionNames[static_cast<size_t>(section)] + ">";
+      if (isTagLine(line, position, tag))
+      {
+        action = section;
+      }
+    }
+  }
+
+  if (inElement || file.bad())
+  {
+    aElements.clear();
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Get the kind of converted primitive that is represented by an element. Lanelets and areas are
+ * relations, traffic signs are ways tagged as area.
+ *
+ * @param[in] aElement Element, including its tags.
+ * @retval TPrimitiveKind Kind of primitive.
+ */
+TPrimitiveKind getPrimitiveKind(const COsmElement& aElement)
+{
+  const std::string typeTag = std::string("<tag k=\"") + lanelet::AttributeNamesString::Type;
+  switch (aElement.mType)
+  {
+    case TOsmElementType::Relation:
+      if (aElement.mText.find(typeTag + "\" v=\"" + lanelet::AttributeValueString::Lanelet + "\"")
+          != std::string::npos)
+      {
+        return TPrimitiveKind::Lanelet;
+      }
+      if (aElement.mText.find(typeTag + "\" v=\"" + lanelet::AttributeValueString::Multipolygon
+                              + "\"")
+          != std::string::npos)
+      {
+        return TPrimitiveKind::Area;
+      }
+      return TPrimitiveKind::Other;
+    case TOsmElementType::Way:
+      return aElement.mText.find("<tag k=\"area\" v=\"yes\"") != std::string::npos
+               ? TPrimitiveKind::TrafficSign
+               : TPrimitiveKind::Other;
+    case TOsmElementType::Node:
+      return TPrimitiveKind::Other;
+  }
+
+  return TPrimitiveKind::Other;
+}
+
+/**
+ * Check if an element refers to any of the given IDs, as node of a way or member of a relation.
+ *
+ * @param[in] aElement Element.
+ * @param[in] aIds IDs of referred elements.
+ * @retval True If the element refers to at least one of the IDs.
+ * @retval False If the element refers to none of the IDs.
+ */
+bool referencesAny(const COsmElement& aElement, const std::unordered_set<lanelet::Id>& aIds)
+{
+  const std::string& text = aElement.mText;
+  for (size_t position = text.find(" ref=\""); position != std::string::npos;
+       position        = text.find(" ref=\"", position + 1))
+  {
+    if (aIds.count(std::strtoll(text.c_str() + position + 6, nullptr, 10)) > 0)
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * Count a primitive in the statistics of a change set.
+ *
+ * @param[in] aKind Kind of the primitive.
+ * @param[in, out] aNumberOfLanelets Counter of lanelets.
+ * @param[in, out] aNumberOfAreas Counter of areas.
+ * @param[in, out] aNumberOfTrafficSigns Counter of traffic signs.
+ */
+void countPrimitive(const TPrimitiveKind aKind,
+                    size_t&              aNumberOfLanelets,
+                    size_t&              aNumberOfAreas,
+                    size_t&              aNumberOfTrafficSigns)
+{
+  switch (aKind)
+  {
+    case TPrimitiveKind::Lanelet:
+      ++aNumberOfLanelets;
+      break;
+    case TPrimitiveKind::Area:
+      ++aNumberOfAreas;
+      break;
+    case TPrimitiveKind::TrafficSign:
+      ++aNumberOfTrafficSigns;
+      break;
+    case TPrimitiveKind::Other:
+      break;
+  }
+}
+
+/**
+ * Write a section of a change set, nothing is written for an empty section.
+ *
+ * @param[in, out] aOutput Stream to which the section must be written.
+ * @param[in] aAction Section that must be written.
+ * @param[in] aElements Elements of the section.
+ */
+void writeChangeSection(std::ostream&                   aOutput,
+                        const TOsmChangeAction          aAction,
+                        const std::vector<COsmElement>& aElements)
+{
+  if (aElements.empty())
+  {
+    return;
+  }
+
+  const char* const name = Constants::kOsmChangeSectionNames[static_cast<size_t>(aAction)];
+  aOutput << "  <" << name << ">\n";
+  for (const COsmElement& element : aElements)
+  {
+    aOutput << element.mText;
+  }
+  aOutput << "  </" << name << ">\n";
+}
+
+COsmDocument::COsmDocument()
+  : mElements()
+  , mElementIndices()
+{
+}
+
+bool COsmDocument::load(const std::string& aFileName)
+{
+  clear();
+  if (!readOsmElements(aFileName, mElements))
+  {
+    return false;
+  }
+
+  for (size_t elementIdx = 0; elementIdx < mElements.size(); ++elementIdx)
+  {
+    const COsmElement& element = mElements[elementIdx];
+    if (element.mAction != TOsmChangeAction::None)
+    {
+      std::cerr << aFileName << " is a change set instead of a map." << std::endl;
+      clear();
+      return false;
+    }
+
+    mElementIndices[static_cast<size_t>(element.mType)].emplace(element.mId, elementIdx);
+  }
+
+  return true;
+}
+
+void COsmDocument::clear()
+{
+  mElements.clear();
+  for (auto& elementIndices : mElementIndices)
+  {
+    elementIndices.clear();
+  }
+}
+
+const std::vector<COsmElement>& COsmDocument::getElements() const noexcept
+{
+  return mElements;
+}
+
+const COsmElement* COsmDocument::findElement(const TOsmElementType aType,
+                                             const lanelet::Id     aId) const
+{
+  const auto& elementIndices = mElementIndices[static_cast<size_t>(aType)];
+  const auto  found          = elementIndices.find(aId);
+  return found != elementIndices.end() ? &mElements[found->second] : nullptr;
+}
+
+CMapDelta::CMapDelta()
+  : mCreatedElements()
+  , mModifiedElements()
+  , mDeletedElements()
+  , mStatistics()
+{
+}
+
+void CMapDelta::compute(const COsmDocument& aPrevious, const COsmDocument& aCurrent)
+{
+  mCreatedElements.clear();
+  mModifiedElements.clear();
+  mDeletedElements.clear();
+
+  for (const COsmElement& element : aCurrent.getElements())
+  {
+    const COsmElement* previousElement = aPrevious.findElement(element.mType, element.mId);
+    if (previousElement == nullptr)
+    {
+      mCreatedElements.push_back(element);
+      mCreatedElements.back().mAction = TOsmChangeAction::Create;
+    }
+    else if (previousElement->mText != element.mText)
+    {
+      mModifiedElements.push_back(element);
+      mModifiedElements.back().mAction = TOsmChangeAction::Modify;
+    }
+  }
+
+  // Relations are deleted before their ways and ways before their nodes
+  const std::vector<COsmElement>& previousElements = aPrevious.getElements();
+  for (auto element = previousElements.rbegin(); element != previousElements.rend(); ++element)
+  {
+    if (aCurrent.findElement(element->mType, element->mId) == nullptr)
+    {
+      const std::string text = "  <" + getElementName(element->mType) + " id=\""
+                               + std::to_string(element->mId)
+                               + "\" visible=\"false\" version=\"1\"/>\n";
+      mDeletedElements.push_back(
+        COsmElement { element->mType, element->mId, TOsmChangeAction::Delete, text });
+    }
+  }
+
+  mStatistics = CMapDeltaStatistics();
+  computeStatistics(aPrevious, aCurrent);
+}
+
+bool CMapDelta::load(const std::string& aFileName)
+{
+  mCreatedElements.clear();
+  mModifiedElements.clear();
+  mDeletedElements.clear();
+  mStatistics = CMapDeltaStatistics();
+
+  std::vector<COsmElement> elements;
+  if (!readOsmElements(aFileName, elements))
+  {
+    return false;
+  }
+
+  for (COsmElement& element : elements)
+  {
+    switch (element.mAction)
+    {
+      case TOsmChangeAction::Create:
+        mCreatedElements.push_back(std::move(element));
+        break;
+      case TOsmChangeAction::Modify:
+        mModifiedElements.push_back(std::move(element));
+        break;
+      case TOsmChangeAction::Delete:
+        mDeletedElements.push_back(std::move(element));
+        break;
+      case TOsmChangeAction::None:
+        std::cerr << aFileName << " is a map instead of a change set." << std::endl;
+        mCreatedElements.clear();
+        mModifiedElements.clear();
+        mDeletedElements.clear();
+        return false;
+    }
+  }
+
+  return true;
+}
+
+bool CMapDelta::store(const std::string& aFileName) const
+{
+  CMapOutputStream output;
+  if (!output.open(aFileName))
+  {
+    return false;
+  }
+
+  output << "<?xml version=\"1.0\"?>\n<osmChange version=\"0.6\" generator=\"lanelet2\">\n";
+  writeChangeSection(output, TOsmChangeAction::Create, mCreatedElements);
+  writeChangeSection(output, TOsmChangeAction::Modify, mModifiedElements);
+  writeChangeSection(output, TOsmChangeAction::Delete, mDeletedElements);
+  output << "</osmChange>\n";
+
+  return output.close();
+}
+
+bool CMapDelta::apply(const COsmDocument& aBase, const std::string& aOutputFileName) const
+{
+  // Modified and deleted elements by type and ID, such that each base element is looked up once
+  std::array<std::unordered_map<lanelet::Id, const COsmElement*>, 3> changedElements;
+  for (const auto* elements : { &mModifiedElements, &mDeletedElements })
+  {
+    for (const COsmElement& element : *elements)
+    {
+      if (aBase.findElement(element.mType, element.mId) == nullptr)
+      {
+        std::cerr << "Change set changes " << getElementName(element.mType) << " " << element.mId
+                  << ", which is not part of the map." << std::endl;
+        return false;
+      }
+      changedElements[static_cast<size_t>(element.mType)].emplace(element.mId, &element);
+    }
+  }
+
+  for (const COsmElement& element : mCreatedElements)
+  {
+    if (aBase.findElement(element.mType, element.mId) != nullptr)
+    {
+      std::cerr << "Change set creates " << getElementName(element.mType) << " " << element.mId
+                << ", which is already part of the map." << std::endl;
+      return false;
+    }
+  }
+
+  CMapOutputStream output;
+  if (!output.open(aOutputFileName))
+  {
+    return false;
+  }
+
+  output << "<?xml version=\"1.0\"?>\n<osm version=\"0.6\" generator=\"lanelet2\">\n";
+  for (const TOsmElementType type : Constants::kOsmElementTypes)
+  {
+    const auto& changedElementsOfType = changedElements[static_cast<size_t>(type)];
+    for (const COsmElement& element : aBase.getElements())
+    {
+      if (element.mType != type)
+      {
+        continue;
+      }
+
+      const auto changedElement = changedElementsOfType.find(element.mId);
+      if (changedElement == changedElementsOfType.end())
+      {
+        output << element.mText;
+      }
+      else if (changedElement->second->mAction == TOsmChangeAction::Modify)
+      {
+        output << changedElement->second->mText;
+      }
+    }
+
+    for (const COsmElement& element : mCreatedElements)
+    {
+      if (element.mType == type)
+      {
+        output << element.mText;
+      }
+    }
+  }
+  output << "</osm>\n";
+
+  return output.close();
+}
+
+size_t CMapDelta::getNumberOfElements(const TOsmChangeAction aAction) const noexcept
+{
+  switch (aAction)
+  {
+    case TOsmChangeAction::Create:
+      return mCreatedElements.size();
+    case TOsmChangeAction::Modify:
+      return mModifiedElements.size();
+    case TOsmChangeAction::Delete:
+      return mDeletedElements.size();
+    case TOsmChangeAction::None:
+      break;
+  }
+
+  return 0;
+}
+
+const CMapDeltaStatistics& CMapDelta::getStatistics() const noexcept
+{
+  return mStatistics;
+}
+
+void CMapDelta::printStatistics(std::ostream& aOutput) const
+{
+  aOutput << mStatistics.mNumberOfAddedLanelets << " added, "
+          << mStatistics.mNumberOfRemovedLanelets << " removed and "
+          << mStatistics.mNumberOfModifiedLanelets << " modified lanelets, "
+          << mStatistics.mNumberOfAddedAreas << " added, " << mStatistics.mNumberOfRemovedAreas
+          << " removed and " << mStatistics.mNumberOfModifiedAreas << " modified areas, "
+          << mStatistics.mNumberOfAddedTrafficSigns << " added, "
+          << mStatistics.mNumberOfRemovedTrafficSigns << " removed and "
+          << mStatistics.mNumberOfModifiedTrafficSigns << " modified traffic signs";
+}
+
+void CMapDelta::computeStatistics(const COsmDocument& aPrevious, const COsmDocument& aCurrent)
+{
+  CMapDeltaStatistics& statistics = mStatistics;
+  for (const COsmElement& element : mCreatedElements)
+  {
+    countPrimitive(getPrimitiveKind(element),
+                   statistics.mNumberOfAddedLanelets,
+                   statistics.mNumberOfAddedAreas,
+                   statistics.mNumberOfAddedTrafficSigns);
+  }
+
+  // Deleted elements are reduced to their ID, their kind follows from the previous map
+  for (const COsmElement& element : mDeletedElements)
+  {
+    countPrimitive(getPrimitiveKind(*aPrevious.findElement(element.mType, element.mId)),
+                   statistics.mNumberOfRemovedLanelets,
+                   statistics.mNumberOfRemovedAreas,
+                   statistics.mNumberOfRemovedTrafficSigns);
+  }
+
+  // A way changes with its nodes and a relation with its ways, even if their own text is unchanged
+  std::unordered_set<lanelet::Id> changedNodeIds, changedWayIds, modifiedRelationIds;
+  for (const auto* elements : { &mCreatedElements, &mModifiedElements, &mDeletedElements })
+  {
+    for (const COsmElement& element : *elements)
+    {
+      switch (element.mType)
+      {
+        case TOsmElementType::Node:
+          changedNodeIds.insert(element.mId);
+          break;
+        case TOsmElementType::Way:
+          changedWayIds.insert(element.mId);
+          break;
+        case TOsmElementType::Relation:
+          modifiedRelationIds.insert(element.mId);
+          break;
+      }
+    }
+  }
+
+  for (const COsmElement& element : aCurrent.getElements())
+  {
+    if (element.mType == TOsmElementType::Way && referencesAny(element, changedNodeIds))
+    {
+      changedWayIds.insert(element.mId);
+    }
+  }
+
+  for (const COsmElement& element : aCurrent.getElements())
+  {
+    if (aPrevious.findElement(element.mType, element.mId) == nullptr)
+    {
+      continue;
+    }
+
+    const bool modified =
+      (element.mType == TOsmElementType::Way && changedWayIds.count(element.mId) > 0)
+      || (element.mType == TOsmElementType::Relation
+          && (modifiedRelationIds.count(element.mId) > 0 || referencesAny(element, changedWayIds)));
+    if (modified)
+    {
+      countPrimitive(getPrimitiveKind(element),
+                     statistics.mNumberOfModifiedLanelets,
+                     statistics.mNumberOfModifiedAreas,
+                     statistics.mNumberOfModifiedTrafficSigns);
+    }
+  }
+}
+}
+}
+}
@@ -0,0 +1,519 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#include "AutoStreamMapConverter/MapRecording.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <type_traits>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+namespace Constants {
+// Identification of recording files, the version must be increased whenever the format changes
+constexpr char     kMapRecordingMagic[]   = "ASLLMREC";
+constexpr uint32_t kMapRecordingVersion   = 1;
+constexpr size_t   kMapRecordingMagicSize = sizeof(kMapRecordingMagic) - 1;
+}
+
+static_assert(std::is_trivially_copyable<AutoStream::HdMap::TArcKey>::value,
+              "Arc keys are recorded as raw bytes");
+static_assert(std::is_trivially_copyable<AutoStream::HdMap::TTrafficSignKey>::value,
+              "Traffic sign keys are recorded as raw bytes");
+static_assert(
+  std::is_trivially_copyable<AutoStream::HdMap::HdMapTrafficSignLayer::TSignSize>::value,
+  "Traffic sign sizes are recorded as raw bytes");
+
+namespace {
+/**
+ * Write the bytes of a value to a stream.
+ *
+ * @param[in, out] aOutput Stream to which the value must be written.
+ * @param[in] aValue Value that must be written, must be trivially copyable.
+ */
+template <typename T>
+void writeValue(std::ostream& aOutput, const T& aValue)
+{
+  static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be written");
+  aOutput.write(reinterpret_cast<const char*>(&aValue), sizeof(T));
+}
+
+/**
+ * Read the bytes of a value from a stream.
+ *
+ * @param[in, out] aInput Stream from which the value must be read.
+ * @param[out] aValue Value that has been read.
+ * @retval True If reading succeeded.
+ * @retval False If the stream ended.
+ */
+template <typename T>
+bool readValue(std::istream& aInput, T& aValue)
+{
+  static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be read");
+  return static_cast<bool>(aInput.read(reinterpret_cast<char*>(&aValue), sizeof(T)));
+}
+
+/**
+ * Write a coordinate as latitude and longitude in degrees and height in millimeters.
+ *
+ * @param[in, out] aOutput Stream to which the coordinate must be written.
+ * @param[in] aCoordinate Coordinate that must be written.
+ */
+void writeCoordinate(std::ostream& aOutput, const AutoStream::TCoordinate3D& aCoordinate)
+{
+  writeValue(aOutput, aCoordinate.getXY().getLatDegree());
+  writeValue(aOutput, aCoordinate.getXY().getLonDegree());
+  writeValue(aOutput, static_cast<int32_t>(aCoordinate.getHeight()));
+}
+
+/**
+ * Read a coordinate written by writeCoordinate and append it to a line.
+ *
+ * @param[in, out] aInput Stream from which the coordinate must be read.
+ * @param[in, out] aLine Line to which the coordinate must be appended.
+ * @retval True If reading succeeded.
+ * @retval False If the stream ended.
+ */
+bool readCoordinate(std::istream& aInput, std::vector<AutoStream::TCoordinate3D>& aLine)
+{
+  double  latDeg = 0., lonDeg = 0.;
+  int32_t heightMm = 0;
+  if (!readValue(aInput, latDeg) || !readValue(aInput, lonDeg) || !readValue(aInput, heightMm))
+  {
+    return false;
+  }
+
+  aLine.emplace_back(AutoStream::TCoordinate::createFromDegrees(latDeg, lonDeg), heightMm);
+  return true;
+}
+
+/**
+ * Write keys found per area.
+ *
+ * @param[in, out] aOutput Stream to which the keys must be written.
+ * @param[in] aKeysByArea Keys per area.
+ */
+template <typename KeysByAreaT>
+void writeKeysByArea(std::ostream& aOutput, const KeysByAreaT& aKeysByArea)
+{
+  writeValue(aOutput, static_cast<uint64_t>(aKeysByArea.size()));
+  for (const auto& areaAndKeys : aKeysByArea)
+  {
+    writeValue(aOutput, areaAndKeys.first);
+    writeValue(aOutput, static_cast<uint64_t>(areaAndKeys.second.size()));
+    for (const auto& key : areaAndKeys.second)
+    {
+      writeValue(aOutput, key);
+    }
+  }
+}
+
+/**
+ * Read keys found per area written by writeKeysByArea.
+ *
+ * @param[in, out] aInput Stream from which the keys must be read.
+ * @param[out] aKeysByArea Keys per area.
+ * @retval True If reading succeeded.
+ * @retval False If the stream ended.
+ */
+template <typename KeysByAreaT>
+bool readKeysByArea(std::istream& aInput, KeysByAreaT& aKeysByArea)
+{
+  uint64_t numberOfAreas = 0;
+  if (!readValue(aInput, numberOfAreas))
+  {
+    return false;
+  }
+
+  for (uint64_t areaIdx = 0; areaIdx < numberOfAreas; ++areaIdx)
+  {
+    typename KeysByAreaT::key_type area;
+    uint64_t                       numberOfKeys = 0;
+    if (!readValue(aInput, area) || !readValue(aInput, numberOfKeys))
+    {
+      return false;
+    }
+
+    auto& keys = aKeysByArea[area];
+    for (uint64_t keyIdx = 0; keyIdx < numberOfKeys; ++keyIdx)
+    {
+      typename KeysByAreaT::mapped_type::value_type key;
+      if (!readValue(aInput, key))
+      {
+        return false;
+      }
+      keys.push_back(key);
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Write the data of an arc.
+ *
+ * @param[in, out] aOutput Stream to which the arc data must be written.
+ * @param[in] aArcData Arc data that must be written.
+ */
+void writeArcData(std::ostream& aOutput, const CAutoStreamArcData& aArcData)
+{
+  writeValue(aOutput, static_cast<uint32_t>(aArcData.mLaneMetaData.size()));
+  for (const auto& metaData : aArcData.mLaneMetaData)
+  {
+    writeValue(aOutput, metaData.mDrivingSide);
+    writeValue(aOutput, metaData.mOpposingTrafficAllowed);
+    writeValue(aOutput, metaData.mLaneWidthCm);
+    writeValue(aOutput, metaData.mLaneLengthCm);
+    writeValue(aOutput, metaData.mType);
+    writeValue(aOutput, metaData.mInvalidConnectionOut);
+    writeValue(aOutput, static_cast<uint32_t>(metaData.mConnectionsOut.size()));
+    for (const auto& connection : metaData.mConnectionsOut)
+    {
+      writeValue(aOutput, connection.first);
+      writeValue(aOutput, connection.second);
+    }
+  }
+
+  writeValue(aOutput, static_cast<uint32_t>(aArcData.mSpeedLimits.size()));
+  for (const auto& speedLimit : aArcData.mSpeedLimits)
+  {
+    writeValue(aOutput, speedLimit);
+  }
+
+  writeValue(aOutput, static_cast<uint32_t>(aArcData.mLaneBorders.size()));
+  for (const auto& border : aArcData.mLaneBorders)
+  {
+    writeValue(aOutput, border.mWidthCm);
+    writeValue(aOutput, static_cast<uint32_t>(border.mComponents.size()));
+    for (const auto& component : border.mComponents)
+    {
+      writeValue(aOutput, component.mType);
+      writeValue(aOutput, component.mColor);
+      writeValue(aOutput, static_cast<uint32_t>(component.mLine.size()));
+      for (const auto& point : component.mLine)
+      {
+        writeCoordinate(aOutput, point);
+      }
+    }
+  }
+}
+
+/**
+ * Read the data of an arc written by writeArcData.
+ *
+ * @param[in, out] aInput Stream from which the arc data must be read.
+ * @param[out] aArcData Arc data that has been read.
+ * @retval True If reading succeeded.
+ * @retval False If the stream ended.
+ */
+bool readArcData(std::istream& aInput, CAutoStreamArcData& aArcData)
+{
+  uint32_t numberOfLanes = 0;
+  if (!readValue(aInput, numberOfLanes))
+  {
+    return false;
+  }
+
+  for (uint32_t laneIdx = 0; laneIdx < numberOfLanes; ++laneIdx)
+  {
+    CAutoStreamLaneMetaData metaData;
+    uint32_t                numberOfConnections = 0;
+    if (!readValue(aInput, metaData.mDrivingSide)
+        || !readValue(aInput, metaData.mOpposingTrafficAllowed)
+        || !readValue(aInput, metaData.mLaneWidthCm) || !readValue(aInput, metaData.mLaneLengthCm)
+        || !readValue(aInput, metaData.mType) || !readValue(aInput, metaData.mInvalidConnectionOut)
+        || !readValue(aInput, numberOfConnections))
+    {
+      return false;
+    }
+
+    for (uint32_t conIdx = 0; conIdx < numberOfConnections; ++conIdx)
+    {
+      std::pair<AutoStream::HdMap::TArcKey, uint32_t> connection;
+      if (!readValue(aInput, connection.first) || !readValue(aInput, connection.second))
+      {
+        return false;
+      }
+      metaData.mConnectionsOut.push_back(connection);
+    }
+    aArcData.mLaneMetaData.push_back(std::move(metaData));
+  }
+
+  uint32_t numberOfSpeedLimits = 0;
+  if (!readValue(aInput, numberOfSpeedLimits))
+  {
+    return false;
+  }
+
+  for (uint32_t laneIdx = 0; laneIdx < numberOfSpeedLimits; ++laneIdx)
+  {
+    CAutoStreamSpeedLimit speedLimit {};
+    if (!readValue(aInput, speedLimit))
+    {
+      return false;
+    }
+    aArcData.mSpeedLimits.push_back(speedLimit);
+  }
+
+  uint32_t numberOfBorders = 0;
+  if (!readValue(aInput, numberOfBorders))
+  {
+    return false;
+  }
+
+  for (uint32_t borderIdx = 0; borderIdx < numberOfBorders; ++borderIdx)
+  {
+    CAutoStreamLaneBorder border;
+    uint32_t              numberOfComponents = 0;
+    if (!readValue(aInput, border.mWidthCm) || !readValue(aInput, numberOfComponents))
+    {
+      return false;
+    }
+
+    for (uint32_t componentIdx = 0; componentIdx < numberOfComponents; ++componentIdx)
+    {
+      CAutoStreamLaneBorderComponent component;
+      uint32_t                       numberOfPoints = 0;
+      if (!readValue(aInput, component.mType) || !readValue(aInput, component.mColor)
+          || !readValue(aInput, numberOfPoints))
+      {
+        return false;
+      }
+
+      for (uint32_t pointIdx = 0; pointIdx < numberOfPoints; ++pointIdx)
+      {
+        if (!readCoordinate(aInput, component.mLine))
+        {
+          return false;
+        }
+      }
+      border.mComponents.push_back(std::move(component));
+    }
+    aArcData.mLaneBorders.push_back(std::move(border));
+  }
+
+  return true;
+}
+}
+
+CAutoStreamMapRecording::CAutoStreamMapRecording()
+  : mMapVersionAndHash()
+{
+}
+
+void CAutoStreamMapRecording::reset(const AutoStream::CMapVersionAndHash& aMapVersionAndHash)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mMapVersionAndHash = aMapVersionAndHash;
+  mArcKeysByArea.clear();
+  mTrafficSignKeysByArea.clear();
+  mArcs.clear();
+  mTrafficSigns.clear();
+}
+
+bool CAutoStreamMapRecording::load(const std::string& aFileName)
+{
+  reset(AutoStream::CMapVersionAndHash());
+
+  std::ifstream input(aFileName, std::ios::in | std::ios::binary);
+  if (!input)
+  {
+    std::cerr << "Opening map recording " << aFileName << " failed." << std::endl;
+    return false;
+  }
+
+  char     magic[Constants::kMapRecordingMagicSize];
+  uint32_t version = 0;
+  if (!input.read(magic, sizeof(magic))
+      || std::memcmp(magic, Constants::kMapRecordingMagic, sizeof(magic)) != 0
+      || !readValue(input, version) || version != Constants::kMapRecordingVersion)
+  {
+    std::cerr << aFileName << " is not a map recording of a supported version." << std::endl;
+    return false;
+  }
+
+  uint64_t numberOfArcs = 0, numberOfTrafficSigns = 0;
+  bool     valid = readValue(input, mMapVersionAndHash) && readKeysByArea(input, mArcKeysByArea)
+               && readKeysByArea(input, mTrafficSignKeysByArea) && readValue(input, numberOfArcs);
+
+  for (uint64_t arcIdx = 0; valid && arcIdx < numberOfArcs; ++arcIdx)
+  {
+    AutoStream::HdMap::TArcKey key;
+    CAutoStreamArcData         arcData;
+    valid = readValue(input, key) && readArcData(input, arcData);
+    if (valid)
+    {
+      mArcs.emplace(key, std::move(arcData));
+    }
+  }
+
+  valid = valid && readValue(input, numberOfTrafficSigns);
+  for (uint64_t signIdx = 0; valid && signIdx < numberOfTrafficSigns; ++signIdx)
+  {
+    AutoStream::HdMap::TTrafficSignKey                  key;
+    std::vector<AutoStream::TCoordinate3D>              centerOfMass;
+    double                                              normalDeg = 0.;
+    AutoStream::HdMap::HdMapTrafficSignLayer::TSignSize size;
+    valid = readValue(input, key) && readCoordinate(input, centerOfMass)
+            && readValue(input, normalDeg) && readValue(input, size);
+    if (valid)
+    {
+      mTrafficSigns.emplace(key,
+                            CAutoStreamTrafficSignData { centerOfMass.front(), normalDeg, size });
+    }
+  }
+
+  if (!valid)
+  {
+    std::cerr << "Map recording " << aFileName << " is corrupt." << std::endl;
+    reset(AutoStream::CMapVersionAndHash());
+    return false;
+  }
+
+  return true;
+}
+
+bool CAutoStreamMapRecording::store(const std::string& aFileName) const
+{
+  std::ofstream output(aFileName, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!output)
+  {
+    std::cerr << "Opening map recording " << aFileName << " for writing failed." << std::endl;
+    return false;
+  }
+
+  output.write(Constants::kMapRecordingMagic, Constants::kMapRecordingMagicSize);
+  writeValue(output, Constants::kMapRecordingVersion);
+  writeValue(output, mMapVersionAndHash);
+  writeKeysByArea(output, mArcKeysByArea);
+  writeKeysByArea(output, mTrafficSignKeysByArea);
+
+  writeValue(output, static_cast<uint64_t>(mArcs.size()));
+  for (const auto& keyAndArc : mArcs)
+  {
+    writeValue(output, keyAndArc.first);
+    writeArcData(output, keyAndArc.second);
+  }
+
+  writeValue(output, static_cast<uint64_t>(mTrafficSigns.size()));
+  for (const auto& keyAndSign : mTrafficSigns)
+  {
+    writeValue(output, keyAndSign.first);
+    writeCoordinate(output, keyAndSign.second.mCenterOfMass);
+    writeValue(output, keyAndSign.second.mNormalDeg);
+    writeValue(output, keyAndSign.second.mSize);
+  }
+
+  return static_cast<bool>(output.flush());
+}
+
+const AutoStream::CMapVersionAndHash& CAutoStreamMapRecording::getMapVersionAndHash() const noexcept
+{
+  return mMapVersionAndHash;
+}
+
+void CAutoStreamMapRecording::addArcKeysInArea(
+  const AutoStream::TBoundingBox&                aArea,
+  const std::vector<AutoStream::HdMap::TArcKey>& aArcKeys)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mArcKeysByArea[toArea(aArea)] = aArcKeys;
+}
+
+bool CAutoStreamMapRecording::findArcKeysInArea(
+  const AutoStream::TBoundingBox&          aArea,
+  std::vector<AutoStream::HdMap::TArcKey>& aArcKeys) const
+{
+  const auto keys = mArcKeysByArea.find(toArea(aArea));
+  if (keys == mArcKeysByArea.end())
+  {
+    return false;
+  }
+
+  aArcKeys = keys->second;
+  return true;
+}
+
+void CAutoStreamMapRecording::addArc(const AutoStream::HdMap::TArcKey& aArcKey,
+                                     const CAutoStreamArcData&         aArcData)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mArcs.emplace(aArcKey, aArcData);
+}
+
+const CAutoStreamArcData*
+CAutoStreamMapRecording::findArc(const AutoStream::HdMap::TArcKey& aArcKey) const
+{
+  const auto arc = mArcs.find(aArcKey);
+  return arc == mArcs.end() ? nullptr : &arc->second;
+}
+
+void CAutoStreamMapRecording::addTrafficSignKeysInArea(
+  const AutoStream::TBoundingBox&                        aArea,
+  const std::vector<AutoStream::HdMap::TTrafficSignKey>& aTrafficSignKeys)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mTrafficSignKeysByArea[toArea(aArea)] = aTrafficSignKeys;
+}
+
+bool CAutoStreamMapRecording::findTrafficSignKeysInArea(
+  const AutoStream::TBoundingBox&                  aArea,
+  std::vector<AutoStream::HdMap::TTrafficSignKey>& aTrafficSignKeys) const
+{
+  const auto keys = mTrafficSignKeysByArea.find(toArea(aArea));
+  if (keys == mTrafficSignKeysByArea.end())
+  {
+    return false;
+  }
+
+  aTrafficSignKeys = keys->second;
+  return true;
+}
+
+void CAutoStreamMapRecording::addTrafficSign(
+  const AutoStream::HdMap::TTrafficSignKey& aTrafficSignKey,
+  const CAutoStreamTrafficSignData&         aTrafficSign)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mTrafficSigns.emplace(aTrafficSignKey, aTrafficSign);
+}
+
+const CAutoStreamTrafficSignData* CAutoStreamMapRecording::findTrafficSign(
+  const AutoStream::HdMap::TTrafficSignKey& aTrafficSignKey) const
+{
+  const auto trafficSign = mTrafficSigns.find(aTrafficSignKey);
+  return trafficSign == mTrafficSigns.end() ? nullptr : &trafficSign->second;
+}
+
+size_t CAutoStreamMapRecording::getNumberOfArcs() const noexcept
+{
+  return mArcs.size();
+}
+
+size_t CAutoStreamMapRecording::getNumberOfTrafficSigns() const noexcept
+{
+  return mTrafficSigns.size();
+}
+
+CAutoStreamMapRecording::TArea
+CAutoStreamMapRecording::toArea(const AutoStream::TBoundingBox& aBoundingBox)
+{
+  return { { aBoundingBox.getCornerSW().getLatDegree(),
+             aBoundingBox.getCornerSW().getLonDegree(),
+             aBoundingBox.getCornerNE().getLatDegree(),
+             aBoundingBox.getCornerNE().getLonDegree() } };
+}
+}
+}
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#include "AutoStreamMapConverter/MemoryUsage.hpp"
+
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+namespace Constants {
+// Process status file of Linux, holding the current and peak resident set size in kB
+constexpr const char* kProcessStatusFile      = "/proc/self/status";
+constexpr const char* kResidentSetSizeKey     = "VmRSS:";
+constexpr const char* kPeakResidentSetSizeKey = "VmHWM:";
+
+// Writing "5" to this file resets the peak resident set size of the process
+constexpr const char* kClearRefsFile            = "/proc/self/clear_refs";
+constexpr const char* kResetPeakResidentSetSize = "5";
+
+constexpr size_t kBytesPerKilobyte = 1024;
+}
+
+// Heap usage counted by the allocation hook, constant initialized before any allocation
+std::atomic<bool>   gAllocationCountingEnabled(false);
+std::atomic<size_t> gLiveHeapBytes(0);
+std::atomic<size_t> gPeakLiveHeapBytes(0);
+
+/**
+ * Read a size in kB from the process status file.
+ *
+ * @param[in] aKey Key of the line holding the size, including the colon.
+ * @retval size_t Size in bytes, zero if the file or key is not present.
+ */
+size_t readProcessStatusSize(const std::string& aKey)
+{
+  std::ifstream status(Constants::kProcessStatusFile);
+  std::string   line;
+  while (std::getline(status, line))
+  {
+    if (line.compare(0, aKey.size(), aKey) == 0)
+    {
+      std::istringstream value(line.substr(aKey.size()));
+      size_t             sizeKilobytes = 0;
+      value >> sizeKilobytes;
+      return sizeKilobytes * Constants::kBytesPerKilobyte;
+    }
+  }
+
+  return 0;
+}
+
+size_t getResidentSetSize()
+{
+  return readProcessStatusSize(Constants::kResidentSetSizeKey);
+}
+
+size_t getPeakResidentSetSize()
+{
+  return readProcessStatusSize(Constants::kPeakResidentSetSizeKey);
+}
+
+bool resetPeakResidentSetSize()
+{
+  std::ofstream clearRefs(Constants::kClearRefsFile);
+  clearRefs << Constants::kResetPeakResidentSetSize;
+  clearRefs.flush();
+
+  return static_cast<bool>(clearRefs);
+}
+
+void enableAllocationCounting() noexcept
+{
+  gAllocationCountingEnabled.store(true, std::memory_order_relaxed);
+}
+
+bool isAllocationCountingEnabled() noexcept
+{
+  return gAllocationCountingEnabled.load(std::memory_order_relaxed);
+}
+
+void countAllocation(const size_t aSize) noexcept
+{
+  const size_t liveHeapBytes = gLiveHeapBytes.fetch_add(aSize, std::memory_order_relaxed) + aSize;
+
+  // Raise the peak without a lock, another thread may raise it concurrently
+  size_t peakLiveHeapBytes = gPeakLiveHeapBytes.load(std::memory_order_relaxed);
+  while (liveHeapBytes > peakLiveHeapBytes
+         && !gPeakLiveHeapBytes.compare_exchange_weak(
+           peakLiveHeapBytes, liveHeapBytes, std::memory_order_relaxed))
+  {
+  }
+}
+
+void countDeallocation(const size_t aSize) noexcept
+{
+  gLiveHeapBytes.fetch_sub(aSize, std::memory_order_relaxed);
+}
+
+size_t getLiveHeapBytes() noexcept
+{
+  return gLiveHeapBytes.load(std::memory_order_relaxed);
+}
+
+size_t getPeakLiveHeapBytes() noexcept
+{
+  return gPeakLiveHeapBytes.load(std::memory_order_relaxed);
+}
+
+size_t restartPeakLiveHeapBytes() noexcept
+{
+  return gPeakLiveHeapBytes.exchange(gLiveHeapBytes.load(std::memory_order_relaxed),
+                                     std::memory_order_relaxed);
+}
+
+void mergePeakLiveHeapBytes(const size_t aPeakLiveHeapBytes) noexcept
+{
+  size_t peakLiveHeapBytes = gPeakLiveHeapBytes.load(std::memory_order_relaxed);
+  while (aPeakLiveHeapBytes > peakLiveHeapBytes
+         && !gPeakLiveHeapBytes.compare_exchange_weak(
+           peakLiveHeapBytes, aPeakLiveHeapBytes, std::memory_order_relaxed))
+  {
+  }
+}
+}
+}
+}
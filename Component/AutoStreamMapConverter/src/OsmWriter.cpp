@@ -0,0 +1,246 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#include "AutoStreamMapConverter/OsmWriter.hpp"
+
+#include <cstdio>
+#include <iostream>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+namespace Constants {
+// Significant digits of written numbers, well below a millimetre for latitude and longitude
+constexpr int kOsmNumberPrecision = 12;
+}
+
+COsmWriter::COsmWriter(std::ostream&                            aOutput,
+                       const lanelet::projection::UtmProjector& aUtmProjector)
+  : mOutput(aOutput)
+  , mUtmProjector(aUtmProjector)
+{
+}
+
+bool COsmWriter::write(const std::vector<lanelet::Lanelet>&   aLanelets,
+                       const std::vector<lanelet::Area>&      aAreas,
+                       const std::vector<lanelet::Polygon3d>& aPolygons)
+{
+  mOutput << "<?xml version=\"1.0\"?>\n<osm version=\"0.6\" generator=\"lanelet2\">\n";
+
+  // Nodes
+  mWrittenIds.clear();
+  for (const auto& lanelet : aLanelets)
+  {
+    writeNodes(lanelet.leftBound());
+    writeNodes(lanelet.rightBound());
+  }
+  for (const auto& area : aAreas)
+  {
+    for (const auto& border : area.outerBound())
+    {
+      writeNodes(border);
+    }
+  }
+  for (const auto& polygon : aPolygons)
+  {
+    writeNodes(polygon);
+  }
+
+  // Ways
+  mWrittenIds.clear();
+  for (const auto& lanelet : aLanelets)
+  {
+    writeWay(lanelet.leftBound(), false);
+    writeWay(lanelet.rightBound(), false);
+  }
+  for (const auto& area : aAreas)
+  {
+    for (const auto& border : area.outerBound())
+    {
+      writeWay(border, false);
+    }
+  }
+  for (const auto& polygon : aPolygons)
+  {
+    writeWay(polygon, true);
+  }
+
+  // Relations
+  mWrittenIds.clear();
+  for (const auto& lanelet : aLanelets)
+  {
+    writeLanelet(lanelet);
+  }
+  for (const auto& area : aAreas)
+  {
+    writeArea(area);
+  }
+  mWrittenIds.clear();
+
+  mOutput << "</osm>\n";
+  mOutput.flush();
+
+  if (!mOutput)
+  {
+    std::cerr << "Writing OSM output failed." << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+template <typename LineStringT>
+void COsmWriter::writeNodes(const LineStringT& aLineString)
+{
+  for (size_t idx = 0; idx < aLineString.size(); ++idx)
+  {
+    const lanelet::ConstPoint3d point = aLineString[idx];
+    if (!markWritten(point.id()))
+    {
+      continue;
+    }
+
+    const lanelet::GPSPoint gps = mUtmProjector.reverse(point.basicPoint());
+
+    mOutput << "  <node id=\"" << point.id() << "\" visible=\"true\" version=\"1\" lat=\"";
+    writeNumber(gps.lat);
+    mOutput << "\" lon=\"";
+    writeNumber(gps.lon);
+    mOutput << "\">\n    <tag k=\"ele\" v=\"";
+    writeNumber(gps.ele);
+    mOutput << "\"/>\n";
+    writeTags(point.attributes(), nullptr);
+    mOutput << "  </node>\n";
+  }
+}
+
+template <typename LineStringT>
+void COsmWriter::writeWay(const LineStringT& aLineString, const bool aIsArea)
+{
+  if (!markWritten(aLineString.id()))
+  {
+    return;
+  }
+
+  mOutput << "  <way id=\"" << aLineString.id() << "\" visible=\"true\" version=\"1\">\n";
+  const size_t size = aLineString.size();
+  for (size_t idx = 0; idx < size; ++idx)
+  {
+    const size_t pointIdx = aLineString.inverted() ? size - 1 - idx : idx;
+    mOutput << "    <nd ref=\"" << aLineString[pointIdx].id() << "\"/>\n";
+  }
+  if (aIsArea)
+  {
+    writeTag("area", "yes");
+  }
+  writeTags(aLineString.attributes(), nullptr);
+  mOutput << "  </way>\n";
+}
+
+void COsmWriter::writeLanelet(const lanelet::ConstLanelet& aLanelet)
+{
+  if (!markWritten(aLanelet.id()))
+  {
+    return;
+  }
+
+  mOutput << "  <relation id=\"" << aLanelet.id() << "\" visible=\"true\" version=\"1\">\n";
+  writeMember("left", aLanelet.leftBound().id());
+  writeMember("right", aLanelet.rightBound().id());
+  writeTags(aLanelet.attributes(), lanelet::AttributeValueString::Lanelet);
+  mOutput << "  </relation>\n";
+}
+
+void COsmWriter::writeArea(const lanelet::ConstArea& aArea)
+{
+  if (!markWritten(aArea.id()))
+  {
+    return;
+  }
+
+  mOutput << "  <relation id=\"" << aArea.id() << "\" visible=\"true\" version=\"1\">\n";
+  for (const auto& border : aArea.outerBound())
+  {
+    writeMember("outer", border.id());
+  }
+  writeTags(aArea.attributes(), lanelet::AttributeValueString::Multipolygon);
+  mOutput << "  </relation>\n";
+}
+
+void COsmWriter::writeMember(const char* aRole, const lanelet::Id aId)
+{
+  mOutput << "    <member type=\"way\" role=\"" << aRole << "\" ref=\"" << aId << "\"/>\n";
+}
+
+void COsmWriter::writeTags(const lanelet::AttributeMap& aAttributes, const char* aType)
+{
+  const std::string typeKey = lanelet::AttributeNamesString::Type;
+  if (aType != nullptr && aAttributes.find(typeKey) == aAttributes.end())
+  {
+    writeTag(typeKey, aType);
+  }
+
+  for (const auto& attribute : aAttributes)
+  {
+    writeTag(attribute.first, attribute.second.value());
+  }
+}
+
+void COsmWriter::writeTag(const std::string& aKey, const std::string& aValue)
+{
+  mOutput << "    <tag k=\"";
+  writeEscaped(aKey);
+  mOutput << "\" v=\"";
+  writeEscaped(aValue);
+  mOutput << "\"/>\n";
+}
+
+void COsmWriter::writeNumber(const double aValue)
+{
+  char      buffer[32];
+  const int length =
+    std::snprintf(buffer, sizeof(buffer), "%.*g", Constants::kOsmNumberPrecision, aValue);
+  mOutput.write(buffer, length);
+}
+
+void COsmWriter::writeEscaped(const std::string& aValue)
+{
+  for (const char c : aValue)
+  {
+    switch (c)
+    {
+      case '&':
+        mOutput << "&amp;";
+        break;
+      case '<':
+        mOutput << "&lt;";
+        break;
+      case '>':
+        mOutput << "&gt;";
+        break;
+      case '"':
+        mOutput << "&quot;";
+        break;
+      default:
+        mOutput.put(c);
+        break;
+    }
+  }
+}
+
+bool COsmWriter::markWritten(const lanelet::Id aId)
+{
+  return mWrittenIds.insert(aId).second;
+}
+}
+}
+}
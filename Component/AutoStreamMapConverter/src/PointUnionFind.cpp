@@ -0,0 +1,98 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#include "AutoStreamMapConverter/PointUnionFind.hpp"
+
+#include <utility>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+void CPointUnionFind::merge(const lanelet::Point3d& aOldPoint, const lanelet::Point3d& aNewPoint)
+{
+  size_t oldRoot = findRoot(getIndex(aOldPoint));
+  size_t newRoot = findRoot(getIndex(aNewPoint));
+
+  if (oldRoot != newRoot)
+  {
+    // Attach the tree with lower rank below the root of the other one
+    if (mRank[oldRoot] > mRank[newRoot])
+    {
+      std::swap(oldRoot, newRoot);
+    }
+    else if (mRank[oldRoot] == mRank[newRoot])
+    {
+      ++mRank[newRoot];
+    }
+    mParent[oldRoot] = newRoot;
+  }
+
+  mRepresentatives[newRoot] = aNewPoint;
+}
+
+bool CPointUnionFind::find(const lanelet::Id aPointId, lanelet::Point3d& aReplacement)
+{
+  const auto index = mIndexById.find(aPointId);
+  if (index == mIndexById.end())
+  {
+    return false;
+  }
+
+  const lanelet::Point3d& representative = mRepresentatives[findRoot(index->second)];
+  if (representative.id() == aPointId)
+  {
+    return false;
+  }
+
+  aReplacement = representative;
+  return true;
+}
+
+bool CPointUnionFind::empty() const noexcept
+{
+  return mIndexById.empty();
+}
+
+size_t CPointUnionFind::getIndex(const lanelet::Point3d& aPoint)
+{
+  const auto inserted = mIndexById.emplace(aPoint.id(), mParent.size());
+  if (inserted.second)
+  {
+    mParent.push_back(inserted.first->second);
+    mRank.push_back(0);
+    mRepresentatives.push_back(aPoint);
+  }
+
+  return inserted.first->second;
+}
+
+size_t CPointUnionFind::findRoot(size_t aIdx)
+{
+  size_t root = aIdx;
+  while (mParent[root] != root)
+  {
+    root = mParent[root];
+  }
+
+  // Path compression: let all elements on the path point to the root directly
+  while (mParent[aIdx] != root)
+  {
+    const size_t next = mParent[aIdx];
+    mParent[aIdx]     = root;
+    aIdx              = next;
+  }
+
+  return root;
+}
+}
+}
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#include "AutoStreamMapConverter/RecordingMapSource.hpp"
+
+#include <stdexcept>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+CAutoStreamRecordingMapSource::CAutoStreamRecordingMapSource(TMapSourcePtr            aSource,
+                                                             CAutoStreamMapRecording& aRecording)
+  : mSource(std::move(aSource))
+  , mRecording(aRecording)
+{
+}
+
+AutoStream::CMapVersionAndHash CAutoStreamRecordingMapSource::getMapVersionAndHash() const
+{
+  return mSource->getMapVersionAndHash();
+}
+
+std::vector<AutoStream::HdMap::TArcKey>
+CAutoStreamRecordingMapSource::getArcKeysInArea(const AutoStream::TBoundingBox& aArea)
+{
+  std::vector<AutoStream::HdMap::TArcKey> keys = mSource->getArcKeysInArea(aArea);
+  mRecording.addArcKeysInArea(aArea, keys);
+  return keys;
+}
+
+CAutoStreamArcData CAutoStreamRecordingMapSource::getArc(const AutoStream::HdMap::TArcKey& aArcKey)
+{
+  CAutoStreamArcData arcData = mSource->getArc(aArcKey);
+  mRecording.addArc(aArcKey, arcData);
+  return arcData;
+}
+
+void CAutoStreamRecordingMapSource::prefetchArc(const AutoStream::HdMap::TArcKey& aArcKey)
+{
+  // Prefetched data is recorded when it is retrieved for conversion
+  mSource->prefetchArc(aArcKey);
+}
+
+std::vector<AutoStream::HdMap::TTrafficSignKey>
+CAutoStreamRecordingMapSource::getTrafficSignKeysInArea(const AutoStream::TBoundingBox& aArea)
+{
+  std::vector<AutoStream::HdMap::TTrafficSignKey> keys = mSource->getTrafficSignKeysInArea(aArea);
+  mRecording.addTrafficSignKeysInArea(aArea, keys);
+  return keys;
+}
+
+CAutoStreamTrafficSignData CAutoStreamRecordingMapSource::getTrafficSign(
+  const AutoStream::HdMap::TTrafficSignKey& aTrafficSignKey)
+{
+  const CAutoStreamTrafficSignData trafficSign = mSource->getTrafficSign(aTrafficSignKey);
+  mRecording.addTrafficSign(aTrafficSignKey, trafficSign);
+  return trafficSign;
+}
+
+CAutoStreamReplayMapSource::CAutoStreamReplayMapSource(const CAutoStreamMapRecording& aRecording)
+  : mRecording(aRecording)
+{
+}
+
+AutoStream::CMapVersionAndHash CAutoStreamReplayMapSource::getMapVersionAndHash() const
+{
+  return mRecording.getMapVersionAndHash();
+}
+
+std::vector<AutoStream::HdMap::TArcKey>
+CAutoStreamReplayMapSource::getArcKeysInArea(const AutoStream::TBoundingBox& aArea)
+{
+  std::vector<AutoStream::HdMap::TArcKey> keys;
+  if (!mRecording.findArcKeysInArea(aArea, keys))
+  {
+    throw std::runtime_error("Area was not queried by the recorded conversion.");
+  }
+  return keys;
+}
+
+CAutoStreamArcData CAutoStreamReplayMapSource::getArc(const AutoStream::HdMap::TArcKey& aArcKey)
+{
+  const CAutoStreamArcData* arcData = mRecording.findArc(aArcKey);
+  if (arcData == nullptr)
+  {
+    throw std::runtime_error("Arc was not retrieved by the recorded conversion.");
+  }
+  return *arcData;
+}
+
+void CAutoStreamReplayMapSource::prefetchArc(const AutoStream::HdMap::TArcKey& /*aArcKey*/)
+{
+}
+
+std::vector<AutoStream::HdMap::TTrafficSignKey>
+CAutoStreamReplayMapSource::getTrafficSignKeysInArea(const AutoStream::TBoundingBox& aArea)
+{
+  std::vector<AutoStream::HdMap::TTrafficSignKey> keys;
+  if (!mRecording.findTrafficSignKeysInArea(aArea, keys))
+  {
+    throw std::runtime_error("Area was not queried by the recorded conversion.");
+  }
+  return keys;
+}
+
+CAutoStreamTrafficSignData CAutoStreamReplayMapSource::getTrafficSign(
+  const AutoStream::HdMap::TTrafficSignKey& aTrafficSignKey)
+{
+  const CAutoStreamTrafficSignData* trafficSign = mRecording.findTrafficSign(aTrafficSignKey);
+  if (trafficSign == nullptr)
+  {
+    throw std::runtime_error("Traffic sign was not retrieved by the recorded conversion.");
+  }
+  return *trafficSign;
+}
+}
+}
+}
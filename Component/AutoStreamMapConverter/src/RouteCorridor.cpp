@@ -0,0 +1,238 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#include "AutoStreamMapConverter/RouteCorridor.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+namespace Constants {
+// Length of one degree of latitude on a sphere with the mean earth radius
+constexpr double kMeterPerDegree = 111195.08;
+
+// Shortest route piece covered by a single bounding box, limits the number of boxes for narrow
+// buffers
+constexpr double kMinCorridorPieceLengthMeter = 50.;
+
+// Smallest cosine of the latitude used for converting distances to longitude differences, keeps
+// boxes near the poles finite
+constexpr double kMinLatitudeCosine = 0.01;
+}
+
+/**
+ * Get the number of meters per degree of longitude at the given latitude.
+ *
+ * @param[in] aLatDegree Latitude in degrees.
+ * @retval double Meters per degree of longitude.
+ */
+double getMeterPerLonDegree(const double aLatDegree)
+{
+  const double latRadian = aLatDegree * M_PI / 180.;
+  return Constants::kMeterPerDegree * std::max(std::cos(latRadian), Constants::kMinLatitudeCosine);
+}
+
+/**
+ * Get the squared distance between a point and a line segment in a plane.
+ *
+ * @param[in] aX X coordinate of the point.
+ * @param[in] aY Y coordinate of the point.
+ * @param[in] aStartX X coordinate of the start of the segment.
+ * @param[in] aStartY Y coordinate of the start of the segment.
+ * @param[in] aEndX X coordinate of the end of the segment.
+ * @param[in] aEndY Y coordinate of the end of the segment.
+ * @retval double Squared distance.
+ */
+double getSquaredDistanceToSegment(const double aX,
+                                   const double aY,
+                                   const double aStartX,
+                                   const double aStartY,
+                                   const double aEndX,
+                                   const double aEndY)
+{
+  const double deltaX        = aEndX - aStartX;
+  const double deltaY        = aEndY - aStartY;
+  const double squaredLength = deltaX * deltaX + deltaY * deltaY;
+
+  double fraction = 0.;
+  if (squaredLength > 0.)
+  {
+    fraction = ((aX - aStartX) * deltaX + (aY - aStartY) * deltaY) / squaredLength;
+    fraction = std::min(std::max(fraction, 0.), 1.);
+  }
+
+  const double closestX = aStartX + fraction * deltaX - aX;
+  const double closestY = aStartY + fraction * deltaY - aY;
+  return closestX * closestX + closestY * closestY;
+}
+
+/**
+ * Check if two line segments in a plane cross each other.
+ *
+ * @param[in] aX0 X coordinate of the start of the first segment.
+ * @param[in] aY0 Y coordinate of the start of the first segment.
+ * @param[in] aX1 X coordinate of the end of the first segment.
+ * @param[in] aY1 Y coordinate of the end of the first segment.
+ * @param[in] aX2 X coordinate of the start of the second segment.
+ * @param[in] aY2 Y coordinate of the start of the second segment.
+ * @param[in] aX3 X coordinate of the end of the second segment.
+ * @param[in] aY3 Y coordinate of the end of the second segment.
+ * @retval True If the segments cross.
+ * @retval False If the segments do not cross, touching segments are handled by distances.
+ */
+bool segmentsCross(const double aX0,
+                   const double aY0,
+                   const double aX1,
+                   const double aY1,
+                   const double aX2,
+                   const double aY2,
+                   const double aX3,
+                   const double aY3)
+{
+  const auto side = [](double aAx, double aAy, double aBx, double aBy, double aPx, double aPy) {
+    return (aBx - aAx) * (aPy - aAy) - (aBy - aAy) * (aPx - aAx);
+  };
+
+  const double side0 = side(aX0, aY0, aX1, aY1, aX2, aY2);
+  const double side1 = side(aX0, aY0, aX1, aY1, aX3, aY3);
+  const double side2 = side(aX2, aY2, aX3, aY3, aX0, aY0);
+  const double side3 = side(aX2, aY2, aX3, aY3, aX1, aY1);
+  return side0 * side1 < 0. && side2 * side3 < 0.;
+}
+
+CRouteCorridor::CRouteCorridor(const std::vector<AutoStream::TCoordinate>& aRoute,
+                               const double                                aBufferWidthMeter)
+  : mBufferWidthMeter(std::max(aBufferWidthMeter, 0.))
+  , mSouthLat(std::numeric_limits<double>::max())
+  , mWestLon(std::numeric_limits<double>::max())
+  , mNorthLat(std::numeric_limits<double>::lowest())
+  , mEastLon(std::numeric_limits<double>::lowest())
+{
+  if (aRoute.empty())
+  {
+    return;
+  }
+
+  const double pieceLengthMeter =
+    std::max(2. * mBufferWidthMeter, Constants::kMinCorridorPieceLengthMeter);
+  const double bufferLatDegree = mBufferWidthMeter / Constants::kMeterPerDegree;
+
+  // A single point is covered by one piece of zero length
+  const size_t numberOfSegments = std::max<size_t>(aRoute.size() - 1, 1);
+  for (size_t segmentIdx = 0; segmentIdx < numberOfSegments; ++segmentIdx)
+  {
+    const auto&  start    = aRoute[segmentIdx];
+    const auto&  end      = aRoute[std::min(segmentIdx + 1, aRoute.size() - 1)];
+    const double startLat = start.getLatDegree();
+    const double startLon = start.getLonDegree();
+    const double deltaLat = end.getLatDegree() - startLat;
+    const double deltaLon = end.getLonDegree() - startLon;
+
+    const double meterPerLonDegree = getMeterPerLonDegree(startLat + deltaLat / 2.);
+    const double lengthMeter =
+      std::hypot(deltaLat * Constants::kMeterPerDegree, deltaLon * meterPerLonDegree);
+    const size_t numberOfPieces =
+      std::max<size_t>(static_cast<size_t>(std::ceil(lengthMeter / pieceLengthMeter)), 1);
+
+    for (size_t pieceIdx = 0; pieceIdx < numberOfPieces; ++pieceIdx)
+    {
+      const double startFraction = static_cast<double>(pieceIdx) / numberOfPieces;
+      const double endFraction   = static_cast<double>(pieceIdx + 1) / numberOfPieces;
+      const double pieceLat0     = startLat + startFraction * deltaLat;
+      const double pieceLat1     = startLat + endFraction * deltaLat;
+      const double pieceLon0     = startLon + startFraction * deltaLon;
+      const double pieceLon1     = startLon + endFraction * deltaLon;
+
+      CPiece piece;
+      piece.mStartLat          = pieceLat0;
+      piece.mStartLon          = pieceLon0;
+      piece.mMeterPerLonDegree = meterPerLonDegree;
+      piece.mEndX              = (pieceLon1 - pieceLon0) * meterPerLonDegree;
+      piece.mEndY              = (pieceLat1 - pieceLat0) * Constants::kMeterPerDegree;
+      mPieces.push_back(piece);
+
+      const double southLat = std::max(std::min(pieceLat0, pieceLat1) - bufferLatDegree, -90.);
+      const double northLat = std::min(std::max(pieceLat0, pieceLat1) + bufferLatDegree, 90.);
+
+      // Use the latitude furthest from the equator, such that the buffer is covered everywhere
+      const double bufferLonDegree =
+        mBufferWidthMeter / getMeterPerLonDegree(std::max(std::abs(southLat), std::abs(northLat)));
+      const double westLon = std::min(pieceLon0, pieceLon1) - bufferLonDegree;
+      const double eastLon = std::max(pieceLon0, pieceLon1) + bufferLonDegree;
+
+      mBoundingBoxes.emplace_back(AutoStream::TCoordinate::createFromDegrees(southLat, westLon),
+                                  AutoStream::TCoordinate::createFromDegrees(northLat, eastLon));
+      mSouthLat = std::min(mSouthLat, southLat);
+      mWestLon  = std::min(mWestLon, westLon);
+      mNorthLat = std::max(mNorthLat, northLat);
+      mEastLon  = std::max(mEastLon, eastLon);
+    }
+  }
+}
+
+bool CRouteCorridor::empty() const noexcept
+{
+  return mPieces.empty();
+}
+
+const std::vector<AutoStream::TBoundingBox>& CRouteCorridor::getBoundingBoxes() const noexcept
+{
+  return mBoundingBoxes;
+}
+
+AutoStream::TBoundingBox CRouteCorridor::getBoundingBox() const
+{
+  return AutoStream::TBoundingBox(AutoStream::TCoordinate::createFromDegrees(mSouthLat, mWestLon),
+                                  AutoStream::TCoordinate::createFromDegrees(mNorthLat, mEastLon));
+}
+
+bool CRouteCorridor::isSegmentWithinPiece(const size_t                   aPieceIdx,
+                                          const AutoStream::TCoordinate& aStart,
+                                          const AutoStream::TCoordinate& aEnd) const
+{
+  const CPiece& piece = mPieces[aPieceIdx];
+  const double  x0    = (aStart.getLonDegree() - piece.mStartLon) * piece.mMeterPerLonDegree;
+  const double  y0    = (aStart.getLatDegree() - piece.mStartLat) * Constants::kMeterPerDegree;
+  const double  x1    = (aEnd.getLonDegree() - piece.mStartLon) * piece.mMeterPerLonDegree;
+  const double  y1    = (aEnd.getLatDegree() - piece.mStartLat) * Constants::kMeterPerDegree;
+
+  if (segmentsCross(x0, y0, x1, y1, 0., 0., piece.mEndX, piece.mEndY))
+  {
+    return true;
+  }
+
+  // Otherwise the closest points include an end point of one of the segments
+  const double squaredBuffer = mBufferWidthMeter * mBufferWidthMeter;
+  return getSquaredDistanceToSegment(x0, y0, 0., 0., piece.mEndX, piece.mEndY) <= squaredBuffer
+         || getSquaredDistanceToSegment(x1, y1, 0., 0., piece.mEndX, piece.mEndY) <= squaredBuffer
+         || getSquaredDistanceToSegment(0., 0., x0, y0, x1, y1) <= squaredBuffer
+         || getSquaredDistanceToSegment(piece.mEndX, piece.mEndY, x0, y0, x1, y1) <= squaredBuffer;
+}
+
+bool CRouteCorridor::contains(const AutoStream::TCoordinate& aPoint) const
+{
+  for (size_t pieceIdx = 0; pieceIdx < mPieces.size(); ++pieceIdx)
+  {
+    if (isSegmentWithinPiece(pieceIdx, aPoint, aPoint))
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+}
+}
+}
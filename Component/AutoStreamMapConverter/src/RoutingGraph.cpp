@@ -0,0 +1,632 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#include "AutoStreamMapConverter/RoutingGraph.hpp"
+#include "AutoStreamMapConverter/CompressedFile.hpp"
+
+#include <lanelet2_core/Attribute.h>
+#include <lanelet2_traffic_rules/TrafficRulesFactory.h>
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+namespace Constants {
+// Identification of routing graph files, the version must be increased whenever the format changes
+constexpr char     kRoutingGraphMagic[8]      = "ASLLRGR";
+constexpr uint32_t kRoutingGraphVersion       = 2;
+constexpr uint32_t kRoutingGraphByteOrderMark = 0x01020304;
+
+// Edge length of the grid cells in which lanelets are searched for conflicts
+constexpr double kConflictGridCellMeters = 50.;
+
+// Number of records by which the tables grow while they are read
+constexpr uint64_t kRecordsPerChunk = 1 << 16;
+}
+
+/**
+ * Header of a routing graph file, followed by the lanelet table and the relation table.
+ */
+struct CRoutingGraphFileHeader
+{
+  char     mMagic[8];
+  uint32_t mVersion;
+  uint32_t mByteOrderMark;
+  uint64_t mNumberOfLanelets;
+  uint64_t mNumberOfRelations;
+};
+
+static_assert(std::is_trivially_copyable<CRoutingGraphLanelet>::value
+                && std::is_trivially_copyable<CRoutingGraphRelation>::value,
+              "Routing graph records are stored as raw bytes");
+
+/**
+ * Read a table of raw records in chunks, such that a corrupt number of records in the header cannot
+ * allocate more memory than the file actually holds.
+ *
+ * @param[in, out] aInput Stream from which the records must be read.
+ * @param[in] aNumberOfRecords Number of records given by the header.
+ * @param[out] aRecords Records that have been read.
+ * @retval True If all records were read.
+ * @retval False If the file ends early or reading failed.
+ */
+template <typename RecordT>
+bool readTable(std::istream&         aInput,
+               const uint64_t        aNumberOfRecords,
+               std::vector<RecordT>& aRecords)
+{
+  aRecords.clear();
+  while (aInput && aRecords.size() < aNumberOfRecords)
+  {
+    const size_t firstRecord     = aRecords.size();
+    const size_t numberOfRecords = static_cast<size_t>(
+      std::min(aNumberOfRecords - firstRecord, Constants::kRecordsPerChunk));
+    aRecords.resize(firstRecord + numberOfRecords);
+    aInput.read(reinterpret_cast<char*>(&aRecords[firstRecord]),
+                static_cast<std::streamsize>(numberOfRecords * sizeof(RecordT)));
+  }
+
+  return static_cast<bool>(aInput);
+}
+
+/**
+ * Bounding box of a lanelet in the ground plane.
+ */
+struct CLaneletBox
+{
+  double mMinX;
+  double mMinY;
+  double mMaxX;
+  double mMaxY;
+};
+
+/**
+ * Get the length of a line string in the ground plane.
+ *
+ * @param[in] aLineString Line string of which the length is requested.
+ * @retval double Length in meters.
+ */
+double getLength2d(const lanelet::ConstLineString3d& aLineString)
+{
+  double length = 0.;
+  for (size_t idx = 1; idx < aLineString.size(); ++idx)
+  {
+    length += std::hypot(aLineString[idx].x() - aLineString[idx - 1].x(),
+                         aLineString[idx].y() - aLineString[idx - 1].y());
+  }
+
+  return length;
+}
+
+/**
+ * Get the bounding box of both bounds of a lanelet in the ground plane.
+ *
+ * @param[in] aLanelet Lanelet with non-empty bounds.
+ * @retval CLaneletBox Bounding box.
+ */
+CLaneletBox getBoundingBox(const lanelet::ConstLanelet& aLanelet)
+{
+  CLaneletBox box { std::numeric_limits<double>::max(),
+                    std::numeric_limits<double>::max(),
+                    std::numeric_limits<double>::lowest(),
+                    std::numeric_limits<double>::lowest() };
+  for (const auto& bound : { aLanelet.leftBound(), aLanelet.rightBound() })
+  {
+    for (size_t idx = 0; idx < bound.size(); ++idx)
+    {
+      box.mMinX = std::min(box.mMinX, bound[idx].x());
+      box.mMinY = std::min(box.mMinY, bound[idx].y());
+      box.mMaxX = std::max(box.mMaxX, bound[idx].x());
+      box.mMaxY = std::max(box.mMaxY, bound[idx].y());
+    }
+  }
+
+  return box;
+}
+
+/**
+ * Check whether two values have opposite signs, zero has no sign.
+ *
+ * @param[in] aFirst First value.
+ * @param[in] aSecond Second value.
+ * @retval True If one value is positive and the other one negative.
+ * @retval False Otherwise.
+ */
+bool haveOppositeSigns(const double aFirst, const double aSecond)
+{
+  return (aFirst > 0. && aSecond < 0.) || (aFirst < 0. && aSecond > 0.);
+}
+
+/**
+ * Get on which side of a segment a point lies in the ground plane.
+ *
+ * @param[in] aStart Start of the segment.
+ * @param[in] aEnd End of the segment.
+ * @param[in] aPoint Point.
+ * @retval double Positive left of the segment, negative right of it and zero on its line.
+ */
+double getSide(const lanelet::ConstPoint3d& aStart,
+               const lanelet::ConstPoint3d& aEnd,
+               const lanelet::ConstPoint3d& aPoint)
+{
+  return (aEnd.x() - aStart.x()) * (aPoint.y() - aStart.y())
+         - (aEnd.y() - aStart.y()) * (aPoint.x() - aStart.x());
+}
+
+/**
+ * Check whether two line strings cross in the ground plane. Line strings that only touch, such as
+ * line strings sharing a point, do not cross.
+ *
+ * @param[in] aFirst First line string.
+ * @param[in] aSecond Second line string.
+ * @retval True If a segment of the first line string crosses a segment of the second one.
+ * @retval False Otherwise.
+ */
+bool doLineStringsCross(const lanelet::ConstLineString3d& aFirst,
+                        const lanelet::ConstLineString3d& aSecond)
+{
+  for (size_t firstIdx = 1; firstIdx < aFirst.size(); ++firstIdx)
+  {
+    for (size_t secondIdx = 1; secondIdx < aSecond.size(); ++secondIdx)
+    {
+      if (haveOppositeSigns(getSide(aFirst[firstIdx - 1], aFirst[firstIdx], aSecond[secondIdx - 1]),
+                            getSide(aFirst[firstIdx - 1], aFirst[firstIdx], aSecond[secondIdx]))
+          && haveOppositeSigns(
+            getSide(aSecond[secondIdx - 1], aSecond[secondIdx], aFirst[firstIdx - 1]),
+            getSide(aSecond[secondIdx - 1], aSecond[secondIdx], aFirst[firstIdx])))
+      {
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+/**
+ * Check whether two lanelets conflict: their bounds cross, while they are not connected by a
+ * shared bound or a shared end point of their bounds as successors, neighbours or merging and
+ * diverging lanelets are.
+ *
+ * @param[in] aFirst First lanelet.
+ * @param[in] aSecond Second lanelet.
+ * @retval True If the lanelets conflict.
+ * @retval False Otherwise.
+ */
+bool areConflicting(const lanelet::ConstLanelet& aFirst, const lanelet::ConstLanelet& aSecond)
+{
+  const auto getConnectionIds = [](const lanelet::ConstLanelet& aLanelet) {
+    const auto leftBound  = aLanelet.leftBound();
+    const auto rightBound = aLanelet.rightBound();
+    return std::array<lanelet::Id, 6> { leftBound.id(),         rightBound.id(),
+                                        leftBound.front().id(), leftBound.back().id(),
+                                        rightBound.front().id(), rightBound.back().id() };
+  };
+
+  const std::array<lanelet::Id, 6> firstIds  = getConnectionIds(aFirst);
+  const std::array<lanelet::Id, 6> secondIds = getConnectionIds(aSecond);
+  for (const lanelet::Id id : firstIds)
+  {
+    if (std::find(secondIds.begin(), secondIds.end(), id) != secondIds.end())
+    {
+      return false;
+    }
+  }
+
+  for (const auto& firstBound : { aFirst.leftBound(), aFirst.rightBound() })
+  {
+    for (const auto& secondBound : { aSecond.leftBound(), aSecond.rightBound() })
+    {
+      if (doLineStringsCross(firstBound, secondBound))
+      {
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+/**
+ * Find the conflicting lanelets of every lanelet. Lanelets are only compared to the lanelets of
+ * the grid cells their bounding box covers, such that the search takes linear time for maps of
+ * evenly spread lanelets.
+ *
+ * @param[in] aLanelets Lanelets with non-empty bounds.
+ * @retval std::vector<std::vector<uint32_t>> Indices of the conflicting lanelets of each lanelet.
+ */
+std::vector<std::vector<uint32_t>>
+  findConflictingLanelets(const std::vector<lanelet::ConstLanelet>& aLanelets)
+{
+  std::vector<std::vector<uint32_t>>                 conflictingLanelets(aLanelets.size());
+  std::unordered_map<int64_t, std::vector<uint32_t>> laneletsByCell;
+  std::vector<CLaneletBox>                           boxes;
+  std::vector<uint32_t>                              candidates;
+  boxes.reserve(aLanelets.size());
+
+  const auto getCell = [](const double aCoordinate) {
+    return static_cast<int32_t>(std::floor(aCoordinate / Constants::kConflictGridCellMeters));
+  };
+
+  for (uint32_t laneletIdx = 0; laneletIdx < aLanelets.size(); ++laneletIdx)
+  {
+    boxes.push_back(getBoundingBox(aLanelets[laneletIdx]));
+    const CLaneletBox& box = boxes.back();
+
+    // Lanelets of earlier cells were inserted before, each pair is therefore compared once
+    candidates.clear();
+    for (int32_t cellX = getCell(box.mMinX); cellX <= getCell(box.mMaxX); ++cellX)
+    {
+      for (int32_t cellY = getCell(box.mMinY); cellY <= getCell(box.mMaxY); ++cellY)
+      {
+        const int64_t cell = (static_cast<int64_t>(cellX) << 32) | static_cast<uint32_t>(cellY);
+        std::vector<uint32_t>& cellLanelets = laneletsByCell[cell];
+        candidates.insert(candidates.end(), cellLanelets.begin(), cellLanelets.end());
+        cellLanelets.push_back(laneletIdx);
+      }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    for (const uint32_t candidateIdx : candidates)
+    {
+      const CLaneletBox& candidateBox = boxes[candidateIdx];
+      if (box.mMinX <= candidateBox.mMaxX && candidateBox.mMinX <= box.mMaxX
+          && box.mMinY <= candidateBox.mMaxY && candidateBox.mMinY <= box.mMaxY
+          && areConflicting(aLanelets[laneletIdx], aLanelets[candidateIdx]))
+      {
+        conflictingLanelets[laneletIdx].push_back(candidateIdx);
+        conflictingLanelets[candidateIdx].push_back(laneletIdx);
+      }
+    }
+  }
+
+  return conflictingLanelets;
+}
+
+CRoutingGraph::CRoutingGraph()
+  : mLanelets()
+  , mRelations()
+{
+}
+
+void CRoutingGraph::build(const std::vector<lanelet::Lanelet>& aLanelets)
+{
+  clear();
+
+  std::vector<lanelet::ConstLanelet> mapLanelets;
+  mapLanelets.reserve(aLanelets.size());
+  for (const auto& lanelet : aLanelets)
+  {
+    if (lanelet.id() != lanelet::InvalId && !lanelet.leftBound().empty()
+        && !lanelet.rightBound().empty())
+    {
+      mapLanelets.emplace_back(lanelet);
+    }
+  }
+  std::sort(mapLanelets.begin(),
+            mapLanelets.end(),
+            [](const lanelet::ConstLanelet& aLeft, const lanelet::ConstLanelet& aRight) {
+              return aLeft.id() < aRight.id();
+            });
+
+  // The graph holds every direction in which vehicles may drive a lanelet, numbered by ascending ID
+  // and direction, such that lanelets can be found by binary search
+  const auto trafficRules = lanelet::traffic_rules::TrafficRulesFactory::create(
+    lanelet::Locations::Germany, lanelet::Participants::Vehicle);
+  std::vector<lanelet::ConstLanelet> passableLanelets;
+  std::vector<lanelet::ConstLanelet> lanelets;
+  std::vector<uint32_t>              passableLaneletIndices;
+  std::vector<uint32_t>              firstLaneletIndices;
+  for (const auto& lanelet : mapLanelets)
+  {
+    const bool isPassable         = trafficRules->canPass(lanelet);
+    const bool isInvertedPassable = trafficRules->canPass(lanelet.invert());
+    if (!isPassable && !isInvertedPassable)
+    {
+      continue;
+    }
+
+    firstLaneletIndices.push_back(static_cast<uint32_t>(lanelets.size()));
+    if (isPassable)
+    {
+      lanelets.push_back(lanelet);
+      passableLaneletIndices.push_back(static_cast<uint32_t>(passableLanelets.size()));
+    }
+    if (isInvertedPassable)
+    {
+      lanelets.push_back(lanelet.invert());
+      passableLaneletIndices.push_back(static_cast<uint32_t>(passableLanelets.size()));
+    }
+    passableLanelets.push_back(lanelet);
+  }
+  firstLaneletIndices.push_back(static_cast<uint32_t>(lanelets.size()));
+
+  if (lanelets.size() > std::numeric_limits<uint32_t>::max())
+  {
+    std::cerr << "Too many lanelets for building the routing graph." << std::endl;
+    return;
+  }
+
+  // Stitched connections share the end points of the bounds, adjacent lanes share a bound
+  std::unordered_map<lanelet::Id, std::vector<uint32_t>> laneletsByLeftStart;
+  std::unordered_map<lanelet::Id, std::vector<uint32_t>> laneletsByLeftEnd;
+  std::unordered_map<lanelet::Id, std::vector<uint32_t>> laneletsByLeftBound;
+  std::unordered_map<lanelet::Id, std::vector<uint32_t>> laneletsByRightBound;
+  for (uint32_t laneletIdx = 0; laneletIdx < lanelets.size(); ++laneletIdx)
+  {
+    const lanelet::ConstLanelet& lanelet = lanelets[laneletIdx];
+    laneletsByLeftStart[lanelet.leftBound().front().id()].push_back(laneletIdx);
+    laneletsByLeftEnd[lanelet.leftBound().back().id()].push_back(laneletIdx);
+    laneletsByLeftBound[lanelet.leftBound().id()].push_back(laneletIdx);
+    laneletsByRightBound[lanelet.rightBound().id()].push_back(laneletIdx);
+  }
+
+  const std::vector<std::vector<uint32_t>> conflictingLanelets =
+    findConflictingLanelets(passableLanelets);
+
+  const std::vector<uint32_t> noLanelets;
+  const auto                  findLanelets =
+    [&noLanelets](const std::unordered_map<lanelet::Id, std::vector<uint32_t>>& aLaneletsById,
+                  const lanelet::Id aId) -> const std::vector<uint32_t>& {
+    const auto found = aLaneletsById.find(aId);
+    return found != aLaneletsById.end() ? found->second : noLanelets;
+  };
+
+  mLanelets.reserve(lanelets.size());
+  for (uint32_t laneletIdx = 0; laneletIdx < lanelets.size(); ++laneletIdx)
+  {
+    const lanelet::ConstLanelet& lanelet    = lanelets[laneletIdx];
+    const auto                   leftBound  = lanelet.leftBound();
+    const auto                   rightBound = lanelet.rightBound();
+
+    CRoutingGraphLanelet record {};
+    record.mId            = lanelet.id();
+    record.mLengthMeter   = (getLength2d(leftBound) + getLength2d(rightBound)) / 2.;
+    record.mFirstRelation = static_cast<uint32_t>(mRelations.size());
+    record.mInverted      = lanelet.inverted() ? 1 : 0;
+
+    for (const uint32_t otherIdx : findLanelets(laneletsByLeftStart, leftBound.back().id()))
+    {
+      if (lanelets[otherIdx].rightBound().front().id() == rightBound.back().id()
+          && trafficRules->canPass(lanelet, lanelets[otherIdx]))
+      {
+        mRelations.push_back(CRoutingGraphRelation { otherIdx, TRoutingRelation::Successor });
+      }
+    }
+
+    for (const uint32_t otherIdx : findLanelets(laneletsByLeftEnd, leftBound.back().id()))
+    {
+      if (otherIdx != laneletIdx
+          && lanelets[otherIdx].rightBound().back().id() == rightBound.back().id())
+      {
+        mRelations.push_back(CRoutingGraphRelation { otherIdx, TRoutingRelation::Merging });
+      }
+    }
+
+    for (const uint32_t otherIdx : findLanelets(laneletsByLeftStart, leftBound.front().id()))
+    {
+      if (otherIdx != laneletIdx
+          && lanelets[otherIdx].rightBound().front().id() == rightBound.front().id())
+      {
+        mRelations.push_back(CRoutingGraphRelation { otherIdx, TRoutingRelation::Diverging });
+      }
+    }
+
+    // Neighbours driving in the same direction use the shared bound with the same orientation
+    for (const uint32_t otherIdx : findLanelets(laneletsByRightBound, leftBound.id()))
+    {
+      if (lanelets[otherIdx].rightBound().inverted() == leftBound.inverted())
+      {
+        mRelations.push_back(CRoutingGraphRelation {
+          otherIdx,
+          trafficRules->canChangeLane(lanelet, lanelets[otherIdx])
+            ? TRoutingRelation::Left
+            : TRoutingRelation::AdjacentLeft });
+      }
+    }
+
+    for (const uint32_t otherIdx : findLanelets(laneletsByLeftBound, rightBound.id()))
+    {
+      if (lanelets[otherIdx].leftBound().inverted() == rightBound.inverted())
+      {
+        mRelations.push_back(CRoutingGraphRelation {
+          otherIdx,
+          trafficRules->canChangeLane(lanelet, lanelets[otherIdx])
+            ? TRoutingRelation::Right
+            : TRoutingRelation::AdjacentRight });
+      }
+    }
+
+    // Conflicts are found once per lanelet and hold for all directions of both lanelets
+    for (const uint32_t passableIdx : conflictingLanelets[passableLaneletIndices[laneletIdx]])
+    {
+      for (uint32_t otherIdx = firstLaneletIndices[passableIdx];
+           otherIdx < firstLaneletIndices[passableIdx + 1];
+           ++otherIdx)
+      {
+        mRelations.push_back(CRoutingGraphRelation { otherIdx, TRoutingRelation::Conflicting });
+      }
+    }
+
+    record.mNumberOfRelations = static_cast<uint32_t>(mRelations.size()) - record.mFirstRelation;
+    std::sort(mRelations.begin() + record.mFirstRelation,
+              mRelations.end(),
+              [](const CRoutingGraphRelation& aLeft, const CRoutingGraphRelation& aRight) {
+                return aLeft.mRelation != aRight.mRelation ? aLeft.mRelation < aRight.mRelation
+                                                           : aLeft.mLanelet < aRight.mLanelet;
+              });
+    mLanelets.push_back(record);
+  }
+}
+
+void CRoutingGraph::clear()
+{
+  mLanelets.clear();
+  mRelations.clear();
+}
+
+bool CRoutingGraph::store(const std::string& aFileName) const
+{
+  CMapOutputStream output;
+  if (!output.open(aFileName))
+  {
+    return false;
+  }
+
+  CRoutingGraphFileHeader header {};
+  std::memcpy(header.mMagic, Constants::kRoutingGraphMagic, sizeof(header.mMagic));
+  header.mVersion           = Constants::kRoutingGraphVersion;
+  header.mByteOrderMark     = Constants::kRoutingGraphByteOrderMark;
+  header.mNumberOfLanelets  = mLanelets.size();
+  header.mNumberOfRelations = mRelations.size();
+
+  output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  output.write(reinterpret_cast<const char*>(mLanelets.data()),
+               static_cast<std::streamsize>(mLanelets.size() * sizeof(CRoutingGraphLanelet)));
+  output.write(reinterpret_cast<const char*>(mRelations.data()),
+               static_cast<std::streamsize>(mRelations.size() * sizeof(CRoutingGraphRelation)));
+  return output.close();
+}
+
+bool CRoutingGraph::load(const std::string& aFileName)
+{
+  clear();
+
+  CMapInputStream         input;
+  CRoutingGraphFileHeader header {};
+  if (!input.open(aFileName) || !input.read(reinterpret_cast<char*>(&header), sizeof(header)))
+  {
+    return false;
+  }
+
+  const uint64_t maxTableSize = std::numeric_limits<uint32_t>::max();
+  if (std::memcmp(header.mMagic, Constants::kRoutingGraphMagic, sizeof(header.mMagic)) != 0
+      || header.mVersion != Constants::kRoutingGraphVersion
+      || header.mByteOrderMark != Constants::kRoutingGraphByteOrderMark
+      || header.mNumberOfLanelets > maxTableSize || header.mNumberOfRelations > maxTableSize)
+  {
+    std::cerr << aFileName << " is not a routing graph of version "
+              << Constants::kRoutingGraphVersion << "." << std::endl;
+    return false;
+  }
+
+  // Plain files must be large enough for both tables, gzip files just end early
+  struct stat    status;
+  const uint64_t tablesEnd = sizeof(header)
+                             + header.mNumberOfLanelets * sizeof(CRoutingGraphLanelet)
+                             + header.mNumberOfRelations * sizeof(CRoutingGraphRelation);
+  bool valid = getMapFileCompression(aFileName) == TMapFileCompression::Gzip
+               || (::stat(aFileName.c_str(), &status) == 0
+                   && static_cast<uint64_t>(status.st_size) >= tablesEnd);
+
+  valid = valid && readTable(input, header.mNumberOfLanelets, mLanelets)
+          && readTable(input, header.mNumberOfRelations, mRelations);
+  for (size_t idx = 0; valid && idx < mLanelets.size(); ++idx)
+  {
+    valid = mLanelets[idx].mFirstRelation <= mRelations.size()
+            && mLanelets[idx].mNumberOfRelations
+                 <= mRelations.size() - mLanelets[idx].mFirstRelation
+            && mLanelets[idx].mInverted <= 1;
+  }
+  for (size_t idx = 0; valid && idx < mRelations.size(); ++idx)
+  {
+    valid = mRelations[idx].mLanelet < mLanelets.size()
+            && mRelations[idx].mRelation <= TRoutingRelation::Diverging;
+  }
+
+  if (!valid)
+  {
+    std::cerr << "Routing graph " << aFileName << " is corrupt." << std::endl;
+    clear();
+    return false;
+  }
+
+  return true;
+}
+
+bool CRoutingGraph::findLanelet(const lanelet::Id aId,
+                                const bool        aInverted,
+                                size_t&           aLaneletIdx) const
+{
+  const uint32_t inverted = aInverted ? 1 : 0;
+  const auto     lanelet  = std::lower_bound(
+    mLanelets.begin(),
+    mLanelets.end(),
+    std::make_pair(aId, inverted),
+    [](const CRoutingGraphLanelet& aLanelet, const std::pair<lanelet::Id, uint32_t>& aValue) {
+      return std::make_pair(aLanelet.mId, aLanelet.mInverted) < aValue;
+    });
+  if (lanelet == mLanelets.end() || lanelet->mId != aId || lanelet->mInverted != inverted)
+  {
+    return false;
+  }
+
+  aLaneletIdx = static_cast<size_t>(lanelet - mLanelets.begin());
+  return true;
+}
+
+std::vector<size_t> CRoutingGraph::getRelatedLanelets(const size_t           aLaneletIdx,
+                                                      const TRoutingRelation aRelation) const
+{
+  std::vector<size_t> relatedLanelets;
+  if (aLaneletIdx >= mLanelets.size())
+  {
+    return relatedLanelets;
+  }
+
+  const CRoutingGraphLanelet& lanelet = mLanelets[aLaneletIdx];
+  for (uint32_t idx = 0; idx < lanelet.mNumberOfRelations; ++idx)
+  {
+    const CRoutingGraphRelation& relation = mRelations[lanelet.mFirstRelation + idx];
+    if (relation.mRelation == aRelation)
+    {
+      relatedLanelets.push_back(relation.mLanelet);
+    }
+  }
+
+  return relatedLanelets;
+}
+
+size_t CRoutingGraph::getNumberOfRelations(const TRoutingRelation aRelation) const
+{
+  return static_cast<size_t>(
+    std::count_if(mRelations.begin(),
+                  mRelations.end(),
+                  [aRelation](const CRoutingGraphRelation& aCandidate) {
+                    return aCandidate.mRelation == aRelation;
+                  }));
+}
+
+const std::vector<CRoutingGraphLanelet>& CRoutingGraph::getLanelets() const noexcept
+{
+  return mLanelets;
+}
+
+const std::vector<CRoutingGraphRelation>& CRoutingGraph::getRelations() const noexcept
+{
+  return mRelations;
+}
+}
+}
+}
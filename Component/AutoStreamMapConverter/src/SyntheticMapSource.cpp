@@ -0,0 +1,670 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#include "AutoStreamMapConverter/SyntheticMapSource.hpp"
+#include "AutoStreamMapConverter/ConversionHelpers.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+namespace Constants {
+// Approximate length of a degree of latitude, a synthetic map does not need to be exact
+constexpr double kMetersPerDegreeLat = 111320.0;
+
+// Distance between the outer lane borders of neighbouring roads
+constexpr double kRoadGapMeter = 20.0;
+
+// Distance of traffic signs to the right of the right-most lane border
+constexpr double kTrafficSignDistanceMeter = 2.0;
+
+// Traffic sign appearance, signs face the traffic approaching from the west
+constexpr int32_t  kTrafficSignHeightMm  = 2000;
+constexpr uint32_t kTrafficSignSizeCm    = 60;
+constexpr double   kTrafficSignNormalDeg = 180.0;
+constexpr double   kMetersPerKilometer   = 1000.0;
+
+// Lane borders and lanes
+constexpr double   kDoubleLineSpacingMeter = 0.2;
+constexpr uint32_t kPaintedBorderWidthCm   = 15;
+constexpr uint32_t kUrbanSpeedLimitKmh     = 50;
+constexpr uint32_t kRuralSpeedLimitKmh     = 80;
+constexpr size_t   kMinTriangularInterval  = 3;
+
+// Parameters of the 64-bit FNV-1a hash used for the map version
+constexpr uint64_t kVersionOffsetBasis = 14695981039346656037ULL;
+constexpr uint64_t kVersionPrime       = 1099511628211ULL;
+}
+
+/**
+ * Create a key from the index of an arc or traffic sign. Keys are only used to look up data in the
+ * map source that created them, any unique bytes will do.
+ *
+ * @param[in] aIndex Index of the arc or traffic sign.
+ * @retval KeyT Key of the arc or traffic sign.
+ */
+template <typename KeyT>
+KeyT toSyntheticKey(const size_t aIndex)
+{
+  static_assert(std::is_trivially_copyable<KeyT>::value && sizeof(KeyT) >= sizeof(uint64_t),
+                "Keys must be able to hold an index");
+
+  // Zero is left unused, such that default constructed keys are not found
+  const uint64_t value = static_cast<uint64_t>(aIndex) + 1;
+  KeyT           key;
+  std::memset(&key, 0, sizeof(key));
+  std::memcpy(&key, &value, sizeof(value));
+  return key;
+}
+
+/**
+ * Get the index of an arc or traffic sign from a key created by toSyntheticKey.
+ *
+ * @param[in] aKey Key of the arc or traffic sign.
+ * @param[out] aIndex Index of the arc or traffic sign.
+ * @retval True If the key holds an index.
+ * @retval False If the key was not created by toSyntheticKey.
+ */
+template <typename KeyT>
+bool fromSyntheticKey(const KeyT& aKey, size_t& aIndex)
+{
+  uint64_t value = 0;
+  std::memcpy(&value, &aKey, sizeof(value));
+  if (value == 0)
+  {
+    return false;
+  }
+
+  aIndex = static_cast<size_t>(value - 1);
+  return true;
+}
+
+/**
+ * Add the bytes of a value to the hash from which the map version is derived.
+ *
+ * @param[in] aValue Value that must be added, must be trivially copyable.
+ * @param[in, out] aHash Hash to which the value must be added.
+ */
+template <typename T>
+void addToVersionHash(const T& aValue, uint64_t& aHash)
+{
+  static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be hashed");
+
+  const auto* bytes = reinterpret_cast<const unsigned char*>(&aValue);
+  for (size_t idx = 0; idx < sizeof(T); ++idx)
+  {
+    aHash = (aHash ^ bytes[idx]) * Constants::kVersionPrime;
+  }
+}
+
+/**
+ * Set the type and color of the first component of a lane border for the given marking.
+ *
+ * @param[in] aMarking Marking of the lane border.
+ * @param[in] aLeftSide True for the left border of a road, which is relevant for curbs.
+ * @param[out] aComponent First component of the lane border.
+ * @param[out] aLaneBorder Lane border of which the width is set.
+ */
+void setBorderMarking(const TSyntheticBorderMarking   aMarking,
+                      const bool                      aLeftSide,
+                      CAutoStreamLaneBorderComponent& aComponent,
+                      CAutoStreamLaneBorder&          aLaneBorder)
+{
+  aComponent.mColor    = AutoStream::HdMap::HdRoad::kLaneBorderColorWhite;
+  aLaneBorder.mWidthCm = Constants::kPaintedBorderWidthCm;
+
+  switch (aMarking)
+  {
+    case TSyntheticBorderMarking::LongDashedLine:
+      aComponent.mType = AutoStream::HdMap::HdRoad::kLaneBorderTypeRoadSurfaceLongDashedLine;
+      return;
+    case TSyntheticBorderMarking::ShortDashedLine:
+      aComponent.mType = AutoStream::HdMap::HdRoad::kLaneBorderTypeRoadSurfaceShortDashedLine;
+      return;
+    case TSyntheticBorderMarking::SolidLine:
+      aComponent.mType = AutoStream::HdMap::HdRoad::kLaneBorderTypeRoadSurfaceSingleSolidLine;
+      return;
+    case TSyntheticBorderMarking::DoubleLine:
+      aComponent.mType  = AutoStream::HdMap::HdRoad::kLaneBorderTypeRoadSurfaceSingleSolidLine;
+      aComponent.mColor = AutoStream::HdMap::HdRoad::kLaneBorderColorYellow;
+      return;
+    case TSyntheticBorderMarking::NoMarking:
+      aComponent.mType = AutoStream::HdMap::HdRoad::kLaneBorderTypeRoadSurfaceNoMarking;
+      break;
+    case TSyntheticBorderMarking::Curb:
+      aComponent.mType = aLeftSide ? AutoStream::HdMap::HdRoad::kLaneBorderTypeCurbLeftCurb
+                                   : AutoStream::HdMap::HdRoad::kLaneBorderTypeCurbRightCurb;
+      break;
+    case TSyntheticBorderMarking::Guardrail:
+      aComponent.mType = AutoStream::HdMap::HdRoad::kLaneBorderTypePhysicalBarrierGuardrail;
+      break;
+    case TSyntheticBorderMarking::Fence:
+      aComponent.mType = AutoStream::HdMap::HdRoad::kLaneBorderTypePhysicalBarrierFence;
+      break;
+  }
+
+  // Borders that are not painted have no color and width
+  aComponent.mColor    = AutoStream::HdMap::HdRoad::kLaneBorderColorUnknown;
+  aLaneBorder.mWidthCm = 0;
+}
+
+CSyntheticMapParameters::CSyntheticMapParameters()
+  : mNumberOfArcs(1000)
+  , mArcsPerRoad(100)
+  , mNumberOfLanes(3)
+  , mArcLengthMeter(50.0)
+  , mLaneWidthMeter(3.5)
+  , mPointsPerBorder(11)
+  , mParkingAreaInterval(10)
+  , mTriangularLaneInterval(20)
+  , mTrafficSignsPerKilometer(4.0)
+  , mRightBorder(TSyntheticBorderMarking::Curb)
+  , mLeftBorder(TSyntheticBorderMarking::Guardrail)
+  , mInnerBorders({ TSyntheticBorderMarking::LongDashedLine,
+                    TSyntheticBorderMarking::ShortDashedLine,
+                    TSyntheticBorderMarking::DoubleLine })
+  , mConnectionGapInterval(0)
+  , mTwoWayRoadInterval(0)
+  , mOriginLatDeg(52.0)
+  , mOriginLonDeg(5.0)
+{
+}
+
+CAutoStreamSyntheticMapSource::CAutoStreamSyntheticMapSource(
+  const CSyntheticMapParameters& aParameters)
+  : mParameters(aParameters)
+{
+  // Degenerate parameters are raised to the smallest map that can be converted
+  mParameters.mArcsPerRoad     = std::max<size_t>(mParameters.mArcsPerRoad, 1);
+  mParameters.mNumberOfLanes   = std::max<uint32_t>(mParameters.mNumberOfLanes, 1);
+  mParameters.mPointsPerBorder = std::max<uint32_t>(mParameters.mPointsPerBorder, 2);
+
+  mNumberOfRoads =
+    (mParameters.mNumberOfArcs + mParameters.mArcsPerRoad - 1) / mParameters.mArcsPerRoad;
+  mRoadSpacingMeter =
+    (mParameters.mNumberOfLanes + 2) * mParameters.mLaneWidthMeter + Constants::kRoadGapMeter;
+  mMetersPerDegreeLon =
+    Constants::kMetersPerDegreeLat * std::cos(mParameters.mOriginLatDeg * Constants::kDeg2rad);
+
+  mTrafficSignsPerRoad = getNumberOfTrafficSignsOnRoad(0);
+
+  uint64_t hash = Constants::kVersionOffsetBasis;
+  addToVersionHash(mParameters.mNumberOfArcs, hash);
+  addToVersionHash(mParameters.mArcsPerRoad, hash);
+  addToVersionHash(mParameters.mNumberOfLanes, hash);
+  addToVersionHash(mParameters.mArcLengthMeter, hash);
+  addToVersionHash(mParameters.mLaneWidthMeter, hash);
+  addToVersionHash(mParameters.mPointsPerBorder, hash);
+  addToVersionHash(mParameters.mParkingAreaInterval, hash);
+  addToVersionHash(mParameters.mTriangularLaneInterval, hash);
+  addToVersionHash(mParameters.mTrafficSignsPerKilometer, hash);
+  addToVersionHash(mParameters.mRightBorder, hash);
+  addToVersionHash(mParameters.mLeftBorder, hash);
+  addToVersionHash(mParameters.mInnerBorders.size(), hash);
+  for (const auto marking : mParameters.mInnerBorders)
+  {
+    addToVersionHash(marking, hash);
+  }
+  addToVersionHash(mParameters.mConnectionGapInterval, hash);
+  addToVersionHash(mParameters.mTwoWayRoadInterval, hash);
+  addToVersionHash(mParameters.mOriginLatDeg, hash);
+  addToVersionHash(mParameters.mOriginLonDeg, hash);
+
+  // The map version is only compared byte-wise, the hash is stored in its leading bytes
+  static_assert(std::is_trivially_copyable<AutoStream::CMapVersionAndHash>::value,
+                "Map versions are compared byte-wise");
+  std::memset(&mMapVersionAndHash, 0, sizeof(mMapVersionAndHash));
+  std::memcpy(&mMapVersionAndHash, &hash, std::min(sizeof(hash), sizeof(mMapVersionAndHash)));
+}
+
+AutoStream::TBoundingBox CAutoStreamSyntheticMapSource::getBoundingBox() const
+{
+  const double width    = mParameters.mLaneWidthMeter;
+  const size_t lastRoad = mNumberOfRoads > 0 ? mNumberOfRoads - 1 : 0;
+  const size_t arcsOnFirstRoad = getNumberOfArcsOnRoad(0);
+
+  return AutoStream::TBoundingBox(
+    toCoordinate(0.0, -width - Constants::kTrafficSignDistanceMeter),
+    toCoordinate(arcsOnFirstRoad * mParameters.mArcLengthMeter,
+                 lastRoad * mRoadSpacingMeter + (mParameters.mNumberOfLanes + 1) * width));
+}
+
+AutoStream::CMapVersionAndHash CAutoStreamSyntheticMapSource::getMapVersionAndHash() const
+{
+  return mMapVersionAndHash;
+}
+
+std::vector<AutoStream::HdMap::TArcKey>
+CAutoStreamSyntheticMapSource::getArcKeysInArea(const AutoStream::TBoundingBox& aArea)
+{
+  double west = 0., south = 0., east = 0., north = 0.;
+  toMeters(aArea, west, south, east, north);
+
+  // Lanes of a road lie between a parking area and a triangular lane
+  size_t firstRoad = 0, endRoad = 0;
+  getRoadsInArea(south,
+                 north,
+                 -mParameters.mLaneWidthMeter,
+                 (mParameters.mNumberOfLanes + 1) * mParameters.mLaneWidthMeter,
+                 firstRoad,
+                 endRoad);
+
+  std::vector<AutoStream::HdMap::TArcKey> keys;
+  if (east < 0.0)
+  {
+    return keys;
+  }
+
+  // Arc k of a road covers k * length up to (k + 1) * length
+  const double length   = mParameters.mArcLengthMeter;
+  const size_t firstArc = static_cast<size_t>(std::max(std::ceil(west / length) - 1.0, 0.0));
+  const size_t lastArc  = static_cast<size_t>(std::floor(east / length));
+  for (size_t road = firstRoad; road < endRoad; ++road)
+  {
+    const size_t arcsOnRoad = getNumberOfArcsOnRoad(road);
+    for (size_t position = firstArc; position <= lastArc && position < arcsOnRoad; ++position)
+    {
+      keys.push_back(
+        toSyntheticKey<AutoStream::HdMap::TArcKey>(road * mParameters.mArcsPerRoad + position));
+    }
+  }
+
+  std::sort(keys.begin(), keys.end());
+  return keys;
+}
+
+CAutoStreamArcData CAutoStreamSyntheticMapSource::getArc(const AutoStream::HdMap::TArcKey& aArcKey)
+{
+  size_t arcIdx = 0;
+  if (!fromSyntheticKey(aArcKey, arcIdx) || arcIdx >= mParameters.mNumberOfArcs)
+  {
+    throw std::runtime_error("Arc is not part of the synthetic map.");
+  }
+
+  const size_t     road          = arcIdx / mParameters.mArcsPerRoad;
+  const size_t     position      = arcIdx % mParameters.mArcsPerRoad;
+  const CArcLayout layout        = getArcLayout(position);
+  const uint32_t   numberOfLanes = layout.getNumberOfLanes(mParameters.mNumberOfLanes);
+
+  CAutoStreamArcData arcData;
+  for (uint32_t laneIdx = 0; laneIdx < numberOfLanes; ++laneIdx)
+  {
+    addLane(arcIdx, layout, laneIdx, arcData);
+  }
+
+  // Number of lane borders equals number of lanes plus one
+  for (uint32_t borderIdx = 0; borderIdx <= numberOfLanes; ++borderIdx)
+  {
+    arcData.mLaneBorders.push_back(getLaneBorder(road, position, layout, borderIdx));
+  }
+
+  return arcData;
+}
+
+void CAutoStreamSyntheticMapSource::prefetchArc(const AutoStream::HdMap::TArcKey& /*aArcKey*/)
+{
+}
+
+std::vector<AutoStream::HdMap::TTrafficSignKey>
+CAutoStreamSyntheticMapSource::getTrafficSignKeysInArea(const AutoStream::TBoundingBox& aArea)
+{
+  std::vector<AutoStream::HdMap::TTrafficSignKey> keys;
+  if (mTrafficSignsPerRoad == 0)
+  {
+    return keys;
+  }
+
+  double west = 0., south = 0., east = 0., north = 0.;
+  toMeters(aArea, west, south, east, north);
+
+  const double offset = -mParameters.mLaneWidthMeter - Constants::kTrafficSignDistanceMeter;
+  size_t       firstRoad = 0, endRoad = 0;
+  getRoadsInArea(south, north, offset, offset, firstRoad, endRoad);
+
+  // Sign j of a road is placed at (j + 0.5) * spacing
+  const double spacing = Constants::kMetersPerKilometer / mParameters.mTrafficSignsPerKilometer;
+  const double last    = std::floor(east / spacing - 0.5);
+  if (last < 0.0)
+  {
+    return keys;
+  }
+
+  const size_t firstSign = static_cast<size_t>(std::max(std::ceil(west / spacing - 0.5), 0.0));
+  const size_t lastSign  = static_cast<size_t>(last);
+  for (size_t road = firstRoad; road < endRoad; ++road)
+  {
+    const size_t signsOnRoad = getNumberOfTrafficSignsOnRoad(road);
+    for (size_t sign = firstSign; sign <= lastSign && sign < signsOnRoad; ++sign)
+    {
+      keys.push_back(
+        toSyntheticKey<AutoStream::HdMap::TTrafficSignKey>(road * mTrafficSignsPerRoad + sign));
+    }
+  }
+
+  std::sort(keys.begin(), keys.end());
+  return keys;
+}
+
+CAutoStreamTrafficSignData CAutoStreamSyntheticMapSource::getTrafficSign(
+  const AutoStream::HdMap::TTrafficSignKey& aTrafficSignKey)
+{
+  size_t signIdx = 0;
+  if (!fromSyntheticKey(aTrafficSignKey, signIdx) || mTrafficSignsPerRoad == 0
+      || signIdx / mTrafficSignsPerRoad >= mNumberOfRoads
+      || signIdx % mTrafficSignsPerRoad
+           >= getNumberOfTrafficSignsOnRoad(signIdx / mTrafficSignsPerRoad))
+  {
+    throw std::runtime_error("Traffic sign is not part of the synthetic map.");
+  }
+
+  const size_t road    = signIdx / mTrafficSignsPerRoad;
+  const size_t sign    = signIdx % mTrafficSignsPerRoad;
+  const double spacing = Constants::kMetersPerKilometer / mParameters.mTrafficSignsPerKilometer;
+  const double north   = road * mRoadSpacingMeter - mParameters.mLaneWidthMeter
+                       - Constants::kTrafficSignDistanceMeter;
+
+  CAutoStreamTrafficSignData trafficSign {
+    AutoStream::TCoordinate3D(toCoordinate((sign + 0.5) * spacing, north),
+                              Constants::kTrafficSignHeightMm),
+    Constants::kTrafficSignNormalDeg,
+    AutoStream::HdMap::HdMapTrafficSignLayer::TSignSize()
+  };
+  trafficSign.mSize.widthCentimeter  = Constants::kTrafficSignSizeCm;
+  trafficSign.mSize.heightCentimeter = Constants::kTrafficSignSizeCm;
+  return trafficSign;
+}
+
+uint32_t CAutoStreamSyntheticMapSource::CArcLayout::getFirstRegularLane() const noexcept
+{
+  return mParkingArea ? 1 : 0;
+}
+
+uint32_t CAutoStreamSyntheticMapSource::CArcLayout::getNumberOfLanes(
+  const uint32_t aNumberOfRegularLanes) const noexcept
+{
+  const uint32_t triangularLanes = (mDivergingLane || mConvergingLane) ? 1 : 0;
+  return getFirstRegularLane() + aNumberOfRegularLanes + triangularLanes;
+}
+
+CAutoStreamSyntheticMapSource::CArcLayout
+CAutoStreamSyntheticMapSource::getArcLayout(const size_t aPosition) const noexcept
+{
+  CArcLayout layout {};
+
+  const size_t parkingInterval = mParameters.mParkingAreaInterval;
+  layout.mParkingArea          = parkingInterval > 0 && (aPosition + 1) % parkingInterval == 0;
+
+  // A triangular lane opens in one arc and closes in the next one
+  const size_t triangularInterval = mParameters.mTriangularLaneInterval;
+  if (triangularInterval >= Constants::kMinTriangularInterval)
+  {
+    layout.mDivergingLane  = aPosition % triangularInterval == triangularInterval - 2;
+    layout.mConvergingLane = aPosition % triangularInterval == triangularInterval - 1;
+  }
+
+  return layout;
+}
+
+size_t CAutoStreamSyntheticMapSource::getNumberOfArcsOnRoad(const size_t aRoad) const noexcept
+{
+  const size_t firstArc = aRoad * mParameters.mArcsPerRoad;
+  if (firstArc >= mParameters.mNumberOfArcs)
+  {
+    return 0;
+  }
+
+  return std::min(mParameters.mArcsPerRoad, mParameters.mNumberOfArcs - firstArc);
+}
+
+size_t
+CAutoStreamSyntheticMapSource::getNumberOfTrafficSignsOnRoad(const size_t aRoad) const noexcept
+{
+  if (mParameters.mTrafficSignsPerKilometer <= 0.0)
+  {
+    return 0;
+  }
+
+  const double roadLength = getNumberOfArcsOnRoad(aRoad) * mParameters.mArcLengthMeter;
+  return static_cast<size_t>(std::floor(roadLength * mParameters.mTrafficSignsPerKilometer
+                                        / Constants::kMetersPerKilometer));
+}
+
+double CAutoStreamSyntheticMapSource::getBorderOffset(const CArcLayout& aLayout,
+                                                      const uint32_t    aBorderIdx,
+                                                      const double      aFraction) const noexcept
+{
+  const double   width        = mParameters.mLaneWidthMeter;
+  const uint32_t firstRegular = aLayout.getFirstRegularLane();
+  const uint32_t lanes        = mParameters.mNumberOfLanes;
+
+  // Right border of the parking area
+  if (aBorderIdx < firstRegular)
+  {
+    return -width;
+  }
+
+  if (aBorderIdx <= firstRegular + lanes)
+  {
+    return (aBorderIdx - firstRegular) * width;
+  }
+
+  // Left border of the triangular lane meets the left border of the regular lanes at the tip.
+  // Interpolating this way returns the end points exactly, such that the tip points are equal.
+  const double start = aLayout.mDivergingLane ? lanes * width : (lanes + 1) * width;
+  const double end   = aLayout.mDivergingLane ? (lanes + 1) * width : lanes * width;
+  return (1.0 - aFraction) * start + aFraction * end;
+}
+
+TSyntheticBorderMarking
+CAutoStreamSyntheticMapSource::getBorderMarking(const size_t      aRoad,
+                                                const CArcLayout& aLayout,
+                                                const uint32_t    aBorderIdx) const noexcept
+{
+  const uint32_t firstRegular = aLayout.getFirstRegularLane();
+  const uint32_t lastBorder   = aLayout.getNumberOfLanes(mParameters.mNumberOfLanes);
+  const auto&    inner        = mParameters.mInnerBorders;
+
+  // Physical borders at the outside, markings in between, inner markings vary between roads
+  if (aBorderIdx == 0)
+  {
+    return mParameters.mRightBorder;
+  }
+  if (aBorderIdx == lastBorder)
+  {
+    return mParameters.mLeftBorder;
+  }
+  if (aBorderIdx == firstRegular)
+  {
+    return TSyntheticBorderMarking::SolidLine;
+  }
+  if (aBorderIdx == firstRegular + mParameters.mNumberOfLanes)
+  {
+    return TSyntheticBorderMarking::ShortDashedLine;
+  }
+  if (inner.empty())
+  {
+    return TSyntheticBorderMarking::LongDashedLine;
+  }
+
+  return inner[(aBorderIdx + aRoad) % inner.size()];
+}
+
+CAutoStreamLaneBorder CAutoStreamSyntheticMapSource::getLaneBorder(const size_t      aRoad,
+                                                                   const size_t      aPosition,
+                                                                   const CArcLayout& aLayout,
+                                                                   const uint32_t aBorderIdx) const
+{
+  const TSyntheticBorderMarking marking    = getBorderMarking(aRoad, aLayout, aBorderIdx);
+  const bool                    doubleLine = marking == TSyntheticBorderMarking::DoubleLine;
+
+  CAutoStreamLaneBorderComponent component;
+  CAutoStreamLaneBorder          laneBorder;
+  setBorderMarking(marking, aBorderIdx > 0, component, laneBorder);
+
+  // Points are spread evenly, the last point of an arc equals the first point of the next arc.
+  // A double line gets a second line to the north, only the first line is converted.
+  const uint32_t numberOfPoints = mParameters.mPointsPerBorder;
+  const double   north          = aRoad * mRoadSpacingMeter;
+  CAutoStreamLaneBorderComponent secondComponent;
+  secondComponent.mType  = AutoStream::HdMap::HdRoad::kLaneBorderTypeRoadSurfaceLongDashedLine;
+  secondComponent.mColor = component.mColor;
+  for (uint32_t pointIdx = 0; pointIdx < numberOfPoints; ++pointIdx)
+  {
+    const double fraction  = static_cast<double>(pointIdx) / (numberOfPoints - 1);
+    const double east      = (aPosition + fraction) * mParameters.mArcLengthMeter;
+    const double lineNorth = north + getBorderOffset(aLayout, aBorderIdx, fraction);
+    component.mLine.emplace_back(toCoordinate(east, lineNorth), 0);
+    if (doubleLine)
+    {
+      const double secondNorth = lineNorth + Constants::kDoubleLineSpacingMeter;
+      secondComponent.mLine.emplace_back(toCoordinate(east, secondNorth), 0);
+    }
+  }
+
+  laneBorder.mComponents.push_back(std::move(component));
+  if (doubleLine)
+  {
+    laneBorder.mComponents.push_back(std::move(secondComponent));
+  }
+
+  return laneBorder;
+}
+
+void CAutoStreamSyntheticMapSource::addLane(const size_t        aArcIdx,
+                                            const CArcLayout&   aLayout,
+                                            const uint32_t      aLaneIdx,
+                                            CAutoStreamArcData& aArcData) const
+{
+  const size_t   road           = aArcIdx / mParameters.mArcsPerRoad;
+  const size_t   position       = aArcIdx % mParameters.mArcsPerRoad;
+  const uint32_t lanes          = mParameters.mNumberOfLanes;
+  const uint32_t firstRegular   = aLayout.getFirstRegularLane();
+  const bool     isParkingArea  = aLaneIdx < firstRegular;
+  const bool     isTriangular   = aLaneIdx >= firstRegular + lanes;
+  const bool     isUrbanRoad    = road % 2 == 0;
+  const size_t   twoWayInterval = mParameters.mTwoWayRoadInterval;
+  const size_t   gapInterval    = mParameters.mConnectionGapInterval;
+
+  CAutoStreamLaneMetaData metaData;
+  metaData.mDrivingSide            = AutoStream::HdMap::HdRoad::TDrivingSide::kDrivingSideRight;
+  metaData.mOpposingTrafficAllowed = twoWayInterval > 0 && (road + 1) % twoWayInterval == 0;
+  metaData.mLaneWidthCm =
+    static_cast<uint32_t>(std::lround(mParameters.mLaneWidthMeter / Constants::kCm2meter));
+  metaData.mLaneLengthCm =
+    static_cast<uint32_t>(std::lround(mParameters.mArcLengthMeter / Constants::kCm2meter));
+  metaData.mType                 = AutoStream::HdMap::HdRoad::TLaneType::kLaneTypeDrivable;
+  metaData.mInvalidConnectionOut = false;
+  if (isParkingArea)
+  {
+    metaData.mType = AutoStream::HdMap::HdRoad::TLaneType::kLaneTypeParking;
+  }
+  else if (aLaneIdx == firstRegular && !isUrbanRoad)
+  {
+    metaData.mType = AutoStream::HdMap::HdRoad::TLaneType::kLaneTypeBus;
+  }
+
+  // Lanes continue on the next arc of the same road, parking areas are not connected
+  const bool isGap = gapInterval > 0 && (position + 1) % gapInterval == 0;
+  if (!isParkingArea && !isGap && position + 1 < getNumberOfArcsOnRoad(road))
+  {
+    const CArcLayout                 next         = getArcLayout(position + 1);
+    const uint32_t                   nextRegular  = next.getFirstRegularLane();
+    const AutoStream::HdMap::TArcKey nextKey =
+      toSyntheticKey<AutoStream::HdMap::TArcKey>(aArcIdx + 1);
+
+    if (!isTriangular)
+    {
+      metaData.mConnectionsOut.emplace_back(nextKey, nextRegular + aLaneIdx - firstRegular);
+
+      // The left-most lane also continues on a diverging triangular lane
+      if (aLaneIdx == firstRegular + lanes - 1 && next.mDivergingLane)
+      {
+        metaData.mConnectionsOut.emplace_back(nextKey, nextRegular + lanes);
+      }
+    }
+    else if (aLayout.mDivergingLane && next.mConvergingLane)
+    {
+      metaData.mConnectionsOut.emplace_back(nextKey, nextRegular + lanes);
+    }
+    else
+    {
+      // A converging triangular lane ends on the left-most lane
+      metaData.mConnectionsOut.emplace_back(nextKey, nextRegular + lanes - 1);
+    }
+  }
+
+  CAutoStreamSpeedLimit speedLimit {};
+  if (!isParkingArea)
+  {
+    speedLimit.mNumberOfRestrictions = 1;
+    speedLimit.mValue =
+      isUrbanRoad ? Constants::kUrbanSpeedLimitKmh : Constants::kRuralSpeedLimitKmh;
+    speedLimit.mUnit = AutoStream::HdMap::HdMapSpeedRestrictionLayer::kSpeedUnitKmh;
+  }
+
+  aArcData.mLaneMetaData.push_back(std::move(metaData));
+  aArcData.mSpeedLimits.push_back(speedLimit);
+}
+
+AutoStream::TCoordinate CAutoStreamSyntheticMapSource::toCoordinate(const double aEastMeter,
+                                                                    const double aNorthMeter) const
+{
+  return AutoStream::TCoordinate::createFromDegrees(
+    mParameters.mOriginLatDeg + aNorthMeter / Constants::kMetersPerDegreeLat,
+    mParameters.mOriginLonDeg + aEastMeter / mMetersPerDegreeLon);
+}
+
+void CAutoStreamSyntheticMapSource::toMeters(const AutoStream::TBoundingBox& aArea,
+                                             double&                         aWestMeter,
+                                             double&                         aSouthMeter,
+                                             double&                         aEastMeter,
+                                             double&                         aNorthMeter) const
+{
+  aWestMeter =
+    (aArea.getCornerSW().getLonDegree() - mParameters.mOriginLonDeg) * mMetersPerDegreeLon;
+  aSouthMeter = (aArea.getCornerSW().getLatDegree() - mParameters.mOriginLatDeg)
+                * Constants::kMetersPerDegreeLat;
+  aEastMeter =
+    (aArea.getCornerNE().getLonDegree() - mParameters.mOriginLonDeg) * mMetersPerDegreeLon;
+  aNorthMeter = (aArea.getCornerNE().getLatDegree() - mParameters.mOriginLatDeg)
+                * Constants::kMetersPerDegreeLat;
+}
+
+void CAutoStreamSyntheticMapSource::getRoadsInArea(const double aSouthMeter,
+                                                   const double aNorthMeter,
+                                                   const double aMinOffsetMeter,
+                                                   const double aMaxOffsetMeter,
+                                                   size_t&      aFirstRoad,
+                                                   size_t&      aEndRoad) const noexcept
+{
+  aFirstRoad = 0;
+  aEndRoad   = 0;
+
+  // Road r covers r * spacing + minimum offset up to r * spacing + maximum offset
+  const double first = std::ceil((aSouthMeter - aMaxOffsetMeter) / mRoadSpacingMeter);
+  const double last  = std::floor((aNorthMeter - aMinOffsetMeter) / mRoadSpacingMeter);
+  if (last < 0.0 || first > last)
+  {
+    return;
+  }
+
+  aFirstRoad = static_cast<size_t>(std::max(first, 0.0));
+  aEndRoad   = std::min(static_cast<size_t>(last) + 1, mNumberOfRoads);
+}
+}
+}
+}
@@ -0,0 +1,230 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#include "AutoStreamMapConverter/TraceRecorder.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+namespace Constants {
+// Maximum number of spans kept by a recorder, about 64 bytes each
+constexpr size_t kMaxTraceEvents = 1 << 22;
+
+// Number of spans buffered by a thread before they are handed to the recorder
+constexpr size_t kTraceBufferSize = 4096;
+
+constexpr double kNanoseconds2microseconds = 0.001;
+}
+
+/**
+ * Write the bytes of an arc key as hexadecimal digits.
+ *
+ * @param[in, out] aOutput Stream to which the key must be written.
+ * @param[in] aArcKey Arc key.
+ */
+void writeArcKeyHex(std::ostream& aOutput, const AutoStream::HdMap::TArcKey& aArcKey)
+{
+  unsigned char bytes[sizeof(AutoStream::HdMap::TArcKey)];
+  std::memcpy(bytes, &aArcKey, sizeof(bytes));
+
+  aOutput << std::hex << std::setfill('0');
+  for (const unsigned char byte : bytes)
+  {
+    aOutput << std::setw(2) << static_cast<unsigned int>(byte);
+  }
+  aOutput << std::dec << std::setfill(' ');
+}
+
+CTraceRecorder::CTraceRecorder()
+  : mStart(TTraceClock::now())
+  , mNumberOfDroppedEvents(0)
+  , mMaxThreadId(0)
+{
+}
+
+void CTraceRecorder::start()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mStart = TTraceClock::now();
+  mEvents.clear();
+  mNumberOfDroppedEvents = 0;
+  mMaxThreadId           = 0;
+}
+
+TTraceClock::time_point CTraceRecorder::getStart() const noexcept
+{
+  return mStart;
+}
+
+void CTraceRecorder::addEvents(std::vector<CTraceEvent>& aEvents)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+
+  const size_t numberOfKept =
+    std::min(aEvents.size(), Constants::kMaxTraceEvents - std::min(mEvents.size(),
+                                                                   Constants::kMaxTraceEvents));
+  mEvents.insert(mEvents.end(), aEvents.begin(), aEvents.begin() + numberOfKept);
+  mNumberOfDroppedEvents += aEvents.size() - numberOfKept;
+  for (const CTraceEvent& event : aEvents)
+  {
+    mMaxThreadId = std::max(mMaxThreadId, event.mThreadId);
+  }
+
+  aEvents.clear();
+}
+
+bool CTraceRecorder::store(const std::string& aFileName) const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+
+  std::ofstream output(aFileName, std::ios::out | std::ios::trunc);
+  if (!output)
+  {
+    return false;
+  }
+
+  // Complete events ("X") with timestamps in microseconds, preceded by the thread names
+  output << std::fixed << std::setprecision(3);
+  output << "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedEvents\":"
+         << mNumberOfDroppedEvents << "},\"traceEvents\":[\n";
+  for (uint32_t threadId = 0; threadId <= mMaxThreadId; ++threadId)
+  {
+    output << (threadId == 0 ? "" : ",\n")
+           << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << threadId
+           << ",\"args\":{\"name\":\"";
+    if (threadId == 0)
+    {
+      output << "conversion";
+    }
+    else
+    {
+      output << "worker " << threadId;
+    }
+    output << "\"}}";
+  }
+
+  for (const CTraceEvent& event : mEvents)
+  {
+    output << ",\n{\"name\":\"" << event.mName << "\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+           << event.mThreadId << ",\"ts\":" << event.mStartNs * Constants::kNanoseconds2microseconds
+           << ",\"dur\":" << event.mDurationNs * Constants::kNanoseconds2microseconds;
+    if (event.mHasArcKey || event.mHasLaneCount)
+    {
+      output << ",\"args\":{";
+      if (event.mHasArcKey)
+      {
+        output << "\"arcKey\":\"";
+        writeArcKeyHex(output, event.mArcKey);
+        output << "\"" << (event.mHasLaneCount ? "," : "");
+      }
+      if (event.mHasLaneCount)
+      {
+        output << "\"lanes\":" << event.mLaneCount;
+      }
+      output << "}";
+    }
+    output << "}";
+  }
+  output << "\n]}\n";
+
+  return static_cast<bool>(output);
+}
+
+CTraceBuffer::CTraceBuffer(CTraceRecorder& aRecorder, const uint32_t aThreadId)
+  : mRecorder(aRecorder)
+  , mThreadId(aThreadId)
+{
+  mEvents.reserve(Constants::kTraceBufferSize);
+}
+
+CTraceBuffer::~CTraceBuffer()
+{
+  try
+  {
+    flush();
+  }
+  catch (...)
+  {
+    // Losing spans is preferred over terminating the conversion
+  }
+}
+
+void CTraceBuffer::addSpan(CTraceEvent                   aEvent,
+                           const TTraceClock::time_point aStart,
+                           const TTraceClock::time_point aEnd)
+{
+  aEvent.mThreadId   = mThreadId;
+  aEvent.mStartNs    = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      aStart - mRecorder.getStart())
+                      .count();
+  aEvent.mDurationNs = std::chrono::duration_cast<std::chrono::nanoseconds>(aEnd - aStart).count();
+  mEvents.push_back(aEvent);
+
+  if (mEvents.size() >= Constants::kTraceBufferSize)
+  {
+    flush();
+  }
+}
+
+void CTraceBuffer::flush()
+{
+  if (!mEvents.empty())
+  {
+    mRecorder.addEvents(mEvents);
+  }
+}
+
+CTraceSpan::CTraceSpan(CTraceBuffer* aBuffer, const char* aName)
+  : mBuffer(aBuffer)
+  , mEvent()
+{
+  if (mBuffer != nullptr)
+  {
+    mEvent.mName = aName;
+    mStart       = TTraceClock::now();
+  }
+}
+
+CTraceSpan::~CTraceSpan()
+{
+  if (mBuffer != nullptr)
+  {
+    try
+    {
+      mBuffer->addSpan(mEvent, mStart, TTraceClock::now());
+    }
+    catch (...)
+    {
+      // Losing a span is preferred over terminating the conversion
+    }
+  }
+}
+
+void CTraceSpan::setArcKey(const AutoStream::HdMap::TArcKey& aArcKey) noexcept
+{
+  mEvent.mHasArcKey = true;
+  mEvent.mArcKey    = aArcKey;
+}
+
+void CTraceSpan::setLaneCount(const size_t aLaneCount) noexcept
+{
+  mEvent.mHasLaneCount = true;
+  mEvent.mLaneCount    = static_cast<uint32_t>(aLaneCount);
+}
+}
+}
+}
@@ -13,8 +13,6 @@
 
 #include "AutoStreamMapConverter/ConversionHelpers.hpp"
 
-#include "TomTom/AutoStream/HdMap/HdMapTrafficSigns.h"
-
 #include <lanelet2_core/LaneletMap.h>
 
 namespace TomTom {
@@ -28,20 +26,13 @@ CAutoStreamTrafficSignConverter::CAutoStreamTrafficSignConverter(
 }
 
 bool CAutoStreamTrafficSignConverter::convertTrafficSign(
-  const AutoStream::HdMap::TTrafficSign& aTrafficSign,
-  const AutoStream::HdMap::CHdMapAccess* aMapAccess,
-  lanelet::Polygon3d&                    aTrafficSignPolygon) const
+  const CAutoStreamTrafficSignData& aTrafficSign,
+  CIdAllocator&                     aIdAllocator,
+  lanelet::Polygon3d&               aTrafficSignPolygon) const
 {
-  // Collect data needed for reconstructing bounding box around traffic sign
-  const AutoStream::TCoordinate3D centerOfMass =
-    aMapAccess->getTrafficSigns().getCenterOfMass(aTrafficSign);
-  double headingNormalDeg =
-    aMapAccess->getTrafficSigns().getNormal(aTrafficSign) * Constants::kMilliDeg2deg;
-  const AutoStream::HdMap::HdMapTrafficSignLayer::TSignSize size =
-    aMapAccess->getTrafficSigns().getSize(aTrafficSign);
-
   // Complete traffic sign
-  aTrafficSignPolygon = getTrafficSignBoundingBox(centerOfMass, headingNormalDeg, size);
+  aTrafficSignPolygon = getTrafficSignBoundingBox(
+    aTrafficSign.mCenterOfMass, aTrafficSign.mNormalDeg, aTrafficSign.mSize, aIdAllocator);
   aTrafficSignPolygon.attributes()[lanelet::AttributeName::Type] =
     lanelet::AttributeValueString::TrafficSign;
 
@@ -51,7 +42,8 @@ bool CAutoStreamTrafficSignConverter::convertTrafficSign(
 lanelet::Polygon3d CAutoStreamTrafficSignConverter::getTrafficSignBoundingBox(
   const AutoStream::TCoordinate3D&                           aPosition,
   const double&                                              aNormal,
-  const AutoStream::HdMap::HdMapTrafficSignLayer::TSignSize& aSize) const
+  const AutoStream::HdMap::HdMapTrafficSignLayer::TSignSize& aSize,
+  CIdAllocator&                                              aIdAllocator) const
 {
   // Position
   const AutoStream::TCoordinate pos          = aPosition.getXY();
@@ -69,12 +61,12 @@ lanelet::Polygon3d CAutoStreamTrafficSignConverter::getTrafficSignBoundingBox(
   const auto high      = heightSignMm + halfSignHeightMm;
 
   // Convert sign corner points to UTM
-  const lanelet::Point3d lowerLeft  = toUtm({ leftEdge, low }, mUtmProjector);
-  const lanelet::Point3d upperLeft  = toUtm({ leftEdge, high }, mUtmProjector);
-  const lanelet::Point3d lowerRight = toUtm({ rightEdge, low }, mUtmProjector);
-  const lanelet::Point3d upperRight = toUtm({ rightEdge, high }, mUtmProjector);
+  const lanelet::Point3d lowerLeft  = toUtm({ leftEdge, low }, mUtmProjector, aIdAllocator);
+  const lanelet::Point3d upperLeft  = toUtm({ leftEdge, high }, mUtmProjector, aIdAllocator);
+  const lanelet::Point3d lowerRight = toUtm({ rightEdge, low }, mUtmProjector, aIdAllocator);
+  const lanelet::Point3d upperRight = toUtm({ rightEdge, high }, mUtmProjector, aIdAllocator);
 
-  return lanelet::Polygon3d(lanelet::utils::getId(),
+  return lanelet::Polygon3d(aIdAllocator.getId(),
                             { lowerLeft, upperLeft, upperRight, lowerRight });
 }
 
@@ -0,0 +1,223 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#include "AutoStreamMapConverter/UtmBatchProjector.hpp"
+#include "AutoStreamMapConverter/ConversionHelpers.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+namespace Constants {
+// WGS84 ellipsoid and UTM parameters
+constexpr double kWgs84SemiMajorAxisMeters = 6378137.;
+constexpr double kWgs84Flattening          = 1. / 298.257223563;
+constexpr double kUtmScaleFactor           = 0.9996;
+constexpr double kUtmFalseEastingMeters    = 5e5;
+constexpr double kUtmFalseNorthingMeters   = 1e7;
+
+// Latitude range covered by UTM, the polar regions are covered by UPS
+constexpr double kUtmMinLatDeg = -80.;
+constexpr double kUtmMaxLatDeg = 84.;
+}
+
+/**
+ * Get the central meridian of the standard UTM zone for the given coordinate, including the
+ * exceptions for Norway and Svalbard.
+ *
+ * @param[in] aLatDeg Latitude in degrees, must be within the UTM latitude range.
+ * @param[in] aLonDeg Longitude in degrees.
+ * @retval double Central meridian of the zone in degrees.
+ */
+double getCentralMeridianDeg(const double aLatDeg, const double aLonDeg)
+{
+  int lon = static_cast<int>(std::floor(aLonDeg));
+  if (lon >= 180)
+  {
+    lon -= 360;
+  }
+  else if (lon < -180)
+  {
+    lon += 360;
+  }
+
+  int       zone = (lon + 186) / 6;
+  const int band = std::min(9, (static_cast<int>(std::floor(aLatDeg)) + 80) / 8 - 10);
+  if (band == 7 && zone == 31 && lon >= 3)
+  {
+    // Norway
+    zone = 32;
+  }
+  else if (band == 9 && lon >= 0 && lon < 42)
+  {
+    // Svalbard
+    zone = 2 * ((lon + 183) / 12) + 1;
+  }
+
+  return 6. * zone - 183.;
+}
+
+CUtmBatchProjector::CUtmBatchProjector(const lanelet::projection::UtmProjector& aUtmProjector)
+  : mUtmProjector(aUtmProjector)
+  , mUseSeries(false)
+  , mNorthernHemisphere(true)
+  , mCentralMeridianDeg(0.)
+  , mAlpha()
+  , mScaledRectifyingRadius(0.)
+  , mOffsetX(0.)
+  , mOffsetY(0.)
+{
+  const auto& origin = mUtmProjector.origin().position;
+  if (origin.lat < Constants::kUtmMinLatDeg || origin.lat >= Constants::kUtmMaxLatDeg)
+  {
+    return;
+  }
+
+  mNorthernHemisphere = origin.lat >= 0.;
+  mCentralMeridianDeg = getCentralMeridianDeg(origin.lat, origin.lon);
+
+  // Series coefficients in the third flattening n (Karney, 2011)
+  const double n  = Constants::kWgs84Flattening / (2. - Constants::kWgs84Flattening);
+  const double n2 = n * n;
+  const double n3 = n2 * n;
+  const double n4 = n3 * n;
+  const double n5 = n4 * n;
+  const double n6 = n5 * n;
+
+  mScaledRectifyingRadius = Constants::kUtmScaleFactor * Constants::kWgs84SemiMajorAxisMeters
+                            / (1. + n) * (1. + n2 / 4. + n4 / 64. + n6 / 256.);
+
+  mAlpha[0] = n / 2. - 2. / 3. * n2 + 5. / 16. * n3 + 41. / 180. * n4 - 127. / 288. * n5
+              + 7891. / 37800. * n6;
+  mAlpha[1] = 13. / 48. * n2 - 3. / 5. * n3 + 557. / 1440. * n4 + 281. / 630. * n5
+              - 1983433. / 1935360. * n6;
+  mAlpha[2] =
+    61. / 240. * n3 - 103. / 140. * n4 + 15061. / 26880. * n5 + 167603. / 181440. * n6;
+  mAlpha[3] = 49561. / 161280. * n4 - 179. / 168. * n5 + 6601661. / 7257600. * n6;
+  mAlpha[4] = 34729. / 80640. * n5 - 3418889. / 1995840. * n6;
+  mAlpha[5] = 212378941. / 319334400. * n6;
+
+  // The UTM projector subtracts the projected origin if it uses an offset, in which case it
+  // projects the origin to zero
+  double originX = 0.;
+  double originY = 0.;
+  forwardSeries(&origin.lat, &origin.lon, 1, &originX, &originY);
+  const auto projectedOrigin = mUtmProjector.forward(origin);
+  mOffsetX                   = originX - projectedOrigin.x();
+  mOffsetY                   = originY - projectedOrigin.y();
+
+  mUseSeries = true;
+}
+
+void CUtmBatchProjector::forward(const std::vector<double>& aLatDeg,
+                                 const std::vector<double>& aLonDeg,
+                                 std::vector<double>&       aX,
+                                 std::vector<double>&       aY) const
+{
+  const size_t size = std::min(aLatDeg.size(), aLonDeg.size());
+  aX.resize(size);
+  aY.resize(size);
+
+  if (mUseSeries)
+  {
+    forwardSeries(aLatDeg.data(), aLonDeg.data(), size, aX.data(), aY.data());
+  }
+
+  // Points not covered by the series are rare, project them separately to keep the loop above free
+  // of branches
+  for (size_t idx = 0; idx < size; ++idx)
+  {
+    if (!mUseSeries || !isCoveredBySeries(aLatDeg[idx]))
+    {
+      const auto point = mUtmProjector.forward({ aLatDeg[idx], aLonDeg[idx], 0. });
+      aX[idx]          = point.x();
+      aY[idx]          = point.y();
+    }
+  }
+}
+
+bool CUtmBatchProjector::isSeriesUsed() const noexcept
+{
+  return mUseSeries;
+}
+
+const lanelet::projection::UtmProjector& CUtmBatchProjector::getUtmProjector() const noexcept
+{
+  return mUtmProjector;
+}
+
+void CUtmBatchProjector::forwardSeries(const double* aLatDeg,
+                                       const double* aLonDeg,
+                                       const size_t  aSize,
+                                       double*       aX,
+                                       double*       aY) const
+{
+  const double e = std::sqrt(Constants::kWgs84Flattening * (2. - Constants::kWgs84Flattening));
+  const double falseNorthing = mNorthernHemisphere ? 0. : Constants::kUtmFalseNorthingMeters;
+
+  for (size_t idx = 0; idx < aSize; ++idx)
+  {
+    const double phi    = aLatDeg[idx] * Constants::kDeg2rad;
+    const double lambda = (aLonDeg[idx] - mCentralMeridianDeg) * Constants::kDeg2rad;
+
+    // Conformal latitude, expressed by its tangent
+    const double tau      = std::tan(phi);
+    const double sigma    = std::sinh(e * std::atanh(e * tau / std::sqrt(1. + tau * tau)));
+    const double tauPrime = tau * std::sqrt(1. + sigma * sigma) - sigma * std::sqrt(1. + tau * tau);
+
+    // Spherical Transverse Mercator coordinates
+    const double cosLambda = std::cos(lambda);
+    const double xiPrime   = std::atan2(tauPrime, cosLambda);
+    const double etaPrime =
+      std::asinh(std::sin(lambda) / std::sqrt(tauPrime * tauPrime + cosLambda * cosLambda));
+
+    // Sum alpha_j * sin(2 j zeta) with zeta = xiPrime + i etaPrime using Clenshaw summation on
+    // complex numbers, such that only one sine and hyperbolic sine are needed
+    const double sin2Xi   = std::sin(2. * xiPrime);
+    const double cos2Xi   = std::cos(2. * xiPrime);
+    const double sinh2Eta = std::sinh(2. * etaPrime);
+    const double cosh2Eta = std::cosh(2. * etaPrime);
+    const double cReal    = 2. * cos2Xi * cosh2Eta;
+    const double cImag    = -2. * sin2Xi * sinh2Eta;
+
+    double yReal     = 0.;
+    double yImag     = 0.;
+    double yNextReal = 0.;
+    double yNextImag = 0.;
+    for (size_t j = kSeriesOrder; j > 0; --j)
+    {
+      const double real = mAlpha[j - 1] + cReal * yReal - cImag * yImag - yNextReal;
+      const double imag = cReal * yImag + cImag * yReal - yNextImag;
+      yNextReal         = yReal;
+      yNextImag         = yImag;
+      yReal             = real;
+      yImag             = imag;
+    }
+
+    const double xi  = xiPrime + yReal * sin2Xi * cosh2Eta - yImag * cos2Xi * sinh2Eta;
+    const double eta = etaPrime + yReal * cos2Xi * sinh2Eta + yImag * sin2Xi * cosh2Eta;
+
+    aX[idx] = mScaledRectifyingRadius * eta + Constants::kUtmFalseEastingMeters - mOffsetX;
+    aY[idx] = mScaledRectifyingRadius * xi + falseNorthing - mOffsetY;
+  }
+}
+
+bool CUtmBatchProjector::isCoveredBySeries(const double aLatDeg) const noexcept
+{
+  return aLatDeg >= Constants::kUtmMinLatDeg && aLatDeg < Constants::kUtmMaxLatDeg
+         && (aLatDeg >= 0.) == mNorthernHemisphere;
+}
+}
+}
+}
@@ -0,0 +1,171 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#include "AutoStreamMapConverter/ArcCache.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+namespace Constants {
+// Fingerprint of the cached arc
+constexpr uint64_t kFingerprint = 0x1234;
+}
+
+/**
+ * Cache files holding a single arc, which are damaged in several ways before they are loaded.
+ */
+class ArcCacheTest : public testing::Test
+{
+protected:
+  ArcCacheTest()
+    : mArcKey()
+  {
+    CAutoStreamArcConversionResult result;
+    result.mConverted   = true;
+    result.mFingerprint = Constants::kFingerprint;
+
+    mCache.reset(AutoStream::CMapVersionAndHash(), lanelet::GPSPoint { 52.37, 4.89 });
+    mCache.add(mArcKey, result);
+    mFileName = testing::TempDir() + "ArcCacheTest.cache";
+    EXPECT_TRUE(mCache.store(mFileName));
+    mContents = readFile(mFileName);
+  }
+
+  ~ArcCacheTest() override
+  {
+    std::remove(mFileName.c_str());
+  }
+
+  /**
+   * Read a whole file.
+   *
+   * @param[in] aFileName Name of the file.
+   * @retval std::string Contents of the file, empty if it cannot be read.
+   */
+  static std::string readFile(const std::string& aFileName)
+  {
+    std::ifstream     input(aFileName, std::ios::binary);
+    std::stringstream contents;
+    contents << input.rdbuf();
+    return contents.str();
+  }
+
+  /**
+   * Replace the cache file.
+   *
+   * @param[in] aContents New contents of the file.
+   */
+  void writeFile(const std::string& aContents) const
+  {
+    std::ofstream output(mFileName, std::ios::binary | std::ios::trunc);
+    output.write(aContents.data(), static_cast<std::streamsize>(aContents.size()));
+  }
+
+  /**
+   * Get the offset of the data size of the arc, which is stored right in front of its data at the
+   * end of the file.
+   *
+   * @retval size_t Offset of the data size in the file.
+   */
+  size_t getDataSizeOffset() const
+  {
+    return mContents.size() - mCache.find(mArcKey)->mData.size() - sizeof(uint64_t);
+  }
+
+  /**
+   * Overwrite the data size of the arc.
+   *
+   * @param[in] aDataSize Data size that must be stored.
+   * @param[in, out] aContents Contents of the file.
+   */
+  void setDataSize(const uint64_t aDataSize, std::string& aContents) const
+  {
+    aContents.replace(getDataSizeOffset(),
+                      sizeof(aDataSize),
+                      reinterpret_cast<const char*>(&aDataSize),
+                      sizeof(aDataSize));
+  }
+
+  AutoStream::HdMap::TArcKey mArcKey;
+  CAutoStreamArcCache        mCache;
+  std::string                mFileName;
+  std::string                mContents;
+};
+
+TEST_F(ArcCacheTest, LoadsStoredCache)
+{
+  CAutoStreamArcCache cache;
+  ASSERT_TRUE(cache.load(mFileName));
+  ASSERT_EQ(cache.size(), 1u);
+
+  const CAutoStreamArcCacheEntry* entry = cache.find(mArcKey);
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->mFingerprint, Constants::kFingerprint);
+  EXPECT_EQ(entry->mData, mCache.find(mArcKey)->mData);
+}
+
+TEST_F(ArcCacheTest, LoadsEntryWithoutData)
+{
+  std::string contents = mContents;
+  setDataSize(0, contents);
+  contents.resize(getDataSizeOffset() + sizeof(uint64_t));
+  writeFile(contents);
+
+  CAutoStreamArcCache cache;
+  ASSERT_TRUE(cache.load(mFileName));
+  const CAutoStreamArcCacheEntry* entry = cache.find(mArcKey);
+  ASSERT_NE(entry, nullptr);
+  EXPECT_TRUE(entry->mData.empty());
+}
+
+TEST_F(ArcCacheTest, IgnoresTruncatedCache)
+{
+  // Cut the file within the header, the entry header and the data of the entry
+  for (const size_t size : { size_t(4), getDataSizeOffset(), mContents.size() - 1 })
+  {
+    SCOPED_TRACE(testing::Message() << "size " << size);
+    writeFile(mContents.substr(0, size));
+
+    CAutoStreamArcCache cache;
+    EXPECT_FALSE(cache.load(mFileName));
+    EXPECT_EQ(cache.size(), 0u);
+  }
+}
+
+TEST_F(ArcCacheTest, IgnoresOversizedDataSize)
+{
+  for (const uint64_t dataSize : { uint64_t(mContents.size()),
+                                   uint64_t(1) << 40,
+                                   std::numeric_limits<uint64_t>::max() })
+  {
+    SCOPED_TRACE(testing::Message() << "data size " << dataSize);
+    std::string contents = mContents;
+    setDataSize(dataSize, contents);
+    writeFile(contents);
+
+    CAutoStreamArcCache cache;
+    EXPECT_FALSE(cache.load(mFileName));
+    EXPECT_EQ(cache.size(), 0u);
+  }
+}
+}
+}
+}
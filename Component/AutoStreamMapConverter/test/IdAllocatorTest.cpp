@@ -0,0 +1,65 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#include "AutoStreamMapConverter/IdAllocator.hpp"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+namespace Constants {
+// End of the last range, which leaves room for the ID after the largest one
+constexpr lanelet::Id kEndOfIdRanges = lanelet::Id(1) << 62;
+}
+
+/**
+ * Allocate all IDs of a range and check that they are consecutive and end within the bounds.
+ *
+ * @param[in] aFirstId First ID of the range.
+ */
+void expectWholeRangeAllocated(const lanelet::Id aFirstId)
+{
+  CIdAllocator allocator(aFirstId);
+  for (lanelet::Id idx = 0; idx < CIdAllocator::getRangeSize(); ++idx)
+  {
+    ASSERT_EQ(allocator.getId(), aFirstId + idx);
+  }
+
+  EXPECT_THROW(allocator.getId(), std::out_of_range);
+}
+
+TEST(IdAllocatorTest, AllocatesFirstAndLastRange)
+{
+  const lanelet::Id firstRange = CIdAllocator::getRangeSize();
+  const lanelet::Id lastRange  = Constants::kEndOfIdRanges - CIdAllocator::getRangeSize();
+
+  expectWholeRangeAllocated(firstRange);
+  expectWholeRangeAllocated(lastRange);
+}
+
+TEST(IdAllocatorTest, ClaimsFirstRangeAfterLastRange)
+{
+  const lanelet::Id firstRange = CIdAllocator::getRangeSize();
+  const lanelet::Id lastRange  = Constants::kEndOfIdRanges - CIdAllocator::getRangeSize();
+
+  CIdRangeTable idRanges;
+  EXPECT_EQ(idRanges.claim(lastRange), lastRange);
+  EXPECT_EQ(idRanges.claim(lastRange), firstRange);
+  EXPECT_EQ(idRanges.claim(lastRange), firstRange + CIdAllocator::getRangeSize());
+  EXPECT_EQ(idRanges.getNumberOfCollisions(), 2u);
+}
+}
+}
+}
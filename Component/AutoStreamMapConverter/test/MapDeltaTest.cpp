@@ -0,0 +1,231 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#include "AutoStreamMapConverter/MapDelta.hpp"
+#include "AutoStreamMapConverter/OsmWriter.hpp"
+
+#include <lanelet2_core/LaneletMap.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+/**
+ * Previous and current version of a small map, written by the OSM writer. Between both versions a
+ * node of a lanelet moves, an area and a traffic sign change their tags and one lanelet, area and
+ * traffic sign is added and one lanelet and traffic sign is removed.
+ */
+class MapDeltaTest : public testing::Test
+{
+protected:
+  MapDeltaTest()
+    : mUtmProjector(lanelet::Origin({ 52.37, 4.89 }))
+  {
+  }
+
+  ~MapDeltaTest() override
+  {
+    for (const auto& fileName : mFileNames)
+    {
+      std::remove(fileName.c_str());
+    }
+  }
+
+  /**
+   * Get the name of a temporary file that is removed at the end of the test.
+   *
+   * @param[in] aName Name of the file within the temporary directory.
+   * @retval std::string Full name of the file.
+   */
+  std::string getTemporaryFileName(const std::string& aName)
+  {
+    mFileNames.push_back(testing::TempDir() + aName);
+    return mFileNames.back();
+  }
+
+  /**
+   * Create points with subsequent IDs.
+   *
+   * @param[in] aFirstId ID of the first point.
+   * @param[in] aCoordinates X and Y coordinates in meters of all points.
+   * @retval lanelet::Points3d Points.
+   */
+  static lanelet::Points3d createPoints(const lanelet::Id                             aFirstId,
+                                        const std::vector<std::pair<double, double>>& aCoordinates)
+  {
+    lanelet::Points3d points;
+    for (const auto& coordinate : aCoordinates)
+    {
+      const lanelet::Id id = aFirstId + static_cast<lanelet::Id>(points.size());
+      points.emplace_back(id, coordinate.first, coordinate.second, 0.);
+    }
+
+    return points;
+  }
+
+  /**
+   * Write a version of the map and load it as document.
+   *
+   * @param[in] aCurrent True for the current version, false for the previous version.
+   * @param[out] aDocument Document of the written map.
+   */
+  void writeMap(const bool aCurrent, COsmDocument& aDocument)
+  {
+    const lanelet::AttributeMap border = {
+      { lanelet::AttributeNamesString::Type, lanelet::AttributeValueString::RoadBorder }
+    };
+    const lanelet::AttributeMap road = {
+      { lanelet::AttributeNamesString::Subtype, lanelet::AttributeValueString::Road },
+      { lanelet::AttributeNamesString::OneWay, "yes" }
+    };
+
+    // Two neighbouring lanelets, of which the last point of the right bound moves
+    const lanelet::LineString3d left(100, createPoints(1, { { 0., 7. }, { 50., 7. } }), border);
+    const lanelet::LineString3d middle(101, createPoints(3, { { 0., 3.5 }, { 50., 3.5 } }), border);
+    const lanelet::LineString3d right(
+      102, createPoints(5, { { 0., 0. }, { 50., aCurrent ? 0.5 : 0. } }), border);
+
+    std::vector<lanelet::Lanelet> lanelets = { lanelet::Lanelet(200, left, middle, road),
+                                               lanelet::Lanelet(201, middle, right, road) };
+
+    // A lanelet that is replaced by another one
+    const lanelet::Id replacedId = aCurrent ? 203 : 202;
+    const lanelet::Id pointId    = aCurrent ? 11 : 7;
+    lanelets.emplace_back(
+      replacedId,
+      lanelet::LineString3d(
+        replacedId - 90, createPoints(pointId, { { 100., 7. }, { 150., 7. } }), border),
+      lanelet::LineString3d(
+        replacedId - 80, createPoints(pointId + 2, { { 100., 3.5 }, { 150., 3.5 } }), border),
+      road);
+
+    // A parking area that is renamed and an area that is added
+    std::vector<lanelet::Area>     areas;
+    const std::vector<lanelet::Id> areaIds =
+      aCurrent ? std::vector<lanelet::Id> { 300, 301 } : std::vector<lanelet::Id> { 300 };
+    for (const lanelet::Id areaId : areaIds)
+    {
+      const double            offset = static_cast<double>(areaId - 300) * 20.;
+      const lanelet::Points3d points = createPoints(
+        20 + (areaId - 300) * 10, { { offset, -3. }, { offset + 10., -3. }, { offset, -8. } });
+      areas.emplace_back(
+        areaId,
+        lanelet::LineStrings3d { lanelet::LineString3d(areaId - 180, points),
+                                 lanelet::LineString3d(areaId - 170,
+                                                       { points.back(), points.front() }) },
+        lanelet::InnerBounds(),
+        lanelet::AttributeMap {
+          { lanelet::AttributeNamesString::Subtype, lanelet::AttributeValueString::Parking },
+          { "name", areaId == 300 && aCurrent ? "renamed" : "original" } });
+    }
+
+    // Traffic signs that stay, are removed, are added or change their subtype
+    std::vector<lanelet::Polygon3d> polygons;
+    const std::vector<lanelet::Id>  polygonIds = aCurrent
+                                                   ? std::vector<lanelet::Id> { 400, 402, 403 }
+                                                   : std::vector<lanelet::Id> { 400, 401, 403 };
+    for (const lanelet::Id polygonId : polygonIds)
+    {
+      const double offset = static_cast<double>(polygonId - 400) * 10.;
+      polygons.emplace_back(
+        polygonId,
+        createPoints(40 + (polygonId - 400) * 3,
+                     { { offset, 10. }, { offset + 1., 10. }, { offset + 1., 12. } }),
+        lanelet::AttributeMap {
+          { lanelet::AttributeNamesString::Type, lanelet::AttributeValueString::TrafficSign },
+          { lanelet::AttributeNamesString::Subtype,
+            polygonId == 403 && aCurrent ? "de274" : "de206" } });
+    }
+
+    const std::string fileName =
+      getTemporaryFileName(aCurrent ? "MapDeltaTestCurrent.osm" : "MapDeltaTestPrevious.osm");
+    {
+      std::ofstream output(fileName);
+      COsmWriter    writer(output, mUtmProjector);
+      EXPECT_TRUE(writer.write(lanelets, areas, polygons));
+    }
+
+    EXPECT_TRUE(aDocument.load(fileName));
+  }
+
+  lanelet::projection::UtmProjector mUtmProjector;
+  std::vector<std::string>          mFileNames;
+};
+
+TEST_F(MapDeltaTest, CountsChangedPrimitives)
+{
+  COsmDocument previous, current;
+  writeMap(false, previous);
+  writeMap(true, current);
+
+  CMapDelta delta;
+  delta.compute(previous, current);
+
+  // Lanelet 201 only changes through its moved node
+  const CMapDeltaStatistics& statistics = delta.getStatistics();
+  EXPECT_EQ(statistics.mNumberOfAddedLanelets, 1u);
+  EXPECT_EQ(statistics.mNumberOfRemovedLanelets, 1u);
+  EXPECT_EQ(statistics.mNumberOfModifiedLanelets, 1u);
+  EXPECT_EQ(statistics.mNumberOfAddedAreas, 1u);
+  EXPECT_EQ(statistics.mNumberOfRemovedAreas, 0u);
+  EXPECT_EQ(statistics.mNumberOfModifiedAreas, 1u);
+  EXPECT_EQ(statistics.mNumberOfAddedTrafficSigns, 1u);
+  EXPECT_EQ(statistics.mNumberOfRemovedTrafficSigns, 1u);
+  EXPECT_EQ(statistics.mNumberOfModifiedTrafficSigns, 1u);
+}
+
+TEST_F(MapDeltaTest, AppliesStoredChangeSet)
+{
+  COsmDocument previous, current;
+  writeMap(false, previous);
+  writeMap(true, current);
+
+  CMapDelta computed;
+  computed.compute(previous, current);
+  const std::string changeSetFileName = getTemporaryFileName("MapDeltaTest.osc");
+  ASSERT_TRUE(computed.store(changeSetFileName));
+
+  CMapDelta loaded;
+  ASSERT_TRUE(loaded.load(changeSetFileName));
+  for (const TOsmChangeAction action :
+       { TOsmChangeAction::Create, TOsmChangeAction::Modify, TOsmChangeAction::Delete })
+  {
+    EXPECT_GT(loaded.getNumberOfElements(action), 0u);
+    EXPECT_EQ(loaded.getNumberOfElements(action), computed.getNumberOfElements(action));
+  }
+
+  const std::string appliedFileName = getTemporaryFileName("MapDeltaTestApplied.osm");
+  ASSERT_TRUE(loaded.apply(previous, appliedFileName));
+
+  COsmDocument applied;
+  ASSERT_TRUE(applied.load(appliedFileName));
+  ASSERT_EQ(applied.getElements().size(), current.getElements().size());
+  for (const COsmElement& element : current.getElements())
+  {
+    const COsmElement* appliedElement = applied.findElement(element.mType, element.mId);
+    ASSERT_NE(appliedElement, nullptr) << element.mText;
+    EXPECT_EQ(appliedElement->mText, element.mText);
+  }
+
+  // A change set that does not belong to the map is rejected
+  EXPECT_FALSE(loaded.apply(current, getTemporaryFileName("MapDeltaTestReapplied.osm")));
+}
+}
+}
+}
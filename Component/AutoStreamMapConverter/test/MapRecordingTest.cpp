@@ -0,0 +1,136 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#include "AutoStreamMapConverter/MapConverter.hpp"
+#include "AutoStreamMapConverter/SyntheticMapSource.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+namespace Constants {
+// Size of the synthetic map, two roads with a few parking areas and triangular lanes each
+constexpr size_t kNumberOfArcs = 60;
+constexpr size_t kArcsPerRoad  = 30;
+}
+
+/**
+ * Conversions of a small synthetic map that is recorded and replayed.
+ */
+class MapRecordingTest : public testing::Test
+{
+protected:
+  MapRecordingTest()
+  {
+    mParameters.mNumberOfArcs = Constants::kNumberOfArcs;
+    mParameters.mArcsPerRoad  = Constants::kArcsPerRoad;
+  }
+
+  ~MapRecordingTest() override
+  {
+    for (const auto& fileName : mFileNames)
+    {
+      std::remove(fileName.c_str());
+    }
+  }
+
+  /**
+   * Get the name of a temporary file that is removed at the end of the test.
+   *
+   * @param[in] aName Name of the file within the temporary directory.
+   * @retval std::string Full name of the file.
+   */
+  std::string getTemporaryFileName(const std::string& aName)
+  {
+    mFileNames.push_back(testing::TempDir() + aName);
+    return mFileNames.back();
+  }
+
+  /**
+   * Set up a converter that converts the synthetic map.
+   *
+   * @param[in, out] aConverter Converter that must use the synthetic map.
+   */
+  void useSyntheticMap(CAutoStreamMapConverter& aConverter) const
+  {
+    const CSyntheticMapParameters parameters = mParameters;
+    aConverter.setMapSourceFactory(
+      [parameters]() { return std::make_unique<CAutoStreamSyntheticMapSource>(parameters); });
+  }
+
+  /**
+   * Read a whole file.
+   *
+   * @param[in] aFileName Name of the file.
+   * @retval std::string Contents of the file, empty if it cannot be read.
+   */
+  static std::string readFile(const std::string& aFileName)
+  {
+    std::ifstream     input(aFileName);
+    std::stringstream contents;
+    contents << input.rdbuf();
+    return contents.str();
+  }
+
+  CSyntheticMapParameters  mParameters;
+  std::vector<std::string> mFileNames;
+};
+
+TEST_F(MapRecordingTest, ReplaysArcsRestoredFromArcCache)
+{
+  const AutoStream::TBoundingBox boundingBox =
+    CAutoStreamSyntheticMapSource(mParameters).getBoundingBox();
+
+  // The prefetch thread decides on its own which arcs it retrieves
+  for (const size_t prefetchDepth : { size_t(0), size_t(4) })
+  {
+    SCOPED_TRACE(testing::Message() << "prefetch depth " << prefetchDepth);
+
+    const std::string arcCacheFileName    = getTemporaryFileName("MapRecordingTest.cache");
+    const std::string recordingFileName   = getTemporaryFileName("MapRecordingTest.rec");
+    const std::string recordedMapFileName = getTemporaryFileName("MapRecordingTest.osm");
+    const std::string replayedMapFileName = getTemporaryFileName("MapRecordingTestReplay.osm");
+
+    // The first conversion fills the arc cache, the second one restores all arcs from it
+    CAutoStreamMapConverter recorder;
+    useSyntheticMap(recorder);
+    recorder.setPrefetchDepth(prefetchDepth);
+    recorder.setArcCacheFileName(arcCacheFileName);
+    recorder.setOutputFileName(getTemporaryFileName("MapRecordingTestFirst.osm"));
+    ASSERT_TRUE(recorder.storeMap(boundingBox));
+
+    recorder.setRecordingFileName(recordingFileName);
+    recorder.setOutputFileName(recordedMapFileName);
+    ASSERT_TRUE(recorder.storeMap(boundingBox));
+
+    // Without the arc cache every arc must be served by the recording
+    CAutoStreamMapConverter replayer;
+    replayer.setReplayFileName(recordingFileName);
+    replayer.setOutputFileName(replayedMapFileName);
+    ASSERT_TRUE(replayer.storeMap(boundingBox));
+
+    const std::string recordedMap = readFile(recordedMapFileName);
+    EXPECT_FALSE(recordedMap.empty());
+    EXPECT_EQ(readFile(replayedMapFileName), recordedMap);
+  }
+}
+}
+}
+}
@@ -0,0 +1,288 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#include "AutoStreamMapConverter/OsmWriter.hpp"
+
+#include <lanelet2_core/LaneletMap.h>
+#include <lanelet2_io/Io.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+namespace Constants {
+// Maximum allowed difference between written and loaded coordinates
+constexpr double kMaxCoordinateDifferenceMeters = 1e-3;
+}
+
+/**
+ * Primitives of a small converted map, of which bounds and points are shared like the converter
+ * shares them: two neighbouring lanelets, a parking area with two borders and a traffic sign.
+ */
+class OsmWriterTest : public testing::Test
+{
+protected:
+  OsmWriterTest()
+    : mUtmProjector(lanelet::Origin({ 52.37, 4.89 }))
+  {
+    const auto createPoint = [this](const lanelet::Id aId, const double aX, const double aY) {
+      mPoints.emplace_back(aId, aX, aY, 1.5);
+      return mPoints.back();
+    };
+
+    const lanelet::Points3d leftPoints  = { createPoint(1, 0., 7.), createPoint(2, 50., 7.2) };
+    const lanelet::Points3d midPoints   = { createPoint(3, 0., 3.5), createPoint(4, 50., 3.6) };
+    const lanelet::Points3d rightPoints = { createPoint(5, 0., 0.), createPoint(6, 50., 0.) };
+    const lanelet::Points3d areaPoints  = { createPoint(7, 0., -3.), createPoint(8, 50., -3.) };
+
+    mPoints.front().attributes()["note"] = "quote \" & <angle>";
+
+    const lanelet::LineString3d left(
+      10,
+      leftPoints,
+      { { lanelet::AttributeNamesString::Type, lanelet::AttributeValueString::RoadBorder } });
+    const lanelet::LineString3d middle(
+      11,
+      midPoints,
+      { { lanelet::AttributeNamesString::Type, lanelet::AttributeValueString::LineThin },
+        { lanelet::AttributeNamesString::Subtype, lanelet::AttributeValueString::Dashed } });
+    const lanelet::LineString3d right(
+      12,
+      rightPoints,
+      { { lanelet::AttributeNamesString::Type, lanelet::AttributeValueString::LineThin },
+        { lanelet::AttributeNamesString::Subtype, lanelet::AttributeValueString::Solid } });
+    const lanelet::LineString3d areaBorder(
+      13,
+      { rightPoints.back(), areaPoints.back(), areaPoints.front() },
+      { { lanelet::AttributeNamesString::Type, lanelet::AttributeValueString::Curbstone } });
+    const lanelet::LineString3d areaClosure(
+      14,
+      { areaPoints.front(), rightPoints.front(), rightPoints.back() });
+
+    const lanelet::AttributeMap laneletAttributes = {
+      { lanelet::AttributeNamesString::Subtype, lanelet::AttributeValueString::Road },
+      { lanelet::AttributeNamesString::OneWay, "yes" },
+      { lanelet::AttributeNamesString::SpeedLimit, "50" },
+      { lanelet::AttributeNamesString::Location, "urban" }
+    };
+    mLanelets.emplace_back(20, left, middle, laneletAttributes);
+    mLanelets.emplace_back(21, middle, right, laneletAttributes);
+
+    mAreas.emplace_back(
+      30,
+      lanelet::LineStrings3d { areaBorder, areaClosure },
+      lanelet::InnerBounds(),
+      lanelet::AttributeMap {
+        { lanelet::AttributeNamesString::Subtype, lanelet::AttributeValueString::Parking } });
+
+    mPolygons.emplace_back(
+      40,
+      lanelet::Points3d { createPoint(41, 60., 10.),
+                          createPoint(42, 61., 10.),
+                          createPoint(43, 61., 12.) },
+      lanelet::AttributeMap {
+        { lanelet::AttributeNamesString::Type, lanelet::AttributeValueString::TrafficSign },
+        { lanelet::AttributeNamesString::Subtype, "de206" } });
+  }
+
+  ~OsmWriterTest() override
+  {
+    for (const auto& fileName : mFileNames)
+    {
+      std::remove(fileName.c_str());
+    }
+  }
+
+  /**
+   * Get the name of a temporary file that is removed at the end of the test.
+   *
+   * @param[in] aName Name of the file within the temporary directory.
+   * @retval std::string Full name of the file.
+   */
+  std::string getTemporaryFileName(const std::string& aName)
+  {
+    mFileNames.push_back(testing::TempDir() + aName);
+    return mFileNames.back();
+  }
+
+  /**
+   * Write the primitives with the OSM writer and load the written map with lanelet2.
+   *
+   * @retval lanelet::LaneletMapPtr Loaded map.
+   */
+  lanelet::LaneletMapPtr writeAndLoad()
+  {
+    const std::string fileName = getTemporaryFileName("OsmWriterTest.osm");
+    {
+      std::ofstream output(fileName);
+      COsmWriter    writer(output, mUtmProjector);
+      EXPECT_TRUE(writer.write(mLanelets, mAreas, mPolygons));
+    }
+
+    lanelet::ErrorMessages errors;
+    lanelet::LaneletMapPtr map = lanelet::load(fileName, mUtmProjector, &errors);
+    EXPECT_TRUE(errors.empty()) << errors.front();
+    return map;
+  }
+
+  /**
+   * Write the primitives with the lanelet2 writer and load the written map with lanelet2.
+   *
+   * @retval lanelet::LaneletMapPtr Loaded map.
+   */
+  lanelet::LaneletMapPtr writeAndLoadWithLanelet2()
+  {
+    lanelet::LaneletMap map;
+    for (const auto& lanelet : mLanelets)
+    {
+      map.add(lanelet);
+    }
+    for (const auto& area : mAreas)
+    {
+      map.add(area);
+    }
+    for (const auto& polygon : mPolygons)
+    {
+      map.add(polygon);
+    }
+
+    const std::string fileName = getTemporaryFileName("OsmWriterTestLanelet2.osm");
+    lanelet::write(fileName, map, mUtmProjector);
+    return lanelet::load(fileName, mUtmProjector);
+  }
+
+  lanelet::projection::UtmProjector mUtmProjector;
+  lanelet::Points3d                 mPoints;
+  std::vector<lanelet::Lanelet>     mLanelets;
+  std::vector<lanelet::Area>        mAreas;
+  std::vector<lanelet::Polygon3d>   mPolygons;
+  std::vector<std::string>          mFileNames;
+};
+
+/**
+ * Compare the attributes of two primitives.
+ *
+ * @param[in] aActual Attributes of the primitive written by the OSM writer.
+ * @param[in] aExpected Attributes of the primitive written by lanelet2.
+ */
+void expectSameAttributes(const lanelet::AttributeMap& aActual,
+                          const lanelet::AttributeMap& aExpected)
+{
+  EXPECT_EQ(aActual.size(), aExpected.size());
+  for (const auto& attribute : aExpected)
+  {
+    const auto actual = aActual.find(attribute.first);
+    ASSERT_TRUE(actual != aActual.end()) << "missing " << attribute.first;
+    EXPECT_EQ(actual->second.value(), attribute.second.value()) << attribute.first;
+  }
+}
+
+/**
+ * Compare the point IDs of two line strings or polygons.
+ *
+ * @param[in] aActual Line string written by the OSM writer.
+ * @param[in] aExpected Line string written by lanelet2.
+ */
+template <typename LineStringT>
+void expectSamePoints(const LineStringT& aActual, const LineStringT& aExpected)
+{
+  ASSERT_EQ(aActual.size(), aExpected.size());
+  for (size_t idx = 0; idx < aExpected.size(); ++idx)
+  {
+    EXPECT_EQ(aActual[idx].id(), aExpected[idx].id());
+  }
+}
+
+TEST_F(OsmWriterTest, LoadsLikeLanelet2Writer)
+{
+  const lanelet::LaneletMapPtr actual   = writeAndLoad();
+  const lanelet::LaneletMapPtr expected = writeAndLoadWithLanelet2();
+  ASSERT_TRUE(actual);
+  ASSERT_TRUE(expected);
+
+  ASSERT_EQ(actual->pointLayer.size(), expected->pointLayer.size());
+  for (const auto& point : expected->pointLayer)
+  {
+    ASSERT_TRUE(actual->pointLayer.exists(point.id())) << point.id();
+    const auto actualPoint = actual->pointLayer.get(point.id());
+    EXPECT_LE((actualPoint.basicPoint() - point.basicPoint()).norm(),
+              Constants::kMaxCoordinateDifferenceMeters);
+    expectSameAttributes(actualPoint.attributes(), point.attributes());
+  }
+
+  ASSERT_EQ(actual->lineStringLayer.size(), expected->lineStringLayer.size());
+  for (const auto& lineString : expected->lineStringLayer)
+  {
+    ASSERT_TRUE(actual->lineStringLayer.exists(lineString.id())) << lineString.id();
+    const auto actualLineString = actual->lineStringLayer.get(lineString.id());
+    expectSamePoints(actualLineString, lineString);
+    expectSameAttributes(actualLineString.attributes(), lineString.attributes());
+  }
+
+  ASSERT_EQ(actual->polygonLayer.size(), expected->polygonLayer.size());
+  for (const auto& polygon : expected->polygonLayer)
+  {
+    ASSERT_TRUE(actual->polygonLayer.exists(polygon.id())) << polygon.id();
+    const auto actualPolygon = actual->polygonLayer.get(polygon.id());
+    expectSamePoints(actualPolygon, polygon);
+    expectSameAttributes(actualPolygon.attributes(), polygon.attributes());
+  }
+
+  ASSERT_EQ(actual->laneletLayer.size(), expected->laneletLayer.size());
+  for (const auto& lanelet : expected->laneletLayer)
+  {
+    ASSERT_TRUE(actual->laneletLayer.exists(lanelet.id())) << lanelet.id();
+    const auto actualLanelet = actual->laneletLayer.get(lanelet.id());
+    EXPECT_EQ(actualLanelet.leftBound().id(), lanelet.leftBound().id());
+    EXPECT_EQ(actualLanelet.rightBound().id(), lanelet.rightBound().id());
+    EXPECT_EQ(actualLanelet.leftBound().inverted(), lanelet.leftBound().inverted());
+    EXPECT_EQ(actualLanelet.rightBound().inverted(), lanelet.rightBound().inverted());
+    expectSameAttributes(actualLanelet.attributes(), lanelet.attributes());
+  }
+
+  ASSERT_EQ(actual->areaLayer.size(), expected->areaLayer.size());
+  for (const auto& area : expected->areaLayer)
+  {
+    ASSERT_TRUE(actual->areaLayer.exists(area.id())) << area.id();
+    const auto actualArea = actual->areaLayer.get(area.id());
+    ASSERT_EQ(actualArea.outerBound().size(), area.outerBound().size());
+    for (size_t idx = 0; idx < area.outerBound().size(); ++idx)
+    {
+      EXPECT_EQ(actualArea.outerBound()[idx].id(), area.outerBound()[idx].id());
+    }
+    expectSameAttributes(actualArea.attributes(), area.attributes());
+  }
+}
+
+TEST_F(OsmWriterTest, KeepsConvertedCoordinates)
+{
+  const lanelet::LaneletMapPtr map = writeAndLoad();
+  ASSERT_TRUE(map);
+
+  ASSERT_EQ(map->pointLayer.size(), mPoints.size());
+  for (const auto& point : mPoints)
+  {
+    ASSERT_TRUE(map->pointLayer.exists(point.id())) << point.id();
+    EXPECT_LE((map->pointLayer.get(point.id()).basicPoint() - point.basicPoint()).norm(),
+              Constants::kMaxCoordinateDifferenceMeters)
+      << point.id();
+  }
+}
+}
+}
+}
@@ -0,0 +1,448 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#include "AutoStreamMapConverter/RoutingGraph.hpp"
+#include "AutoStreamMapConverter/CompressedFile.hpp"
+
+#include <lanelet2_core/LaneletMap.h>
+#include <lanelet2_routing/RoutingGraph.h>
+#include <lanelet2_traffic_rules/TrafficRulesFactory.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+namespace Constants {
+// Lanelets of which the conflicts are compared with lanelet2: the crossing lanelet and the lanelets
+// it crosses, all of them one-way
+const std::set<lanelet::Id> kConflictingLaneletIds = { 203, 204, 206 };
+
+// Offset of the number of lanelets in the header of routing graph files
+constexpr size_t kNumberOfLaneletsOffset = 16;
+}
+
+// Direction of a lanelet, by its ID and whether it is inverted
+typedef std::pair<lanelet::Id, bool> TLaneletKey;
+
+/**
+ * Lanelets of a small map. Each test adds the lanelets it needs.
+ */
+class RoutingGraphTest : public testing::Test
+{
+protected:
+  ~RoutingGraphTest() override
+  {
+    for (const auto& fileName : mFileNames)
+    {
+      std::remove(fileName.c_str());
+    }
+  }
+
+  /**
+   * Get the name of a temporary file that is removed at the end of the test.
+   *
+   * @param[in] aName Name of the file within the temporary directory.
+   * @retval std::string Full name of the file.
+   */
+  std::string getTemporaryFileName(const std::string& aName)
+  {
+    mFileNames.push_back(testing::TempDir() + aName);
+    return mFileNames.back();
+  }
+
+  /**
+   * Write a file, compressed if its name ends with ".gz".
+   *
+   * @param[in] aFileName Name of the file.
+   * @param[in] aContents Uncompressed contents of the file.
+   */
+  static void writeFile(const std::string& aFileName, const std::string& aContents)
+  {
+    CMapOutputStream output;
+    ASSERT_TRUE(output.open(aFileName));
+    output.write(aContents.data(), static_cast<std::streamsize>(aContents.size()));
+    ASSERT_TRUE(output.close());
+  }
+
+  /**
+   * Create a point.
+   *
+   * @param[in] aId ID of the point.
+   * @param[in] aX X coordinate in meters.
+   * @param[in] aY Y coordinate in meters.
+   * @retval lanelet::Point3d Point.
+   */
+  static lanelet::Point3d createPoint(const lanelet::Id aId, const double aX, const double aY)
+  {
+    return lanelet::Point3d(aId, aX, aY, 0.);
+  }
+
+  /**
+   * Create a lane border.
+   *
+   * @param[in] aId ID of the line string.
+   * @param[in] aPoints Points of the line string.
+   * @param[in] aType Type of the line string.
+   * @param[in] aSubtype Subtype of the line string, empty for none.
+   * @retval lanelet::LineString3d Line string.
+   */
+  static lanelet::LineString3d createBorder(const lanelet::Id        aId,
+                                            const lanelet::Points3d& aPoints,
+                                            const std::string&       aType,
+                                            const std::string&       aSubtype)
+  {
+    lanelet::AttributeMap attributes = { { lanelet::AttributeNamesString::Type, aType } };
+    if (!aSubtype.empty())
+    {
+      attributes[lanelet::AttributeNamesString::Subtype] = aSubtype;
+    }
+
+    return lanelet::LineString3d(aId, aPoints, attributes);
+  }
+
+  /**
+   * Add a lanelet.
+   *
+   * @param[in] aId ID of the lanelet.
+   * @param[in] aLeft Left bound.
+   * @param[in] aRight Right bound.
+   * @param[in] aSubtype Subtype of the lanelet.
+   * @param[in] aOneWay True if the lanelet may only be driven along its bounds.
+   */
+  void addLanelet(const lanelet::Id            aId,
+                  const lanelet::LineString3d& aLeft,
+                  const lanelet::LineString3d& aRight,
+                  const std::string&           aSubtype,
+                  const bool                   aOneWay)
+  {
+    mLanelets.emplace_back(
+      aId,
+      aLeft,
+      aRight,
+      lanelet::AttributeMap { { lanelet::AttributeNamesString::Subtype, aSubtype },
+                              { lanelet::AttributeNamesString::OneWay, aOneWay ? "yes" : "no" },
+                              { lanelet::AttributeNamesString::Location, "urban" } });
+  }
+
+  /**
+   * Get the lanelets to which a lanelet of the graph has a relation.
+   *
+   * @param[in] aGraph Routing graph.
+   * @param[in] aLaneletIdx Index of the lanelet.
+   * @param[in] aRelation Kind of relation.
+   * @retval std::set<TLaneletKey> Related lanelets.
+   */
+  static std::set<TLaneletKey> getRelatedLanelets(const CRoutingGraph&   aGraph,
+                                                  const size_t           aLaneletIdx,
+                                                  const TRoutingRelation aRelation)
+  {
+    std::set<TLaneletKey> keys;
+    for (const size_t relatedIdx : aGraph.getRelatedLanelets(aLaneletIdx, aRelation))
+    {
+      const CRoutingGraphLanelet& related = aGraph.getLanelets()[relatedIdx];
+      keys.emplace(related.mId, related.mInverted != 0);
+    }
+
+    return keys;
+  }
+
+  /**
+   * Get the keys of lanelets of the lanelet2 routing graph.
+   *
+   * @param[in] aLanelets Lanelets.
+   * @retval std::set<TLaneletKey> Keys of the lanelets.
+   */
+  static std::set<TLaneletKey> toKeys(const lanelet::ConstLanelets& aLanelets)
+  {
+    std::set<TLaneletKey> keys;
+    for (const auto& lanelet : aLanelets)
+    {
+      keys.emplace(lanelet.id(), lanelet.inverted());
+    }
+
+    return keys;
+  }
+
+  /**
+   * Get the key of an optional lanelet of the lanelet2 routing graph.
+   *
+   * @param[in] aLanelet Lanelet, if any.
+   * @retval std::set<TLaneletKey> Key of the lanelet, empty if there is none.
+   */
+  static std::set<TLaneletKey> toKeys(const lanelet::Optional<lanelet::ConstLanelet>& aLanelet)
+  {
+    return aLanelet ? toKeys(lanelet::ConstLanelets { *aLanelet }) : std::set<TLaneletKey>();
+  }
+
+  /**
+   * Get the keys of the lanelets among lanelets and areas of the lanelet2 routing graph.
+   *
+   * @param[in] aLaneletsOrAreas Lanelets and areas.
+   * @retval std::set<TLaneletKey> Keys of the lanelets.
+   */
+  static std::set<TLaneletKey> toKeys(const lanelet::ConstLaneletOrAreas& aLaneletsOrAreas)
+  {
+    lanelet::ConstLanelets lanelets;
+    for (const auto& laneletOrArea : aLaneletsOrAreas)
+    {
+      if (laneletOrArea.lanelet())
+      {
+        lanelets.push_back(*laneletOrArea.lanelet());
+      }
+    }
+
+    return toKeys(lanelets);
+  }
+
+  std::vector<lanelet::Lanelet> mLanelets;
+  std::vector<std::string>      mFileNames;
+};
+
+TEST_F(RoutingGraphTest, MatchesLanelet2RoutingGraph)
+{
+  const std::string road       = lanelet::AttributeValueString::Road;
+  const std::string roadBorder = lanelet::AttributeValueString::RoadBorder;
+  const std::string lineThin   = lanelet::AttributeValueString::LineThin;
+
+  // Two lanes followed by two lanes, with a dashed and then a solid line between them
+  const auto right0 = createPoint(1, 0., 0.), right1 = createPoint(2, 50., 0.),
+             right2 = createPoint(3, 100., 0.);
+  const auto middle0 = createPoint(4, 0., 3.5), middle1 = createPoint(5, 50., 3.5),
+             middle2 = createPoint(6, 100., 3.5);
+  const auto left0 = createPoint(7, 0., 7.), left1 = createPoint(8, 50., 7.),
+             left2 = createPoint(9, 100., 7.);
+  const auto firstRight  = createBorder(101, { right0, right1 }, roadBorder, "");
+  const auto firstMiddle = createBorder(102, { middle0, middle1 }, lineThin, "dashed");
+  const auto firstLeft   = createBorder(103, { left0, left1 }, roadBorder, "");
+  const auto nextRight   = createBorder(104, { right1, right2 }, roadBorder, "");
+  const auto nextMiddle  = createBorder(105, { middle1, middle2 }, lineThin, "solid");
+  const auto nextLeft    = createBorder(106, { left1, left2 }, roadBorder, "");
+  addLanelet(201, firstMiddle, firstRight, road, true);
+  addLanelet(202, firstLeft, firstMiddle, road, true);
+  addLanelet(203, nextMiddle, nextRight, road, true);
+  addLanelet(204, nextLeft, nextMiddle, road, true);
+
+  // A bicycle lane next to the first lanes, which vehicles must not use
+  const auto bicycleRight = createBorder(
+    107, { createPoint(10, 0., -1.5), createPoint(11, 50., -1.5) }, lineThin, "solid");
+  addLanelet(205, firstRight, bicycleRight, lanelet::AttributeValueString::BicycleLane, true);
+
+  // A lanelet crossing the next lanes
+  const auto crossingLeft = createBorder(
+    108, { createPoint(12, 70., -10.), createPoint(13, 70., 17.) }, roadBorder, "");
+  const auto crossingRight = createBorder(
+    109, { createPoint(14, 80., -10.), createPoint(15, 80., 17.) }, roadBorder, "");
+  addLanelet(206, crossingLeft, crossingRight, road, true);
+
+  // Two consecutive two-way lanelets
+  const auto twoWayRight0 = createPoint(16, 0., 20.), twoWayRight1 = createPoint(17, 50., 20.),
+             twoWayRight2 = createPoint(18, 100., 20.);
+  const auto twoWayLeft0 = createPoint(19, 0., 23.5), twoWayLeft1 = createPoint(20, 50., 23.5),
+             twoWayLeft2 = createPoint(21, 100., 23.5);
+  addLanelet(207,
+             createBorder(111, { twoWayLeft0, twoWayLeft1 }, roadBorder, ""),
+             createBorder(110, { twoWayRight0, twoWayRight1 }, roadBorder, ""),
+             road,
+             false);
+  addLanelet(208,
+             createBorder(113, { twoWayLeft1, twoWayLeft2 }, roadBorder, ""),
+             createBorder(112, { twoWayRight1, twoWayRight2 }, roadBorder, ""),
+             road,
+             false);
+
+  CRoutingGraph graph;
+  graph.build(mLanelets);
+
+  lanelet::LaneletMap map;
+  for (const auto& lanelet : mLanelets)
+  {
+    map.add(lanelet);
+  }
+  const auto trafficRules = lanelet::traffic_rules::TrafficRulesFactory::create(
+    lanelet::Locations::Germany, lanelet::Participants::Vehicle);
+  const auto reference = lanelet::routing::RoutingGraph::build(map, *trafficRules);
+  ASSERT_TRUE(reference);
+
+  size_t numberOfLanelets = 0;
+  for (const lanelet::ConstLanelet& mapLanelet : mLanelets)
+  {
+    for (const bool inverted : { false, true })
+    {
+      const lanelet::ConstLanelet lanelet = inverted ? mapLanelet.invert() : mapLanelet;
+      SCOPED_TRACE(testing::Message() << "lanelet " << lanelet.id() << ", inverted " << inverted);
+
+      size_t laneletIdx = 0;
+      ASSERT_EQ(graph.findLanelet(lanelet.id(), inverted, laneletIdx),
+                trafficRules->canPass(lanelet));
+      if (!trafficRules->canPass(lanelet))
+      {
+        continue;
+      }
+      ++numberOfLanelets;
+
+      EXPECT_EQ(getRelatedLanelets(graph, laneletIdx, TRoutingRelation::Successor),
+                toKeys(reference->following(lanelet, false)));
+      EXPECT_EQ(getRelatedLanelets(graph, laneletIdx, TRoutingRelation::Left),
+                toKeys(reference->left(lanelet)));
+      EXPECT_EQ(getRelatedLanelets(graph, laneletIdx, TRoutingRelation::Right),
+                toKeys(reference->right(lanelet)));
+      EXPECT_EQ(getRelatedLanelets(graph, laneletIdx, TRoutingRelation::AdjacentLeft),
+                toKeys(reference->adjacentLeft(lanelet)));
+      EXPECT_EQ(getRelatedLanelets(graph, laneletIdx, TRoutingRelation::AdjacentRight),
+                toKeys(reference->adjacentRight(lanelet)));
+
+      if (Constants::kConflictingLaneletIds.count(lanelet.id()) > 0)
+      {
+        EXPECT_EQ(getRelatedLanelets(graph, laneletIdx, TRoutingRelation::Conflicting),
+                  toKeys(reference->conflicting(lanelet)));
+      }
+    }
+  }
+
+  // Five one-way lanelets and both directions of the two-way lanelets, without the bicycle lane
+  EXPECT_EQ(numberOfLanelets, 9u);
+  EXPECT_EQ(graph.getLanelets().size(), numberOfLanelets);
+  EXPECT_EQ(graph.getNumberOfRelations(TRoutingRelation::Conflicting), 4u);
+}
+
+TEST_F(RoutingGraphTest, RelatesMergingAndDivergingLanelets)
+{
+  const std::string road       = lanelet::AttributeValueString::Road;
+  const std::string roadBorder = lanelet::AttributeValueString::RoadBorder;
+
+  // Two lanes that merge into one lane at x = 50 and split into two lanes again
+  const auto mergeLeft = createPoint(1, 50., 3.5), mergeRight = createPoint(2, 50., 0.);
+  const auto splitLeft = createPoint(3, 100., 3.5), splitRight = createPoint(4, 100., 0.);
+  addLanelet(201,
+             createBorder(101, { createPoint(5, 0., 3.5), mergeLeft }, roadBorder, ""),
+             createBorder(102, { createPoint(6, 0., 0.), mergeRight }, roadBorder, ""),
+             road,
+             true);
+  addLanelet(202,
+             createBorder(103, { createPoint(7, 0., 7.), mergeLeft }, roadBorder, ""),
+             createBorder(104, { createPoint(8, 0., 3.5), mergeRight }, roadBorder, ""),
+             road,
+             true);
+  addLanelet(203,
+             createBorder(105, { mergeLeft, splitLeft }, roadBorder, ""),
+             createBorder(106, { mergeRight, splitRight }, roadBorder, ""),
+             road,
+             true);
+  addLanelet(204,
+             createBorder(107, { splitLeft, createPoint(9, 150., 3.5) }, roadBorder, ""),
+             createBorder(108, { splitRight, createPoint(10, 150., 0.) }, roadBorder, ""),
+             road,
+             true);
+  addLanelet(205,
+             createBorder(109, { splitLeft, createPoint(11, 150., 7.) }, roadBorder, ""),
+             createBorder(110, { splitRight, createPoint(12, 150., 3.5) }, roadBorder, ""),
+             road,
+             true);
+
+  CRoutingGraph graph;
+  graph.build(mLanelets);
+  ASSERT_EQ(graph.getLanelets().size(), mLanelets.size());
+
+  const auto expectRelated = [&graph](const lanelet::Id             aId,
+                                      const TRoutingRelation        aRelation,
+                                      const std::set<TLaneletKey>& aExpected) {
+    size_t laneletIdx = 0;
+    ASSERT_TRUE(graph.findLanelet(aId, false, laneletIdx));
+    EXPECT_EQ(getRelatedLanelets(graph, laneletIdx, aRelation), aExpected) << aId;
+  };
+
+  expectRelated(201, TRoutingRelation::Merging, { { 202, false } });
+  expectRelated(202, TRoutingRelation::Merging, { { 201, false } });
+  expectRelated(204, TRoutingRelation::Diverging, { { 205, false } });
+  expectRelated(205, TRoutingRelation::Diverging, { { 204, false } });
+  expectRelated(201, TRoutingRelation::Successor, { { 203, false } });
+  expectRelated(202, TRoutingRelation::Successor, { { 203, false } });
+  expectRelated(203, TRoutingRelation::Successor, { { 204, false }, { 205, false } });
+  expectRelated(203, TRoutingRelation::Merging, {});
+  expectRelated(203, TRoutingRelation::Diverging, {});
+
+  // Merging and diverging lanelets overlap, but are not conflicting
+  EXPECT_EQ(graph.getNumberOfRelations(TRoutingRelation::Conflicting), 0u);
+}
+
+TEST_F(RoutingGraphTest, IgnoresTruncatedAndCorruptFiles)
+{
+  const std::string road       = lanelet::AttributeValueString::Road;
+  const std::string roadBorder = lanelet::AttributeValueString::RoadBorder;
+
+  const auto middleLeft = createPoint(1, 50., 3.5), middleRight = createPoint(2, 50., 0.);
+  addLanelet(201,
+             createBorder(101, { createPoint(3, 0., 3.5), middleLeft }, roadBorder, ""),
+             createBorder(102, { createPoint(4, 0., 0.), middleRight }, roadBorder, ""),
+             road,
+             true);
+  addLanelet(202,
+             createBorder(103, { middleLeft, createPoint(5, 100., 3.5) }, roadBorder, ""),
+             createBorder(104, { middleRight, createPoint(6, 100., 0.) }, roadBorder, ""),
+             road,
+             true);
+
+  CRoutingGraph graph;
+  graph.build(mLanelets);
+  const std::string plainFileName = getTemporaryFileName("RoutingGraphTest.routing");
+  ASSERT_TRUE(graph.store(plainFileName));
+
+  std::string contents;
+  {
+    std::ifstream     input(plainFileName, std::ios::binary);
+    std::stringstream stream;
+    stream << input.rdbuf();
+    contents = stream.str();
+  }
+
+  // Largest number of lanelets that passes the checks of the header
+  const uint64_t numberOfLanelets = std::numeric_limits<uint32_t>::max();
+  std::string    oversized        = contents;
+  oversized.replace(Constants::kNumberOfLaneletsOffset,
+                    sizeof(numberOfLanelets),
+                    reinterpret_cast<const char*>(&numberOfLanelets),
+                    sizeof(numberOfLanelets));
+
+  for (const char* extension : { "", ".gz" })
+  {
+    const std::string fileName =
+      getTemporaryFileName(std::string("RoutingGraphTestCorrupt.routing") + extension);
+
+    writeFile(fileName, contents);
+    CRoutingGraph loaded;
+    EXPECT_TRUE(loaded.load(fileName)) << fileName;
+    EXPECT_EQ(loaded.getLanelets().size(), graph.getLanelets().size());
+
+    // The tables end early, also when the header asks for billions of lanelets
+    for (const std::string& corrupt : { contents.substr(0, contents.size() - 1), oversized })
+    {
+      writeFile(fileName, corrupt);
+      EXPECT_FALSE(loaded.load(fileName)) << fileName;
+      EXPECT_TRUE(loaded.getLanelets().empty());
+      EXPECT_TRUE(loaded.getRelations().empty());
+    }
+  }
+}
+}
+}
+}
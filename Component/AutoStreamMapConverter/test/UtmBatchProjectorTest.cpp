@@ -0,0 +1,165 @@
+/*
+ * Copyright © 2021 TomTom NV. All rights reserved.
+ *
+ * This software is the proprietary copyright of TomTom NV and its subsidiaries and may be
+ * used for internal evaluation purposes or commercial use strictly subject to separate
+ * license agreement between you and TomTom NV. If you are the licensee, you are only permitted
+ * to use this software in accordance with the terms of your license agreement. If you are
+ * not the licensee, you are not authorized to use this software in any manner and should
+ * immediately return or destroy it.
+ */
+
+#include "AutoStreamMapConverter/UtmBatchProjector.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+namespace TomTom {
+namespace AutoStreamForAutoware {
+namespace AutoStreamMapConverter {
+
+namespace Constants {
+// Maximum allowed difference between the batch projector and the UTM projector
+constexpr double kMaxProjectionDifferenceMeters = 1e-4;
+
+// Latitude range of UTM and the grid in which each zone is sampled, the longitudes extend half a
+// degree beyond the zone borders into the padding of the UTM projector
+constexpr double kUtmMinLatDeg        = -80.;
+constexpr double kUtmMaxLatDeg        = 84.;
+constexpr double kGridLatStepDeg      = 0.5;
+constexpr double kGridLonStepDeg      = 0.25;
+constexpr double kGridHalfWidthLonDeg = 3.5;
+}
+
+/**
+ * Origin of a projector and the central meridian of its UTM zone.
+ */
+struct CTestOrigin
+{
+  double mLatDeg;
+  double mLonDeg;
+  double mCentralMeridianDeg;
+};
+
+// Origins in both hemispheres, next to the antimeridian and in the zones of Norway and Svalbard
+const std::vector<CTestOrigin> kTestOrigins = {
+  { 52.37, 4.89, 3. },   { 48.1, 11.5, 9. },      { -33.9, 151.2, 153. }, { 0.5, -177.5, -177. },
+  { 10., 179.5, 177. },  { -10., -179.5, -177. }, { 60., 4.5, 9. },       { 78., 15., 15. },
+  { 83.5, -100., -99. }, { -79.5, 30., 33. },     { 1., 2.9, 3. }
+};
+
+/**
+ * Get coordinates covering the zone of an origin on its hemisphere, including the zone borders.
+ *
+ * @param[in] aOrigin Origin of which the zone must be covered.
+ * @param[out] aLatDeg Latitudes in degrees.
+ * @param[out] aLonDeg Longitudes in degrees, wrapped to [-180, 180).
+ */
+void getZoneGrid(const CTestOrigin&   aOrigin,
+                 std::vector<double>& aLatDeg,
+                 std::vector<double>& aLonDeg)
+{
+  const double minLatDeg = aOrigin.mLatDeg >= 0. ? 0. : Constants::kUtmMinLatDeg;
+  const double maxLatDeg = aOrigin.mLatDeg >= 0. ? Constants::kUtmMaxLatDeg : 0.;
+  for (double lat = minLatDeg; lat < maxLatDeg; lat += Constants::kGridLatStepDeg)
+  {
+    for (double lonOffset = -Constants::kGridHalfWidthLonDeg;
+         lonOffset <= Constants::kGridHalfWidthLonDeg;
+         lonOffset += Constants::kGridLonStepDeg)
+    {
+      double lon = aOrigin.mCentralMeridianDeg + lonOffset;
+      if (lon >= 180.)
+      {
+        lon -= 360.;
+      }
+      else if (lon < -180.)
+      {
+        lon += 360.;
+      }
+
+      aLatDeg.push_back(lat);
+      aLonDeg.push_back(lon);
+    }
+  }
+}
+
+/**
+ * Compare the batch projector with the UTM projector for all coordinates of a grid.
+ *
+ * @param[in] aUtmProjector UTM projector.
+ * @param[in] aLatDeg Latitudes in degrees.
+ * @param[in] aLonDeg Longitudes in degrees.
+ */
+void expectSameProjection(const lanelet::projection::UtmProjector& aUtmProjector,
+                          const std::vector<double>&               aLatDeg,
+                          const std::vector<double>&               aLonDeg)
+{
+  const CUtmBatchProjector batchProjector(aUtmProjector);
+
+  std::vector<double> x;
+  std::vector<double> y;
+  batchProjector.forward(aLatDeg, aLonDeg, x, y);
+  ASSERT_EQ(x.size(), aLatDeg.size());
+  ASSERT_EQ(y.size(), aLatDeg.size());
+
+  for (size_t idx = 0; idx < aLatDeg.size(); ++idx)
+  {
+    const auto expected = aUtmProjector.forward({ aLatDeg[idx], aLonDeg[idx], 0. });
+    EXPECT_LE(std::hypot(x[idx] - expected.x(), y[idx] - expected.y()),
+              Constants::kMaxProjectionDifferenceMeters)
+      << "at " << aLatDeg[idx] << ", " << aLonDeg[idx];
+  }
+}
+
+TEST(UtmBatchProjectorTest, MatchesUtmProjectorAcrossZone)
+{
+  for (const auto& origin : kTestOrigins)
+  {
+    SCOPED_TRACE(testing::Message() << "origin " << origin.mLatDeg << ", " << origin.mLonDeg);
+
+    std::vector<double> latDeg;
+    std::vector<double> lonDeg;
+    getZoneGrid(origin, latDeg, lonDeg);
+
+    const lanelet::Origin projectorOrigin({ origin.mLatDeg, origin.mLonDeg });
+    const lanelet::projection::UtmProjector utmProjector(projectorOrigin);
+    EXPECT_TRUE(CUtmBatchProjector(utmProjector).isSeriesUsed());
+    expectSameProjection(utmProjector, latDeg, lonDeg);
+  }
+}
+
+TEST(UtmBatchProjectorTest, MatchesUtmProjectorWithoutOffset)
+{
+  for (const auto& origin : kTestOrigins)
+  {
+    SCOPED_TRACE(testing::Message() << "origin " << origin.mLatDeg << ", " << origin.mLonDeg);
+
+    std::vector<double> latDeg;
+    std::vector<double> lonDeg;
+    getZoneGrid(origin, latDeg, lonDeg);
+
+    const lanelet::Origin projectorOrigin({ origin.mLatDeg, origin.mLonDeg });
+    expectSameProjection(lanelet::projection::UtmProjector(projectorOrigin, false), latDeg, lonDeg);
+  }
+}
+
+TEST(UtmBatchProjectorTest, MatchesUtmProjectorOutsideSeries)
+{
+  // Coordinates on the opposite hemisphere and in the polar regions are projected by the UTM
+  // projector, which transfers them to the zone of the origin
+  const lanelet::projection::UtmProjector northern(lanelet::Origin({ 52.37, 4.89 }));
+  expectSameProjection(northern, { -0.5, -1., 84., 84.5 }, { 4., 5., 4., 5. });
+
+  const lanelet::projection::UtmProjector southern(lanelet::Origin({ -33.9, 151.2 }));
+  expectSameProjection(southern, { 0., 0.5, -80.5 }, { 151., 152., 151. });
+
+  // Origins in the polar regions are not covered by the series at all
+  const lanelet::projection::UtmProjector polar(lanelet::Origin({ 85., 10. }));
+  EXPECT_FALSE(CUtmBatchProjector(polar).isSeriesUsed());
+  expectSameProjection(polar, { 85., 85.5 }, { 10., 11. });
+}
+}
+}
+}